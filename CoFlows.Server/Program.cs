@@ -117,6 +117,9 @@ namespace CoFlows.Server
 
             if(config["Logging"] != null)
                 QuantApp.Kernel.Logger.SetConfig(JsonConvert.DeserializeObject<QuantApp.Kernel.Logger.Config>(config["Logging"].ToString()));
+
+            if(config["JVM"] != null)
+                QuantApp.Kernel.JVM.Runtime.LaunchOptions = QuantApp.Kernel.JVM.JVMLaunchOptions.FromJson(config["JVM"].ToString());
             
             //Jupyter Lab
             if(args != null && args.Length > 0 && args[0] == "lab")
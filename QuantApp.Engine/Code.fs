@@ -1373,7 +1373,7 @@ module Code =
                             let jars = jars |> Seq.append(jarsMnt)
                             let path = jars |> Seq.map(fun jar -> jar.ToString()) |> Seq.fold(fun acc x -> acc + ":" + x) ""
 
-                            if Runtime.InitJVM(classpath=path) <> 0 then
+                            if Runtime.InitJVM(classpath=path, options=Runtime.LaunchOptions) <> 0 then
                                 CompiledJVMBaseClasses.Values |> Seq.toArray |> Runtime.SetClassPath
                                 
                                 "JVM Engine not started: " + JVM.Runtime.Loaded.ToString() |> logger.Error
@@ -22,12 +22,38 @@
 #include <set>
 #include <dirent.h>
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
 
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <unordered_map>
+#include <string>
+#include <vector>
 
 using namespace std;
 extern "C" {
 
+    /*
+    Threading model.
+    Every exported function can be called from any number of threads at once and none of them takes a lock on the
+    call path. A JNIEnv is only ever used by the thread it belongs to, and the little shared state there is stays off
+    the hot path:
+    - the class and method ID registry is written once under call_once and only read afterwards,
+    - thread attachment and local reference accounting live in thread local storage,
+    - the direct buffer registry is sharded by token, and its pool has its own lock on the allocation path only,
+    - the handle table behind the object IDs is lock free, and so is queueing a release; the batches are
+      freed by a single release thread,
+    - the .NET callbacks (fnInvoke and friends) are set once at start up and run concurrently, one per calling Java
+      thread; Runtime.cs only serializes calls into objects whose type is marked JVMSerialized, on striped monitors,
+    - the executor behind SubmitWork queues through lock free rings, its lock is only taken to start and stop it,
+    - call metrics are recorded into per-thread shards and only merged when read.
+    */
+
     static int g_nExitCode = 0;
 
     void system_exit(jint nCode)
@@ -35,20 +61,707 @@ extern "C" {
         g_nExitCode = nCode;
     }
 
+    /*
+    Metrics.
+    Every exported wrapper opens a JNI_METRIC scope named after the function. The scope counts calls, the exceptions
+    left pending on return and the bytes marshalled, and records latency in a log linear histogram with 8 sub-buckets
+    per power of two, which is within 12.5% from 8ns up to about a minute.
+    Each thread writes its own shard, so recording takes no lock and no atomic read-modify-write. SnapshotMetrics merges
+    the shards on read, and ResetMetrics moves a baseline instead of clearing counters that other threads are writing.
+    SetMetricsEnabled switches recording off at run time. Building with -DJNIWRAPPER_NO_METRICS compiles the scopes out
+    entirely; the snapshot functions are still exported and report nothing.
+    */
+
+    #define METRIC_MAX 256
+    #define METRIC_SUB_BITS 3
+    #define METRIC_BUCKETS 280
 
-    int MakeJavaVMInitArgs(char* classpath, char* libpath, void** ppArgs )
+    struct MetricSnapshot
+    {
+        jlong calls;
+        jlong exceptions;
+        jlong bytes;
+        jlong nanos;
+        jlong buckets[METRIC_BUCKETS];
+    };
+
+    static inline int MetricBucket(jlong nanos)
+    {
+        if(nanos < (1 << METRIC_SUB_BITS))
+            return nanos < 0 ? 0 : (int)nanos;
+
+        int exponent = 63 - __builtin_clzll((unsigned long long)nanos);
+        int bucket = (exponent - METRIC_SUB_BITS + 1) * (1 << METRIC_SUB_BITS) + (int)((nanos >> (exponent - METRIC_SUB_BITS)) & ((1 << METRIC_SUB_BITS) - 1));
+        return bucket < METRIC_BUCKETS ? bucket : METRIC_BUCKETS - 1;
+    }
+
+#ifndef JNIWRAPPER_NO_METRICS
+    struct MetricCounters
+    {
+        std::atomic<jlong> calls;
+        std::atomic<jlong> exceptions;
+        std::atomic<jlong> bytes;
+        std::atomic<jlong> nanos;
+        std::atomic<jlong> buckets[METRIC_BUCKETS];
+    };
+
+    struct MetricShard
+    {
+        std::atomic<MetricCounters*> counters[METRIC_MAX];
+        std::atomic<bool> inUse;
+        MetricShard* next;
+    };
+
+    static const char* g_metricNames[METRIC_MAX];
+    static std::atomic<int> g_metricCount(0);
+    static std::atomic<MetricShard*> g_metricShards(NULL);
+    static std::atomic<bool> g_metricsEnabled(true);
+
+    //Taken to register a name and to read or move the baseline, never while recording.
+    static std::mutex g_metricLock;
+    static MetricSnapshot g_metricBaseline[METRIC_MAX];
+
+    static int RegisterMetric(const char* szName)
+    {
+        std::lock_guard<std::mutex> lock(g_metricLock);
+        int count = g_metricCount.load(std::memory_order_relaxed);
+        for(int i = 0; i < count; i++)
+            if(strcmp(g_metricNames[i], szName) == 0)
+                return i;
+
+        if(count >= METRIC_MAX)
+            return -1;
+
+        g_metricNames[count] = szName;
+        g_metricCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    //Shards of finished threads are handed to new ones, their counts stay in the totals.
+    struct MetricShardOwner
+    {
+        MetricShard* shard;
+        ~MetricShardOwner()
+        {
+            if(shard != NULL)
+                shard->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    static thread_local MetricShardOwner t_metricShard = { NULL };
+
+    static MetricShard* ThreadMetricShard()
+    {
+        if(t_metricShard.shard != NULL)
+            return t_metricShard.shard;
+
+        for(MetricShard* shard = g_metricShards.load(std::memory_order_acquire); shard != NULL; shard = shard->next)
+        {
+            bool idle = false;
+            if(shard->inUse.compare_exchange_strong(idle, true, std::memory_order_acquire))
+                return t_metricShard.shard = shard;
+        }
+
+        MetricShard* shard = new MetricShard();
+        for(int i = 0; i < METRIC_MAX; i++)
+            shard->counters[i].store(NULL, std::memory_order_relaxed);
+        shard->inUse.store(true, std::memory_order_relaxed);
+
+        MetricShard* head = g_metricShards.load(std::memory_order_relaxed);
+        do
+        {
+            shard->next = head;
+        }
+        while(!g_metricShards.compare_exchange_weak(head, shard, std::memory_order_release, std::memory_order_relaxed));
+
+        return t_metricShard.shard = shard;
+    }
+
+    static MetricCounters* ThreadMetricCounters(int id)
+    {
+        MetricShard* shard = ThreadMetricShard();
+        MetricCounters* counters = shard->counters[id].load(std::memory_order_relaxed);
+        if(counters != NULL)
+            return counters;
+
+        counters = new MetricCounters();
+        counters->calls.store(0, std::memory_order_relaxed);
+        counters->exceptions.store(0, std::memory_order_relaxed);
+        counters->bytes.store(0, std::memory_order_relaxed);
+        counters->nanos.store(0, std::memory_order_relaxed);
+        for(int i = 0; i < METRIC_BUCKETS; i++)
+            counters->buckets[i].store(0, std::memory_order_relaxed);
+
+        shard->counters[id].store(counters, std::memory_order_release);
+        return counters;
+    }
+
+    //Only the owning thread writes a counter, so a plain load and store is enough and readers never see a torn value.
+    static inline void MetricAdd(std::atomic<jlong>& counter, jlong value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    class MetricScope
+    {
+    public:
+        MetricScope(JNIEnv* pEnv, int id) : bytes(0), m_pEnv(pEnv), m_counters(NULL)
+        {
+            if(id < 0 || !g_metricsEnabled.load(std::memory_order_relaxed))
+                return;
+
+            m_counters = ThreadMetricCounters(id);
+            m_start = std::chrono::steady_clock::now();
+        }
+
+        ~MetricScope()
+        {
+            if(m_counters == NULL)
+                return;
+
+            jlong nanos = (jlong)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+            MetricAdd(m_counters->calls, 1);
+            MetricAdd(m_counters->nanos, nanos);
+            MetricAdd(m_counters->buckets[MetricBucket(nanos)], 1);
+            if(bytes != 0)
+                MetricAdd(m_counters->bytes, bytes);
+            if(m_pEnv != NULL && m_pEnv->ExceptionCheck() == JNI_TRUE)
+                MetricAdd(m_counters->exceptions, 1);
+        }
+
+        jlong bytes;
+
+    private:
+        MetricScope(const MetricScope&);
+        MetricScope& operator=(const MetricScope&);
+
+        JNIEnv* m_pEnv;
+        MetricCounters* m_counters;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    static void MergeMetrics(MetricSnapshot* pSnapshots, int count)
+    {
+        memset(pSnapshots, 0, sizeof(MetricSnapshot) * count);
+        for(MetricShard* shard = g_metricShards.load(std::memory_order_acquire); shard != NULL; shard = shard->next)
+        {
+            for(int id = 0; id < count; id++)
+            {
+                MetricCounters* counters = shard->counters[id].load(std::memory_order_acquire);
+                if(counters == NULL)
+                    continue;
+
+                MetricSnapshot& snapshot = pSnapshots[id];
+                snapshot.calls += counters->calls.load(std::memory_order_relaxed);
+                snapshot.exceptions += counters->exceptions.load(std::memory_order_relaxed);
+                snapshot.bytes += counters->bytes.load(std::memory_order_relaxed);
+                snapshot.nanos += counters->nanos.load(std::memory_order_relaxed);
+                for(int i = 0; i < METRIC_BUCKETS; i++)
+                    snapshot.buckets[i] += counters->buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    #define JNI_METRIC(pEnv) static const int _metricId = RegisterMetric(__func__); MetricScope _metric(pEnv, _metricId)
+    #define JNI_METRIC_BYTES(n) (_metric.bytes += (jlong)(n))
+#else
+    #define JNI_METRIC(pEnv)
+    #define JNI_METRIC_BYTES(n)
+#endif
+
+    //1 while metrics are compiled in and recording.
+    int MetricsEnabled()
+    {
+#ifndef JNIWRAPPER_NO_METRICS
+        return g_metricsEnabled.load() ? 1 : 0;
+#else
+        return 0;
+#endif
+    }
+
+    void SetMetricsEnabled(int enabled)
+    {
+#ifndef JNIWRAPPER_NO_METRICS
+        g_metricsEnabled.store(enabled != 0);
+#endif
+    }
+
+    int GetMetricCount()
+    {
+#ifndef JNIWRAPPER_NO_METRICS
+        return g_metricCount.load(std::memory_order_acquire);
+#else
+        return 0;
+#endif
+    }
+
+    //Name of the wrapper behind a metric, NULL past GetMetricCount.
+    const char* GetMetricName(int id)
+    {
+#ifndef JNIWRAPPER_NO_METRICS
+        if(id >= 0 && id < g_metricCount.load(std::memory_order_acquire))
+            return g_metricNames[id];
+#endif
+        return NULL;
+    }
+
+    int GetMetricBucketCount()
+    {
+        return METRIC_BUCKETS;
+    }
+
+    //Smallest latency in nanoseconds that falls in bucket.
+    jlong GetMetricBucketLowerBound(int bucket)
+    {
+        if(bucket < (1 << METRIC_SUB_BITS))
+            return bucket;
+
+        int exponent = bucket / (1 << METRIC_SUB_BITS) + METRIC_SUB_BITS - 1;
+        jlong sub = bucket % (1 << METRIC_SUB_BITS);
+        return ((jlong)(1 << METRIC_SUB_BITS) + sub) << (exponent - METRIC_SUB_BITS);
+    }
+
+    //Fills up to count snapshots, by metric ID, with the totals since the last ResetMetrics. Returns how many were filled.
+    int SnapshotMetrics(MetricSnapshot* pSnapshots, int count)
+    {
+#ifndef JNIWRAPPER_NO_METRICS
+        int registered = g_metricCount.load(std::memory_order_acquire);
+        if(count > registered)
+            count = registered;
+        if(count <= 0)
+            return 0;
+
+        MergeMetrics(pSnapshots, count);
+
+        std::lock_guard<std::mutex> lock(g_metricLock);
+        for(int id = 0; id < count; id++)
+        {
+            MetricSnapshot& snapshot = pSnapshots[id];
+            const MetricSnapshot& baseline = g_metricBaseline[id];
+            snapshot.calls -= baseline.calls;
+            snapshot.exceptions -= baseline.exceptions;
+            snapshot.bytes -= baseline.bytes;
+            snapshot.nanos -= baseline.nanos;
+            for(int i = 0; i < METRIC_BUCKETS; i++)
+                snapshot.buckets[i] -= baseline.buckets[i];
+        }
+        return count;
+#else
+        return 0;
+#endif
+    }
+
+    void ResetMetrics()
+    {
+#ifndef JNIWRAPPER_NO_METRICS
+        std::lock_guard<std::mutex> lock(g_metricLock);
+        MergeMetrics(g_metricBaseline, g_metricCount.load(std::memory_order_acquire));
+#endif
+    }
+
+    /*
+    Process-wide registry of the classes and IDs used on every boxing and error path.
+    Classes are held as global references so the cached IDs stay valid for the life of the JVM.
+    It is filled once, either explicitly through InitJNICache or lazily by the first wrapper that needs it.
+    */
+
+    struct JNICache
+    {
+        jclass clsBoolean;
+        jclass clsByte;
+        jclass clsCharacter;
+        jclass clsShort;
+        jclass clsInteger;
+        jclass clsLong;
+        jclass clsFloat;
+        jclass clsDouble;
+        jclass clsString;
+        jclass clsClass;
+
+        jclass clsBooleanArray;
+        jclass clsByteArray;
+        jclass clsCharArray;
+        jclass clsShortArray;
+        jclass clsIntArray;
+        jclass clsLongArray;
+        jclass clsFloatArray;
+        jclass clsDoubleArray;
+        jclass clsObjectArray;
+
+        jmethodID midBooleanValueOf;
+        jmethodID midByteValueOf;
+        jmethodID midCharacterValueOf;
+        jmethodID midShortValueOf;
+        jmethodID midIntegerValueOf;
+        jmethodID midLongValueOf;
+        jmethodID midFloatValueOf;
+        jmethodID midDoubleValueOf;
+
+        jmethodID midBooleanValue;
+        jmethodID midByteValue;
+        jmethodID midCharacterValue;
+        jmethodID midShortValue;
+        jmethodID midIntegerValue;
+        jmethodID midLongValue;
+        jmethodID midFloatValue;
+        jmethodID midDoubleValue;
+
+        jobject objBooleanTrue;
+        jobject objBooleanFalse;
+
+        jmethodID midClassGetName;
+
+        jclass clsThrowable;
+        jmethodID midThrowableGetMessage;
+        jmethodID midThrowableGetCause;
+
+        jclass clsIterator;
+        jmethodID midIteratorHasNext;
+        jmethodID midIteratorNext;
+        jclass clsMapEntry;
+        jmethodID midMapEntryGetKey;
+        jmethodID midMapEntryGetValue;
+
+        jclass clsCollection;
+        jmethodID midCollectionSize;
+        jmethodID midCollectionToArray;
+        jclass clsArrayList;
+        jmethodID midArrayListInit;
+        jmethodID midArrayListAdd;
+        jclass clsNumber;
+        jmethodID midNumberDoubleValue;
+        jmethodID midNumberLongValue;
+        jmethodID midNumberIntValue;
+        jmethodID midNumberFloatValue;
+
+        bool loaded;
+    };
+
+    static JNICache g_cache;
+    static std::once_flag g_cacheOnce;
+
+    static jclass CacheClass(JNIEnv* pEnv, const char* szClass)
+    {
+        jclass cls = pEnv->FindClass(szClass);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || cls == NULL)
+        {
+            pEnv->ExceptionClear();
+            return NULL;
+        }
+
+        jclass global = (jclass)pEnv->NewGlobalRef(cls);
+        pEnv->DeleteLocalRef(cls);
+        return global;
+    }
+
+    static jmethodID CacheMethod(JNIEnv* pEnv, jclass cls, const char* szName, const char* szArgs, bool isStatic)
+    {
+        if(cls == NULL)
+            return NULL;
+
+        jmethodID mid = isStatic ? pEnv->GetStaticMethodID(cls, szName, szArgs) : pEnv->GetMethodID(cls, szName, szArgs);
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            pEnv->ExceptionClear();
+            return NULL;
+        }
+        return mid;
+    }
+
+    static jobject CacheStaticObject(JNIEnv* pEnv, jclass cls, const char* szName, const char* szSig)
+    {
+        if(cls == NULL)
+            return NULL;
+
+        jfieldID fid = pEnv->GetStaticFieldID(cls, szName, szSig);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || fid == NULL)
+        {
+            pEnv->ExceptionClear();
+            return NULL;
+        }
+
+        jobject obj = pEnv->GetStaticObjectField(cls, fid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || obj == NULL)
+        {
+            pEnv->ExceptionClear();
+            return NULL;
+        }
+
+        jobject global = pEnv->NewGlobalRef(obj);
+        pEnv->DeleteLocalRef(obj);
+        return global;
+    }
+
+    static void LoadJNICache(JNIEnv* pEnv)
+    {
+        g_cache.clsBoolean = CacheClass(pEnv, "java/lang/Boolean");
+        g_cache.clsByte = CacheClass(pEnv, "java/lang/Byte");
+        g_cache.clsCharacter = CacheClass(pEnv, "java/lang/Character");
+        g_cache.clsShort = CacheClass(pEnv, "java/lang/Short");
+        g_cache.clsInteger = CacheClass(pEnv, "java/lang/Integer");
+        g_cache.clsLong = CacheClass(pEnv, "java/lang/Long");
+        g_cache.clsFloat = CacheClass(pEnv, "java/lang/Float");
+        g_cache.clsDouble = CacheClass(pEnv, "java/lang/Double");
+        g_cache.clsString = CacheClass(pEnv, "java/lang/String");
+        g_cache.clsClass = CacheClass(pEnv, "java/lang/Class");
+
+        g_cache.clsBooleanArray = CacheClass(pEnv, "[Z");
+        g_cache.clsByteArray = CacheClass(pEnv, "[B");
+        g_cache.clsCharArray = CacheClass(pEnv, "[C");
+        g_cache.clsShortArray = CacheClass(pEnv, "[S");
+        g_cache.clsIntArray = CacheClass(pEnv, "[I");
+        g_cache.clsLongArray = CacheClass(pEnv, "[J");
+        g_cache.clsFloatArray = CacheClass(pEnv, "[F");
+        g_cache.clsDoubleArray = CacheClass(pEnv, "[D");
+        g_cache.clsObjectArray = CacheClass(pEnv, "[Ljava/lang/Object;");
+
+        g_cache.midBooleanValueOf = CacheMethod(pEnv, g_cache.clsBoolean, "valueOf", "(Z)Ljava/lang/Boolean;", true);
+        g_cache.midByteValueOf = CacheMethod(pEnv, g_cache.clsByte, "valueOf", "(B)Ljava/lang/Byte;", true);
+        g_cache.midCharacterValueOf = CacheMethod(pEnv, g_cache.clsCharacter, "valueOf", "(C)Ljava/lang/Character;", true);
+        g_cache.midShortValueOf = CacheMethod(pEnv, g_cache.clsShort, "valueOf", "(S)Ljava/lang/Short;", true);
+        g_cache.midIntegerValueOf = CacheMethod(pEnv, g_cache.clsInteger, "valueOf", "(I)Ljava/lang/Integer;", true);
+        g_cache.midLongValueOf = CacheMethod(pEnv, g_cache.clsLong, "valueOf", "(J)Ljava/lang/Long;", true);
+        g_cache.midFloatValueOf = CacheMethod(pEnv, g_cache.clsFloat, "valueOf", "(F)Ljava/lang/Float;", true);
+        g_cache.midDoubleValueOf = CacheMethod(pEnv, g_cache.clsDouble, "valueOf", "(D)Ljava/lang/Double;", true);
+
+        g_cache.midBooleanValue = CacheMethod(pEnv, g_cache.clsBoolean, "booleanValue", "()Z", false);
+        g_cache.midByteValue = CacheMethod(pEnv, g_cache.clsByte, "byteValue", "()B", false);
+        g_cache.midCharacterValue = CacheMethod(pEnv, g_cache.clsCharacter, "charValue", "()C", false);
+        g_cache.midShortValue = CacheMethod(pEnv, g_cache.clsShort, "shortValue", "()S", false);
+        g_cache.midIntegerValue = CacheMethod(pEnv, g_cache.clsInteger, "intValue", "()I", false);
+        g_cache.midLongValue = CacheMethod(pEnv, g_cache.clsLong, "longValue", "()J", false);
+        g_cache.midFloatValue = CacheMethod(pEnv, g_cache.clsFloat, "floatValue", "()F", false);
+        g_cache.midDoubleValue = CacheMethod(pEnv, g_cache.clsDouble, "doubleValue", "()D", false);
+
+        g_cache.objBooleanTrue = CacheStaticObject(pEnv, g_cache.clsBoolean, "TRUE", "Ljava/lang/Boolean;");
+        g_cache.objBooleanFalse = CacheStaticObject(pEnv, g_cache.clsBoolean, "FALSE", "Ljava/lang/Boolean;");
+
+        g_cache.midClassGetName = CacheMethod(pEnv, g_cache.clsClass, "getName", "()Ljava/lang/String;", false);
+
+        g_cache.clsThrowable = CacheClass(pEnv, "java/lang/Throwable");
+        g_cache.midThrowableGetMessage = CacheMethod(pEnv, g_cache.clsThrowable, "getMessage", "()Ljava/lang/String;", false);
+        g_cache.midThrowableGetCause = CacheMethod(pEnv, g_cache.clsThrowable, "getCause", "()Ljava/lang/Throwable;", false);
+
+        g_cache.clsIterator = CacheClass(pEnv, "java/util/Iterator");
+        g_cache.midIteratorHasNext = CacheMethod(pEnv, g_cache.clsIterator, "hasNext", "()Z", false);
+        g_cache.midIteratorNext = CacheMethod(pEnv, g_cache.clsIterator, "next", "()Ljava/lang/Object;", false);
+        g_cache.clsMapEntry = CacheClass(pEnv, "java/util/Map$Entry");
+        g_cache.midMapEntryGetKey = CacheMethod(pEnv, g_cache.clsMapEntry, "getKey", "()Ljava/lang/Object;", false);
+        g_cache.midMapEntryGetValue = CacheMethod(pEnv, g_cache.clsMapEntry, "getValue", "()Ljava/lang/Object;", false);
+
+        g_cache.clsCollection = CacheClass(pEnv, "java/util/Collection");
+        g_cache.midCollectionSize = CacheMethod(pEnv, g_cache.clsCollection, "size", "()I", false);
+        g_cache.midCollectionToArray = CacheMethod(pEnv, g_cache.clsCollection, "toArray", "()[Ljava/lang/Object;", false);
+        g_cache.clsArrayList = CacheClass(pEnv, "java/util/ArrayList");
+        g_cache.midArrayListInit = CacheMethod(pEnv, g_cache.clsArrayList, "<init>", "(I)V", false);
+        g_cache.midArrayListAdd = CacheMethod(pEnv, g_cache.clsArrayList, "add", "(Ljava/lang/Object;)Z", false);
+        g_cache.clsNumber = CacheClass(pEnv, "java/lang/Number");
+        g_cache.midNumberDoubleValue = CacheMethod(pEnv, g_cache.clsNumber, "doubleValue", "()D", false);
+        g_cache.midNumberLongValue = CacheMethod(pEnv, g_cache.clsNumber, "longValue", "()J", false);
+        g_cache.midNumberIntValue = CacheMethod(pEnv, g_cache.clsNumber, "intValue", "()I", false);
+        g_cache.midNumberFloatValue = CacheMethod(pEnv, g_cache.clsNumber, "floatValue", "()F", false);
+
+        g_cache.loaded = true;
+    }
+
+    //Returns the registry, loading it on first use.
+    static JNICache* GetJNICache(JNIEnv* pEnv)
+    {
+        std::call_once(g_cacheOnce, LoadJNICache, pEnv);
+        return &g_cache;
+    }
+
+    /*
+    The bridge classes come from the bridge jar, which may not be loadable yet when the first wrapper runs. They are
+    kept apart from the JDK entries and only published once CLRRuntime is found, so a failed lookup is retried by the
+    next caller instead of being cached. JNI_OnLoad fills them as soon as CLRRuntime loads the library.
+    GetBridgeCache returns NULL while the bridge is not loadable; every caller has a path for that.
+    */
+
+    struct BridgeCache
+    {
+        jclass clsCLRRuntime;
+        jmethodID midCLRRuntimeGetError;
+        jmethodID midCLRRuntimeRemoveIDs;
+        jmethodID midCLRRuntimeFieldType;
+        jmethodID midCLRRuntimeTransformType;
+
+        jclass clsCLRBuffer;
+        jmethodID midCLRBufferTrack;
+    };
+
+    static std::atomic<BridgeCache*> g_bridge(NULL);
+    static std::mutex g_bridgeLock;
+
+    static BridgeCache* GetBridgeCache(JNIEnv* pEnv)
+    {
+        BridgeCache* bridge = g_bridge.load(std::memory_order_acquire);
+        if(bridge != NULL)
+            return bridge;
+
+        std::lock_guard<std::mutex> lock(g_bridgeLock);
+        bridge = g_bridge.load(std::memory_order_relaxed);
+        if(bridge != NULL)
+            return bridge;
+
+        jclass cls = CacheClass(pEnv, "app/quant/clr/CLRRuntime");
+        if(cls == NULL)
+            return NULL;
+
+        bridge = new BridgeCache();
+        bridge->clsCLRRuntime = cls;
+        bridge->midCLRRuntimeGetError = CacheMethod(pEnv, cls, "GetError", "(Ljava/lang/Throwable;)Ljava/lang/String;", true);
+        bridge->midCLRRuntimeRemoveIDs = CacheMethod(pEnv, cls, "RemoveIDs", "([I)V", true);
+        bridge->midCLRRuntimeFieldType = CacheMethod(pEnv, cls, "FieldType", "(Ljava/lang/Class;Ljava/lang/String;)Ljava/lang/Class;", true);
+        bridge->midCLRRuntimeTransformType = CacheMethod(pEnv, cls, "TransformType", "(Ljava/lang/reflect/Type;)Ljava/lang/String;", true);
+
+        bridge->clsCLRBuffer = CacheClass(pEnv, "app/quant/clr/CLRBuffer");
+        bridge->midCLRBufferTrack = CacheMethod(pEnv, bridge->clsCLRBuffer, "Track", "(Ljava/nio/ByteBuffer;J)Ljava/nio/ByteBuffer;", true);
+
+        g_bridge.store(bridge, std::memory_order_release);
+        return bridge;
+    }
+
+    int InitJNICache(JNIEnv* pEnv)
+    {
+        GetJNICache(pEnv);
+        return GetBridgeCache(pEnv) == NULL ? -2 : 0;
+    }
+
+    /*
+    Local reference frames.
+    Threads attached from .NET never return to Java, so every local reference a wrapper hands out stays alive
+    until the thread detaches. Callers that produce many references in a loop bracket the work with PushFrame/PopFrame
+    (or delete single references with DeleteLocalRef) so the table stays bounded.
+    The counters below are a per-thread estimate of the live references handed out by the wrappers; the peak is kept
+    so long running threads can be checked for leaks.
+    */
+
+    struct LocalRefStats
+    {
+        int current;
+        int peak;
+        std::vector<int> frames;
+    };
+
+    static thread_local LocalRefStats t_localRefs = { 0, 0, std::vector<int>() };
+
+    static inline void TrackLocalRef(jobject obj)
+    {
+        if(obj == NULL)
+            return;
+
+        t_localRefs.current++;
+        if(t_localRefs.current > t_localRefs.peak)
+            t_localRefs.peak = t_localRefs.current;
+    }
+
+    int PushFrame(JNIEnv* pEnv, int capacity)
+    {
+        JNI_METRIC(pEnv);
+        if(pEnv->PushLocalFrame(capacity) != JNI_OK)
+        {
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return -1;
+            return -2;
+        }
+
+        t_localRefs.frames.push_back(t_localRefs.current);
+        return 0;
+    }
+
+    int PopFrame(JNIEnv* pEnv, jobject result, jobject* pResult)
+    {
+        JNI_METRIC(pEnv);
+        jobject val = pEnv->PopLocalFrame(result);
+
+        if(!t_localRefs.frames.empty())
+        {
+            t_localRefs.current = t_localRefs.frames.back();
+            t_localRefs.frames.pop_back();
+        }
+        TrackLocalRef(val);
+
+        if(pResult != NULL)
+            *pResult = val;
+        return 0;
+    }
+
+    int DeleteLocalRef(JNIEnv* pEnv, jobject obj)
+    {
+        JNI_METRIC(pEnv);
+        if(obj == NULL)
+            return -2;
+
+        pEnv->DeleteLocalRef(obj);
+        if(t_localRefs.current > 0)
+            t_localRefs.current--;
+        return 0;
+    }
+
+    //Global references outlive the thread scope they were created in, for .NET objects that hold on to a Java object.
+    int NewGlobalRef(JNIEnv* pEnv, jobject obj, jobject* pRef)
+    {
+        JNI_METRIC(pEnv);
+        if(obj == NULL)
+            return -2;
+
+        *pRef = pEnv->NewGlobalRef(obj);
+        return *pRef == NULL ? -1 : 0;
+    }
+
+    int DeleteGlobalRef(JNIEnv* pEnv, jobject obj)
+    {
+        JNI_METRIC(pEnv);
+        if(obj == NULL)
+            return -2;
+
+        pEnv->DeleteGlobalRef(obj);
+        return 0;
+    }
+
+    int GetLocalRefStats(int* pCurrent, int* pPeak, int* pDepth)
+    {
+        *pCurrent = t_localRefs.current;
+        *pPeak = t_localRefs.peak;
+        *pDepth = (int)t_localRefs.frames.size();
+        return 0;
+    }
+
+    void ResetLocalRefPeak()
+    {
+        t_localRefs.peak = t_localRefs.current;
+    }
+
+
+    static char* CopyOption(const char* szFormat, const char* szValue)
+    {
+        char* option = new char[strlen(szFormat) + strlen(szValue) + 1];
+        sprintf( option, szFormat, szValue );
+        return option;
+    }
+
+    /*
+    Builds the JVM init arguments: class path and library path followed by the caller's options
+    (heap size, GC, class data sharing...), passed through to JNI_CreateJavaVM in order.
+    Unrecognized options are ignored so a profile can be shared between JVM versions.
+    */
+
+    int MakeJavaVMInitArgsEx(char* classpath, char* libpath, int nExtra, char** pExtra, void** ppArgs )
     {
-        int nOptSize = 2;
+        if(nExtra < 0 || (nExtra > 0 && pExtra == NULL))
+            return -2;
+
+        int nOptSize = 2 + nExtra;
         JavaVMInitArgs* pArgs    = new JavaVMInitArgs();
         JavaVMOption*   pOptions = new JavaVMOption[nOptSize];
+        memset(pOptions, 0, sizeof(JavaVMOption) * nOptSize);
 
+        pOptions[0].optionString = CopyOption( "-Djava.class.path=%s", classpath );
+        pOptions[1].optionString = CopyOption( "-Djava.library.path=%s", libpath );
 
-        pOptions[0].optionString = new char[strlen("-Djava.class.path=")+strlen(classpath)+1];
-        sprintf( pOptions[0].optionString, "-Djava.class.path=%s", classpath );
-        
-        pOptions[1].optionString = new char[strlen("-Djava.library.path=")+strlen(libpath)+1];
-        sprintf( pOptions[1].optionString, "-Djava.library.path=%s", libpath );
-
+        for(int i = 0; i < nExtra; i++)
+            pOptions[2 + i].optionString = CopyOption( "%s", pExtra[i] == NULL ? "" : pExtra[i] );
 
         memset(pArgs, 0, sizeof(JavaVMInitArgs));
         pArgs->version = JNI_VERSION_1_6;
@@ -57,2365 +770,5410 @@ extern "C" {
         pArgs->nOptions = nOptSize;
         pArgs->ignoreUnrecognized = JNI_TRUE;
 
-        *ppArgs = pArgs;
+        *ppArgs = pArgs;
+
+        return 0;
+    }
+
+    int MakeJavaVMInitArgs(char* classpath, char* libpath, void** ppArgs )
+    {
+        return MakeJavaVMInitArgsEx(classpath, libpath, 0, NULL, ppArgs);
+    }
+
+    /*
+    Free the allocated JVM init argumets
+    */
+
+    void FreeJavaVMInitArgs( void* pArgs )
+    {
+        JavaVMInitArgs* pInitArgs = (JavaVMInitArgs*)pArgs;
+        if(pInitArgs == NULL)
+            return;
+
+        for(int i = 0; i < pInitArgs->nOptions; i++)
+            delete[] pInitArgs->options[i].optionString;
+        delete[] pInitArgs->options;
+        delete pInitArgs;
+    }
+
+    /*
+    Static wrapper on FindClass() JNI function.
+    See the description in
+    http://jre.sfbay/java/re/jdk/6/promoted/latest/docs/technotes/guides/jni/spec/functions.html#wp16027
+    */
+
+    int FindClass(JNIEnv* pEnv, const char* szClass, jclass* pClass )
+    {
+        JNI_METRIC(pEnv);
+        // The bridge class is looked up on almost every call from .NET, serve it from the registry.
+        if(strcmp(szClass, "app/quant/clr/CLRRuntime") == 0)
+        {
+            BridgeCache* bridge = GetBridgeCache(pEnv);
+            if(bridge != NULL)
+            {
+                *pClass = bridge->clsCLRRuntime;
+                return 0;
+            }
+        }
+
+        *pClass = pEnv->FindClass( szClass );
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        TrackLocalRef(*pClass);
+        if(*pClass != NULL)
+            return 0;
+        else
+            return -2;
+
+    }
+
+    /*
+    Thread attachment.
+    The JNIEnv of every thread that calls in from .NET is cached in thread local storage, so entering the JVM is a
+    load after the first call. Threads attached here are daemon threads named after the .NET thread, so ThreadPool and
+    scheduler threads never hold up JVM shutdown, and a thread key destructor detaches them when the OS thread exits.
+    Threads that were already attached, like the thread that created the JVM, are used as they are.
+    Threads are never detached by a call. EnterThread opens a scope and LeaveThread closes it. Scopes nest: only the
+    outermost EnterThread pushes a local frame and only its matching LeaveThread pops it. That releases every local
+    reference handed out in the scope, the same way detaching used to, so a local must not be used after the
+    LeaveThread that closes the outermost scope it was created in; keep a global reference instead. A nested scope
+    never frees the locals of the scope around it. The frame is left alone while a callback from Java is running on
+    the thread (Java owns the locals then) or while a frame opened through PushFrame is above it.
+    DetacheThread is the old name of LeaveThread and only forwards to it.
+    */
+
+    struct ThreadAttachment
+    {
+        JNIEnv* env;
+        bool framed;
+        size_t frameDepth;
+        int callbacks;
+        int depth;
+    };
+
+    static thread_local ThreadAttachment t_attachment = { NULL, false, 0, 0, 0 };
+    static std::atomic<int> g_attachedThreads(0);
+
+    struct CallbackScope
+    {
+        CallbackScope() { t_attachment.callbacks++; }
+        ~CallbackScope() { t_attachment.callbacks--; }
+    };
+
+#ifdef _WIN32
+    struct ThreadDetacher
+    {
+        JavaVM* pVM;
+        ~ThreadDetacher()
+        {
+            if(pVM != NULL)
+                pVM->DetachCurrentThread();
+        }
+    };
+
+    static thread_local ThreadDetacher t_detacher = { NULL };
+
+    static void DetachOnThreadExit(JavaVM* pVM)
+    {
+        t_detacher.pVM = pVM;
+    }
+#else
+    static pthread_key_t g_detachKey;
+    static pthread_once_t g_detachKeyOnce = PTHREAD_ONCE_INIT;
+
+    static void DetachThreadKey(void* pVM)
+    {
+        ((JavaVM*)pVM)->DetachCurrentThread();
+    }
+
+    static void CreateDetachKey()
+    {
+        pthread_key_create(&g_detachKey, DetachThreadKey);
+    }
+
+    static void DetachOnThreadExit(JavaVM* pVM)
+    {
+        pthread_once(&g_detachKeyOnce, CreateDetachKey);
+        pthread_setspecific(g_detachKey, pVM);
+    }
+#endif
+
+    static bool AttachCurrent(JavaVM* pVM, const char* szName, ThreadAttachment& attachment)
+    {
+        JNIEnv* pEnv = NULL;
+        int getEnvStat = pVM->GetEnv((void **)&pEnv, JNI_VERSION_1_6);
+
+        if (getEnvStat == JNI_OK)
+        {
+            attachment.env = pEnv;
+            return true;
+        }
+
+        if (getEnvStat != JNI_EDETACHED)
+            return false;
+
+        char name[64];
+        if(szName == NULL || szName[0] == 0)
+        {
+            snprintf(name, sizeof(name), "CLR Thread %d", ++g_attachedThreads);
+            szName = name;
+        }
+
+        JavaVMAttachArgs args;
+        args.version = JNI_VERSION_1_6;
+        args.name = (char*)szName;
+        args.group = NULL;
+
+        if (pVM->AttachCurrentThreadAsDaemon((void **)&pEnv, &args) != JNI_OK)
+            return false;
+
+        DetachOnThreadExit(pVM);
+        attachment.env = pEnv;
+        return true;
+    }
+
+    void* EnterThread(JavaVM* pVM, const char* szName)
+    {
+        ThreadAttachment& attachment = t_attachment;
+        if(attachment.env == NULL && !AttachCurrent(pVM, szName, attachment))
+            return NULL;
+
+        if(attachment.callbacks == 0)
+        {
+            if(!attachment.framed && PushFrame(attachment.env, 64) == 0)
+            {
+                attachment.framed = true;
+                attachment.frameDepth = t_localRefs.frames.size();
+            }
+            attachment.depth++;
+        }
+        return attachment.env;
+    }
+
+    /*
+    Returns the cached env when EnterThread would have nothing else to do but count the scope, NULL otherwise.
+    It only touches thread local storage, so .NET can call it without a GC transition.
+    */
+
+    void* GetThreadEnv()
+    {
+        ThreadAttachment& attachment = t_attachment;
+        if(attachment.env == NULL)
+            return NULL;
+        if(attachment.callbacks > 0)
+            return attachment.env;
+        if(attachment.depth > 0)
+        {
+            attachment.depth++;
+            return attachment.env;
+        }
+        return NULL;
+    }
+
+    int AttacheThread(JavaVM* pVM, void** pEnv)
+    {
+        *pEnv = EnterThread(pVM, NULL);
+        if(*pEnv == NULL)
+            return -2;
+        return 0;
+    }
+
+    int LeaveThread(JavaVM* pVM)
+    {
+        ThreadAttachment& attachment = t_attachment;
+        if(attachment.callbacks > 0 || attachment.depth == 0)
+            return 0;
+
+        if(--attachment.depth == 0 && attachment.framed && t_localRefs.frames.size() == attachment.frameDepth)
+        {
+            PopFrame(attachment.env, NULL, NULL);
+            attachment.framed = false;
+        }
+        return 0;
+    }
+
+    int DetacheThread(JavaVM* pVM)
+    {
+        return LeaveThread(pVM);
+    }
+
+
+    //object
+    int NewObjectP(JNIEnv* pEnv, jclass cls, const char* szArgs, int len, void** pArgs, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        jmethodID methodID = pEnv->GetMethodID(cls, "<init>", szArgs);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        
+        *pobj = pEnv->NewObjectA(cls, methodID, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        TrackLocalRef(*pobj);
+        if( *pobj != NULL )
+            return 0;
+        else
+            return -2;
+    }
+
+    int NewObject(JNIEnv* pEnv, const char* szType, const char* szArgs, int len, void** pArgs, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        jclass cls = pEnv->FindClass( szType );
+        if(pEnv->ExceptionCheck() == JNI_TRUE || cls == NULL){
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        jmethodID methodID = pEnv->GetMethodID(cls, "<init>", szArgs);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            pEnv->DeleteLocalRef(cls);
+            return -1;
+        }
+
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        
+        *pobj = pEnv->NewObjectA(cls, methodID, (const jvalue*)args);
+        pEnv->DeleteLocalRef(cls);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        TrackLocalRef(*pobj);
+        if( *pobj != NULL )
+            return 0;
+        else
+            return -2;
+    }
+
+    /*
+    Boxing.
+    Boxes are produced through the valueOf factories, so the JVM's own caches (Boolean.TRUE/FALSE, -128..127 for the
+    integral types) are reused instead of allocating a new object for every scalar handed to Java.
+    EnableBoxCache adds a native table of global references to boxed Integer and Long values over a wider range,
+    which serves the most common callback results without a call into Java at all. The table is built once and
+    never changes afterwards, so lookups need no locking.
+    */
+
+    struct BoxCache
+    {
+        jlong low;
+        jlong high;
+        jobject* integers;
+        jobject* longs;
+    };
+
+    static const jlong BOX_CACHE_MAX = 1 << 16;
+    static std::atomic<BoxCache*> g_boxCache(NULL);
+
+    static int ReturnBox(JNIEnv* pEnv, jobject obj, jobject* pobj)
+    {
+        *pobj = obj;
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            *pobj = NULL;
+            return -1;
+        }
+
+        TrackLocalRef(*pobj);
+
+        if( *pobj != NULL )
+            return 0;
+        else
+            return -2;
+    }
+
+    int EnableBoxCache(JNIEnv* pEnv, int low, int high)
+    {
+        if(high < low || (jlong)high - (jlong)low + 1 > BOX_CACHE_MAX)
+            return -2;
+
+        if(g_boxCache.load(std::memory_order_acquire) != NULL)
+            return -2;
+
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midIntegerValueOf == NULL || cache->midLongValueOf == NULL)
+            return -1;
+
+        jlong size = (jlong)high - (jlong)low + 1;
+        BoxCache* box = new BoxCache();
+        box->low = low;
+        box->high = high;
+        box->integers = new jobject[size]();
+        box->longs = new jobject[size]();
+
+        int res = 0;
+        for(jlong i = 0; i < size && res == 0; i++)
+        {
+            jobject intBox = pEnv->CallStaticObjectMethod(cache->clsInteger, cache->midIntegerValueOf, (jint)(low + i));
+            jobject longBox = intBox == NULL ? NULL : pEnv->CallStaticObjectMethod(cache->clsLong, cache->midLongValueOf, (jlong)(low + i));
+            if(pEnv->ExceptionCheck() == JNI_TRUE || intBox == NULL || longBox == NULL)
+                res = -1;
+            else
+            {
+                box->integers[i] = pEnv->NewGlobalRef(intBox);
+                box->longs[i] = pEnv->NewGlobalRef(longBox);
+            }
+
+            if(intBox != NULL)
+                pEnv->DeleteLocalRef(intBox);
+            if(longBox != NULL)
+                pEnv->DeleteLocalRef(longBox);
+        }
+
+        BoxCache* expected = NULL;
+        if(res != 0 || !g_boxCache.compare_exchange_strong(expected, box, std::memory_order_acq_rel))
+        {
+            for(jlong i = 0; i < size; i++)
+            {
+                if(box->integers[i] != NULL)
+                    pEnv->DeleteGlobalRef(box->integers[i]);
+                if(box->longs[i] != NULL)
+                    pEnv->DeleteGlobalRef(box->longs[i]);
+            }
+            delete[] box->integers;
+            delete[] box->longs;
+            delete box;
+            return res != 0 ? res : -2;
+        }
+
+        return 0;
+    }
+
+    //bool object
+    int NewBooleanObject(JNIEnv* pEnv, bool val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        JNICache* cache = GetJNICache(pEnv);
+        jobject constant = val ? cache->objBooleanTrue : cache->objBooleanFalse;
+        if(constant != NULL)
+            return ReturnBox(pEnv, pEnv->NewLocalRef(constant), pobj);
+
+        if(cache->midBooleanValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsBoolean, cache->midBooleanValueOf, (jboolean)val), pobj);
+    }
+
+    //byte object
+    int NewByteObject(JNIEnv* pEnv, jbyte val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midByteValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsByte, cache->midByteValueOf, val), pobj);
+    }
+
+    //char object
+    int NewCharacterObject(JNIEnv* pEnv, char val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midCharacterValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsCharacter, cache->midCharacterValueOf, (jchar)val), pobj);
+    }
+
+    //short object
+    int NewShortObject(JNIEnv* pEnv, short val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midShortValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsShort, cache->midShortValueOf, (jshort)val), pobj);
+    }
+
+    //int object
+    int NewIntegerObject(JNIEnv* pEnv, int val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        BoxCache* box = g_boxCache.load(std::memory_order_acquire);
+        if(box != NULL && val >= box->low && val <= box->high)
+            return ReturnBox(pEnv, pEnv->NewLocalRef(box->integers[val - box->low]), pobj);
+
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midIntegerValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsInteger, cache->midIntegerValueOf, (jint)val), pobj);
+    }
+
+    //long object
+    int NewLongObject(JNIEnv* pEnv, long val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        BoxCache* box = g_boxCache.load(std::memory_order_acquire);
+        if(box != NULL && val >= box->low && val <= box->high)
+            return ReturnBox(pEnv, pEnv->NewLocalRef(box->longs[val - box->low]), pobj);
+
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midLongValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsLong, cache->midLongValueOf, (jlong)val), pobj);
+    }
+
+    //float object
+    int NewFloatObject(JNIEnv* pEnv, float val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midFloatValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsFloat, cache->midFloatValueOf, (jfloat)val), pobj);
+    }
+
+    //double object
+    int NewDoubleObject(JNIEnv* pEnv, double val, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midDoubleValueOf == NULL){
+            return -1;
+        }
+
+        return ReturnBox(pEnv, pEnv->CallStaticObjectMethod(cache->clsDouble, cache->midDoubleValueOf, (jdouble)val), pobj);
+    }
+
+    //Methods
+    int GetStaticMethodID(JNIEnv* pEnv, jclass pClass, const char* szName, const char* szArgs, jmethodID* pMid)
+    {
+        JNI_METRIC(pEnv);
+        *pMid = pEnv->GetStaticMethodID( pClass, szName, szArgs);
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        if( *pMid != NULL )
+            return 0;
+        else
+            return -2;
+    }
+
+    int GetMethodID(JNIEnv* pEnv, jobject pObj, const char* szName, const char* szArgs, jmethodID*  pMid)
+    {
+        JNI_METRIC(pEnv);
+        jclass cls = pEnv->GetObjectClass(pObj);
+
+        *pMid = pEnv->GetMethodID(cls, szName, szArgs);
+        pEnv->DeleteLocalRef(cls);
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+
+        if( *pMid != NULL )
+            return 0;
+        else
+            return -2;
+    }
+
+    //Fields
+    int GetStaticFieldID(JNIEnv* pEnv, jclass pClass, const char* szName, const char* sig, jfieldID* pFid)
+    {
+        JNI_METRIC(pEnv);
+        *pFid = pEnv->GetStaticFieldID( pClass, szName, sig);
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        if( *pFid != NULL )
+            return 0;
+        else
+            return -2;
+    }
+
+    int GetFieldID(JNIEnv* pEnv, jobject pObj, const char* szName, const char* sig, jfieldID*  pFid)
+    {
+        JNI_METRIC(pEnv);
+        jclass cls = pEnv->GetObjectClass(pObj);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        *pFid = pEnv->GetFieldID(cls, szName, sig);
+        pEnv->DeleteLocalRef(cls);
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+
+        if( *pFid != NULL )
+            return 0;
+        else
+            return -2;
+    }
+
+    
+    //void
+    int CallStaticVoidMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs)
+    { 
+        JNI_METRIC(pEnv);
+
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        pEnv->CallStaticVoidMethodA( pClass, pMid, (const jvalue*)args);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        
+        free(args);
+        return 0;
+    }
+
+    int CallVoidMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        pEnv->CallVoidMethodA( pClass, pMid, (const jvalue*)args);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    //object
+
+    int GetObjectClass(JNIEnv* pEnv, jobject pobj, jclass* cls, jstring* clsname)
+    {
+        JNI_METRIC(pEnv);
+        jclass _cls = pEnv->GetObjectClass(pobj);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midClassGetName == NULL){
+            return -1;
+        }
+
+        jobject jclsName = pEnv->CallObjectMethod(_cls, cache->midClassGetName);
+
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            pEnv->DeleteLocalRef(_cls);
+            return -1;
+        }
+
+        TrackLocalRef(_cls);
+        TrackLocalRef(jclsName);
+        *cls = _cls;
+        *clsname = (jstring)jclsName;
+        return 0;
+    }
+    
+    /*
+    Unboxing.
+    UnboxObject classifies a Java value against the cached box, String and array classes and, for boxes, reads the
+    primitive payload in the same crossing. The kind is the JNI signature letter of the payload ('Z', 'B', 'C', 'S',
+    'I', 'J', 'F', 'D'), 'T' for java.lang.String, '[' for arrays, 'L' for any other object and 0 for null.
+    For '[' and 'L' the class name is returned as well so the caller does not need a second lookup.
+    */
+
+    struct TaggedValue
+    {
+        jvalue value;
+        jstring name;
+        int kind;
+        int reserved;
+    };
+
+    static bool UnboxAs(JNIEnv* pEnv, jobject obj, jclass cls, jmethodID mid, int kind, TaggedValue* pResult)
+    {
+        if(cls == NULL || mid == NULL || pEnv->IsInstanceOf(obj, cls) != JNI_TRUE)
+            return false;
+
+        pResult->kind = kind;
+        switch(kind)
+        {
+            case 'Z': pResult->value.z = pEnv->CallBooleanMethod(obj, mid); break;
+            case 'B': pResult->value.b = pEnv->CallByteMethod(obj, mid); break;
+            case 'C': pResult->value.c = pEnv->CallCharMethod(obj, mid); break;
+            case 'S': pResult->value.s = pEnv->CallShortMethod(obj, mid); break;
+            case 'I': pResult->value.i = pEnv->CallIntMethod(obj, mid); break;
+            case 'J': pResult->value.j = pEnv->CallLongMethod(obj, mid); break;
+            case 'F': pResult->value.f = pEnv->CallFloatMethod(obj, mid); break;
+            case 'D': pResult->value.d = pEnv->CallDoubleMethod(obj, mid); break;
+        }
+        return true;
+    }
+
+    //Element kind of an array ('L' for object arrays), 0 if obj is not an array.
+    static int ArrayKind(JNIEnv* pEnv, jobject obj, JNICache* cache)
+    {
+        jclass arrays[] = { cache->clsObjectArray, cache->clsDoubleArray, cache->clsIntArray, cache->clsLongArray,
+            cache->clsFloatArray, cache->clsBooleanArray, cache->clsByteArray, cache->clsCharArray, cache->clsShortArray };
+        const char kinds[] = { 'L', 'D', 'I', 'J', 'F', 'Z', 'B', 'C', 'S' };
+
+        for(size_t i = 0; i < sizeof(arrays) / sizeof(arrays[0]); i++)
+            if(arrays[i] != NULL && pEnv->IsInstanceOf(obj, arrays[i]) == JNI_TRUE)
+                return kinds[i];
+        return 0;
+    }
+
+    static bool UnboxScalar(JNIEnv* pEnv, jobject obj, JNICache* cache, TaggedValue* pResult)
+    {
+        // most frequent first
+        return UnboxAs(pEnv, obj, cache->clsDouble, cache->midDoubleValue, 'D', pResult) ||
+            UnboxAs(pEnv, obj, cache->clsInteger, cache->midIntegerValue, 'I', pResult) ||
+            UnboxAs(pEnv, obj, cache->clsLong, cache->midLongValue, 'J', pResult) ||
+            UnboxAs(pEnv, obj, cache->clsBoolean, cache->midBooleanValue, 'Z', pResult) ||
+            UnboxAs(pEnv, obj, cache->clsFloat, cache->midFloatValue, 'F', pResult) ||
+            UnboxAs(pEnv, obj, cache->clsShort, cache->midShortValue, 'S', pResult) ||
+            UnboxAs(pEnv, obj, cache->clsByte, cache->midByteValue, 'B', pResult) ||
+            UnboxAs(pEnv, obj, cache->clsCharacter, cache->midCharacterValue, 'C', pResult);
+    }
+
+    int UnboxObject(JNIEnv* pEnv, jobject obj, TaggedValue* pResult)
+    {
+        JNI_METRIC(pEnv);
+        pResult->value.j = 0;
+        pResult->name = NULL;
+        pResult->kind = 0;
+        pResult->reserved = 0;
+
+        if(obj == NULL)
+            return 0;
+
+        JNICache* cache = GetJNICache(pEnv);
+
+        if(UnboxScalar(pEnv, obj, cache, pResult))
+        {
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return -1;
+            return 0;
+        }
+
+        if(cache->clsString != NULL && pEnv->IsInstanceOf(obj, cache->clsString) == JNI_TRUE)
+        {
+            pResult->kind = 'T';
+            pResult->value.l = obj;
+            return 0;
+        }
+
+        if(cache->midClassGetName == NULL)
+            return -2;
+
+        pResult->kind = ArrayKind(pEnv, obj, cache) != 0 ? '[' : 'L';
+        pResult->value.l = obj;
+
+        jclass cls = pEnv->GetObjectClass(obj);
+        jobject name = pEnv->CallObjectMethod(cls, cache->midClassGetName);
+        pEnv->DeleteLocalRef(cls);
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            return -1;
+
+        TrackLocalRef(name);
+        pResult->name = (jstring)name;
+        return 0;
+    }
+
+    /*
+    Callback arguments.
+    The Object[] handed to a callback is decoded here in one pass into packed tagged values: boxes are unboxed with
+    the same kinds as UnboxObject, strings become UTF-16 spans ('T', value points at the characters, length is the
+    character count) and anything else stays a local reference ('L', or '[' with the array length and element kind).
+    The buffers live until the callback returns, the local references until the native method returns.
+    */
+
+    struct TaggedArg
+    {
+        jvalue value;
+        int kind;
+        int length;
+        int elementKind;
+        int reserved;
+    };
+
+    class CallbackArgs
+    {
+    public:
+        CallbackArgs() : m_status(0), m_sealed(true) {}
+
+        CallbackArgs(JNIEnv* pEnv, jobjectArray args, int len) : m_status(0), m_sealed(true)
+        {
+            if(args == NULL || len <= 0)
+                return;
+
+            int available = pEnv->GetArrayLength(args);
+            if(len > available)
+                len = available;
+
+            if(pEnv->EnsureLocalCapacity(len + 16) != 0)
+            {
+                m_status = -1;
+                return;
+            }
+
+            JNICache* cache = GetJNICache(pEnv);
+            m_args.reserve(len);
+
+            for(int i = 0; i < len && m_status == 0; i++)
+            {
+                jobject element = pEnv->GetObjectArrayElement(args, i);
+                if(pEnv->ExceptionCheck() == JNI_TRUE)
+                {
+                    m_status = -1;
+                    break;
+                }
+                Append(pEnv, cache, element);
+            }
+            Seal();
+        }
+
+        //Decodes element into the next tagged value. Takes over the local reference.
+        void Append(JNIEnv* pEnv, JNICache* cache, jobject element)
+        {
+            m_sealed = false;
+            m_args.push_back(TaggedArg());
+            TaggedArg& arg = m_args.back();
+            memset(&arg, 0, sizeof(TaggedArg));
+
+            if(element == NULL)
+                return;
+
+            TaggedValue scalar;
+            scalar.value.j = 0;
+            if(UnboxScalar(pEnv, element, cache, &scalar))
+            {
+                arg.kind = scalar.kind;
+                arg.value = scalar.value;
+                pEnv->DeleteLocalRef(element);
+            }
+            else if(cache->clsString != NULL && pEnv->IsInstanceOf(element, cache->clsString) == JNI_TRUE)
+            {
+                jsize length = pEnv->GetStringLength((jstring)element);
+                size_t offset = m_chars.size();
+                m_chars.resize(offset + length + 1);
+                if(length > 0)
+                    pEnv->GetStringRegion((jstring)element, 0, length, &m_chars[offset]);
+
+                arg.kind = 'T';
+                arg.length = length;
+                m_strings.push_back(std::make_pair(m_args.size() - 1, offset));
+                pEnv->DeleteLocalRef(element);
+            }
+            else
+            {
+                int elementKind = ArrayKind(pEnv, element, cache);
+                arg.kind = elementKind != 0 ? '[' : 'L';
+                arg.elementKind = elementKind;
+                arg.length = elementKind != 0 ? pEnv->GetArrayLength((jarray)element) : 0;
+                arg.value.l = element;
+            }
+
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                m_status = -1;
+        }
+
+        //The character buffer has its final size once appending stops, turn the string offsets into pointers.
+        void Seal()
+        {
+            if(m_sealed)
+                return;
+
+            for(size_t i = 0; i < m_strings.size(); i++)
+                m_args[m_strings[i].first].value.l = (jobject)&m_chars[m_strings[i].second];
+            m_sealed = true;
+        }
+
+        //Drops the local references still held by object and array entries.
+        void Release(JNIEnv* pEnv)
+        {
+            for(size_t i = 0; i < m_args.size(); i++)
+            {
+                if((m_args[i].kind == 'L' || m_args[i].kind == '[') && m_args[i].value.l != NULL)
+                    pEnv->DeleteLocalRef(m_args[i].value.l);
+                m_args[i].value.l = NULL;
+            }
+        }
+
+        int status() const { return m_status; }
+        int count() const { return (int)m_args.size(); }
+        void* data() { return m_args.empty() ? NULL : &m_args[0]; }
+
+    private:
+        CallbackArgs(const CallbackArgs&);
+        CallbackArgs& operator=(const CallbackArgs&);
+
+        int m_status;
+        bool m_sealed;
+        std::vector<TaggedArg> m_args;
+        std::vector<jchar> m_chars;
+        std::vector<std::pair<size_t, size_t> > m_strings;
+    };
+
+    int CallStaticObjectMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, jobject* pobj, int len, void** pArgs)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        jobject val = pEnv->CallStaticObjectMethodA( pClass, pMid, (const jvalue*)args);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        TrackLocalRef(val);
+        *pobj = val;
+        free(args);
+        return 0;
+    }
+    int CallObjectMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, jobject* pobj, int len, void** pArgs)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        jobject val = pEnv->CallObjectMethodA( pObject, pMid, (const jvalue*)args);
+
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        
+        TrackLocalRef(val);
+        
+        *pobj = val;
+        free(args);
+        return 0;
+    }
+
+    int GetStaticObjectField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        jobject val = pEnv->GetStaticObjectField(pClass, pMid);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        
+        TrackLocalRef(val);
+        
+        *pobj = val;
+        return 0;
+    }
+
+    int GetObjectField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jobject* pobj)
+    {
+        JNI_METRIC(pEnv);
+        jobject val = pEnv->GetObjectField( pObject, pMid);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        
+        TrackLocalRef(val);
+        
+        *pobj = val;
+        return 0;
+    }
+
+    int SetStaticObjectField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jobject val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticObjectField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetObjectField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jobject val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetObjectField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            // //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    //int
+    int CallStaticIntMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, int* res)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *res = pEnv->CallStaticIntMethodA(pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+
+    }
+
+    int CallIntMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, int* res)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *res = pEnv->CallIntMethodA( pObject, pMid, (const jvalue*)args);
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int GetStaticIntField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, int* res)
+    {
+        JNI_METRIC(pEnv);
+        *res = pEnv->GetStaticIntField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int GetIntField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, int* res)
+    {
+        JNI_METRIC(pEnv);
+        *res = pEnv->GetIntField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetStaticIntField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, int val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticIntField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetIntField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, int val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetIntField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+
+    //long
+    int CallStaticLongMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, long* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallStaticLongMethodA( pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int CallLongMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, long* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallLongMethodA(pObject, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    int GetStaticLongField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, long* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetStaticLongField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int GetLongField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, long* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetLongField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int SetStaticLongField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, long val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticLongField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int SetLongField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, long val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetLongField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    //float
+    int CallStaticFloatMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, float* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallStaticFloatMethodA( pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    int CallFloatMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, float* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        // float val = pEnv->CallFloatMethodA(pObject, pMid, (const jvalue*)args);
+        *val = pEnv->CallFloatMethodA(pObject, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    int GetStaticFloatField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, float *val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetStaticFloatField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){        
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int GetFloatField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, float *val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetFloatField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int SetStaticFloatField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, float val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticFloatField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int SetFloatField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, float val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetFloatField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    //double
+    int CallStaticDoubleMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, double* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallStaticDoubleMethodA(pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int CallDoubleMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, double* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallDoubleMethodA( pObject, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    int GetStaticDoubleField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, double* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetStaticDoubleField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int GetDoubleField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, double* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetDoubleField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetStaticDoubleField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, double val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticDoubleField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetDoubleField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, double val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetDoubleField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    //bool
+    int CallStaticBooleanMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, bool* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallStaticBooleanMethodA( pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int CallBooleanMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, bool* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallBooleanMethodA( pObject, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int GetStaticBooleanField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, bool* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetStaticBooleanField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int GetBooleanField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, bool* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetBooleanField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int SetStaticBooleanField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, bool val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticBooleanField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetBooleanField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, bool val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetBooleanField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    //byte
+    int CallStaticByteMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, jbyte* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallStaticByteMethodA( pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    int CallByteMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, jbyte* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallByteMethodA( pObject, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int GetStaticByteField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jbyte* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetStaticByteField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int GetByteField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jbyte* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetByteField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int SetStaticByteField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jbyte val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticByteField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetByteField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jbyte val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetByteField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    //char
+    int CallStaticCharMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, char* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallStaticCharMethodA( pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int CallCharMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, char* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+            
+        *val = pEnv->CallCharMethodA( pObject, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+        free(args);
+        return 0;
+    }
+
+    int GetStaticCharField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, char* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetStaticCharField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int GetCharField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, char* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetCharField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetStaticCharField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, char val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticCharField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetCharField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, char val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetCharField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+
+    //short
+    int CallStaticShortMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, short* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallStaticShortMethodA( pClass, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    int CallShortMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, short* val)
+    {
+        JNI_METRIC(pEnv);
+        void** args = (void**)malloc(sizeof(void *) * len);
+
+        for(int i = 0; i < len; i++)
+            args[i] = pArgs[i];
+
+        *val = pEnv->CallShortMethodA( pObject, pMid, (const jvalue*)args);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            free(args);
+            return -1;
+        }
+
+        free(args);
+        return 0;
+    }
+
+    int GetStaticShortField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, short* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetStaticShortField(pClass, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int GetShortField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, short* val)
+    {
+        JNI_METRIC(pEnv);
+        *val = pEnv->GetShortField(pObject, pMid);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+
+        return 0;
+    }
+
+    int SetStaticShortField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, short val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetStaticShortField(pClass, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+    int SetShortField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, short val)
+    {
+        JNI_METRIC(pEnv);
+        pEnv->SetShortField( pObject, pMid, val);
+        
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
+
+
+
+    //string back and forth
+    jstring GetJavaString(JNIEnv* pEnv, const char* nString)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES(nString == NULL ? 0 : strlen(nString));
+        jstring val = pEnv->NewStringUTF(nString);
+        TrackLocalRef(val);
+        return val;
+    }
+
+    /*
+    UTF-16 strings.
+    Both runtimes store strings as UTF-16, so text is copied as is with GetStringRegion/NewString instead of being
+    converted through modified UTF-8 and then decoded again on the other side.
+    GetStringUTF16 writes the characters into the caller's buffer when it is large enough and always returns the
+    length, so a caller with a small stack buffer can retry once with the right size.
+    */
+
+    int GetStringUTF16(JNIEnv* pEnv, jstring jString, jchar* pBuffer, int capacity, int* pLength)
+    {
+        JNI_METRIC(pEnv);
+        *pLength = 0;
+        if(jString == NULL)
+            return -2;
+
+        jsize len = pEnv->GetStringLength(jString);
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            return -1;
+
+        *pLength = len;
+        if(len > 0 && len <= capacity && pBuffer != NULL)
+        {
+            JNI_METRIC_BYTES(len * sizeof(jchar));
+            pEnv->GetStringRegion(jString, 0, len, pBuffer);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return -1;
+        }
+        return 0;
+    }
+
+    jstring NewStringUTF16(JNIEnv* pEnv, const jchar* pChars, int len)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES(len * sizeof(jchar));
+        jstring val = pEnv->NewString(pChars, len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            return NULL;
+
+        TrackLocalRef(val);
+        return val;
+    }
+
+    /*
+    Bounded intern table for identifiers (method, class and property names) that cross the bridge repeatedly.
+    Each entry holds a global reference, callers get a fresh local reference to it. Once the table is full new
+    strings are simply created and not retained, so the table cannot grow without bound.
+    */
+
+    static const int STRING_SHARDS = 16;
+    static const size_t STRING_INTERN_MAX = 4096;
+    static const int STRING_INTERN_MAX_LENGTH = 256;
+
+    struct StringShard
+    {
+        std::mutex lock;
+        std::unordered_map<std::u16string, jstring> strings;
+    };
+
+    static StringShard g_stringShards[STRING_SHARDS];
+
+    jstring InternStringUTF16(JNIEnv* pEnv, const jchar* pChars, int len)
+    {
+        JNI_METRIC(pEnv);
+        if(len > STRING_INTERN_MAX_LENGTH)
+            return NewStringUTF16(pEnv, pChars, len);
+
+        std::u16string key((const char16_t*)pChars, len);
+        StringShard& shard = g_stringShards[std::hash<std::u16string>()(key) & (STRING_SHARDS - 1)];
+
+        jstring global = NULL;
+        {
+            std::lock_guard<std::mutex> guard(shard.lock);
+            std::unordered_map<std::u16string, jstring>::iterator it = shard.strings.find(key);
+            if(it != shard.strings.end())
+                global = it->second;
+        }
+
+        if(global == NULL)
+        {
+            jstring local = pEnv->NewString(pChars, len);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return NULL;
+
+            {
+                std::lock_guard<std::mutex> guard(shard.lock);
+                std::unordered_map<std::u16string, jstring>::iterator it = shard.strings.find(key);
+                if(it != shard.strings.end())
+                    global = it->second;
+                else if(shard.strings.size() < STRING_INTERN_MAX / STRING_SHARDS)
+                {
+                    global = (jstring)pEnv->NewGlobalRef(local);
+                    shard.strings[key] = global;
+                }
+            }
+
+            if(global == NULL)
+            {
+                TrackLocalRef(local);
+                return local;
+            }
+            pEnv->DeleteLocalRef(local);
+        }
+
+        jstring val = (jstring)pEnv->NewLocalRef(global);
+        TrackLocalRef(val);
+        return val;
+    }
+
+    /*
+    Java strings handed to the .NET callbacks. The modified UTF-8 copy is only needed for the duration of the
+    callback, which marshals it into a .NET string, and is released when the scope ends.
+    */
+    class JavaUTFChars
+    {
+    public:
+        JavaUTFChars(JNIEnv* pEnv, jstring jString) : m_pEnv(pEnv), m_jString(jString), m_chars(NULL)
+        {
+            if(jString != NULL)
+            {
+                m_chars = pEnv->GetStringUTFChars(jString, 0);
+                if(pEnv->ExceptionCheck() == JNI_TRUE)
+                    m_chars = NULL;
+            }
+        }
+
+        ~JavaUTFChars()
+        {
+            if(m_chars != NULL)
+                m_pEnv->ReleaseStringUTFChars(m_jString, m_chars);
+        }
 
-        return 0;
-    }
+        const char* c_str() const
+        {
+            return m_chars == NULL ? "" : m_chars;
+        }
 
-    /*
-    Free the allocated JVM init argumets
-    */
+    private:
+        JavaUTFChars(const JavaUTFChars&);
+        JavaUTFChars& operator=(const JavaUTFChars&);
 
-    void FreeJavaVMInitArgs( void* pArgs )
-    {
-        delete ((JavaVMInitArgs*)pArgs)->options[0].optionString;
-        delete ((JavaVMInitArgs*)pArgs)->options;
-        delete &pArgs;
-    }
+        JNIEnv* m_pEnv;
+        jstring m_jString;
+        const char* m_chars;
+    };
 
     /*
-    Static wrapper on FindClass() JNI function.
-    See the description in
-    http://jre.sfbay/java/re/jdk/6/promoted/latest/docs/technotes/guides/jni/spec/functions.html#wp16027
+    Exceptions.
+    TakeException clears the pending exception and captures only what is cheap: a global reference to the
+    throwable, its class name and its message. The formatted stack trace (DescribeException) and the cause chain
+    (GetExceptionCause) are only built when .NET asks for them, and ReleaseException drops the reference.
+    Without detail only the pending exception is cleared, which is all a retry loop needs.
     */
 
-    int FindClass(JNIEnv* pEnv, const char* szClass, jclass* pClass )
+    //With clsStatic the method is a static one taking the throwable, otherwise it is called on it.
+    static jstring ThrowableString(JNIEnv* pEnv, jobject throwable, jmethodID mid, jclass clsStatic)
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(mid == NULL)
+            return NULL;
 
-        *pClass = pEnv->FindClass( szClass );
+        jobject res = NULL;
+        if(clsStatic != NULL)
+        {
+            jvalue arg;
+            arg.l = throwable;
+            res = pEnv->CallStaticObjectMethodA(clsStatic, mid, &arg);
+        }
+        else
+            res = pEnv->CallObjectMethod(throwable, mid);
 
         if(pEnv->ExceptionCheck() == JNI_TRUE)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            pEnv->ExceptionClear();
+            return NULL;
         }
+        TrackLocalRef(res);
+        return (jstring)res;
+    }
 
-        mutex.unlock();
-        if(*pClass != NULL)
-            return 0;
-        else
-            return -2;
-
+    static jstring ThrowableClassName(JNIEnv* pEnv, jobject throwable)
+    {
+        JNICache* cache = GetJNICache(pEnv);
+        jclass cls = pEnv->GetObjectClass(throwable);
+        jstring name = ThrowableString(pEnv, cls, cache->midClassGetName, NULL);
+        pEnv->DeleteLocalRef(cls);
+        return name;
     }
 
-    int AttacheThread(JavaVM* pVM, void** pEnv)
+    int TakeException(JNIEnv* pEnv, int captureDetail, jobject* pThrowable, jstring* pClassName, jstring* pMessage)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        *pThrowable = NULL;
+        *pClassName = NULL;
+        *pMessage = NULL;
 
-        int getEnvStat = pVM->GetEnv((void **)pEnv, JNI_VERSION_1_6);
-        
+        jthrowable exception = pEnv->ExceptionOccurred();
+        if(exception == NULL)
+            return -2;
+        pEnv->ExceptionClear();
 
-        if (getEnvStat == JNI_EDETACHED) 
+        if(captureDetail != 0)
         {
-            if (pVM->AttachCurrentThread((void **)pEnv, NULL) != 0) {
-                mutex.unlock();
-                return -2;
-            }
-            else{
-                mutex.unlock();
-                return 0;            
-            }
-        } 
-        else if (getEnvStat == JNI_OK) {
-            mutex.unlock();
-            return 0;
+            JNICache* cache = GetJNICache(pEnv);
+            *pClassName = ThrowableClassName(pEnv, exception);
+            *pMessage = ThrowableString(pEnv, exception, cache->midThrowableGetMessage, NULL);
+            *pThrowable = pEnv->NewGlobalRef(exception);
         }
-        else if (getEnvStat == JNI_EVERSION) {
-            mutex.unlock();
-            return -3;
-        }
-        
-        mutex.unlock();
-        return -1;
-    }
 
-    int DetacheThread(JavaVM* pVM)
-    {
-        // cout << "--DEATACHED" << endl;
-        return pVM->DetachCurrentThread();
+        pEnv->DeleteLocalRef(exception);
+        return 0;
     }
 
-
-    //object
-    int NewObjectP(JNIEnv* pEnv, jclass cls, const char* szArgs, int len, void** pArgs, jobject* pobj)
+    int DescribeException(JNIEnv* pEnv, jobject throwable, jstring* pTrace)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        *pTrace = NULL;
+        if(throwable == NULL)
+            return -2;
 
-        jmethodID methodID = pEnv->GetMethodID(cls, "<init>", szArgs);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
+        BridgeCache* bridge = GetBridgeCache(pEnv);
+        if(bridge == NULL)
+            return -2;
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        *pTrace = ThrowableString(pEnv, throwable, bridge->midCLRRuntimeGetError, bridge->clsCLRRuntime);
+        return *pTrace != NULL ? 0 : -1;
+    }
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    int GetExceptionCause(JNIEnv* pEnv, jobject throwable, jobject* pCause, jstring* pClassName, jstring* pMessage)
+    {
+        JNI_METRIC(pEnv);
+        *pCause = NULL;
+        *pClassName = NULL;
+        *pMessage = NULL;
+        if(throwable == NULL)
+            return -2;
 
-        
-        *pobj = pEnv->NewObjectA(cls, methodID, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
+        JNICache* cache = GetJNICache(pEnv);
+        jobject cause = ThrowableString(pEnv, throwable, cache->midThrowableGetCause, NULL);
+        if(cause == NULL || pEnv->IsSameObject(cause, throwable) == JNI_TRUE)
+        {
+            if(cause != NULL)
+                DeleteLocalRef(pEnv, cause);
+            return -2;
         }
 
-        free(args);
-        mutex.unlock();
-        if( pobj != NULL )
-            return 0;
-        else
+        *pClassName = ThrowableClassName(pEnv, cause);
+        *pMessage = ThrowableString(pEnv, cause, cache->midThrowableGetMessage, NULL);
+        *pCause = pEnv->NewGlobalRef(cause);
+        DeleteLocalRef(pEnv, cause);
+        return 0;
+    }
+
+    int ReleaseException(JNIEnv* pEnv, jobject throwable)
+    {
+        JNI_METRIC(pEnv);
+        if(throwable == NULL)
             return -2;
+        pEnv->DeleteGlobalRef(throwable);
+        return 0;
     }
 
-    int NewObject(JNIEnv* pEnv, const char* szType, const char* szArgs, int len, void** pArgs, jobject* pobj)
+    //Formatted description of the pending exception, valid until the next call on the same thread.
+    const char* GetException(JNIEnv* pEnv)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        static thread_local std::string t_error;
 
-        jclass cls = pEnv->FindClass( szType );
-        jmethodID methodID = pEnv->GetMethodID(cls, "<init>", szArgs);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
+        jthrowable exception = pEnv->ExceptionOccurred();
+        if(exception == NULL)
+            return "";
+        pEnv->ExceptionClear();
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        jstring jString = NULL;
+        DescribeException(pEnv, exception, &jString);
+        pEnv->DeleteLocalRef(exception);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+        if(jString == NULL)
+            return "error when getting error !";
 
-        
-        *pobj = pEnv->NewObjectA(cls, methodID, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
+        const char* res = pEnv->GetStringUTFChars(jString, 0);
+        if(res == NULL || pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            pEnv->ExceptionClear();
+            DeleteLocalRef(pEnv, jString);
+            return "error when getting error !!";
         }
 
-        free(args);
-        mutex.unlock();
-        if( pobj != NULL )
-            return 0;
-        else
-            return -2;
+        t_error.assign(res);
+        pEnv->ReleaseStringUTFChars(jString, res);
+        DeleteLocalRef(pEnv, jString);
+        return t_error.c_str();
     }
 
-    //bool object
-    int NewBooleanObject(JNIEnv* pEnv, bool val, jobject* pobj)
+    //object array
+
+    int NewObjectArrayP(JNIEnv* pEnv, int nDimension, jclass cls, jobjectArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewObjectArray( nDimension, cls, NULL);
 
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Boolean" ), "<init>", "(Z)V");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Boolean" ), methodID, val);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+            //pEnv->ExceptionDescribe();
             return -1;
         }
 
-        mutex.unlock();
-        if( pobj != NULL )
+        TrackLocalRef(*pArray);
+
+        if( *pArray != NULL )
             return 0;
         else
             return -2;
-    }
 
-    //bool object
-    int NewByteObject(JNIEnv* pEnv, jbyte val, jobject* pobj)
+    }
+    
+    int NewObjectArray(JNIEnv* pEnv, int nDimension, const char* szType, jobjectArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
-
-
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Byte" ), "<init>", "(B)V");
+        JNI_METRIC(pEnv);
+        jclass cls = pEnv->FindClass( szType );
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Byte" ), methodID, val);
+
+        *pArray = pEnv->NewObjectArray( nDimension, cls, NULL);
+        pEnv->DeleteLocalRef(cls);
 
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        mutex.unlock();
-        if( pobj != NULL )
+
+        TrackLocalRef(*pArray);
+
+        if( *pArray != NULL )
             return 0;
         else
             return -2;
+
     }
 
-    //char object
-    int NewCharacterObject(JNIEnv* pEnv, char val, jobject* pobj)
+    int SetObjectArrayElement(JNIEnv* pEnv, jobjectArray pArray, int index, jobject value)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Character" ), "<init>", "(C)V");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Character" ), methodID, val);
-
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        JNI_METRIC(pEnv);
+        pEnv->SetObjectArrayElement(pArray, index, value);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        mutex.unlock();
-        if( pobj != NULL )
-            return 0;
         else
-            return -2;
+        {
+            return 0;
+        }
     }
 
-    //short object
-    int NewShortObject(JNIEnv* pEnv, short val, jobject* pobj)
+    int GetObjectArrayElement(JNIEnv* pEnv, jobjectArray pArray, int index, jobject* pobj)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Short" ), "<init>", "(S)V");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        JNI_METRIC(pEnv);
+        jobject val = pEnv->GetObjectArrayElement(pArray, index);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Short" ), methodID, val);
+
+        TrackLocalRef(val);
+        *pobj = val;
+
+        return 0;
+    }
+
+    //primitive arrays
+    //Single element accessors copy through Get<Type>ArrayRegion so nothing is pinned or leaked.
+    //Get/Set<Type>ArrayRegion and New<Type>ArrayFrom move a whole span in one call and should be
+    //used whenever more than a handful of elements cross the bridge.
+
+    //int array
+    int NewIntArray(JNIEnv* pEnv, int nDimension, jintArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewIntArray(nDimension);
         
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+            //pEnv->ExceptionDescribe();
             return -1;
         }
 
-        mutex.unlock();
-        if( pobj != NULL )
+        TrackLocalRef(*pArray);
+
+        if( *pArray != NULL )
             return 0;
         else
             return -2;
+
     }
 
-    //int object
-    int NewIntegerObject(JNIEnv* pEnv, int val, jobject* pobj)
+    int SetIntArrayElement(JNIEnv* pEnv, jintArray pArray, int index, int value)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Integer" ), "<init>", "(I)V");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        JNI_METRIC(pEnv);
+        const jint elements[] = { value };
+        pEnv->SetIntArrayRegion(pArray, index, 1, elements);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
         
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Integer" ), methodID, val);
-        
+        return 0;
+    }
+
+    int GetIntArrayElement(JNIEnv* pEnv, jintArray pArray, int index)
+    {
+        JNI_METRIC(pEnv);
+        jint val = 0;
+        pEnv->GetIntArrayRegion(pArray, index, 1, &val);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return -666;
         }
-
-        mutex.unlock();
-        if( pobj != NULL )
-            return 0;
-        else
-            return -2;
+        return val;
     }
 
-    //long object
-    int NewLongObject(JNIEnv* pEnv, long val, jobject* pobj)
+    int GetIntArrayRegion(JNIEnv* pEnv, jintArray pArray, int offset, int count, jint* pDst)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jint));
+        pEnv->GetIntArrayRegion(pArray, offset, count, pDst);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            return -1;
+        }
+        return 0;
+    }
 
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Long" ), "<init>", "(J)V");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+    int SetIntArrayRegion(JNIEnv* pEnv, jintArray pArray, int offset, int count, const jint* pSrc)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jint));
+        pEnv->SetIntArrayRegion(pArray, offset, count, pSrc);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
             return -1;
         }
-        
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Long" ), methodID, val);
-        
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        return 0;
+    }
+
+    int NewIntArrayFrom(JNIEnv* pEnv, const jint* pSrc, int len, jintArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jint));
+        *pArray = pEnv->NewIntArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
+        {
             return -1;
         }
 
-        mutex.unlock();
-        if( pobj != NULL )
-            return 0;
-        else
-            return -2;
+        if(len > 0)
+        {
+            pEnv->SetIntArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
+        return 0;
     }
 
-    //float object
-    int NewFloatObject(JNIEnv* pEnv, float val, jobject* pobj)
+    //long array
+    int NewLongArray(JNIEnv* pEnv, int nDimension, jlongArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewLongArray( nDimension);
 
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Float" ), "<init>", "(F)V");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
-            return -1;
-        }
-        
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Float" ), methodID, val);
-        
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        mutex.unlock();
-        if( pobj != NULL )
+        TrackLocalRef(*pArray);
+        if( *pArray != NULL )
             return 0;
         else
             return -2;
-    }
-
 
+    }
 
-    //double object
-    int NewDoubleObject(JNIEnv* pEnv, double val, jobject* pobj)
+    int SetLongArrayElement(JNIEnv* pEnv, jlongArray pArray, int index, long value)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        jmethodID methodID = pEnv->GetMethodID(pEnv->FindClass( "java/lang/Double" ), "<init>", "(D)V");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        JNI_METRIC(pEnv);
+        const jlong elements[] = { value };
+        pEnv->SetLongArrayRegion(pArray, index, 1, elements);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
+        return 0;
+    }
 
-        *pobj = pEnv->NewObject(pEnv->FindClass( "java/lang/Double" ), methodID, val);
+    long GetLongArrayElement(JNIEnv* pEnv, jlongArray pArray, int index)
+    {
+        JNI_METRIC(pEnv);
+        jlong val = 0;
+        pEnv->GetLongArrayRegion(pArray, index, 1, &val);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return -666;
         }
-
-        mutex.unlock();
-        if( pobj != NULL )
-            return 0;
-        else
-            return -2;
+        return val;
     }
 
-    
-
-    
-
-    //Methods
-    int GetStaticMethodID(JNIEnv* pEnv, jclass pClass, const char* szName, const char* szArgs, jmethodID* pMid)
+    int GetLongArrayRegion(JNIEnv* pEnv, jlongArray pArray, int offset, int count, jlong* pDst)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *pMid = pEnv->GetStaticMethodID( pClass, szName, szArgs);
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jlong));
+        pEnv->GetLongArrayRegion(pArray, offset, count, pDst);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            return -1;
+        }
+        return 0;
+    }
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+    int SetLongArrayRegion(JNIEnv* pEnv, jlongArray pArray, int offset, int count, const jlong* pSrc)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jlong));
+        pEnv->SetLongArrayRegion(pArray, offset, count, pSrc);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
             return -1;
         }
-        mutex.unlock();
-        if( *pMid != NULL )
-            return 0;
-        else
-            return -2;
+        return 0;
     }
 
-    int GetMethodID(JNIEnv* pEnv, jobject pObj, const char* szName, const char* szArgs, jmethodID*  pMid)
+    int NewLongArrayFrom(JNIEnv* pEnv, const jlong* pSrc, int len, jlongArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jlong));
+        *pArray = pEnv->NewLongArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
+        {
+            return -1;
+        }
 
-        jclass cls = pEnv->GetObjectClass(pObj);
+        if(len > 0)
+        {
+            pEnv->SetLongArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
+        return 0;
+    }
 
-        *pMid = pEnv->GetMethodID(cls, szName, szArgs);
+    //float array
+    int NewFloatArray(JNIEnv* pEnv, int nDimension, jfloatArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewFloatArray( nDimension);
 
         if(pEnv->ExceptionCheck() == JNI_TRUE)
         {
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+            //pEnv->ExceptionDescribe();
             return -1;
         }
 
-        mutex.unlock();
+        TrackLocalRef(*pArray);
 
-        if( *pMid != NULL )
+        if( *pArray != NULL )
             return 0;
         else
             return -2;
+
     }
 
-    //Fields
-    int GetStaticFieldID(JNIEnv* pEnv, jclass pClass, const char* szName, const char* sig, jfieldID* pFid)
+    int SetFloatArrayElement(JNIEnv* pEnv, jfloatArray pArray, int index, float value)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *pFid = pEnv->GetStaticFieldID( pClass, szName, sig);
+        JNI_METRIC(pEnv);
+        float elements[] = { value };
+        pEnv->SetFloatArrayRegion(pArray, index, 1, elements);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
+            return -1;
+        }
+        return 0;
+    }
 
+    float GetFloatArrayElement(JNIEnv* pEnv, jfloatArray pArray, int index)
+    {
+        JNI_METRIC(pEnv);
+        jfloat val = 0;
+        pEnv->GetFloatArrayRegion(pArray, index, 1, &val);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return -666;
         }
+        return val;
+    }
 
-        mutex.unlock();
-        if( *pFid != NULL )
-            return 0;
-        else
-            return -2;
+    int GetFloatArrayRegion(JNIEnv* pEnv, jfloatArray pArray, int offset, int count, jfloat* pDst)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jfloat));
+        pEnv->GetFloatArrayRegion(pArray, offset, count, pDst);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            return -1;
+        }
+        return 0;
     }
 
-    int GetFieldID(JNIEnv* pEnv, jobject pObj, const char* szName, const char* sig, jfieldID*  pFid)
+    int SetFloatArrayRegion(JNIEnv* pEnv, jfloatArray pArray, int offset, int count, const jfloat* pSrc)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jfloat));
+        pEnv->SetFloatArrayRegion(pArray, offset, count, pSrc);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            return -1;
+        }
+        return 0;
+    }
 
-        jclass cls = pEnv->GetObjectClass(pObj);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
+    int NewFloatArrayFrom(JNIEnv* pEnv, const jfloat* pSrc, int len, jfloatArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jfloat));
+        *pArray = pEnv->NewFloatArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
+        {
             return -1;
         }
 
-        *pFid = pEnv->GetFieldID(cls, szName, sig);
+        if(len > 0)
+        {
+            pEnv->SetFloatArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
+        return 0;
+    }
+
+    //double array
+    int NewDoubleArray(JNIEnv* pEnv, int nDimension, jdoubleArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewDoubleArray( nDimension);
 
         if(pEnv->ExceptionCheck() == JNI_TRUE)
         {
             //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
 
-        mutex.unlock();
+        TrackLocalRef(*pArray);
 
-        if( *pFid != NULL )
+        if( *pArray != NULL )
             return 0;
         else
             return -2;
-    }
-
-    
-    //void
-    int CallStaticVoidMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs)
-    { 
-        std::mutex mutex;
-        mutex.lock();
-
-        void** args = (void**)malloc(sizeof(void *) * len);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    }
 
-        pEnv->CallStaticVoidMethodA( pClass, pMid, (const jvalue*)args);
+    int SetDoubleArrayElement(JNIEnv* pEnv, jdoubleArray pArray, int index, double value)
+    {
+        JNI_METRIC(pEnv);
+        double elements[] = { value };
+        pEnv->SetDoubleArrayRegion(pArray, index, 1, elements);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        
-        free(args);
-        mutex.unlock();
         return 0;
     }
 
-    int CallVoidMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs)
+    double GetDoubleArrayElement(JNIEnv* pEnv, jdoubleArray pArray, int index)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        void** args = (void**)malloc(sizeof(void *) * len);
-
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+        JNI_METRIC(pEnv);
+        jdouble val = 0;
+        pEnv->GetDoubleArrayRegion(pArray, index, 1, &val);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
+            return -666;
+        }
+        return val;
+    }
 
-        pEnv->CallVoidMethodA( pClass, pMid, (const jvalue*)args);
+    int GetDoubleArrayRegion(JNIEnv* pEnv, jdoubleArray pArray, int offset, int count, jdouble* pDst)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jdouble));
+        pEnv->GetDoubleArrayRegion(pArray, offset, count, pDst);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            free(args);
-            mutex.unlock();
             return -1;
         }
-
-        free(args);
-        mutex.unlock();
         return 0;
     }
 
-    //object
-
-    int GetObjectClass(JNIEnv* pEnv, jobject pobj, jclass* cls, jstring* clsname)
+    int SetDoubleArrayRegion(JNIEnv* pEnv, jdoubleArray pArray, int offset, int count, const jdouble* pSrc)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jdouble));
+        pEnv->SetDoubleArrayRegion(pArray, offset, count, pSrc);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            return -1;
+        }
+        return 0;
+    }
 
-        jclass _cls = pEnv->GetObjectClass(pobj);
+    int NewDoubleArrayFrom(JNIEnv* pEnv, const jdouble* pSrc, int len, jdoubleArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jdouble));
+        *pArray = pEnv->NewDoubleArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
+        {
+            return -1;
+        }
 
-        void** args = (void**)malloc(sizeof(void *) * 1);
-        jmethodID pMid = pEnv->GetMethodID(_cls, "getClass", "()Ljava/lang/Class;");
+        if(len > 0)
+        {
+            pEnv->SetDoubleArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
+        return 0;
+    }
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
+    //boolean array
+    int NewBooleanArray(JNIEnv* pEnv, int nDimension, jbooleanArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewBooleanArray( nDimension);
 
-            free(args);
-            mutex.unlock();
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        jobject jcls = pEnv->CallObjectMethodA(_cls, pMid, (const jvalue*)args);
+        TrackLocalRef(*pArray);
+        if( *pArray != NULL )
+            return 0;
+        else
+            return -2;
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+    }
+
+    int SetBooleanArrayElement(JNIEnv* pEnv, jbooleanArray pArray, int index, bool value)
+    {
+        JNI_METRIC(pEnv);
+        jboolean elements[] = { value };
+        pEnv->SetBooleanArrayRegion(pArray, index, 1, elements);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
+        return 0;
+    }
 
-        jclass __cls = pEnv->GetObjectClass(jcls);
+    bool GetBooleanArrayElement(JNIEnv* pEnv, jbooleanArray pArray, int index)
+    {
+        JNI_METRIC(pEnv);
+        jboolean val = 0;
+        pEnv->GetBooleanArrayRegion(pArray, index, 1, &val);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
+            return false;
         }
+        return (bool)val;
+    }
 
-        jmethodID pMid2 = pEnv->GetMethodID(__cls, "getName", "()Ljava/lang/String;");
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+    int GetBooleanArrayRegion(JNIEnv* pEnv, jbooleanArray pArray, int offset, int count, jboolean* pDst)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jboolean));
+        pEnv->GetBooleanArrayRegion(pArray, offset, count, pDst);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
             return -1;
         }
+        return 0;
+    }
 
-        jobject jclsName = pEnv->CallObjectMethodA(_cls, pMid2, (const jvalue*)args);
-
+    int SetBooleanArrayRegion(JNIEnv* pEnv, jbooleanArray pArray, int offset, int count, const jboolean* pSrc)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jboolean));
+        pEnv->SetBooleanArrayRegion(pArray, offset, count, pSrc);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
             return -1;
         }
-
-        *cls = _cls;
-        *clsname = (jstring)jclsName;
-        free(args);
-        mutex.unlock();
         return 0;
     }
-    
-    int CallStaticObjectMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, jobject* pobj, int len, void** pArgs)
+
+    int NewBooleanArrayFrom(JNIEnv* pEnv, const jboolean* pSrc, int len, jbooleanArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jboolean));
+        *pArray = pEnv->NewBooleanArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
+        {
+            return -1;
+        }
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        if(len > 0)
+        {
+            pEnv->SetBooleanArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
+        return 0;
+    }
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    
+    //byte array
+    int NewByteArray(JNIEnv* pEnv, int nDimension, jbyteArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewByteArray( nDimension);
 
-        jobject val = pEnv->CallStaticObjectMethodA( pClass, pMid, (const jvalue*)args);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        *pobj = val;
-        free(args);
-        mutex.unlock();
-        return 0;
-    }
-    int CallObjectMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, jobject* pobj, int len, void** pArgs)
-    {
-        std::mutex mutex;
-        mutex.lock();
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        TrackLocalRef(*pArray);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+        if( *pArray != NULL )
+            return 0;
+        else
+            return -2;
 
-        jobject val = pEnv->CallObjectMethodA( pObject, pMid, (const jvalue*)args);
+    }
 
+    int SetByteArrayElement(JNIEnv* pEnv, jbyteArray pArray, int index, jbyte value)
+    {
+        JNI_METRIC(pEnv);
+        jbyte elements[] = { value };
+        pEnv->SetByteArrayRegion(pArray, index, 1, elements);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            // //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+            //pEnv->ExceptionDescribe();
             return -1;
         }
-        
-        *pobj = val;
-        free(args);
-        mutex.unlock();
         return 0;
     }
 
-    int GetStaticObjectField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jobject* pobj)
+    jbyte GetByteArrayElement(JNIEnv* pEnv, jbyteArray pArray, int index)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        jobject val = pEnv->GetStaticObjectField(pClass, pMid);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            mutex.unlock();
-            // //pEnv->ExceptionDescribe();
+        JNI_METRIC(pEnv);
+        jbyte val = 0;
+        pEnv->GetByteArrayRegion(pArray, index, 1, &val);
+        if(pEnv->ExceptionCheck() == JNI_TRUE){
             return -1;
         }
-        
-        *pobj = val;
-        mutex.unlock();
-        return 0;
+        return val;
     }
 
-    int GetObjectField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jobject* pobj)
+    int GetByteArrayRegion(JNIEnv* pEnv, jbyteArray pArray, int offset, int count, jbyte* pDst)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        jobject val = pEnv->GetObjectField( pObject, pMid);
-        
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jbyte));
+        pEnv->GetByteArrayRegion(pArray, offset, count, pDst);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
-        
-        *pobj = val;
-        mutex.unlock();
         return 0;
     }
 
-    int SetStaticObjectField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jobject val)
+    int SetByteArrayRegion(JNIEnv* pEnv, jbyteArray pArray, int offset, int count, const jbyte* pSrc)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetStaticObjectField(pClass, pMid, val);
-        
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jbyte));
+        pEnv->SetByteArrayRegion(pArray, offset, count, pSrc);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
-        mutex.unlock();
         return 0;
     }
 
-    int SetObjectField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jobject val)
+    int NewByteArrayFrom(JNIEnv* pEnv, const jbyte* pSrc, int len, jbyteArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetObjectField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jbyte));
+        *pArray = pEnv->NewByteArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
         {
-            // //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
-        mutex.unlock();
+
+        if(len > 0)
+        {
+            pEnv->SetByteArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
         return 0;
     }
 
-    //int
-    int CallStaticIntMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, int* res)
-    {
-        std::mutex mutex;
-        mutex.lock();
-
-        void** args = (void**)malloc(sizeof(void *) * len);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    //short array
+    int NewShortArray(JNIEnv* pEnv, int nDimension, jshortArray* pArray )
+    {
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewShortArray( nDimension);
 
-        *res = pEnv->CallStaticIntMethodA(pClass, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
             return -1;
         }
-        free(args);
-        mutex.unlock();
-        return 0;
+        TrackLocalRef(*pArray);
+        if( *pArray != NULL )
+            return 0;
+        else
+            return -2;
 
     }
 
-    int CallIntMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, int* res)
+    int SetShortArrayElement(JNIEnv* pEnv, jshortArray pArray, int index, short value)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        void** args = (void**)malloc(sizeof(void *) * len);
-
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
-
-        *res = pEnv->CallIntMethodA( pObject, pMid, (const jvalue*)args);
-
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+        JNI_METRIC(pEnv);
+        short elements[] = { value };
+        pEnv->SetShortArrayRegion(pArray, index, 1, elements);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
             return -1;
         }
-        free(args);
-        mutex.unlock();
         return 0;
     }
 
-    int GetStaticIntField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, int* res)
+    short GetShortArrayElement(JNIEnv* pEnv, jshortArray pArray, int index)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *res = pEnv->GetStaticIntField(pClass, pMid);
+        JNI_METRIC(pEnv);
+        jshort val = 0;
+        pEnv->GetShortArrayRegion(pArray, index, 1, &val);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return -666;
         }
-        mutex.unlock();
-        return 0;
+        return val;
     }
 
-    int GetIntField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, int* res)
+    int GetShortArrayRegion(JNIEnv* pEnv, jshortArray pArray, int offset, int count, jshort* pDst)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *res = pEnv->GetIntField(pObject, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jshort));
+        pEnv->GetShortArrayRegion(pArray, offset, count, pDst);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
             return -1;
         }
-        mutex.unlock();
         return 0;
     }
 
-    int SetStaticIntField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, int val)
+    int SetShortArrayRegion(JNIEnv* pEnv, jshortArray pArray, int offset, int count, const jshort* pSrc)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetStaticIntField(pClass, pMid, val);
-        
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jshort));
+        pEnv->SetShortArrayRegion(pArray, offset, count, pSrc);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
-        mutex.unlock();
         return 0;
     }
 
-    int SetIntField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, int val)
+    int NewShortArrayFrom(JNIEnv* pEnv, const jshort* pSrc, int len, jshortArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetIntField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jshort));
+        *pArray = pEnv->NewShortArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
-        mutex.unlock();
+
+        if(len > 0)
+        {
+            pEnv->SetShortArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
         return 0;
     }
 
-
-    //long
-    int CallStaticLongMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, long* val)
+    //char array
+    int NewCharArray(JNIEnv* pEnv, int nDimension, jcharArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        void** args = (void**)malloc(sizeof(void *) * len);
-
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+        JNI_METRIC(pEnv);
+        *pArray = pEnv->NewCharArray( nDimension);
 
-        *val = pEnv->CallStaticLongMethodA( pClass, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        {
             return -1;
         }
-        free(args);
-        mutex.unlock();
-        return 0;
-    }
 
-    int CallLongMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, long* val)
-    {
-        std::mutex mutex;
-        mutex.lock();
+        TrackLocalRef(*pArray);
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        if( *pArray != NULL )
+            return 0;
+        else
+            return -2;
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    }
 
-        *val = pEnv->CallLongMethodA(pObject, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
+    int SetCharArrayElement(JNIEnv* pEnv, jcharArray pArray, int index, char value)
+    {
+        JNI_METRIC(pEnv);
+        char elements[] = { value };
+        pEnv->SetCharArrayRegion(pArray, index, 1, (jchar *)elements);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
             return -1;
         }
-
-        free(args);
-        mutex.unlock();
         return 0;
     }
 
-    int GetStaticLongField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, long* val)
+    char GetCharArrayElement(JNIEnv* pEnv, jcharArray pArray, int index)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *val = pEnv->GetStaticLongField(pClass, pMid);
+        JNI_METRIC(pEnv);
+        jchar val = 0;
+        pEnv->GetCharArrayRegion(pArray, index, 1, &val);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return (char)-1;
         }
-
-        mutex.unlock();
-        return 0;
+        return (char)val;
     }
 
-    int GetLongField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, long* val)
+    int GetCharArrayRegion(JNIEnv* pEnv, jcharArray pArray, int offset, int count, jchar* pDst)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *val = pEnv->GetLongField(pObject, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jchar));
+        pEnv->GetCharArrayRegion(pArray, offset, count, pDst);
+        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        {
             return -1;
         }
-
-        mutex.unlock();
         return 0;
     }
 
-    int SetStaticLongField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, long val)
+    int SetCharArrayRegion(JNIEnv* pEnv, jcharArray pArray, int offset, int count, const jchar* pSrc)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetStaticLongField(pClass, pMid, val);
-        
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)count * sizeof(jchar));
+        pEnv->SetCharArrayRegion(pArray, offset, count, pSrc);
         if( pEnv->ExceptionCheck() == JNI_TRUE )
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
-
-        mutex.unlock();
         return 0;
     }
 
-    int SetLongField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, long val)
+    int NewCharArrayFrom(JNIEnv* pEnv, const jchar* pSrc, int len, jcharArray* pArray )
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetLongField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES((jlong)len * sizeof(jchar));
+        *pArray = pEnv->NewCharArray(len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || *pArray == NULL)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
             return -1;
         }
 
-        mutex.unlock();
+        if(len > 0)
+        {
+            pEnv->SetCharArrayRegion(*pArray, 0, len, pSrc);
+            if( pEnv->ExceptionCheck() == JNI_TRUE )
+            {
+                pEnv->DeleteLocalRef(*pArray);
+                *pArray = NULL;
+                return -1;
+            }
+        }
+        TrackLocalRef(*pArray);
         return 0;
     }
 
-    //float
-    int CallStaticFloatMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, float* val)
+
+    //batched calls
+    /*
+    Runs many method calls in one crossing from .NET. Each BatchCall names its target (an object, or a class when
+    BATCH_STATIC is set), the method, the return kind as a JNI signature letter ('V', 'Z', 'B', 'C', 'S', 'I', 'J',
+    'F', 'D', or 'L' for any reference) and a slice of the shared jvalue argument buffer, which is handed to the JVM
+    as is, without the per call copy of the single call wrappers.
+    The method is either a resolved ID or, when method is NULL, a name and signature resolved here against the
+    target's class. Consecutive entries with the same class, name and signature pointers reuse the last ID.
+    Each BatchResult gets the value and a status: 0 ok, -1 the call threw (value.l holds the local throwable and the
+    exception is cleared), -2 bad record or not run because stopOnError stopped the batch.
+    Returns the number of failed entries. Reference results are new local references, so large batches should run
+    inside a frame sized accordingly.
+    */
+
+    static const int BATCH_STATIC = 1;
+
+    struct BatchCall
     {
-        std::mutex mutex;
-        mutex.lock();
+        jobject target;
+        jmethodID method;
+        const char* name;
+        const char* signature;
+        int kind;
+        int flags;
+        int argOffset;
+        int argCount;
+    };
+
+    struct BatchResult
+    {
+        jvalue value;
+        int status;
+        int reserved;
+    };
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+    struct BatchMethodCache
+    {
+        jclass cls;
+        const char* name;
+        const char* signature;
+        jmethodID method;
+    };
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    static jmethodID ResolveBatchMethod(JNIEnv* pEnv, const BatchCall& call, BatchMethodCache& cache)
+    {
+        if(call.method != NULL)
+            return call.method;
+        if(call.name == NULL || call.signature == NULL)
+            return NULL;
 
-        *val = pEnv->CallStaticFloatMethodA( pClass, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
+        bool isStatic = (call.flags & BATCH_STATIC) != 0;
+        jclass cls = isStatic ? (jclass)call.target : pEnv->GetObjectClass(call.target);
+        if(cls == NULL)
+            return NULL;
 
-            mutex.unlock();
-            return -1;
+        if(cache.method != NULL && cache.name == call.name && cache.signature == call.signature && pEnv->IsSameObject(cache.cls, cls))
+        {
+            if(!isStatic)
+                pEnv->DeleteLocalRef(cls);
+            return cache.method;
         }
 
-        free(args);
-        mutex.unlock();
-        return 0;
+        jmethodID mid = isStatic ? pEnv->GetStaticMethodID(cls, call.name, call.signature) : pEnv->GetMethodID(cls, call.name, call.signature);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || mid == NULL)
+        {
+            if(!isStatic)
+                pEnv->DeleteLocalRef(cls);
+            return NULL;
+        }
+
+        if(cache.cls != NULL)
+            pEnv->DeleteLocalRef(cache.cls);
+        cache.cls = (jclass)pEnv->NewLocalRef(cls);
+        if(!isStatic)
+            pEnv->DeleteLocalRef(cls);
+        cache.name = call.name;
+        cache.signature = call.signature;
+        cache.method = mid;
+        return mid;
     }
 
-    int CallFloatMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, float* val)
+    static bool RunBatchCall(JNIEnv* pEnv, const BatchCall& call, jmethodID mid, const jvalue* args, jvalue* pValue)
     {
-        std::mutex mutex;
-        mutex.lock();
+        bool isStatic = (call.flags & BATCH_STATIC) != 0;
+        jclass cls = (jclass)call.target;
+        jobject obj = call.target;
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        switch(call.kind)
+        {
+            case 'V':
+                if(isStatic) pEnv->CallStaticVoidMethodA(cls, mid, args); else pEnv->CallVoidMethodA(obj, mid, args);
+                pValue->j = 0;
+                break;
+            case 'Z':
+                pValue->z = isStatic ? pEnv->CallStaticBooleanMethodA(cls, mid, args) : pEnv->CallBooleanMethodA(obj, mid, args);
+                break;
+            case 'B':
+                pValue->b = isStatic ? pEnv->CallStaticByteMethodA(cls, mid, args) : pEnv->CallByteMethodA(obj, mid, args);
+                break;
+            case 'C':
+                pValue->c = isStatic ? pEnv->CallStaticCharMethodA(cls, mid, args) : pEnv->CallCharMethodA(obj, mid, args);
+                break;
+            case 'S':
+                pValue->s = isStatic ? pEnv->CallStaticShortMethodA(cls, mid, args) : pEnv->CallShortMethodA(obj, mid, args);
+                break;
+            case 'I':
+                pValue->i = isStatic ? pEnv->CallStaticIntMethodA(cls, mid, args) : pEnv->CallIntMethodA(obj, mid, args);
+                break;
+            case 'J':
+                pValue->j = isStatic ? pEnv->CallStaticLongMethodA(cls, mid, args) : pEnv->CallLongMethodA(obj, mid, args);
+                break;
+            case 'F':
+                pValue->f = isStatic ? pEnv->CallStaticFloatMethodA(cls, mid, args) : pEnv->CallFloatMethodA(obj, mid, args);
+                break;
+            case 'D':
+                pValue->d = isStatic ? pEnv->CallStaticDoubleMethodA(cls, mid, args) : pEnv->CallDoubleMethodA(obj, mid, args);
+                break;
+            case 'L':
+            case '[':
+                pValue->l = isStatic ? pEnv->CallStaticObjectMethodA(cls, mid, args) : pEnv->CallObjectMethodA(obj, mid, args);
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    static bool FailBatchCall(JNIEnv* pEnv, BatchResult& result)
+    {
+        if(pEnv->ExceptionCheck() != JNI_TRUE)
+            return false;
+
+        jthrowable exception = pEnv->ExceptionOccurred();
+        pEnv->ExceptionClear();
+        TrackLocalRef(exception);
+        result.value.l = exception;
+        result.status = -1;
+        return true;
+    }
+
+    int CallBatch(JNIEnv* pEnv, const BatchCall* pCalls, int count, const jvalue* pArgs, BatchResult* pResults, int stopOnError)
+    {
+        JNI_METRIC(pEnv);
+        if(pCalls == NULL || pResults == NULL)
+            return -2;
+
+        for(int i = 0; i < count; i++)
+        {
+            pResults[i].value.j = 0;
+            pResults[i].status = -2;
+            pResults[i].reserved = 0;
+        }
+
+        BatchMethodCache cache = { NULL, NULL, NULL, NULL };
+        int failed = 0;
+        for(int i = 0; i < count; i++)
+        {
+            const BatchCall& call = pCalls[i];
+            BatchResult& result = pResults[i];
+
+            bool ok = false;
+            if(call.target != NULL && call.argOffset >= 0 && call.argCount >= 0 && (call.argCount == 0 || pArgs != NULL))
+            {
+                jmethodID mid = ResolveBatchMethod(pEnv, call, cache);
+                if(mid != NULL)
+                {
+                    const jvalue* args = call.argCount > 0 ? pArgs + call.argOffset : NULL;
+                    ok = RunBatchCall(pEnv, call, mid, args, &result.value);
+                }
+            }
+
+            if(FailBatchCall(pEnv, result) || !ok)
+            {
+                failed++;
+                if(stopOnError)
+                    break;
+                continue;
+            }
 
-        // float val = pEnv->CallFloatMethodA(pObject, pMid, (const jvalue*)args);
-        *val = pEnv->CallFloatMethodA(pObject, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
+            if(call.kind == 'L' || call.kind == '[')
+                TrackLocalRef(result.value.l);
+            result.status = 0;
         }
 
-        free(args);
-        mutex.unlock();
-        return 0;
+        if(cache.cls != NULL)
+            pEnv->DeleteLocalRef(cache.cls);
+        return failed;
     }
 
-    int GetStaticFloatField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, float *val)
+    //Raises a throwable returned by CallBatch again so GetException can describe it.
+    int ThrowException(JNIEnv* pEnv, jthrowable exception)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        if(exception == NULL)
+            return -2;
+        return pEnv->Throw(exception) == 0 ? 0 : -1;
+    }
 
-        *val = pEnv->GetStaticFloatField(pClass, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){        
-            mutex.unlock();
-            return -1;
-        }
 
-        mutex.unlock();
-        return 0;
-    }
+    //iterator drain
+    /*
+    Pulls up to max elements from a java.util.Iterator in one crossing instead of a hasNext and a next call each.
+    The elements are decoded into the same tagged values as callback arguments (see CallbackArgs). DrainMapEntries
+    walks an iterator of Map.Entry and returns keys and values as two parallel buffers. *pDone is set once hasNext
+    returns false, so the caller never needs an extra call to find the end.
+    The buffers stay valid until FreeTaggedArgs, which also deletes the local references of object entries.
+    */
 
-    int GetFloatField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, float *val)
+    static int DrainEntries(JNIEnv* pEnv, jobject iterator, int max, CallbackArgs* keys, CallbackArgs* values, int* pCount, int* pDone)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNICache* cache = GetJNICache(pEnv);
+        if(iterator == NULL || cache->midIteratorHasNext == NULL || cache->midIteratorNext == NULL)
+            return -2;
+        if(pEnv->IsInstanceOf(iterator, cache->clsIterator) != JNI_TRUE)
+            return -2;
+        if(keys != NULL && (cache->midMapEntryGetKey == NULL || cache->midMapEntryGetValue == NULL))
+            return -2;
 
-        *val = pEnv->GetFloatField(pObject, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
+        if(pEnv->EnsureLocalCapacity((keys != NULL ? 2 * max : max) + 16) != 0)
             return -1;
+
+        int count = 0;
+        *pDone = 0;
+        while(count < max)
+        {
+            jboolean hasNext = pEnv->CallBooleanMethod(iterator, cache->midIteratorHasNext);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return -1;
+            if(hasNext != JNI_TRUE)
+            {
+                *pDone = 1;
+                break;
+            }
+
+            jobject element = pEnv->CallObjectMethod(iterator, cache->midIteratorNext);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return -1;
+
+            if(keys == NULL)
+                values->Append(pEnv, cache, element);
+            else
+            {
+                if(element != NULL && pEnv->IsInstanceOf(element, cache->clsMapEntry) != JNI_TRUE)
+                {
+                    pEnv->DeleteLocalRef(element);
+                    return -2;
+                }
+
+                jobject key = element == NULL ? NULL : pEnv->CallObjectMethod(element, cache->midMapEntryGetKey);
+                jobject value = element == NULL || pEnv->ExceptionCheck() == JNI_TRUE ? NULL : pEnv->CallObjectMethod(element, cache->midMapEntryGetValue);
+                if(element != NULL)
+                    pEnv->DeleteLocalRef(element);
+                if(pEnv->ExceptionCheck() == JNI_TRUE)
+                {
+                    if(key != NULL)
+                        pEnv->DeleteLocalRef(key);
+                    return -1;
+                }
+
+                keys->Append(pEnv, cache, key);
+                values->Append(pEnv, cache, value);
+            }
+
+            count++;
+            if(values->status() != 0 || (keys != NULL && keys->status() != 0))
+                return -1;
         }
 
-        mutex.unlock();
+        if(keys != NULL)
+            keys->Seal();
+        values->Seal();
+        *pCount = count;
         return 0;
     }
 
-    int SetStaticFloatField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, float val)
+    int DrainIterator(JNIEnv* pEnv, jobject iterator, int max, void** ppArgs, void** ppData, int* pCount, int* pDone)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetStaticFloatField(pClass, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        JNI_METRIC(pEnv);
+        *ppArgs = NULL;
+        *ppData = NULL;
+        *pCount = 0;
+
+        CallbackArgs* values = new CallbackArgs();
+        int res = DrainEntries(pEnv, iterator, max, NULL, values, pCount, pDone);
+        if(res != 0)
         {
-            mutex.unlock();
-            return -1;
+            values->Release(pEnv);
+            delete values;
+            return res;
         }
 
-        mutex.unlock();
+        *ppArgs = values;
+        *ppData = values->data();
         return 0;
     }
 
-    int SetFloatField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, float val)
+    int DrainMapEntries(JNIEnv* pEnv, jobject iterator, int max, void** ppKeys, void** ppKeyData, void** ppValues, void** ppValueData, int* pCount, int* pDone)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetFloatField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        JNI_METRIC(pEnv);
+        *ppKeys = NULL;
+        *ppKeyData = NULL;
+        *ppValues = NULL;
+        *ppValueData = NULL;
+        *pCount = 0;
+
+        CallbackArgs* keys = new CallbackArgs();
+        CallbackArgs* values = new CallbackArgs();
+        int res = DrainEntries(pEnv, iterator, max, keys, values, pCount, pDone);
+        if(res != 0)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            keys->Release(pEnv);
+            values->Release(pEnv);
+            delete keys;
+            delete values;
+            return res;
         }
-        mutex.unlock();
+
+        *ppKeys = keys;
+        *ppKeyData = keys->data();
+        *ppValues = values;
+        *ppValueData = values->data();
         return 0;
     }
 
-    //double
-    int CallStaticDoubleMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, double* val)
+    void FreeTaggedArgs(JNIEnv* pEnv, void* args)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        if(args == NULL)
+            return;
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        CallbackArgs* buffer = (CallbackArgs*)args;
+        buffer->Release(pEnv);
+        delete buffer;
+    }
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    //boxed collections
+    /*
+    A java.util.Collection of boxed numbers (List<Double>, Collection<Integer>, ...) copied into a primitive buffer,
+    and an ArrayList built back from one. The collection is flattened with a single toArray call, which for an
+    ArrayList is an array copy and for anything else an iteration that stays inside the JVM; the elements are then
+    unboxed through the cached java.lang.Number accessors, so a Long in a List<Double> converts like it would in Java.
+    A null or non numeric element stops the copy with -2 and *pCount set to its index.
+    */
 
-        *val = pEnv->CallStaticDoubleMethodA(pClass, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            free(args);
-            mutex.unlock();
+    int CollectionSize(JNIEnv* pEnv, jobject collection, int* pSize)
+    {
+        JNI_METRIC(pEnv);
+        *pSize = 0;
+        JNICache* cache = GetJNICache(pEnv);
+        if(collection == NULL || cache->midCollectionSize == NULL || pEnv->IsInstanceOf(collection, cache->clsCollection) != JNI_TRUE)
+            return -2;
+
+        *pSize = pEnv->CallIntMethod(collection, cache->midCollectionSize);
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
             return -1;
-        }
-        free(args);
-        mutex.unlock();
         return 0;
     }
 
-    int CallDoubleMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, double* val)
+    static int CollectionToArray(JNIEnv* pEnv, jobject collection, char kind, void* pDst, int cap, int* pCount)
     {
-        std::mutex mutex;
-        mutex.lock();
+        *pCount = 0;
+        JNICache* cache = GetJNICache(pEnv);
+        if(collection == NULL || cache->midCollectionToArray == NULL || cache->clsNumber == NULL || pEnv->IsInstanceOf(collection, cache->clsCollection) != JNI_TRUE)
+            return -2;
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        jobjectArray elements = (jobjectArray)pEnv->CallObjectMethod(collection, cache->midCollectionToArray);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || elements == NULL)
+            return -1;
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+        int len = pEnv->GetArrayLength(elements);
+        if(len > cap)
+            len = cap;
 
-        *val = pEnv->CallDoubleMethodA( pObject, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            free(args);
-            mutex.unlock();
-            return -1;
+        int res = 0;
+        int i = 0;
+        for(; i < len && res == 0; i++)
+        {
+            jobject element = pEnv->GetObjectArrayElement(elements, i);
+            if(element == NULL || pEnv->IsInstanceOf(element, cache->clsNumber) != JNI_TRUE)
+            {
+                res = -2;
+                if(element != NULL)
+                    pEnv->DeleteLocalRef(element);
+                break;
+            }
+
+            switch(kind)
+            {
+                case 'D': ((jdouble*)pDst)[i] = pEnv->CallDoubleMethod(element, cache->midNumberDoubleValue); break;
+                case 'J': ((jlong*)pDst)[i] = pEnv->CallLongMethod(element, cache->midNumberLongValue); break;
+                case 'I': ((jint*)pDst)[i] = pEnv->CallIntMethod(element, cache->midNumberIntValue); break;
+                case 'F': ((jfloat*)pDst)[i] = pEnv->CallFloatMethod(element, cache->midNumberFloatValue); break;
+            }
+            pEnv->DeleteLocalRef(element);
+
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                res = -1;
         }
+        pEnv->DeleteLocalRef(elements);
 
-        free(args);
-        mutex.unlock();
-        return 0;
+        *pCount = res == 0 ? len : i;
+        return res;
     }
 
-    int GetStaticDoubleField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, double* val)
+    static int NewArrayListFrom(JNIEnv* pEnv, char kind, const void* pSrc, int len, jobject* pList)
     {
-        std::mutex mutex;
-        mutex.lock();
+        *pList = NULL;
+        JNICache* cache = GetJNICache(pEnv);
+        if(cache->midArrayListInit == NULL || cache->midArrayListAdd == NULL)
+            return -2;
 
-        *val = pEnv->GetStaticDoubleField(pClass, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        jobject list = pEnv->NewObject(cache->clsArrayList, cache->midArrayListInit, (jint)len);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || list == NULL)
             return -1;
+
+        for(int i = 0; i < len; i++)
+        {
+            jobject box = NULL;
+            switch(kind)
+            {
+                case 'D': box = pEnv->CallStaticObjectMethod(cache->clsDouble, cache->midDoubleValueOf, ((const jdouble*)pSrc)[i]); break;
+                case 'J': box = pEnv->CallStaticObjectMethod(cache->clsLong, cache->midLongValueOf, ((const jlong*)pSrc)[i]); break;
+                case 'I': box = pEnv->CallStaticObjectMethod(cache->clsInteger, cache->midIntegerValueOf, ((const jint*)pSrc)[i]); break;
+                case 'F': box = pEnv->CallStaticObjectMethod(cache->clsFloat, cache->midFloatValueOf, (jdouble)((const jfloat*)pSrc)[i]); break;
+            }
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+            {
+                pEnv->DeleteLocalRef(list);
+                return -1;
+            }
+
+            pEnv->CallBooleanMethod(list, cache->midArrayListAdd, box);
+            pEnv->DeleteLocalRef(box);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+            {
+                pEnv->DeleteLocalRef(list);
+                return -1;
+            }
         }
 
-        mutex.unlock();
+        TrackLocalRef(list);
+        *pList = list;
         return 0;
     }
 
-    int GetDoubleField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, double* val)
+    int CollectionToDoubleArray(JNIEnv* pEnv, jobject collection, jdouble* pDst, int cap, int* pCount)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        int res = CollectionToArray(pEnv, collection, 'D', pDst, cap, pCount);
+        JNI_METRIC_BYTES(*pCount * sizeof(jdouble));
+        return res;
+    }
 
-        *val = pEnv->GetDoubleField(pObject, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
+    int CollectionToLongArray(JNIEnv* pEnv, jobject collection, jlong* pDst, int cap, int* pCount)
+    {
+        JNI_METRIC(pEnv);
+        int res = CollectionToArray(pEnv, collection, 'J', pDst, cap, pCount);
+        JNI_METRIC_BYTES(*pCount * sizeof(jlong));
+        return res;
     }
 
-    int SetStaticDoubleField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, double val)
+    int CollectionToIntArray(JNIEnv* pEnv, jobject collection, jint* pDst, int cap, int* pCount)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        int res = CollectionToArray(pEnv, collection, 'I', pDst, cap, pCount);
+        JNI_METRIC_BYTES(*pCount * sizeof(jint));
+        return res;
+    }
 
-        pEnv->SetStaticDoubleField(pClass, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
+    int CollectionToFloatArray(JNIEnv* pEnv, jobject collection, jfloat* pDst, int cap, int* pCount)
+    {
+        JNI_METRIC(pEnv);
+        int res = CollectionToArray(pEnv, collection, 'F', pDst, cap, pCount);
+        JNI_METRIC_BYTES(*pCount * sizeof(jfloat));
+        return res;
     }
 
-    int SetDoubleField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, double val)
+    int NewDoubleArrayList(JNIEnv* pEnv, const jdouble* pSrc, int len, jobject* pList)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES(len * sizeof(jdouble));
+        return NewArrayListFrom(pEnv, 'D', pSrc, len, pList);
+    }
 
-        pEnv->SetDoubleField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
+    int NewLongArrayList(JNIEnv* pEnv, const jlong* pSrc, int len, jobject* pList)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES(len * sizeof(jlong));
+        return NewArrayListFrom(pEnv, 'J', pSrc, len, pList);
     }
 
-    //bool
-    int CallStaticBooleanMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, bool* val)
+    int NewIntArrayList(JNIEnv* pEnv, const jint* pSrc, int len, jobject* pList)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES(len * sizeof(jint));
+        return NewArrayListFrom(pEnv, 'I', pSrc, len, pList);
+    }
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+    int NewFloatArrayList(JNIEnv* pEnv, const jfloat* pSrc, int len, jobject* pList)
+    {
+        JNI_METRIC(pEnv);
+        JNI_METRIC_BYTES(len * sizeof(jfloat));
+        return NewArrayListFrom(pEnv, 'F', pSrc, len, pList);
+    }
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    //pinned array views
+    /*
+    Zero copy access to the storage of a primitive array. szType is the element signature ("D", "I", ...)
+    and is checked against the array's class before anything is pinned.
 
-        *val = pEnv->CallStaticBooleanMethodA( pClass, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
-        }
-        free(args);
-        mutex.unlock();
-        return 0;
-    }
+    GetArrayCritical: the pointer is usually the JVM heap itself. Until ReleaseArrayCritical the calling
+    thread must not make any other JNI call or block, and the collector may be held off, so keep the
+    section short.
+    GetArrayElements: may pin or copy (see pIsCopy) and has no restrictions on what runs in between.
 
-    int CallBooleanMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, bool* val)
+    Release modes are the JNI ones: 0 copies back and frees, JNI_COMMIT copies back and keeps the buffer,
+    JNI_ABORT frees without copying back (read only use).
+    */
+
+    static jclass ArrayClassFor(JNICache* cache, const char* szType)
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(szType == NULL)
+            return NULL;
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+        switch(szType[0])
+        {
+            case 'Z': return cache->clsBooleanArray;
+            case 'B': return cache->clsByteArray;
+            case 'C': return cache->clsCharArray;
+            case 'S': return cache->clsShortArray;
+            case 'I': return cache->clsIntArray;
+            case 'J': return cache->clsLongArray;
+            case 'F': return cache->clsFloatArray;
+            case 'D': return cache->clsDoubleArray;
+        }
+        return NULL;
+    }
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    static bool IsArrayOfType(JNIEnv* pEnv, jarray pArray, const char* szType)
+    {
+        if(pArray == NULL)
+            return false;
 
-        *val = pEnv->CallBooleanMethodA( pObject, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
-        }
-        free(args);
-        mutex.unlock();
-        return 0;
+        jclass cls = ArrayClassFor(GetJNICache(pEnv), szType);
+        return cls != NULL && pEnv->IsInstanceOf(pArray, cls) == JNI_TRUE;
     }
 
-    int GetStaticBooleanField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, bool* val)
+    int GetArrayCritical(JNIEnv* pEnv, jarray pArray, const char* szType, void** ppData, int* pLength)
     {
-        std::mutex mutex;
-        mutex.lock();
+        //NULL env: the metric's exception probe would run after return, with the array still pinned.
+        JNI_METRIC(NULL);
+        *ppData = NULL;
+        *pLength = 0;
 
-        *val = pEnv->GetStaticBooleanField(pClass, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        if(!IsArrayOfType(pEnv, pArray, szType))
+            return -2;
+
+        int len = pEnv->GetArrayLength(pArray);
+        //No JNI call is allowed once the array is pinned, not even ExceptionCheck.
+        void* data = pEnv->GetPrimitiveArrayCritical(pArray, NULL);
+        if(data == NULL)
             return -1;
-        }
 
-        mutex.unlock();
+        *ppData = data;
+        *pLength = len;
         return 0;
     }
 
-    int GetBooleanField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, bool* val)
+    int ReleaseArrayCritical(JNIEnv* pEnv, jarray pArray, void* pData, int mode)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *val = pEnv->GetBooleanField(pObject, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
+        JNI_METRIC(pEnv);
+        if(pData == NULL)
+            return -2;
 
-        mutex.unlock();
+        pEnv->ReleasePrimitiveArrayCritical(pArray, pData, mode);
         return 0;
     }
 
-    int SetStaticBooleanField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, bool val)
+    int GetArrayElements(JNIEnv* pEnv, jarray pArray, const char* szType, void** ppData, int* pLength, bool* pIsCopy)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        *ppData = NULL;
+        *pLength = 0;
+        *pIsCopy = false;
 
-        pEnv->SetStaticBooleanField(pClass, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        if(!IsArrayOfType(pEnv, pArray, szType))
+            return -2;
+
+        jboolean isCopy = JNI_FALSE;
+        void* data = NULL;
+        switch(szType[0])
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            case 'Z': data = pEnv->GetBooleanArrayElements((jbooleanArray)pArray, &isCopy); break;
+            case 'B': data = pEnv->GetByteArrayElements((jbyteArray)pArray, &isCopy); break;
+            case 'C': data = pEnv->GetCharArrayElements((jcharArray)pArray, &isCopy); break;
+            case 'S': data = pEnv->GetShortArrayElements((jshortArray)pArray, &isCopy); break;
+            case 'I': data = pEnv->GetIntArrayElements((jintArray)pArray, &isCopy); break;
+            case 'J': data = pEnv->GetLongArrayElements((jlongArray)pArray, &isCopy); break;
+            case 'F': data = pEnv->GetFloatArrayElements((jfloatArray)pArray, &isCopy); break;
+            case 'D': data = pEnv->GetDoubleArrayElements((jdoubleArray)pArray, &isCopy); break;
         }
-        mutex.unlock();
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE || data == NULL)
+            return -1;
+
+        *ppData = data;
+        *pLength = pEnv->GetArrayLength(pArray);
+        *pIsCopy = isCopy == JNI_TRUE;
         return 0;
     }
 
-    int SetBooleanField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, bool val)
+    int ReleaseArrayElements(JNIEnv* pEnv, jarray pArray, const char* szType, void* pData, int mode)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        if(pData == NULL || szType == NULL)
+            return -2;
 
-        pEnv->SetBooleanField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        switch(szType[0])
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            case 'Z': pEnv->ReleaseBooleanArrayElements((jbooleanArray)pArray, (jboolean*)pData, mode); break;
+            case 'B': pEnv->ReleaseByteArrayElements((jbyteArray)pArray, (jbyte*)pData, mode); break;
+            case 'C': pEnv->ReleaseCharArrayElements((jcharArray)pArray, (jchar*)pData, mode); break;
+            case 'S': pEnv->ReleaseShortArrayElements((jshortArray)pArray, (jshort*)pData, mode); break;
+            case 'I': pEnv->ReleaseIntArrayElements((jintArray)pArray, (jint*)pData, mode); break;
+            case 'J': pEnv->ReleaseLongArrayElements((jlongArray)pArray, (jlong*)pData, mode); break;
+            case 'F': pEnv->ReleaseFloatArrayElements((jfloatArray)pArray, (jfloat*)pData, mode); break;
+            case 'D': pEnv->ReleaseDoubleArrayElements((jdoubleArray)pArray, (jdouble*)pData, mode); break;
+            default: return -2;
         }
-        mutex.unlock();
         return 0;
     }
 
-    //byte
-    int CallStaticByteMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, jbyte* val)
-    {
-        std::mutex mutex;
-        mutex.lock();
 
-        void** args = (void**)malloc(sizeof(void *) * len);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
 
-        *val = pEnv->CallStaticByteMethodA( pClass, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
-        }
+    /*
+    Static wrapper on DestroyJavaVM() JNI function.
+    See the description in
+    http://jre.sfbay/java/re/jdk/6/promoted/latest/docs/technotes/guides/jni/spec/invocation.html#destroy_java_vm
+    */
 
-        free(args);
-        mutex.unlock();
+    int DestroyJavaVM( JavaVM* pJVM ){
+        pJVM->DestroyJavaVM();
         return 0;
     }
 
-    int CallByteMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, jbyte* val)
-    {
-        std::mutex mutex;
-        mutex.lock();
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+    
+    int (*fnCreateInstance)(void*, const char*, int, void*);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    void SetfnCreateInstance(void* cb)
+    {
+        fnCreateInstance = (int (*)(void*, const char*, int, void*))cb;
+    }
 
-        *val = pEnv->CallByteMethodA( pObject, pMid, (const jvalue*)args);
+    JNIEXPORT jint JNICALL Java_app_quant_clr_CLRRuntime_nativeCreateInstance(JNIEnv* pEnv, jclass cls, jstring classname, jint len, jobjectArray args)
+    {
+        JNI_METRIC(pEnv);
+        CallbackArgs _args(pEnv, args, len);
+        if(_args.status() != 0)
+            return -1;
+
+        JavaUTFChars _classname(pEnv, classname);
+        CallbackScope callback;
+        int val = fnCreateInstance(pEnv, _classname.c_str(), _args.count(), _args.data());
         if(pEnv->ExceptionCheck() == JNI_TRUE){
             //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
             return -1;
         }
-        free(args);
-        mutex.unlock();
-        return 0;
+        return val;
     }
 
-    int GetStaticByteField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jbyte* val)
+    jobject (*fnInvoke)(void*, int, const char*, int, void*);
+
+    void SetfnInvoke(void* cb)
+    {
+        fnInvoke = (jobject (*)(void*, int, const char*, int, void*))cb;
+    }
+
+    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeInvoke(JNIEnv* pEnv, jclass cls, jint ptr, jstring funcname, jint len, jobjectArray args)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        CallbackArgs _args(pEnv, args, len);
+        if(_args.status() != 0)
+            return NULL;
 
-        *val = pEnv->GetStaticByteField(pClass, pMid);
+        JavaUTFChars _funcname(pEnv, funcname);
+        CallbackScope callback;
+        jobject val = fnInvoke(pEnv, ptr, _funcname.c_str(), _args.count(), _args.data());
         if(pEnv->ExceptionCheck() == JNI_TRUE){
             //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return NULL;
         }
-        mutex.unlock();
-        return 0;
+        return val;
+    }
+
+    jobject (*fnGetProperty)(void*, int, const char*);
+
+    void SetfnGetProperty(void* cb)
+    {
+        fnGetProperty = (jobject (*)(void*, int, const char*))cb;
     }
 
-    int GetByteField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jbyte* val)
+    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeGetProperty(JNIEnv* pEnv, jclass cls, jint ptr, jstring name)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *val = pEnv->GetByteField(pObject, pMid);
+        JNI_METRIC(pEnv);
+        JavaUTFChars _name(pEnv, name);
+        CallbackScope callback;
+        jobject val = fnGetProperty(pEnv, ptr, _name.c_str());
         if(pEnv->ExceptionCheck() == JNI_TRUE){
             //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return NULL;
         }
-
-        mutex.unlock();
-        return 0;
+        return val;
     }
 
-    int SetStaticByteField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jbyte val)
-    {
-        std::mutex mutex;
-        mutex.lock();
+    jobject (*fnSetProperty)(void*, int, const char*, int, void*);
 
-        pEnv->SetStaticByteField(pClass, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
+    void SetfnSetProperty(void* cb)
+    {
+        fnSetProperty = (jobject (*)(void*, int, const char*, int, void*))cb;
     }
 
-    int SetByteField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jbyte val)
+    JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeSetProperty(JNIEnv* pEnv, jclass cls, jint ptr, jstring name, jobjectArray value)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        CallbackArgs _value(pEnv, value, value == NULL ? 0 : pEnv->GetArrayLength(value));
+        if(_value.status() != 0)
+            return;
+
+        JavaUTFChars _name(pEnv, name);
+        CallbackScope callback;
+        fnSetProperty(pEnv, ptr, _name.c_str(), _value.count(), _value.data());
 
-        pEnv->SetByteField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
     }
 
-    //char
-    int CallStaticCharMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, char* val)
-    {
-        std::mutex mutex;
-        mutex.lock();
 
-        void** args = (void**)malloc(sizeof(void *) * len);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    jobject (*fnRegisterFunc)(void*, const char*, int);
 
-        *val = pEnv->CallStaticCharMethodA( pClass, pMid, (const jvalue*)args);
+    void SetfnRegisterFunc(void* cb)
+    {
+        fnRegisterFunc = (jobject (*)(void*, const char*, int))cb;
+    }
+
+    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeRegisterFunc(JNIEnv* pEnv, jclass cls, jstring funcname, jint hash)
+    {
+        JNI_METRIC(pEnv);
+        JavaUTFChars _funcname(pEnv, funcname);
+        
+        CallbackScope callback;
+        jobject val = fnRegisterFunc(pEnv, _funcname.c_str(), hash);
         if(pEnv->ExceptionCheck() == JNI_TRUE){
             //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
+            return NULL;
         }
-        free(args);
-        mutex.unlock();
-        return 0;
+        return val;
     }
 
-    int CallCharMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, char* val)
-    {
-        std::mutex mutex;
-        mutex.lock();
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+    jobject (*fnInvokeFunc)(void*, int, int, void*);
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
-            
-        *val = pEnv->CallCharMethodA( pObject, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
-        }
-        free(args);
-        mutex.unlock();
-        return 0;
+    void SetfnInvokeFunc(void* cb)
+    {
+        fnInvokeFunc = (jobject (*)(void*, int, int, void*))cb;
     }
 
-    int GetStaticCharField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, char* val)
+    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeInvokeFunc(JNIEnv* pEnv, jclass cls, jint ptr, jint len, jobjectArray args)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        CallbackArgs _args(pEnv, args, len);
+        if(_args.status() != 0)
+            return NULL;
 
-        *val = pEnv->GetStaticCharField(pClass, pMid);
+        CallbackScope callback;
+        jobject val = fnInvokeFunc(pEnv, ptr, _args.count(), _args.data());
         if(pEnv->ExceptionCheck() == JNI_TRUE){
             //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            return NULL;
         }
-        mutex.unlock();
-        return 0;
+        return val;
     }
 
-    int GetCharField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, char* val)
-    {
-        std::mutex mutex;
-        mutex.lock();
 
-        *val = pEnv->GetCharField(pObject, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
+
+    jobject (*fnRemoveObject)(void*, int);
+
+    void SetfnRemoveObject(void* cb)
+    {
+        fnRemoveObject = (jobject (*)(void*, int))cb;
     }
 
-    int SetStaticCharField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, char val)
+    JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeRemoveObject(JNIEnv* pEnv, jclass cls, jint ptr)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        // const char* _name = GetNetString(pEnv, name);
+        CallbackScope callback;
+        fnRemoveObject(pEnv, ptr);
 
-        pEnv->SetStaticCharField(pClass, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+    }
+
+
+    //primitive callbacks
+    /*
+    Java to .NET calls for the common numeric shapes, without boxing or an Object[].
+    nativeBindMethod resolves a .NET method once to a token; the nativeCall natives pass the primitives straight
+    to the matching function pointer installed by Runtime.cs. A callback returns 0 on success and -1 once it has
+    raised a Java exception through ThrowNewException.
+    The natives are not part of the generated header, they are registered with RegisterNatives in JNI_OnLoad.
+    */
+
+    int ThrowNewException(JNIEnv* pEnv, const char* szMessage)
+    {
+        jclass cls = pEnv->FindClass("java/lang/RuntimeException");
+        if(cls == NULL)
             return -1;
-        }
-        mutex.unlock();
+
+        pEnv->ThrowNew(cls, szMessage);
+        pEnv->DeleteLocalRef(cls);
         return 0;
     }
 
-    int SetCharField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, char val)
+    int (*fnBindMethod)(void*, int, const char*, const char*);
+    int (*fnCallV)(void*, int);
+    int (*fnCallDV)(void*, int, jdouble);
+    int (*fnCallDDV)(void*, int, jdouble, jdouble);
+    int (*fnCallDD)(void*, int, jdouble, jdouble*);
+    int (*fnCallDDD)(void*, int, jdouble, jdouble, jdouble*);
+    int (*fnCallJJ)(void*, int, jlong, jlong*);
+    int (*fnCallII)(void*, int, jint, jint*);
+    int (*fnCallArrDD)(void*, int, const jdouble*, int, jdouble*);
+
+    void SetfnBindMethod(void* cb) { fnBindMethod = (int (*)(void*, int, const char*, const char*))cb; }
+    void SetfnCallV(void* cb) { fnCallV = (int (*)(void*, int))cb; }
+    void SetfnCallDV(void* cb) { fnCallDV = (int (*)(void*, int, jdouble))cb; }
+    void SetfnCallDDV(void* cb) { fnCallDDV = (int (*)(void*, int, jdouble, jdouble))cb; }
+    void SetfnCallDD(void* cb) { fnCallDD = (int (*)(void*, int, jdouble, jdouble*))cb; }
+    void SetfnCallDDD(void* cb) { fnCallDDD = (int (*)(void*, int, jdouble, jdouble, jdouble*))cb; }
+    void SetfnCallJJ(void* cb) { fnCallJJ = (int (*)(void*, int, jlong, jlong*))cb; }
+    void SetfnCallII(void* cb) { fnCallII = (int (*)(void*, int, jint, jint*))cb; }
+    void SetfnCallArrDD(void* cb) { fnCallArrDD = (int (*)(void*, int, const jdouble*, int, jdouble*))cb; }
+
+    static bool CallbackReady(JNIEnv* pEnv, void* fn)
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(fn != NULL)
+            return true;
+        ThrowNewException(pEnv, "CLR callbacks are not installed");
+        return false;
+    }
 
-        pEnv->SetCharField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+    static jint JNICALL CLRRuntime_nativeBindMethod(JNIEnv* pEnv, jclass cls, jint ptr, jstring funcname, jstring signature)
+    {
+        JNI_METRIC(pEnv);
+        if(!CallbackReady(pEnv, (void*)fnBindMethod))
             return -1;
-        }
-        mutex.unlock();
-        return 0;
+
+        JavaUTFChars _funcname(pEnv, funcname);
+        JavaUTFChars _signature(pEnv, signature);
+        CallbackScope callback;
+        return fnBindMethod(pEnv, ptr, _funcname.c_str(), _signature.c_str());
     }
 
+    static void JNICALL CLRRuntime_nativeCallV(JNIEnv* pEnv, jclass cls, jint token)
+    {
+        JNI_METRIC(pEnv);
+        if(!CallbackReady(pEnv, (void*)fnCallV))
+            return;
+        CallbackScope callback;
+        fnCallV(pEnv, token);
+    }
 
-    //short
-    int CallStaticShortMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, short* val)
+    static void JNICALL CLRRuntime_nativeCallDV(JNIEnv* pEnv, jclass cls, jint token, jdouble a)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        if(!CallbackReady(pEnv, (void*)fnCallDV))
+            return;
+        CallbackScope callback;
+        fnCallDV(pEnv, token, a);
+    }
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+    static void JNICALL CLRRuntime_nativeCallDDV(JNIEnv* pEnv, jclass cls, jint token, jdouble a, jdouble b)
+    {
+        JNI_METRIC(pEnv);
+        if(!CallbackReady(pEnv, (void*)fnCallDDV))
+            return;
+        CallbackScope callback;
+        fnCallDDV(pEnv, token, a, b);
+    }
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+    static jdouble JNICALL CLRRuntime_nativeCallDD(JNIEnv* pEnv, jclass cls, jint token, jdouble a)
+    {
+        JNI_METRIC(pEnv);
+        jdouble res = 0;
+        if(!CallbackReady(pEnv, (void*)fnCallDD))
+            return res;
+        CallbackScope callback;
+        fnCallDD(pEnv, token, a, &res);
+        return res;
+    }
 
-        *val = pEnv->CallStaticShortMethodA( pClass, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
-        }
+    static jdouble JNICALL CLRRuntime_nativeCallDDD(JNIEnv* pEnv, jclass cls, jint token, jdouble a, jdouble b)
+    {
+        JNI_METRIC(pEnv);
+        jdouble res = 0;
+        if(!CallbackReady(pEnv, (void*)fnCallDDD))
+            return res;
+        CallbackScope callback;
+        fnCallDDD(pEnv, token, a, b, &res);
+        return res;
+    }
 
-        free(args);
-        mutex.unlock();
-        return 0;
+    static jlong JNICALL CLRRuntime_nativeCallJJ(JNIEnv* pEnv, jclass cls, jint token, jlong a)
+    {
+        JNI_METRIC(pEnv);
+        jlong res = 0;
+        if(!CallbackReady(pEnv, (void*)fnCallJJ))
+            return res;
+        CallbackScope callback;
+        fnCallJJ(pEnv, token, a, &res);
+        return res;
     }
 
-    int CallShortMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, short* val)
+    static jint JNICALL CLRRuntime_nativeCallII(JNIEnv* pEnv, jclass cls, jint token, jint a)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        jint res = 0;
+        if(!CallbackReady(pEnv, (void*)fnCallII))
+            return res;
+        CallbackScope callback;
+        fnCallII(pEnv, token, a, &res);
+        return res;
+    }
 
-        void** args = (void**)malloc(sizeof(void *) * len);
+    static jdouble JNICALL CLRRuntime_nativeCallArrDD(JNIEnv* pEnv, jclass cls, jint token, jdoubleArray a)
+    {
+        JNI_METRIC(pEnv);
+        jdouble res = 0;
+        if(!CallbackReady(pEnv, (void*)fnCallArrDD))
+            return res;
 
-        for(int i = 0; i < len; i++)
-            args[i] = pArgs[i];
+        jsize len = a == NULL ? 0 : pEnv->GetArrayLength(a);
+        jdouble* elements = a == NULL ? NULL : pEnv->GetDoubleArrayElements(a, NULL);
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            return res;
 
-        *val = pEnv->CallShortMethodA( pObject, pMid, (const jvalue*)args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(args);
-            mutex.unlock();
-            return -1;
+        {
+            CallbackScope callback;
+            fnCallArrDD(pEnv, token, elements, len, &res);
         }
 
-        free(args);
-        mutex.unlock();
-        return 0;
+        if(elements != NULL)
+            pEnv->ReleaseDoubleArrayElements(a, elements, JNI_ABORT);
+        return res;
     }
 
-    int GetStaticShortField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, short* val)
+    static int RegisterCLRRuntimeNatives(JNIEnv* pEnv, JNINativeMethod* methods, int count)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *val = pEnv->GetStaticShortField(pClass, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        jclass cls = pEnv->FindClass("app/quant/clr/CLRRuntime");
+        if(cls == NULL || pEnv->ExceptionCheck() == JNI_TRUE)
+        {
+            pEnv->ExceptionClear();
             return -1;
         }
 
-        mutex.unlock();
-        return 0;
+        int res = pEnv->RegisterNatives(cls, methods, count) == 0 ? 0 : -1;
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            pEnv->ExceptionClear();
+        pEnv->DeleteLocalRef(cls);
+        return res;
     }
 
-    int GetShortField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, short* val)
+    static int RegisterCallbackNatives(JNIEnv* pEnv)
     {
-        std::mutex mutex;
-        mutex.lock();
+        static JNINativeMethod methods[] = {
+            { (char*)"nativeBindMethod", (char*)"(ILjava/lang/String;Ljava/lang/String;)I", (void*)CLRRuntime_nativeBindMethod },
+            { (char*)"nativeCallV", (char*)"(I)V", (void*)CLRRuntime_nativeCallV },
+            { (char*)"nativeCallDV", (char*)"(ID)V", (void*)CLRRuntime_nativeCallDV },
+            { (char*)"nativeCallDDV", (char*)"(IDD)V", (void*)CLRRuntime_nativeCallDDV },
+            { (char*)"nativeCallDD", (char*)"(ID)D", (void*)CLRRuntime_nativeCallDD },
+            { (char*)"nativeCallDDD", (char*)"(IDD)D", (void*)CLRRuntime_nativeCallDDD },
+            { (char*)"nativeCallJJ", (char*)"(IJ)J", (void*)CLRRuntime_nativeCallJJ },
+            { (char*)"nativeCallII", (char*)"(II)I", (void*)CLRRuntime_nativeCallII },
+            { (char*)"nativeCallArrDD", (char*)"(I[D)D", (void*)CLRRuntime_nativeCallArrDD }
+        };
+
+        return RegisterCLRRuntimeNatives(pEnv, methods, sizeof(methods) / sizeof(methods[0]));
+    }
 
-        *val = pEnv->GetShortField(pObject, pMid);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
+    //matrices
+    /*
+    Rectangular and jagged primitive matrices (double[][], int[][], ...) moved one row per Get/Set<Type>ArrayRegion
+    against caller owned row buffers, so a .NET T[,] or T[][] crosses in a call per row instead of one per element.
+    sType is the element signature of the rows, one of "D", "F", "I", "J", "S" or "B". A row length of -1 stands
+    for a null row.
+    Large matrices are split by rows over up to `threads` worker threads attached to the JVM for the copy; small
+    ones stay on the calling thread where the attach would cost more than it saves.
+    */
 
-        mutex.unlock();
-        return 0;
-    }
+    #define MATRIX_PARALLEL_BYTES (4 * 1024 * 1024)
+    #define MATRIX_THREAD_BYTES (1024 * 1024)
+    #define MATRIX_MAX_THREADS 8
 
-    int SetStaticShortField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, short val)
+    static int MatrixElementSize(char kind)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        pEnv->SetStaticShortField(pClass, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        switch(kind)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            case 'D': case 'J': return 8;
+            case 'F': case 'I': return 4;
+            case 'S': return 2;
+            case 'B': return 1;
         }
-        mutex.unlock();
         return 0;
     }
 
-    int SetShortField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, short val)
+    static void CopyRowOut(JNIEnv* pEnv, char kind, jarray row, int len, void* pDst)
     {
-        std::mutex mutex;
-        mutex.lock();
+        switch(kind)
+        {
+            case 'D': pEnv->GetDoubleArrayRegion((jdoubleArray)row, 0, len, (jdouble*)pDst); break;
+            case 'F': pEnv->GetFloatArrayRegion((jfloatArray)row, 0, len, (jfloat*)pDst); break;
+            case 'I': pEnv->GetIntArrayRegion((jintArray)row, 0, len, (jint*)pDst); break;
+            case 'J': pEnv->GetLongArrayRegion((jlongArray)row, 0, len, (jlong*)pDst); break;
+            case 'S': pEnv->GetShortArrayRegion((jshortArray)row, 0, len, (jshort*)pDst); break;
+            case 'B': pEnv->GetByteArrayRegion((jbyteArray)row, 0, len, (jbyte*)pDst); break;
+        }
+    }
 
-        pEnv->SetShortField( pObject, pMid, val);
-        
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+    static jarray NewRowFrom(JNIEnv* pEnv, char kind, int len, const void* pSrc)
+    {
+        jarray row = NULL;
+        switch(kind)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            case 'D': row = pEnv->NewDoubleArray(len); if(row != NULL) pEnv->SetDoubleArrayRegion((jdoubleArray)row, 0, len, (const jdouble*)pSrc); break;
+            case 'F': row = pEnv->NewFloatArray(len); if(row != NULL) pEnv->SetFloatArrayRegion((jfloatArray)row, 0, len, (const jfloat*)pSrc); break;
+            case 'I': row = pEnv->NewIntArray(len); if(row != NULL) pEnv->SetIntArrayRegion((jintArray)row, 0, len, (const jint*)pSrc); break;
+            case 'J': row = pEnv->NewLongArray(len); if(row != NULL) pEnv->SetLongArrayRegion((jlongArray)row, 0, len, (const jlong*)pSrc); break;
+            case 'S': row = pEnv->NewShortArray(len); if(row != NULL) pEnv->SetShortArrayRegion((jshortArray)row, 0, len, (const jshort*)pSrc); break;
+            case 'B': row = pEnv->NewByteArray(len); if(row != NULL) pEnv->SetByteArrayRegion((jbyteArray)row, 0, len, (const jbyte*)pSrc); break;
         }
-        mutex.unlock();
-        return 0;
+        return row;
     }
 
+    static bool GetMatrixRange(JNIEnv* pEnv, jobjectArray array, char kind, int from, int to, void** pRows, const int* pLengths)
+    {
+        for(int i = from; i < to; i++)
+        {
+            if(pLengths[i] <= 0)
+                continue;
 
+            jarray row = (jarray)pEnv->GetObjectArrayElement(array, i);
+            if(row == NULL || pEnv->ExceptionCheck() == JNI_TRUE)
+                return false;
 
-    //string back and forth
-    jstring GetJavaString(JNIEnv* pEnv, const char* nString)
-    {
-        return pEnv->NewStringUTF(nString);
+            CopyRowOut(pEnv, kind, row, pLengths[i], pRows[i]);
+            pEnv->DeleteLocalRef(row);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return false;
+        }
+        return true;
     }
 
-    const char* GetNetString(JNIEnv* pEnv, jstring jString)
+    static bool SetMatrixRange(JNIEnv* pEnv, jobjectArray array, char kind, int from, int to, void** pRows, const int* pLengths)
     {
-        std::mutex mutex;
-        mutex.lock();
+        for(int i = from; i < to; i++)
+        {
+            if(pLengths[i] < 0)
+                continue;
 
-        if(jString == (jstring)0){
-            mutex.unlock();
-            return "";
+            jarray row = NewRowFrom(pEnv, kind, pLengths[i], pRows[i]);
+            if(row == NULL || pEnv->ExceptionCheck() == JNI_TRUE)
+                return false;
+
+            pEnv->SetObjectArrayElement(array, i, row);
+            pEnv->DeleteLocalRef(row);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return false;
         }
-        const char* res = pEnv->GetStringUTFChars(jString, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
-            return "";
+        return true;
+    }
+
+    typedef bool (*MatrixRangeFn)(JNIEnv*, jobjectArray, char, int, int, void**, const int*);
+
+    //Runs fn over all the rows, on worker threads when the matrix is large enough. Returns -1 with an exception pending on failure.
+    static long long MatrixBytes(char kind, int rows, const int* pLengths)
+    {
+        long long bytes = 0;
+        for(int i = 0; i < rows; i++)
+        {
+            if(pLengths[i] > 0)
+                bytes += (long long)pLengths[i] * MatrixElementSize(kind);
         }
-        mutex.unlock();
-        return res;
+        return bytes;
     }
 
-    const char* GetException(JNIEnv* pEnv)
+    static int ForMatrixRows(JNIEnv* pEnv, MatrixRangeFn fn, jobjectArray array, char kind, int rows, void** pRows, const int* pLengths, int threads)
     {
-        // return "error when getting error !";
+        long long bytes = MatrixBytes(kind, rows, pLengths);
 
-        jthrowable exception = pEnv->ExceptionOccurred();
+        int n = threads;
+        if(n > MATRIX_MAX_THREADS)
+            n = MATRIX_MAX_THREADS;
+        if(n > rows)
+            n = rows;
+        if((long long)n * MATRIX_THREAD_BYTES > bytes)
+            n = (int)(bytes / MATRIX_THREAD_BYTES);
 
-        pEnv->ExceptionClear();
+        JavaVM* pVM = NULL;
+        jobjectArray shared = NULL;
+        std::atomic<bool> failed(false);
+        std::vector<std::thread> workers;
+        int chunk = rows;
 
-        jclass clr_runtime_class = pEnv->FindClass("app/quant/clr/CLRRuntime");
-        jmethodID mid_clr_getError =
-            pEnv->GetStaticMethodID(clr_runtime_class,
-                            "GetError",
-                            "(Ljava/lang/Exception;)Ljava/lang/String;");
+        if(n >= 2 && bytes >= MATRIX_PARALLEL_BYTES && pEnv->GetJavaVM(&pVM) == JNI_OK)
+            shared = (jobjectArray)pEnv->NewGlobalRef(array);
 
-        int len = 1;
-        void** args = (void**)malloc(sizeof(void *) * len);
+        if(shared != NULL)
+            chunk = (rows + n - 1) / n;
 
-        for(int i = 0; i < len; i++)
-            args[i] = exception;
+        for(int from = chunk; shared != NULL && from < rows; from += chunk)
+        {
+            int to = from + chunk < rows ? from + chunk : rows;
+            workers.push_back(std::thread([pVM, fn, shared, kind, from, to, pRows, pLengths, &failed]()
+            {
+                JNIEnv* pWorkerEnv = NULL;
+                JavaVMAttachArgs args;
+                args.version = JNI_VERSION_1_6;
+                args.name = (char*)"CLR matrix copy";
+                args.group = NULL;
+
+                if(pVM->AttachCurrentThreadAsDaemon((void**)&pWorkerEnv, &args) != JNI_OK)
+                {
+                    failed = true;
+                    return;
+                }
+
+                if(!fn(pWorkerEnv, shared, kind, from, to, pRows, pLengths))
+                {
+                    pWorkerEnv->ExceptionClear();
+                    failed = true;
+                }
+                pVM->DetachCurrentThread();
+            }));
+        }
 
-        jstring jString = (jstring)pEnv->CallStaticObjectMethodA( clr_runtime_class, mid_clr_getError, (const jvalue*)args);
+        bool ok = fn(pEnv, array, kind, 0, chunk, pRows, pLengths);
 
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        for(size_t i = 0; i < workers.size(); i++)
+            workers[i].join();
+        if(shared != NULL)
+            pEnv->DeleteGlobalRef(shared);
+
+        if(!ok || failed)
         {
-            //pEnv->ExceptionDescribe();
-            // free(args);
-            return "error when getting error !";
-        }
-        
-        if(jString == (jstring)0){
-            return "error when getting error !!";
+            if(pEnv->ExceptionCheck() != JNI_TRUE)
+                ThrowNewException(pEnv, "matrix rows could not be copied");
+            return -1;
         }
-        
-        const char* res = pEnv->GetStringUTFChars(jString, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            return "error when getting error !!!";
+        return 0;
+    }
+
+    //Fills pLengths with the length of each row of array, -1 for a null row. -2 if a row is not an array of sType.
+    int GetMatrixShape(JNIEnv* pEnv, jobjectArray array, const char* sType, int rows, int* pLengths)
+    {
+        JNI_METRIC(pEnv);
+        if(array == NULL || MatrixElementSize(sType[0]) == 0 || ArrayKind(pEnv, array, GetJNICache(pEnv)) != 'L')
+            return -2;
+        if(rows > pEnv->GetArrayLength(array))
+            return -2;
+
+        for(int i = 0; i < rows; i++)
+        {
+            jarray row = (jarray)pEnv->GetObjectArrayElement(array, i);
+            if(pEnv->ExceptionCheck() == JNI_TRUE)
+                return -1;
+
+            if(row == NULL)
+            {
+                pLengths[i] = -1;
+                continue;
+            }
+
+            bool match = IsArrayOfType(pEnv, row, sType);
+            pLengths[i] = match ? pEnv->GetArrayLength(row) : 0;
+            pEnv->DeleteLocalRef(row);
+            if(!match)
+                return -2;
         }
-        return res;
+        return 0;
     }
 
-    //object array
+    //Copies every row of array into pRows[i], which must hold pLengths[i] elements as returned by GetMatrixShape.
+    int GetMatrixRows(JNIEnv* pEnv, jobjectArray array, const char* sType, int rows, void** pRows, const int* pLengths, int threads)
+    {
+        JNI_METRIC(pEnv);
+        if(array == NULL || MatrixElementSize(sType[0]) == 0)
+            return -2;
+
+        JNI_METRIC_BYTES(MatrixBytes(sType[0], rows, pLengths));
+        return ForMatrixRows(pEnv, GetMatrixRange, array, sType[0], rows, pRows, pLengths, threads);
+    }
 
-    int NewObjectArrayP(JNIEnv* pEnv, int nDimension, jclass cls, jobjectArray* pArray )
+    //Creates a sType[][] with rows rows, row i holding the pLengths[i] elements at pRows[i] (null when the length is -1).
+    int NewMatrix(JNIEnv* pEnv, const char* sType, int rows, void** pRows, const int* pLengths, int threads, jobjectArray* pArray)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        *pArray = NULL;
 
-        *pArray = pEnv->NewObjectArray( nDimension, cls, NULL);
+        jclass rowClass = ArrayClassFor(GetJNICache(pEnv), sType);
+        if(rowClass == NULL || MatrixElementSize(sType[0]) == 0)
+            return -2;
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
+        jobjectArray array = pEnv->NewObjectArray(rows, rowClass, NULL);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || array == NULL)
             return -1;
-        }
 
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
-            return -2;
+        JNI_METRIC_BYTES(MatrixBytes(sType[0], rows, pLengths));
+        if(ForMatrixRows(pEnv, SetMatrixRange, array, sType[0], rows, pRows, pLengths, threads) != 0)
+        {
+            pEnv->DeleteLocalRef(array);
+            return -1;
+        }
 
+        *pArray = array;
+        TrackLocalRef(*pArray);
+        return 0;
     }
-    
-    int NewObjectArray(JNIEnv* pEnv, int nDimension, const char* szType, jobjectArray* pArray )
+
+    //field layouts
+    /*
+    The instance fields of a Java class resolved once and mapped onto a packed native struct, so all the fields of an
+    object move in a single call instead of a lookup and a crossing each. An entry is the field ID, its kind
+    ('Z','B','C','S','I','J','F','D', or 'L' for any reference, stored as a jobject) and its byte offset in the struct.
+    The offsets come from the caller, so .NET lays the struct out as its own blittable type. Values are copied with
+    memcpy and the struct may be packed.
+    */
+
+    struct FieldLayoutEntry
     {
-        std::mutex mutex;
-        mutex.lock();
+        jfieldID fid;
+        jclass type;
+        char kind;
+        int offset;
+    };
 
-        *pArray = pEnv->NewObjectArray( nDimension, pEnv->FindClass( szType ), NULL);
+    struct FieldLayout
+    {
+        jclass cls;
+        std::vector<FieldLayoutEntry> fields;
+    };
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+    static void DeleteFieldLayout(JNIEnv* pEnv, FieldLayout* layout)
+    {
+        for(size_t i = 0; i < layout->fields.size(); i++)
+        {
+            if(layout->fields[i].type != NULL)
+                pEnv->DeleteGlobalRef(layout->fields[i].type);
         }
+        if(layout->cls != NULL)
+            pEnv->DeleteGlobalRef(layout->cls);
+        delete layout;
+    }
 
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
+    //Reference fields take whatever type the Java field declares, looked up through CLRRuntime.FieldType.
+    static int ReferenceFieldType(JNIEnv* pEnv, jclass cls, const char* szName, jclass* pType, std::string& signature)
+    {
+        BridgeCache* bridge = GetBridgeCache(pEnv);
+        if(bridge == NULL || bridge->midCLRRuntimeFieldType == NULL || bridge->midCLRRuntimeTransformType == NULL)
             return -2;
 
-    }
+        jstring name = pEnv->NewStringUTF(szName);
+        if(name == NULL)
+            return -1;
 
-    int SetObjectArrayElement(JNIEnv* pEnv, jobjectArray pArray, int index, jobject value)
-    {
-        std::mutex mutex;
-        mutex.lock();
+        jclass type = (jclass)pEnv->CallStaticObjectMethod(bridge->clsCLRRuntime, bridge->midCLRRuntimeFieldType, cls, name);
+        pEnv->DeleteLocalRef(name);
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            return -1;
+        if(type == NULL)
+            return -2;
 
-        pEnv->SetObjectArrayElement(pArray, index, value);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        jstring sig = (jstring)pEnv->CallStaticObjectMethod(bridge->clsCLRRuntime, bridge->midCLRRuntimeTransformType, type);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || sig == NULL)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            pEnv->DeleteLocalRef(type);
+            return pEnv->ExceptionCheck() == JNI_TRUE ? -1 : -2;
         }
-        else
+
+        const char* chars = pEnv->GetStringUTFChars(sig, NULL);
+        signature = chars;
+        pEnv->ReleaseStringUTFChars(sig, chars);
+        pEnv->DeleteLocalRef(sig);
+
+        if(signature[0] != 'L' && signature[0] != '[')
         {
-            mutex.unlock();
-            return 0;
+            pEnv->DeleteLocalRef(type);
+            return -2;
         }
+
+        *pType = (jclass)pEnv->NewGlobalRef(type);
+        pEnv->DeleteLocalRef(type);
+        return 0;
     }
 
-    int GetObjectArrayElement(JNIEnv* pEnv, jobjectArray pArray, int index, jobject* pobj)
+    int NewFieldLayout(JNIEnv* pEnv, jclass cls, int count, const char** names, const char* kinds, const int* offsets, void** ppLayout)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        if(cls == NULL || count < 0 || (count > 0 && (names == NULL || kinds == NULL || offsets == NULL)))
+            return -2;
 
-        jobject val = pEnv->GetObjectArrayElement(pArray, index);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        FieldLayout* layout = new FieldLayout();
+        layout->cls = NULL;
+        layout->fields.resize(count);
+        for(int i = 0; i < count; i++)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            FieldLayoutEntry& entry = layout->fields[i];
+            entry.type = NULL;
+            entry.kind = kinds[i];
+            entry.offset = offsets[i];
+
+            int res = 0;
+            std::string signature;
+            switch(entry.kind)
+            {
+                case 'Z': case 'B': case 'C': case 'S': case 'I': case 'J': case 'F': case 'D':
+                    signature = std::string(1, entry.kind);
+                    break;
+                case 'L':
+                    res = ReferenceFieldType(pEnv, cls, names[i], &entry.type, signature);
+                    break;
+                default:
+                    res = -2;
+                    break;
+            }
+
+            if(res == 0)
+            {
+                entry.fid = pEnv->GetFieldID(cls, names[i], signature.c_str());
+                if(pEnv->ExceptionCheck() == JNI_TRUE)
+                    res = -1;
+            }
+
+            if(res != 0)
+            {
+                DeleteFieldLayout(pEnv, layout);
+                return res;
+            }
         }
-        else
-            *pobj = val;
 
-        mutex.unlock();
+        layout->cls = (jclass)pEnv->NewGlobalRef(cls);
+        *ppLayout = layout;
         return 0;
     }
 
-    //int array
-    int NewIntArray(JNIEnv* pEnv, int nDimension, jintArray* pArray )
+    int FreeFieldLayout(JNIEnv* pEnv, void* pLayout)
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        *pArray = pEnv->NewIntArray(nDimension);
-        
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
+        JNI_METRIC(pEnv);
+        FieldLayout* layout = (FieldLayout*)pLayout;
+        if(layout == NULL)
             return -2;
 
+        DeleteFieldLayout(pEnv, layout);
+        return 0;
     }
 
-    int SetIntArrayElement(JNIEnv* pEnv, jintArray pArray, int index, int value)
+    //Reference fields come back as tracked local references, NULL for null. -2 when obj is not an instance of the layout's class.
+    int GetFields(JNIEnv* pEnv, void* pLayout, jobject obj, void* pStruct)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        FieldLayout* layout = (FieldLayout*)pLayout;
+        if(layout == NULL || obj == NULL || pStruct == NULL)
+            return -2;
+        //The field IDs belong to the layout's class, JNI does not check them against obj.
+        if(pEnv->IsInstanceOf(obj, layout->cls) != JNI_TRUE)
+            return -2;
 
-        const jint elements[] = { value };
-        pEnv->SetIntArrayRegion(pArray, index, 1, elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        char* base = (char*)pStruct;
+        for(size_t i = 0; i < layout->fields.size(); i++)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            const FieldLayoutEntry& entry = layout->fields[i];
+            char* p = base + entry.offset;
+            switch(entry.kind)
+            {
+                case 'Z': { jboolean v = pEnv->GetBooleanField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                case 'B': { jbyte v = pEnv->GetByteField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                case 'C': { jchar v = pEnv->GetCharField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                case 'S': { jshort v = pEnv->GetShortField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                case 'I': { jint v = pEnv->GetIntField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                case 'J': { jlong v = pEnv->GetLongField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                case 'F': { jfloat v = pEnv->GetFloatField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                case 'D': { jdouble v = pEnv->GetDoubleField(obj, entry.fid); memcpy(p, &v, sizeof(v)); break; }
+                default:
+                {
+                    jobject v = pEnv->GetObjectField(obj, entry.fid);
+                    if(v != NULL)
+                        TrackLocalRef(v);
+                    memcpy(p, &v, sizeof(v));
+                    break;
+                }
+            }
         }
-        
-        mutex.unlock();
-        return 0;
+
+        return pEnv->ExceptionCheck() == JNI_TRUE ? -1 : 0;
     }
 
-    int GetIntArrayElement(JNIEnv* pEnv, jintArray pArray, int index)
+    int SetFields(JNIEnv* pEnv, void* pLayout, jobject obj, const void* pStruct)
     {
-        jint *val = pEnv->GetIntArrayElements(pArray, 0);
-        return val[index];
+        JNI_METRIC(pEnv);
+        FieldLayout* layout = (FieldLayout*)pLayout;
+        if(layout == NULL || obj == NULL || pStruct == NULL)
+            return -2;
+        //The field IDs belong to the layout's class, JNI does not check them against obj.
+        if(pEnv->IsInstanceOf(obj, layout->cls) != JNI_TRUE)
+            return -2;
+
+        const char* base = (const char*)pStruct;
+        for(size_t i = 0; i < layout->fields.size(); i++)
+        {
+            const FieldLayoutEntry& entry = layout->fields[i];
+            const char* p = base + entry.offset;
+            switch(entry.kind)
+            {
+                case 'Z': { jboolean v; memcpy(&v, p, sizeof(v)); pEnv->SetBooleanField(obj, entry.fid, v); break; }
+                case 'B': { jbyte v; memcpy(&v, p, sizeof(v)); pEnv->SetByteField(obj, entry.fid, v); break; }
+                case 'C': { jchar v; memcpy(&v, p, sizeof(v)); pEnv->SetCharField(obj, entry.fid, v); break; }
+                case 'S': { jshort v; memcpy(&v, p, sizeof(v)); pEnv->SetShortField(obj, entry.fid, v); break; }
+                case 'I': { jint v; memcpy(&v, p, sizeof(v)); pEnv->SetIntField(obj, entry.fid, v); break; }
+                case 'J': { jlong v; memcpy(&v, p, sizeof(v)); pEnv->SetLongField(obj, entry.fid, v); break; }
+                case 'F': { jfloat v; memcpy(&v, p, sizeof(v)); pEnv->SetFloatField(obj, entry.fid, v); break; }
+                case 'D': { jdouble v; memcpy(&v, p, sizeof(v)); pEnv->SetDoubleField(obj, entry.fid, v); break; }
+                default:
+                {
+                    //JNI does not check the type of a stored reference, a wrong one would corrupt the object.
+                    jobject v;
+                    memcpy(&v, p, sizeof(v));
+                    if(v != NULL && pEnv->IsInstanceOf(v, entry.type) != JNI_TRUE)
+                    {
+                        ThrowNewException(pEnv, "SetFields: value does not match the type of the Java field");
+                        return -1;
+                    }
+                    pEnv->SetObjectField(obj, entry.fid, v);
+                    break;
+                }
+            }
+        }
+
+        return pEnv->ExceptionCheck() == JNI_TRUE ? -1 : 0;
     }
 
-    //long array
-    int NewLongArray(JNIEnv* pEnv, int nDimension, jlongArray* pArray )
+    /*
+    Builds a Java object straight from the struct. No constructor runs (AllocObject), every mapped field is then set
+    from the struct and the others keep their default values, as for a deserialized object.
+    */
+
+    int NewObjectFromFields(JNIEnv* pEnv, void* pLayout, const void* pStruct, jobject* pObj)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        FieldLayout* layout = (FieldLayout*)pLayout;
+        if(layout == NULL || pStruct == NULL)
+            return -2;
 
-        *pArray = pEnv->NewLongArray( nDimension);
+        jobject obj = pEnv->AllocObject(layout->cls);
+        if(obj == NULL)
+            return pEnv->ExceptionCheck() == JNI_TRUE ? -1 : -2;
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        int res = SetFields(pEnv, pLayout, obj, pStruct);
+        if(res != 0)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            pEnv->DeleteLocalRef(obj);
+            return res;
         }
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
-            return -2;
 
+        TrackLocalRef(obj);
+        *pObj = obj;
+        return 0;
     }
 
-    int SetLongArrayElement(JNIEnv* pEnv, jlongArray pArray, int index, long value)
+    //handle table
+    /*
+    Object identity shared by both runtimes. A handle is 64 bits: the slot index in the low half and the slot's
+    generation in the high half. The generation is odd while the slot is live and moves on every allocate and free,
+    so a stale or doubly freed handle never resolves to whatever reuses its slot.
+    Slots sit in slabs that are allocated on demand and never move or go away, so a lookup is a shift and a mask.
+    Allocate and free are lock free: freed slots go on a tagged stack, fresh ones come from a bump counter.
+
+    The bridge keys its maps by int, so each handle also has a 31 bit ID: the slot index in the low 22 bits and the
+    low 9 bits of the slot's use count above it. 0 stays the null ID. A slot is retired instead of reused once that
+    count is about to wrap, which means an ID is never handed out twice.
+    That bounds the process to about 2^31 object IDs over its lifetime (4M slots, 512 uses each), with at most 4M live
+    at once. Past that NewHandle returns 0 and CreateID fails on both sides; a random ID could collide with one still
+    held, so there is no fallback.
+    */
+
+    static const int HANDLE_SLAB_SHIFT = 12;
+    static const uint32_t HANDLE_SLAB_SIZE = 1u << HANDLE_SLAB_SHIFT;
+    static const int HANDLE_INDEX_BITS = 22;
+    static const uint32_t HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BITS) - 1;
+    static const uint32_t HANDLE_TAG_MASK = 0x1ff;
+    static const uint32_t HANDLE_NONE = 0xffffffff;
+
+    struct HandleSlot
     {
-        std::mutex mutex;
-        mutex.lock();
+        std::atomic<uint32_t> generation;
+        std::atomic<uint32_t> next;
+        std::atomic<void*> value;
+        std::atomic<int32_t> refs;
+    };
+
+    static std::atomic<HandleSlot*> g_handleSlabs[(HANDLE_INDEX_MASK + 1) >> HANDLE_SLAB_SHIFT];
+    static std::atomic<uint32_t> g_handleNext(1);
+    //Free list head: pop count in the high half against ABA, slot index in the low half.
+    static std::atomic<uint64_t> g_handleFree(HANDLE_NONE);
+
+    static HandleSlot* HandleSlotAt(uint32_t index)
+    {
+        HandleSlot* slab = g_handleSlabs[index >> HANDLE_SLAB_SHIFT].load(std::memory_order_acquire);
+        return slab == NULL ? NULL : &slab[index & (HANDLE_SLAB_SIZE - 1)];
+    }
 
-        const jlong elements[] = { value };
-        pEnv->SetLongArrayRegion(pArray, index, 1, elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+    static HandleSlot* NewHandleSlot(uint32_t index)
+    {
+        std::atomic<HandleSlot*>& entry = g_handleSlabs[index >> HANDLE_SLAB_SHIFT];
+        HandleSlot* slab = entry.load(std::memory_order_acquire);
+        if(slab == NULL)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            HandleSlot* fresh = new HandleSlot[HANDLE_SLAB_SIZE]();
+            if(entry.compare_exchange_strong(slab, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+                slab = fresh;
+            else
+                delete[] fresh;
         }
-        mutex.unlock();
-        return 0;
+        return &slab[index & (HANDLE_SLAB_SIZE - 1)];
     }
 
-    long GetLongArrayElement(JNIEnv* pEnv, jlongArray pArray, int index)
+    static uint32_t PopFreeHandle()
     {
-        std::mutex mutex;
-        mutex.lock();
-
-        jlong *val = pEnv->GetLongArrayElements(pArray, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -666;
+        uint64_t head = g_handleFree.load(std::memory_order_acquire);
+        while((uint32_t)head != HANDLE_NONE)
+        {
+            uint32_t next = HandleSlotAt((uint32_t)head)->next.load(std::memory_order_relaxed);
+            uint64_t popped = (((head >> 32) + 1) << 32) | next;
+            if(g_handleFree.compare_exchange_weak(head, popped, std::memory_order_acq_rel, std::memory_order_acquire))
+                return (uint32_t)head;
         }
+        return HANDLE_NONE;
+    }
 
-        mutex.unlock();
-        return val[index];
+    static void PushFreeHandle(uint32_t index, HandleSlot* slot)
+    {
+        uint64_t head = g_handleFree.load(std::memory_order_relaxed);
+        do
+        {
+            slot->next.store((uint32_t)head, std::memory_order_relaxed);
+        }
+        while(!g_handleFree.compare_exchange_weak(head, (head & 0xffffffff00000000ULL) | index, std::memory_order_release, std::memory_order_relaxed));
     }
 
-    //float array
-    int NewFloatArray(JNIEnv* pEnv, int nDimension, jfloatArray* pArray )
+    static HandleSlot* LiveHandleSlot(jlong handle, uint32_t* pGeneration)
     {
-        std::mutex mutex;
-        mutex.lock();
+        uint32_t index = (uint32_t)handle;
+        uint32_t generation = (uint32_t)((uint64_t)handle >> 32);
+        if(index == 0 || index > HANDLE_INDEX_MASK || (generation & 1) == 0)
+            return NULL;
 
-        *pArray = pEnv->NewFloatArray( nDimension);
+        HandleSlot* slot = HandleSlotAt(index);
+        if(slot == NULL || slot->generation.load(std::memory_order_acquire) != generation)
+            return NULL;
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        *pGeneration = generation;
+        return slot;
+    }
+
+    //Returns 0 once all 4M slots are live or retired.
+    jlong NewHandle(void* value)
+    {
+        uint32_t index = PopFreeHandle();
+        HandleSlot* slot;
+        if(index != HANDLE_NONE)
+            slot = HandleSlotAt(index);
+        else
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            if(g_handleNext.load(std::memory_order_relaxed) > HANDLE_INDEX_MASK)
+                return 0;
+            index = g_handleNext.fetch_add(1, std::memory_order_relaxed);
+            if(index > HANDLE_INDEX_MASK)
+                return 0;
+            slot = NewHandleSlot(index);
         }
 
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
+        slot->value.store(value, std::memory_order_relaxed);
+        slot->refs.store(1, std::memory_order_relaxed);
+        uint32_t generation = slot->generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+        return (jlong)(((uint64_t)generation << 32) | index);
+    }
+
+    int FreeHandle(jlong handle)
+    {
+        uint32_t generation;
+        HandleSlot* slot = LiveHandleSlot(handle, &generation);
+        if(slot == NULL || !slot->generation.compare_exchange_strong(generation, generation + 1, std::memory_order_acq_rel))
             return -2;
 
+        slot->value.store(NULL, std::memory_order_relaxed);
+        if(((generation >> 1) & HANDLE_TAG_MASK) != HANDLE_TAG_MASK)
+            PushFreeHandle((uint32_t)handle, slot);
+        return 0;
     }
 
-    int SetFloatArrayElement(JNIEnv* pEnv, jfloatArray pArray, int index, float value)
+    int GetHandleValue(jlong handle, void** pValue)
     {
-        std::mutex mutex;
-        mutex.lock();
+        uint32_t generation;
+        HandleSlot* slot = LiveHandleSlot(handle, &generation);
+        if(slot == NULL)
+            return -2;
 
-        float elements[] = { value };
-        pEnv->SetFloatArrayRegion(pArray, index, 1, elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
+        void* value = slot->value.load(std::memory_order_acquire);
+        if(slot->generation.load(std::memory_order_acquire) != generation)
+            return -2;
+
+        *pValue = value;
         return 0;
     }
 
-    float GetFloatArrayElement(JNIEnv* pEnv, jfloatArray pArray, int index)
+    int SetHandleValue(jlong handle, void* value)
     {
-        std::mutex mutex;
-        mutex.lock();
+        uint32_t generation;
+        HandleSlot* slot = LiveHandleSlot(handle, &generation);
+        if(slot == NULL)
+            return -2;
 
-        float *val = pEnv->GetFloatArrayElements(pArray, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -666;
-        }
-        mutex.unlock();
-        return val[index];
+        slot->value.store(value, std::memory_order_release);
+        return 0;
     }
 
-    //double array
-    int NewDoubleArray(JNIEnv* pEnv, int nDimension, jdoubleArray* pArray )
+    jint HandleToID(jlong handle)
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(handle == 0)
+            return 0;
 
-        *pArray = pEnv->NewDoubleArray( nDimension);
+        uint32_t generation = (uint32_t)((uint64_t)handle >> 32);
+        return (jint)((((generation >> 1) & HANDLE_TAG_MASK) << HANDLE_INDEX_BITS) | ((uint32_t)handle & HANDLE_INDEX_MASK));
+    }
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE)
-        {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
-        }
+    //Returns the live handle behind an ID, or 0 if the ID was freed or never came from the table.
+    jlong HandleFromID(jint id)
+    {
+        uint32_t index = (uint32_t)id & HANDLE_INDEX_MASK;
+        if(id <= 0 || index == 0)
+            return 0;
 
-        mutex.unlock();
-        if( pArray != NULL )
+        HandleSlot* slot = HandleSlotAt(index);
+        if(slot == NULL)
+            return 0;
+
+        uint32_t generation = slot->generation.load(std::memory_order_acquire);
+        if((generation & 1) == 0 || ((generation >> 1) & HANDLE_TAG_MASK) != ((uint32_t)id >> HANDLE_INDEX_BITS))
             return 0;
-        else
-            return -2;
 
+        return (jlong)(((uint64_t)generation << 32) | index);
     }
 
-    int SetDoubleArrayElement(JNIEnv* pEnv, jdoubleArray pArray, int index, double value)
+    //reference lifetime
+    /*
+    Every handle starts with a count of one, RetainHandle and ReleaseHandle move it. NewGlobalHandle puts a global or
+    weak global reference behind a handle so native and .NET code can keep a Java object without a map on the Java side.
+    Releasing never touches the JVM. The last ReleaseHandle, and ReleaseID for the object IDs .NET drops from its
+    finalizers, push onto a lock free list. A daemon thread attached to the JVM sleeps until the list stops being empty,
+    takes all of it at once and frees it as one batch: references are deleted and the IDs go to CLRRuntime.RemoveIDs
+    in a single call.
+    RemoveIDs only drops the strong reference Java keeps for .NET. The object may still be alive and cross again under
+    the same ID, so the ID's slot is freed by nativeReleaseObjects once CallbackRef sees the object collected, the
+    same path every other Java side registry is cleared on. IDs that cannot be handed to Java yet are kept for the
+    next batch.
+    */
+
+    struct ReleaseNode
+    {
+        jlong handle;
+        jint id;
+        ReleaseNode* next;
+    };
+
+    static std::atomic<ReleaseNode*> g_releaseList(NULL);
+    static std::atomic<JavaVM*> g_releaseVM(NULL);
+    static std::once_flag g_releaseThreadOnce;
+    //Only taken to sleep and to wake the release thread, never to queue.
+    static std::mutex g_releaseLock;
+    static std::condition_variable g_releaseReady;
+    //Only touched by the release thread.
+    static std::vector<jint> g_releaseIDs;
+
+    static void FreeReleases(JNIEnv* pEnv, ReleaseNode* node)
     {
-        std::mutex mutex;
-        mutex.lock();
+        std::vector<jint>& ids = g_releaseIDs;
+        while(node != NULL)
+        {
+            ReleaseNode* next = node->next;
+            if(node->handle != 0)
+            {
+                void* ref;
+                if(GetHandleValue(node->handle, &ref) == 0 && ref != NULL)
+                {
+                    if(pEnv->GetObjectRefType((jobject)ref) == JNIWeakGlobalRefType)
+                        pEnv->DeleteWeakGlobalRef((jweak)ref);
+                    else
+                        pEnv->DeleteGlobalRef((jobject)ref);
+                }
+                FreeHandle(node->handle);
+            }
+            else
+                ids.push_back(node->id);
 
-        double elements[] = { value };
-        pEnv->SetDoubleArrayRegion(pArray, index, 1, elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+            delete node;
+            node = next;
+        }
+
+        if(ids.empty())
+            return;
+
+        //Looked up again on every batch until CLRRuntime is loadable, the IDs wait for it.
+        BridgeCache* bridge = GetBridgeCache(pEnv);
+        if(bridge == NULL)
+            return;
+
+        if(bridge->midCLRRuntimeRemoveIDs == NULL)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            printf("JNIWrapper: CLRRuntime.RemoveIDs not found, %d Java objects stay referenced\n", (int)ids.size());
+            ids.clear();
+            return;
         }
-        mutex.unlock();
-        return 0;
+
+        jintArray array = pEnv->NewIntArray((jsize)ids.size());
+        if(array != NULL)
+        {
+            pEnv->SetIntArrayRegion(array, 0, (jsize)ids.size(), &ids[0]);
+            pEnv->CallStaticVoidMethod(bridge->clsCLRRuntime, bridge->midCLRRuntimeRemoveIDs, array);
+            pEnv->DeleteLocalRef(array);
+        }
+
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            pEnv->ExceptionClear();
+        else if(array != NULL)
+            ids.clear();
     }
 
-    double GetDoubleArrayElement(JNIEnv* pEnv, jdoubleArray pArray, int index)
+    static void ReleaseThread()
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNIEnv* pEnv = NULL;
+        JavaVMAttachArgs args;
+        args.version = JNI_VERSION_1_6;
+        args.name = (char*)"CLR release";
+        args.group = NULL;
 
-        double *val = pEnv->GetDoubleArrayElements(pArray, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -666;
+        if(g_releaseVM.load()->AttachCurrentThreadAsDaemon((void**)&pEnv, &args) != JNI_OK)
+        {
+            printf("JNIWrapper: release thread not attached, references will not be freed\n");
+            return;
+        }
+
+        while(true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(g_releaseLock);
+                g_releaseReady.wait(lock, []{ return g_releaseList.load(std::memory_order_acquire) != NULL; });
+            }
+            FreeReleases(pEnv, g_releaseList.exchange(NULL, std::memory_order_acq_rel));
         }
-        mutex.unlock();
-        return val[index];
     }
 
-    //boolean array
-    int NewBooleanArray(JNIEnv* pEnv, int nDimension, jbooleanArray* pArray )
+    static void StartReleaseThread()
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(g_releaseVM.load() != NULL)
+            std::call_once(g_releaseThreadOnce, []{ std::thread(ReleaseThread).detach(); });
+    }
 
-        *pArray = pEnv->NewBooleanArray( nDimension);
+    static void PushRelease(jlong handle, jint id)
+    {
+        ReleaseNode* node = new ReleaseNode();
+        node->handle = handle;
+        node->id = id;
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        ReleaseNode* head = g_releaseList.load(std::memory_order_relaxed);
+        do
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            node->next = head;
         }
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
-            return -2;
+        while(!g_releaseList.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
 
+        //Only the push that finds the list empty has to wake the thread, the others are picked up with it.
+        if(head == NULL)
+        {
+            StartReleaseThread();
+            std::lock_guard<std::mutex> lock(g_releaseLock);
+            g_releaseReady.notify_one();
+        }
     }
 
-    int SetBooleanArrayElement(JNIEnv* pEnv, jbooleanArray pArray, int index, bool value)
+    int NewGlobalHandle(JNIEnv* pEnv, jobject obj, int weak, jlong* pHandle)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        jobject ref = weak != 0 ? pEnv->NewWeakGlobalRef(obj) : pEnv->NewGlobalRef(obj);
+        if(ref == NULL)
+            return pEnv->ExceptionCheck() == JNI_TRUE ? -1 : -2;
 
-        jboolean elements[] = { value };
-        pEnv->SetBooleanArrayRegion(pArray, index, 1, elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        *pHandle = NewHandle(ref);
+        if(*pHandle == 0)
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            if(weak != 0)
+                pEnv->DeleteWeakGlobalRef(ref);
+            else
+                pEnv->DeleteGlobalRef(ref);
+            return -2;
         }
-        mutex.unlock();
         return 0;
     }
 
-    bool GetBooleanArrayElement(JNIEnv* pEnv, jbooleanArray pArray, int index)
+    //Returns a local reference to the object behind the handle, -2 if the handle is stale or its weak referent is gone.
+    int GetGlobalHandle(JNIEnv* pEnv, jlong handle, jobject* pObj)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        void* ref;
+        if(GetHandleValue(handle, &ref) != 0 || ref == NULL)
+            return -2;
 
-        jboolean *val = pEnv->GetBooleanArrayElements(pArray, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
-            return false;
-        }
-        mutex.unlock();
-        return (bool)val[index];
+        *pObj = pEnv->NewLocalRef((jobject)ref);
+        if(*pObj == NULL)
+            return -2;
+
+        TrackLocalRef(*pObj);
+        return 0;
     }
 
-    
-    //byte array
-    int NewByteArray(JNIEnv* pEnv, int nDimension, jbyteArray* pArray )
+    int RetainHandle(jlong handle)
     {
-        std::mutex mutex;
-        mutex.lock();
-        *pArray = pEnv->NewByteArray( nDimension);
+        uint32_t generation;
+        HandleSlot* slot = LiveHandleSlot(handle, &generation);
+        if(slot == NULL)
+            return -2;
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE)
+        int32_t refs = slot->refs.load(std::memory_order_relaxed);
+        do
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            if(refs <= 0)
+                return -2;
         }
-
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
-            return -2;
-
+        while(!slot->refs.compare_exchange_weak(refs, refs + 1, std::memory_order_relaxed));
+        return 0;
     }
 
-    int SetByteArrayElement(JNIEnv* pEnv, jbyteArray pArray, int index, jbyte value)
+    int ReleaseHandle(jlong handle)
     {
-        std::mutex mutex;
-        mutex.lock();
+        uint32_t generation;
+        HandleSlot* slot = LiveHandleSlot(handle, &generation);
+        if(slot == NULL)
+            return -2;
 
-        jbyte elements[] = { value };
-        pEnv->SetByteArrayRegion(pArray, index, 1, elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
+        int32_t refs = slot->refs.load(std::memory_order_relaxed);
+        do
         {
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return -1;
+            if(refs <= 0)
+                return -2;
         }
-        mutex.unlock();
+        while(!slot->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_acq_rel));
+
+        if(refs == 1)
+            PushRelease(handle, 0);
         return 0;
     }
 
-    jbyte GetByteArrayElement(JNIEnv* pEnv, jbyteArray pArray, int index)
+    //Queues an object ID .NET no longer uses. Safe from any thread, including ones the JVM has never seen.
+    int ReleaseID(jint id)
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(id == 0)
+            return -2;
 
-        jbyte *val = pEnv->GetByteArrayElements(pArray, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return val[index];
+        PushRelease(0, id);
+        return 0;
     }
 
+    void (*fnRemoveObjects)(void*, jint*, int);
 
-    //short array
-    int NewShortArray(JNIEnv* pEnv, int nDimension, jshortArray* pArray )
+    void SetfnRemoveObjects(void* cb)
     {
-        std::mutex mutex;
-        mutex.lock();
+        fnRemoveObjects = (void (*)(void*, jint*, int))cb;
+    }
 
-        *pArray = pEnv->NewShortArray( nDimension);
+    //Called by CallbackRef's release thread with every Java object collected since its last batch.
+    static void JNICALL CLRRuntime_nativeReleaseObjects(JNIEnv* pEnv, jclass cls, jintArray ids)
+    {
+        JNI_METRIC(pEnv);
+        jsize len = ids == NULL ? 0 : pEnv->GetArrayLength(ids);
+        if(len == 0)
+            return;
 
+        std::vector<jint> buffer(len);
+        pEnv->GetIntArrayRegion(ids, 0, len, &buffer[0]);
         if(pEnv->ExceptionCheck() == JNI_TRUE)
+            return;
+
+        if(fnRemoveObjects != NULL)
         {
-            mutex.unlock();
-            return -1;
+            CallbackScope callback;
+            fnRemoveObjects(pEnv, &buffer[0], len);
         }
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
-            return -2;
 
+        for(jsize i = 0; i < len; i++)
+            FreeHandle(HandleFromID(buffer[i]));
     }
 
-    int SetShortArrayElement(JNIEnv* pEnv, jshortArray pArray, int index, short value)
+    static jint JNICALL CLRRuntime_nativeCreateID(JNIEnv* pEnv, jclass cls)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        return HandleToID(NewHandle(NULL));
+    }
 
-        short elements[] = { value };
-        pEnv->SetShortArrayRegion(pArray, index, 1, elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
+    static jboolean JNICALL CLRRuntime_nativeReleaseID(JNIEnv* pEnv, jclass cls, jint id)
+    {
+        JNI_METRIC(pEnv);
+        return FreeHandle(HandleFromID(id)) == 0 ? JNI_TRUE : JNI_FALSE;
     }
 
-    short GetShortArrayElement(JNIEnv* pEnv, jshortArray pArray, int index)
+    static jlong JNICALL CLRRuntime_nativeHandleFromID(JNIEnv* pEnv, jclass cls, jint id)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        return HandleFromID(id);
+    }
 
-        short *val = pEnv->GetShortArrayElements(pArray, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
-            return -666;
-        }
-        return val[index];
+    static int RegisterHandleNatives(JNIEnv* pEnv)
+    {
+        static JNINativeMethod methods[] = {
+            { (char*)"nativeCreateID", (char*)"()I", (void*)CLRRuntime_nativeCreateID },
+            { (char*)"nativeReleaseID", (char*)"(I)Z", (void*)CLRRuntime_nativeReleaseID },
+            { (char*)"nativeHandleFromID", (char*)"(I)J", (void*)CLRRuntime_nativeHandleFromID },
+            { (char*)"nativeReleaseObjects", (char*)"([I)V", (void*)CLRRuntime_nativeReleaseObjects }
+        };
+
+        return RegisterCLRRuntimeNatives(pEnv, methods, sizeof(methods) / sizeof(methods[0]));
     }
 
-    //char array
-    int NewCharArray(JNIEnv* pEnv, int nDimension, jcharArray* pArray )
+    /*
+    Called when CLRRuntime loads the library in its static initializer.
+    */
+
+    JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* pVM, void* reserved)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNIEnv* pEnv;
+        if(pVM->GetEnv((void**)&pEnv, JNI_VERSION_1_6) != JNI_OK)
+            return JNI_ERR;
 
-        *pArray = pEnv->NewCharArray( nDimension);
+        if(RegisterCallbackNatives(pEnv) != 0)
+            printf("JNIWrapper: primitive callback natives not registered\n");
 
-        if(pEnv->ExceptionCheck() == JNI_TRUE)
-        {
-            mutex.unlock();
-            return -1;
-        }
+        if(RegisterHandleNatives(pEnv) != 0)
+            printf("JNIWrapper: handle table natives not registered\n");
 
-        mutex.unlock();
-        if( pArray != NULL )
-            return 0;
-        else
-            return -2;
+        //FindClass here goes through the loader of CLRRuntime, so the bridge entries resolve even off the class path.
+        if(GetBridgeCache(pEnv) == NULL)
+            printf("JNIWrapper: bridge classes not cached\n");
+
+        g_releaseVM.store(pVM);
+        StartReleaseThread();
 
+        return JNI_VERSION_1_6;
     }
 
-    int SetCharArrayElement(JNIEnv* pEnv, jcharArray pArray, int index, char value)
-    {
-        std::mutex mutex;
-        mutex.lock();
 
-        char elements[] = { value };
-        pEnv->SetCharArrayRegion(pArray, index, 1, (jchar *)elements);
-        if( pEnv->ExceptionCheck() == JNI_TRUE )
-        {
-            mutex.unlock();
-            return -1;
-        }
-        mutex.unlock();
-        return 0;
+    //direct buffers
+    /*
+    Memory handed to Java as a direct ByteBuffer in native byte order, without copying. Each buffer has a token:
+    - pinned: .NET memory held by a pinned GCHandle. fnReleasePin gets the handle back once Java drops the buffer.
+    - native: memory from the native pool. The caller owns it until ReleaseNativeBuffer and it stays alive while
+      Java still holds a view, so it can back long lived data shared by both sides.
+    CLRBuffer.Track queues a phantom reference on the Java side which calls nativeReleaseBuffer with the token.
+    */
+
+    void (*fnReleasePin)(void*);
+
+    void SetfnReleasePin(void* cb)
+    {
+        fnReleasePin = (void (*)(void*))cb;
     }
 
-    char GetCharArrayElement(JNIEnv* pEnv, jcharArray pArray, int index)
+    struct DirectBuffer
     {
-        std::mutex mutex;
-        mutex.lock();
+        void* address;
+        jlong capacity;
+        size_t allocated;   // pool block size, 0 for pinned memory
+        void* pin;          // GCHandle of pinned memory, NULL for native memory
+        int refs;           // owner (native memory only) plus live Java buffers
+    };
 
-        jchar *val = pEnv->GetCharArrayElements(pArray, 0);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            mutex.unlock();
-            return (char)-1;
-        }
-        mutex.unlock();
-        return val[index];
-    }
+    //The registry is split in shards by token so buffers created and released on different threads rarely share a lock.
+    static const int BUFFER_SHARDS = 16;
 
+    struct BufferShard
+    {
+        std::mutex lock;
+        std::unordered_map<jlong, DirectBuffer> buffers;
+    };
 
+    static BufferShard g_bufferShards[BUFFER_SHARDS];
+    static std::atomic<jlong> g_nextBufferToken(1);
 
+    static BufferShard& ShardFor(jlong token)
+    {
+        return g_bufferShards[token & (BUFFER_SHARDS - 1)];
+    }
 
+    //Power of two size classes from 4KB to 64MB are recycled up to 256MB in total. Larger blocks go straight to the allocator.
+    static const int BUFFER_POOL_MIN_SHIFT = 12;
+    static const int BUFFER_POOL_MAX_SHIFT = 26;
+    static const size_t BUFFER_POOL_MAX_CACHED = (size_t)256 << 20;
+    static const size_t BUFFER_ALIGNMENT = 64;
 
+    static std::mutex g_bufferPoolLock;
+    static std::vector<void*> g_bufferPool[BUFFER_POOL_MAX_SHIFT + 1];
+    static size_t g_bufferPoolCached = 0;
 
-    /*
-    Static wrapper on DestroyJavaVM() JNI function.
-    See the description in
-    http://jre.sfbay/java/re/jdk/6/promoted/latest/docs/technotes/guides/jni/spec/invocation.html#destroy_java_vm
-    */
+    static void* AlignedAlloc(size_t size)
+    {
+#ifdef _WIN32
+        return _aligned_malloc(size, BUFFER_ALIGNMENT);
+#else
+        void* p = NULL;
+        if(posix_memalign(&p, BUFFER_ALIGNMENT, size) != 0)
+            return NULL;
+        return p;
+#endif
+    }
 
-    int DestroyJavaVM( JavaVM* pJVM ){
-        pJVM->DestroyJavaVM();
-        return 0;
+    static void AlignedFree(void* p)
+    {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        free(p);
+#endif
     }
 
+    static int BufferSizeClass(size_t size)
+    {
+        int shift = BUFFER_POOL_MIN_SHIFT;
+        while(shift <= BUFFER_POOL_MAX_SHIFT && ((size_t)1 << shift) < size)
+            shift++;
+        return shift <= BUFFER_POOL_MAX_SHIFT ? shift : -1;
+    }
 
-    
-    int (*fnCreateInstance)(void*, const char*, int, void**);
+    static void* PoolAlloc(size_t size, size_t* pAllocated)
+    {
+        int shift = BufferSizeClass(size);
+        if(shift < 0)
+        {
+            *pAllocated = size;
+            return AlignedAlloc(size);
+        }
 
-    void SetfnCreateInstance(void* cb)
+        *pAllocated = (size_t)1 << shift;
+        {
+            std::lock_guard<std::mutex> lock(g_bufferPoolLock);
+            std::vector<void*>& bucket = g_bufferPool[shift];
+            if(!bucket.empty())
+            {
+                void* p = bucket.back();
+                bucket.pop_back();
+                g_bufferPoolCached -= *pAllocated;
+                return p;
+            }
+        }
+        return AlignedAlloc(*pAllocated);
+    }
+
+    static void PoolFree(void* p, size_t allocated)
     {
-        fnCreateInstance = (int (*)(void*, const char*, int, void**))cb;
+        int shift = BufferSizeClass(allocated);
+        if(shift >= 0 && ((size_t)1 << shift) == allocated)
+        {
+            std::lock_guard<std::mutex> lock(g_bufferPoolLock);
+            if(g_bufferPoolCached + allocated <= BUFFER_POOL_MAX_CACHED)
+            {
+                g_bufferPool[shift].push_back(p);
+                g_bufferPoolCached += allocated;
+                return;
+            }
+        }
+        AlignedFree(p);
     }
 
-    JNIEXPORT jint JNICALL Java_app_quant_clr_CLRRuntime_nativeCreateInstance(JNIEnv* pEnv, jclass cls, jstring classname, jint len, jobjectArray args)
+    static void ReleaseBufferRef(jlong token)
     {
-        std::mutex mutex;
-        mutex.lock();
+        DirectBuffer entry;
+        {
+            BufferShard& shard = ShardFor(token);
+            std::lock_guard<std::mutex> lock(shard.lock);
+            std::unordered_map<jlong, DirectBuffer>::iterator it = shard.buffers.find(token);
+            if(it == shard.buffers.end())
+                return;
 
-        void** _args = (void**)malloc(sizeof(void *) * len);
-        for(int i = 0; i < len; i++)
-            _args[i] = (void*)((void**)args)[i];
+            if(--it->second.refs > 0)
+                return;
 
-        const char* _classname = GetNetString(pEnv, classname);
-        int val = fnCreateInstance(pEnv, _classname, len, _args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(_args);
-            mutex.unlock();
-            return -1;
+            entry = it->second;
+            shard.buffers.erase(it);
         }
-        free(_args);
-        mutex.unlock();
-        return val;
-    }
 
-    jobject (*fnInvoke)(void*, int, const char*, int, void**);
+        if(entry.pin == NULL)
+            PoolFree(entry.address, entry.allocated);
+        else if(fnReleasePin != NULL)
+            fnReleasePin(entry.pin);
+    }
 
-    void SetfnInvoke(void* cb)
+    static int WrapDirectBuffer(JNIEnv* pEnv, void* address, jlong capacity, jlong token, jobject* pBuffer)
     {
-        fnInvoke = (jobject (*)(void*, int, const char*, int, void**))cb;
+        *pBuffer = NULL;
+
+        BridgeCache* bridge = GetBridgeCache(pEnv);
+        if(bridge == NULL || bridge->midCLRBufferTrack == NULL)
+            return -2;
+
+        jobject buffer = pEnv->NewDirectByteBuffer(address, capacity);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || buffer == NULL)
+            return -1;
+
+        jobject tracked = pEnv->CallStaticObjectMethod(bridge->clsCLRBuffer, bridge->midCLRBufferTrack, buffer, token);
+        pEnv->DeleteLocalRef(buffer);
+        if(pEnv->ExceptionCheck() == JNI_TRUE || tracked == NULL)
+            return -1;
+
+        TrackLocalRef(tracked);
+        *pBuffer = tracked;
+        return 0;
     }
 
-    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeInvoke(JNIEnv* pEnv, jclass cls, jint ptr, jstring funcname, jint len, jobjectArray args)
+    jlong AllocNativeBuffer(jlong size, void** ppData)
     {
-        std::mutex mutex;
-        mutex.lock();
+        *ppData = NULL;
+        if(size <= 0)
+            return 0;
 
-        void** _args = (void**)malloc(sizeof(void *) * len);
-        for(int i = 0; i < len; i++)
-            _args[i] = (void*)((void**)args)[i];
-            // _args[i] = args[i];
+        size_t allocated = 0;
+        void* p = PoolAlloc((size_t)size, &allocated);
+        if(p == NULL)
+            return 0;
 
-        const char* _funcname = GetNetString(pEnv, funcname);
-        jobject val = fnInvoke(pEnv, ptr, _funcname, len, _args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(_args);
-            mutex.unlock();
-            return NULL;
+        DirectBuffer entry;
+        entry.address = p;
+        entry.capacity = size;
+        entry.allocated = allocated;
+        entry.pin = NULL;
+        entry.refs = 1;
+
+        jlong token = g_nextBufferToken++;
+        {
+            BufferShard& shard = ShardFor(token);
+            std::lock_guard<std::mutex> lock(shard.lock);
+            shard.buffers[token] = entry;
         }
-        free(_args);
-        mutex.unlock();
-        return val;
-    }
 
-    jobject (*fnGetProperty)(void*, int, const char*);
+        *ppData = p;
+        return token;
+    }
 
-    void SetfnGetProperty(void* cb)
+    int ReleaseNativeBuffer(jlong token)
     {
-        fnGetProperty = (jobject (*)(void*, int, const char*))cb;
+        ReleaseBufferRef(token);
+        return 0;
     }
 
-    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeGetProperty(JNIEnv* pEnv, jclass cls, jint ptr, jstring name)
+    int NewDirectBuffer(JNIEnv* pEnv, jlong token, jobject* pBuffer)
     {
-        std::mutex mutex;
-        mutex.lock();
+        JNI_METRIC(pEnv);
+        void* address;
+        jlong capacity;
+        {
+            BufferShard& shard = ShardFor(token);
+            std::lock_guard<std::mutex> lock(shard.lock);
+            std::unordered_map<jlong, DirectBuffer>::iterator it = shard.buffers.find(token);
+            if(it == shard.buffers.end() || it->second.pin != NULL)
+                return -2;
 
-        const char* _name = GetNetString(pEnv, name);
-        jobject val = fnGetProperty(pEnv, ptr, _name);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return NULL;
+            it->second.refs++;
+            address = it->second.address;
+            capacity = it->second.capacity;
         }
-        mutex.unlock();
-        return val;
+
+        int res = WrapDirectBuffer(pEnv, address, capacity, token, pBuffer);
+        if(res != 0)
+            ReleaseBufferRef(token);
+        return res;
     }
 
-    jobject (*fnSetProperty)(void*, int, const char*, void**);
+    //On failure the caller still owns pin and must free it.
+    int NewPinnedDirectBuffer(JNIEnv* pEnv, void* address, jlong capacity, void* pin, jobject* pBuffer)
+    {
+        JNI_METRIC(pEnv);
+        DirectBuffer entry;
+        entry.address = address;
+        entry.capacity = capacity;
+        entry.allocated = 0;
+        entry.pin = pin;
+        entry.refs = 1;
+
+        jlong token = g_nextBufferToken++;
+        BufferShard& shard = ShardFor(token);
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            shard.buffers[token] = entry;
+        }
 
-    void SetfnSetProperty(void* cb)
+        int res = WrapDirectBuffer(pEnv, address, capacity, token, pBuffer);
+        if(res != 0)
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            shard.buffers.erase(token);
+        }
+        return res;
+    }
+
+    JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeReleaseBuffer(JNIEnv* pEnv, jclass cls, jlong token)
     {
-        fnSetProperty = (jobject (*)(void*, int, const char*, void**))cb;
+        JNI_METRIC(pEnv);
+        ReleaseBufferRef(token);
     }
 
-    JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeSetProperty(JNIEnv* pEnv, jclass cls, jint ptr, jstring name, jobjectArray value)
+    //asynchronous calls
+    /*
+    A fixed pool of native threads, attached to the JVM once as daemons when the executor starts, runs calls for .NET
+    threads that must not block on the JVM. A work item is only a token: the worker hands it back to fnRunWork with its
+    own env, and .NET marshals the call, runs it and completes its Task there. Neither the submitting thread nor the
+    .NET ThreadPool has to attach to the JVM.
+    Every worker owns a bounded lock free queue, a ring of sequence numbered cells that any thread can push to and pop
+    from. SubmitWork pushes round robin onto the first queue with room and returns -1 when all of them are full. A
+    worker takes from its own queue first and steals from the others once it is empty, so a worker held up by a long
+    call does not hold back the short ones queued behind it. Idle workers sleep on a counting semaphore that is only
+    locked when one of them actually sleeps.
+    Each item runs in its own local frame and a pending exception is cleared after it. When the executor stops the
+    queued items are still run before the workers exit.
+    */
+
+    struct WorkCell
     {
-        std::mutex mutex;
-        mutex.lock();
+        std::atomic<size_t> sequence;
+        jlong token;
+    };
 
-        const char* _name = GetNetString(pEnv, name);
-        fnSetProperty(pEnv, ptr, _name, (void**)value);
+    class WorkQueue
+    {
+    public:
+        explicit WorkQueue(size_t capacity) : m_mask(capacity - 1), m_cells(new WorkCell[capacity]), m_head(0), m_tail(0)
+        {
+            for(size_t i = 0; i < capacity; i++)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
 
-        mutex.unlock();
-    }
+        ~WorkQueue()
+        {
+            delete[] m_cells;
+        }
 
+        bool Push(jlong token)
+        {
+            size_t pos = m_tail.load(std::memory_order_relaxed);
+            while(true)
+            {
+                WorkCell& cell = m_cells[pos & m_mask];
+                intptr_t diff = (intptr_t)cell.sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+                if(diff == 0)
+                {
+                    if(m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.token = token;
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(diff < 0)
+                    return false;
+                else
+                    pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
 
+        //Can miss an item whose push is still in progress, callers retry while work is known to be queued.
+        bool Pop(jlong* pToken)
+        {
+            size_t pos = m_head.load(std::memory_order_relaxed);
+            while(true)
+            {
+                WorkCell& cell = m_cells[pos & m_mask];
+                intptr_t diff = (intptr_t)cell.sequence.load(std::memory_order_acquire) - (intptr_t)(pos + 1);
+                if(diff == 0)
+                {
+                    if(m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        *pToken = cell.token;
+                        cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if(diff < 0)
+                    return false;
+                else
+                    pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
 
-    jobject (*fnRegisterFunc)(void*, const char*, int);
+    private:
+        WorkQueue(const WorkQueue&);
+        WorkQueue& operator=(const WorkQueue&);
+
+        const size_t m_mask;
+        WorkCell* m_cells;
+        //Consumers and producers move different ends, keep them on separate cache lines.
+        char m_pad0[64];
+        std::atomic<size_t> m_head;
+        char m_pad1[64];
+        std::atomic<size_t> m_tail;
+    };
+
+    //A negative count is the number of sleeping workers, Post only locks to wake one of them.
+    class WorkSignal
+    {
+    public:
+        WorkSignal() : m_count(0), m_wakeups(0) {}
 
-    void SetfnRegisterFunc(void* cb)
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_count.store(0);
+            m_wakeups = 0;
+        }
+
+        void Post()
+        {
+            if(m_count.fetch_add(1, std::memory_order_release) < 0)
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_wakeups++;
+                m_wake.notify_one();
+            }
+        }
+
+        void Wait()
+        {
+            for(int spin = 0; spin < 64; spin++)
+            {
+                int count = m_count.load(std::memory_order_relaxed);
+                if(count > 0 && m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+                std::this_thread::yield();
+            }
+
+            if(m_count.fetch_sub(1, std::memory_order_acquire) > 0)
+                return;
+
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_wake.wait(lock, [this]{ return m_wakeups > 0; });
+            m_wakeups--;
+        }
+
+    private:
+        std::atomic<int> m_count;
+        std::mutex m_lock;
+        std::condition_variable m_wake;
+        int m_wakeups;
+    };
+
+    struct Executor
     {
-        fnRegisterFunc = (jobject (*)(void*, const char*, int))cb;
-    }
+        JavaVM* pVM;
+        std::vector<WorkQueue*> queues;
+        std::vector<std::thread> threads;
+        WorkSignal signal;
+        std::atomic<bool> running;
+        std::atomic<bool> stopping;
+        std::atomic<int> submitters;
+        std::atomic<size_t> next;
+        std::atomic<jlong> submitted;
+        std::atomic<jlong> completed;
+        std::atomic<jlong> stolen;
+        //Only taken by StartExecutor and StopExecutor.
+        std::mutex lock;
+    };
+
+    static Executor g_executor;
+    static thread_local bool t_executorWorker = false;
+
+    int (*fnRunWork)(void*, jlong);
+
+    void SetfnRunWork(void* cb) { fnRunWork = (int (*)(void*, jlong))cb; }
+
+    struct ExecutorStartup
+    {
+        std::mutex lock;
+        std::condition_variable done;
+        int attached;
+        int failed;
+    };
 
-    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeRegisterFunc(JNIEnv* pEnv, jclass cls, jstring funcname, jint hash)
+    static bool TakeWork(size_t index, jlong* pToken)
     {
-        std::mutex mutex;
-        mutex.lock();
+        size_t count = g_executor.queues.size();
+        if(g_executor.queues[index]->Pop(pToken))
+            return true;
 
-        const char* _funcname = GetNetString(pEnv, funcname);
-        
-        jobject val = fnRegisterFunc(pEnv, _funcname, hash);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            mutex.unlock();
-            return NULL;
+        for(size_t i = 1; i < count; i++)
+        {
+            if(g_executor.queues[(index + i) % count]->Pop(pToken))
+            {
+                g_executor.stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
         }
-        mutex.unlock();
-        return val;
+        return false;
+    }
+
+    static void RunWork(JavaVM* pVM, jlong token)
+    {
+        JNIEnv* pEnv = (JNIEnv*)EnterThread(pVM, NULL);
+        {
+            JNI_METRIC(pEnv);
+            fnRunWork(pEnv, token);
+        }
+        if(pEnv->ExceptionCheck() == JNI_TRUE)
+            pEnv->ExceptionClear();
+        LeaveThread(pVM);
+        g_executor.completed.fetch_add(1, std::memory_order_relaxed);
     }
 
+    static void ExecutorWorker(JavaVM* pVM, size_t index, ExecutorStartup* pStartup)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "CLR Worker %d", (int)index + 1);
+        bool attached = AttachCurrent(pVM, name, t_attachment);
+        {
+            std::lock_guard<std::mutex> lock(pStartup->lock);
+            if(attached)
+                pStartup->attached++;
+            else
+                pStartup->failed++;
+            pStartup->done.notify_one();
+        }
+        if(!attached)
+            return;
+
+        t_executorWorker = true;
+        jlong token;
+        while(true)
+        {
+            g_executor.signal.Wait();
+
+            //Every post but the ones from StopExecutor stands for a queued item, so keep looking until it shows up.
+            bool found = false;
+            while(!(found = TakeWork(index, &token)) && !g_executor.stopping.load(std::memory_order_acquire))
+                std::this_thread::yield();
 
-    jobject (*fnInvokeFunc)(void*, int, int, void**);
+            if(!found)
+                break;
+            RunWork(pVM, token);
+        }
+        t_executorWorker = false;
+    }
 
-    void SetfnInvokeFunc(void* cb)
+    static void JoinWorkers()
     {
-        fnInvokeFunc = (jobject (*)(void*, int, int, void**))cb;
+        g_executor.stopping.store(true, std::memory_order_release);
+        for(size_t i = 0; i < g_executor.threads.size(); i++)
+            g_executor.signal.Post();
+        for(size_t i = 0; i < g_executor.threads.size(); i++)
+            g_executor.threads[i].join();
+
+        g_executor.threads.clear();
+        for(size_t i = 0; i < g_executor.queues.size(); i++)
+            delete g_executor.queues[i];
+        g_executor.queues.clear();
     }
 
-    JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeInvokeFunc(JNIEnv* pEnv, jclass cls, jint ptr, jint len, jobjectArray args)
-    // JNIEXPORT jobject JNICALL Java_app_quant_clr_CLRRuntime_nativeInvokeFunc(JNIEnv* pEnv, jclass cls, jint ptr, jint len, void** args)
+    /*
+    Starts threads workers with room for capacity queued items each, rounded up to a power of two.
+    Returns once every worker is attached, -1 if one of them could not attach and -2 for invalid arguments, a missing
+    fnRunWork or an executor that is already running.
+    */
+
+    int StartExecutor(JavaVM* pVM, int threads, int capacity)
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(pVM == NULL || threads <= 0 || capacity <= 0 || fnRunWork == NULL)
+            return -2;
 
-        void** _args = (void**)malloc(sizeof(void *) * len);
-        for(int i = 0; i < len; i++)
-            _args[i] = (void*)((void**)args)[i];
-            // _args[i] = args[i];
+        std::lock_guard<std::mutex> lock(g_executor.lock);
+        if(g_executor.running.load())
+            return -2;
 
+        size_t size = 1;
+        while(size < (size_t)capacity)
+            size <<= 1;
 
-        jobject val = fnInvokeFunc(pEnv, ptr, len, _args);
-        if(pEnv->ExceptionCheck() == JNI_TRUE){
-            //pEnv->ExceptionDescribe();
-            free(_args);
-            mutex.unlock();
-            return NULL;
+        g_executor.pVM = pVM;
+        g_executor.signal.Reset();
+        g_executor.stopping.store(false);
+        for(int i = 0; i < threads; i++)
+            g_executor.queues.push_back(new WorkQueue(size));
+
+        ExecutorStartup startup;
+        startup.attached = 0;
+        startup.failed = 0;
+        for(int i = 0; i < threads; i++)
+            g_executor.threads.push_back(std::thread(ExecutorWorker, pVM, (size_t)i, &startup));
+
+        bool failed;
+        {
+            std::unique_lock<std::mutex> wait(startup.lock);
+            startup.done.wait(wait, [&startup, threads]{ return startup.attached + startup.failed == threads; });
+            failed = startup.failed > 0;
         }
-        free(_args);
-        mutex.unlock();
-        return val;
-    }
 
+        if(failed)
+        {
+            JoinWorkers();
+            return -1;
+        }
 
+        g_executor.running.store(true);
+        return 0;
+    }
 
-    jobject (*fnRemoveObject)(void*, int);
+    /*
+    Queues token for fnRunWork. Returns -1 when every queue is full and -2 when the executor is not running,
+    in both cases the token is not used.
+    */
 
-    void SetfnRemoveObject(void* cb)
+    int SubmitWork(jlong token)
     {
-        fnRemoveObject = (jobject (*)(void*, int))cb;
+        JNI_METRIC(NULL);
+        int res = -2;
+        g_executor.submitters.fetch_add(1);
+        if(g_executor.running.load())
+        {
+            size_t count = g_executor.queues.size();
+            size_t start = g_executor.next.fetch_add(1, std::memory_order_relaxed);
+            res = -1;
+            for(size_t i = 0; i < count; i++)
+            {
+                if(g_executor.queues[(start + i) % count]->Push(token))
+                {
+                    g_executor.submitted.fetch_add(1, std::memory_order_relaxed);
+                    g_executor.signal.Post();
+                    res = 0;
+                    break;
+                }
+            }
+        }
+        g_executor.submitters.fetch_sub(1);
+        return res;
     }
 
-    JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeRemoveObject(JNIEnv* pEnv, jclass cls, jint ptr)
+    //Runs what is still queued and joins the workers. Returns -2 if the executor is not running or when called from one of its workers.
+    int StopExecutor()
     {
-        std::mutex mutex;
-        mutex.lock();
+        if(t_executorWorker)
+            return -2;
 
-        // const char* _name = GetNetString(pEnv, name);
-        fnRemoveObject(pEnv, ptr);
+        std::lock_guard<std::mutex> lock(g_executor.lock);
+        if(!g_executor.running.load())
+            return -2;
+
+        g_executor.running.store(false);
+        while(g_executor.submitters.load() != 0)
+            std::this_thread::yield();
+
+        JoinWorkers();
+        return 0;
+    }
 
-        mutex.unlock();
+    int GetExecutorStats(int* pThreads, jlong* pSubmitted, jlong* pCompleted, jlong* pStolen)
+    {
+        *pThreads = g_executor.running.load() ? (int)g_executor.threads.size() : 0;
+        *pSubmitted = g_executor.submitted.load(std::memory_order_relaxed);
+        *pCompleted = g_executor.completed.load(std::memory_order_relaxed);
+        *pStolen = g_executor.stolen.load(std::memory_order_relaxed);
+        return 0;
     }
 
 }
\ No newline at end of file
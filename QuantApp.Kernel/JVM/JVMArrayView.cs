@@ -0,0 +1,148 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+
+namespace QuantApp.Kernel.JVM
+{
+    public enum JVMArrayAccess
+    {
+        ReadOnly,
+        ReadWrite
+    }
+
+    /// <summary>
+    /// Pinned view over the elements of a Java primitive array.
+    /// Critical views point straight into the JVM heap; element views may be a copy (see IsCopy)
+    /// which is written back on Commit or Dispose when opened for ReadWrite.
+    /// While a critical view is open the thread that opened it must not call into the JVM (no Runtime or
+    /// JVMObject calls, no blocking) until it disposes the view on that same thread. Runtime refuses to
+    /// attach such a thread instead of letting the call run inside the critical region.
+    /// </summary>
+    public unsafe sealed class JVMArrayView<T> : IDisposable where T : unmanaged
+    {
+        private const int JNI_RELEASE = 0;
+        private const int JNI_COMMIT = 1;
+        private const int JNI_ABORT = 2;
+
+        private static readonly string ElementType = Runtime.TransformType(typeof(T));
+
+        private void* pEnv;
+        private void* pArray;
+        private void* pData;
+        private int length;
+        private readonly bool critical;
+
+        public JVMArrayAccess Access { get; private set; }
+        /// <summary>
+        /// True when the view points into the JVM heap. No bridge call may be made on this thread until Dispose.
+        /// </summary>
+        public bool IsCritical { get { return critical; } }
+        public bool IsCopy { get; private set; }
+        public int Length { get { return length; } }
+
+        /// <summary>
+        /// Takes ownership of pArray, a global reference, which is deleted when the view is disposed.
+        /// </summary>
+        internal JVMArrayView(void* pEnv, void* pArray, JVMArrayAccess access, bool critical)
+        {
+            this.pEnv = pEnv;
+            this.pArray = pArray;
+            this.critical = critical;
+            this.Access = access;
+
+            if(ElementType.Length != 1)
+            {
+                Runtime.DeleteGlobalRef(pEnv, pArray);
+                throw new NotSupportedException("JVMArrayView: " + typeof(T) + " is not a Java primitive type");
+            }
+
+            void* data;
+            int len;
+            int res;
+            if(critical)
+                res = Runtime.GetArrayCritical(pEnv, pArray, ElementType, &data, &len);
+            else
+            {
+                bool isCopy;
+                res = Runtime.GetArrayElements(pEnv, pArray, ElementType, &data, &len, &isCopy);
+                IsCopy = isCopy;
+            }
+
+            if(res != 0)
+            {
+                var exception = res == -2 ?
+                    new ArgumentException("JVMArrayView: object is not a Java " + ElementType + " array") :
+                    (Exception)Runtime.TakeJavaException();
+                Runtime.DeleteGlobalRef(pEnv, pArray);
+                throw exception;
+            }
+
+            this.pData = data;
+            this.length = len;
+            if(critical)
+                Runtime.criticalViews++;
+        }
+
+        public Span<T> Span
+        {
+            get
+            {
+                if(Access != JVMArrayAccess.ReadWrite)
+                    throw new InvalidOperationException("JVMArrayView opened as ReadOnly");
+                return new Span<T>(Data(), length);
+            }
+        }
+
+        public ReadOnlySpan<T> ReadOnlySpan
+        {
+            get { return new ReadOnlySpan<T>(Data(), length); }
+        }
+
+        /// <summary>
+        /// Writes changes back to the Java array while keeping the view open. Only needed for element views that are a copy.
+        /// </summary>
+        public void Commit()
+        {
+            if(critical)
+                throw new InvalidOperationException("JVMArrayView: critical views write in place and cannot be committed");
+            if(Access != JVMArrayAccess.ReadWrite)
+                throw new InvalidOperationException("JVMArrayView opened as ReadOnly");
+
+            Runtime.ReleaseArrayElements(pEnv, pArray, ElementType, Data(), JNI_COMMIT);
+        }
+
+        public void Dispose()
+        {
+            if(pData == null)
+                return;
+
+            int mode = Access == JVMArrayAccess.ReadWrite ? JNI_RELEASE : JNI_ABORT;
+            if(critical)
+            {
+                Runtime.ReleaseArrayCritical(pEnv, pArray, pData, mode);
+                Runtime.criticalViews--;
+            }
+            else
+                Runtime.ReleaseArrayElements(pEnv, pArray, ElementType, pData, mode);
+
+            Runtime.DeleteGlobalRef(pEnv, pArray);
+
+            pData = null;
+            pArray = null;
+            length = 0;
+        }
+
+        private void* Data()
+        {
+            if(pData == null)
+                throw new ObjectDisposedException("JVMArrayView");
+            return pData;
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+using System.Collections.Generic;
+using System.Threading.Tasks;
+
+namespace QuantApp.Kernel.JVM
+{
+    /// <summary>
+    /// Collects Java method calls and runs them in a single crossing into the JVM, amortizing the transition,
+    /// argument copies and exception checks over the whole batch.
+    /// Signatures are JNI signatures, e.g. "(DI)D". Arguments are converted when the batch is flushed.
+    /// Flush returns one entry per call in the order they were added: the result, null for void methods,
+    /// or an Exception for calls that failed.
+    /// </summary>
+    public sealed class JVMBatch
+    {
+        internal sealed class Call
+        {
+            public JVMObject Target;
+            public string JavaClass;
+            public string Name;
+            public string Signature;
+            public string ReturnSignature;
+            public object[] Args;
+        }
+
+        private List<Call> calls = new List<Call>();
+
+        /// <summary>
+        /// Stops at the first failing call, the calls after it are reported as not run.
+        /// </summary>
+        public bool StopOnError { get; set; }
+
+        public int Count { get { return calls.Count; } }
+
+        public int Add(JVMObject target, string method, string signature, params object[] args)
+        {
+            if(target == null)
+                throw new ArgumentNullException("target");
+            return add(target, null, method, signature, args);
+        }
+
+        public int AddStatic(string javaClass, string method, string signature, params object[] args)
+        {
+            if(string.IsNullOrEmpty(javaClass))
+                throw new ArgumentNullException("javaClass");
+            return add(null, javaClass.Replace(".", "/"), method, signature, args);
+        }
+
+        public object[] Flush()
+        {
+            var pending = calls;
+            calls = new List<Call>();
+            return Runtime.RunBatch(pending, StopOnError);
+        }
+
+        /// <summary>
+        /// Flush on one of the asynchronous executor threads, see Runtime.InvokeAsync.
+        /// </summary>
+        public async Task<object[]> FlushAsync()
+        {
+            var pending = calls;
+            calls = new List<Call>();
+            bool stopOnError = StopOnError;
+            return (object[])await Runtime.InvokeAsync(() => Runtime.RunBatch(pending, stopOnError));
+        }
+
+        private int add(JVMObject target, string javaClass, string method, string signature, object[] args)
+        {
+            if(string.IsNullOrEmpty(method))
+                throw new ArgumentNullException("method");
+
+            int end = signature == null ? -1 : signature.LastIndexOf(')');
+            if(end < 0 || end == signature.Length - 1)
+                throw new ArgumentException("JVMBatch: invalid signature " + signature);
+
+            calls.Add(new Call{
+                Target = target,
+                JavaClass = javaClass,
+                Name = method,
+                Signature = signature,
+                ReturnSignature = signature.Substring(end + 1),
+                Args = args != null && args.Length == 0 ? null : args
+            });
+            return calls.Count - 1;
+        }
+    }
+}
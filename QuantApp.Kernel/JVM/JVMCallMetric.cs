@@ -0,0 +1,70 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+
+namespace QuantApp.Kernel.JVM
+{
+    /// <summary>
+    /// Calls into one JNIWrapper entry point since the last Runtime.ResetCallMetrics, merged over all threads.
+    /// Latencies are kept in a log linear histogram, so percentiles are within 12.5% of the true value.
+    /// </summary>
+    public sealed class JVMCallMetric
+    {
+        private readonly long[] buckets;
+
+        internal JVMCallMetric(string name, long calls, long exceptions, long bytes, long nanos, long[] buckets)
+        {
+            this.Name = name;
+            this.Calls = calls;
+            this.Exceptions = exceptions;
+            this.Bytes = bytes;
+            this.TotalNanoseconds = nanos;
+            this.buckets = buckets;
+        }
+
+        public string Name { get; private set; }
+        public long Calls { get; private set; }
+        /// <summary>Calls that returned with a Java exception pending.</summary>
+        public long Exceptions { get; private set; }
+        /// <summary>Array, string and struct payload copied by the calls, 0 for entry points that do not count it.</summary>
+        public long Bytes { get; private set; }
+        public long TotalNanoseconds { get; private set; }
+
+        public double MeanNanoseconds { get { return Calls == 0 ? 0 : (double)TotalNanoseconds / Calls; } }
+
+        /// <summary>
+        /// Latency in nanoseconds below which the given fraction (0 to 1) of the calls completed, taken as the
+        /// lower bound of the histogram bucket it falls in.
+        /// </summary>
+        public long Percentile(double fraction)
+        {
+            if(Calls == 0)
+                return 0;
+
+            long rank = (long)Math.Ceiling(Math.Clamp(fraction, 0.0, 1.0) * Calls);
+            long seen = 0;
+            for(int i = 0; i < buckets.Length; i++)
+            {
+                seen += buckets[i];
+                if(seen >= rank && buckets[i] > 0)
+                    return Runtime.MetricBucketLowerBound(i);
+            }
+            return Runtime.MetricBucketLowerBound(buckets.Length - 1);
+        }
+
+        /// <summary>Calls per histogram bucket, see Runtime.MetricBucketLowerBound for the bucket bounds.</summary>
+        public long[] Histogram { get { return (long[])buckets.Clone(); } }
+
+        public override string ToString()
+        {
+            return Name + ": " + Calls + " calls, " + Exceptions + " exceptions, " + Bytes + " bytes, mean " + MeanNanoseconds.ToString("0") +
+                "ns, p50 " + Percentile(0.5) + "ns, p99 " + Percentile(0.99) + "ns";
+        }
+    }
+}
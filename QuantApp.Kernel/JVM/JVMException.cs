@@ -0,0 +1,119 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+
+namespace QuantApp.Kernel.JVM
+{
+    /// <summary>
+    /// Java exception surfaced to .NET. Only the class name and message are read when the exception is raised;
+    /// the Java stack trace and the cause chain are fetched from the JVM the first time they are read.
+    /// </summary>
+    public class JVMException : Exception
+    {
+        private IntPtr throwable;
+        private readonly object sync = new object();
+
+        private string javaStackTrace;
+        private bool causeLoaded;
+        private JVMException javaCause;
+
+        internal JVMException(IntPtr throwable, string javaClassName, string javaMessage)
+        {
+            this.throwable = throwable;
+            JavaClassName = javaClassName;
+            JavaMessage = javaMessage;
+        }
+
+        /// <summary>
+        /// Fully qualified name of the Java exception class, null in error-code-only mode.
+        /// </summary>
+        public string JavaClassName { get; private set; }
+
+        public string JavaMessage { get; private set; }
+
+        public override string Message
+        {
+            get
+            {
+                if(JavaClassName == null)
+                    return JavaMessage ?? "JVM call failed";
+                return JavaMessage == null ? JavaClassName : JavaClassName + ": " + JavaMessage;
+            }
+        }
+
+        /// <summary>
+        /// Java stack trace as printed by printStackTrace, including the causes.
+        /// </summary>
+        public string JavaStackTrace
+        {
+            get
+            {
+                lock(sync)
+                {
+                    if(javaStackTrace == null && throwable != IntPtr.Zero)
+                        javaStackTrace = Runtime.DescribeJavaException(throwable);
+                    return javaStackTrace;
+                }
+            }
+        }
+
+        /// <summary>
+        /// The Java cause of this exception, or null.
+        /// </summary>
+        public JVMException JavaCause
+        {
+            get
+            {
+                lock(sync)
+                {
+                    if(!causeLoaded && throwable != IntPtr.Zero)
+                    {
+                        javaCause = Runtime.GetJavaExceptionCause(throwable);
+                        causeLoaded = true;
+                    }
+                    return javaCause;
+                }
+            }
+        }
+
+        public override string ToString()
+        {
+            string trace = JavaStackTrace;
+            return trace == null ? base.ToString() : trace + Environment.NewLine + base.ToString();
+        }
+
+        /// <summary>
+        /// Drops the reference to the Java throwable. Details not read yet are no longer available.
+        /// </summary>
+        internal void Release()
+        {
+            IntPtr _throwable = TakeThrowable();
+            if(_throwable != IntPtr.Zero)
+                Runtime.ReleaseJavaException(_throwable);
+        }
+
+        /// <summary>
+        /// Hands the reference to the Java throwable over to the caller, who then has to release it.
+        /// </summary>
+        internal IntPtr TakeThrowable()
+        {
+            lock(sync)
+            {
+                IntPtr _throwable = throwable;
+                throwable = IntPtr.Zero;
+                return _throwable;
+            }
+        }
+
+        ~JVMException()
+        {
+            Release();
+        }
+    }
+}
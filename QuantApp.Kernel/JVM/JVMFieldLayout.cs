@@ -0,0 +1,178 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+using System.Collections.Generic;
+using System.Reflection;
+
+namespace QuantApp.Kernel.JVM
+{
+    /// <summary>
+    /// Maps the instance fields of a Java class onto a blittable .NET struct, so all the fields of an object are read
+    /// or written in one crossing instead of a field lookup and a call per member.
+    /// Each struct field binds to the Java field of the same name, declared by the class or one of its superclasses.
+    /// Primitive fields must have the Java field's type (bool, sbyte or byte, char, short, int, long, float, double).
+    /// IntPtr fields bind to reference fields of any type; their values are passed separately, in ReferenceFields order,
+    /// and converted like any other value crossing the bridge.
+    /// A layout resolves its fields once and can be shared between threads.
+    /// </summary>
+    public unsafe sealed class JVMFieldLayout<T> : IDisposable where T : unmanaged
+    {
+        private void* pLayout;
+        private readonly int[] referenceOffsets;
+
+        public string JavaClass { get; private set; }
+        public string[] ReferenceFields { get; private set; }
+
+        public JVMFieldLayout(string javaClass)
+        {
+            if(string.IsNullOrEmpty(javaClass))
+                throw new ArgumentNullException("javaClass");
+
+            this.JavaClass = javaClass.Replace(".", "/");
+
+            var fields = typeof(T).GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic);
+            var names = new string[fields.Length];
+            var kinds = new char[fields.Length];
+            var offsets = new int[fields.Length];
+            var references = new List<string>();
+            var referenceOffsets = new List<int>();
+
+            for(int i = 0; i < fields.Length; i++)
+            {
+                names[i] = javaName(fields[i]);
+                kinds[i] = kindOf(fields[i].FieldType);
+                offsets[i] = offsetOf(fields[i]);
+
+                if(kinds[i] == 'L')
+                {
+                    references.Add(names[i]);
+                    referenceOffsets.Add(offsets[i]);
+                }
+            }
+
+            this.ReferenceFields = references.ToArray();
+            this.referenceOffsets = referenceOffsets.ToArray();
+            this.pLayout = Runtime.newFieldLayout(this.JavaClass, names, new string(kinds), offsets);
+        }
+
+        ~JVMFieldLayout()
+        {
+            Release();
+        }
+
+        public T Read(JVMObject obj)
+        {
+            object[] references;
+            return Read(obj, out references);
+        }
+
+        /// <summary>
+        /// Reads every mapped field of obj. IntPtr fields are left zero, their values are returned in references.
+        /// </summary>
+        public T Read(JVMObject obj, out object[] references)
+        {
+            if(obj == null)
+                throw new ArgumentNullException("obj");
+
+            T value = default(T);
+            references = Runtime.getFields(layout(), obj.JavaHashCode, &value, referenceOffsets);
+            return value;
+        }
+
+        public void Write(JVMObject obj, T value, params object[] references)
+        {
+            if(obj == null)
+                throw new ArgumentNullException("obj");
+
+            Runtime.setFields(layout(), obj.JavaHashCode, &value, referenceOffsets, references);
+        }
+
+        /// <summary>
+        /// Builds a new instance of the Java class from value. No constructor runs: mapped fields are set from value
+        /// and references, the others keep their default values.
+        /// </summary>
+        public object Create(T value, params object[] references)
+        {
+            return Runtime.newObjectFromFields(layout(), &value, referenceOffsets, references);
+        }
+
+        public void Dispose()
+        {
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        private void* layout()
+        {
+            if(pLayout == null)
+                throw new ObjectDisposedException("JVMFieldLayout");
+            return pLayout;
+        }
+
+        private void Release()
+        {
+            if(pLayout != null && Runtime.Loaded)
+                Runtime.freeFieldLayout(pLayout);
+            pLayout = null;
+        }
+
+        // Auto-properties bind through their backing field.
+        private static string javaName(FieldInfo field)
+        {
+            string name = field.Name;
+            int end = name.IndexOf(">k__BackingField");
+            return name.StartsWith("<") && end > 0 ? name.Substring(1, end - 1) : name;
+        }
+
+        private static char kindOf(Type type)
+        {
+            if(type == typeof(IntPtr))
+                return 'L';
+            if(type == typeof(sbyte))
+                return 'B';
+
+            string signature = Runtime.TransformType(type);
+            if(signature.Length == 1 && signature != "V")
+                return signature[0];
+
+            throw new NotSupportedException("JVMFieldLayout: " + type + " has no Java field type, use IntPtr for references");
+        }
+
+        // Offset of the field in T's unmanaged layout, found by setting it to all ones on an otherwise zero value.
+        private static int offsetOf(FieldInfo field)
+        {
+            object boxed = default(T);
+            field.SetValue(boxed, allOnes(field.FieldType));
+            T value = (T)boxed;
+
+            byte* p = (byte*)&value;
+            for(int i = 0; i < sizeof(T); i++)
+            {
+                if(p[i] != 0)
+                    return i;
+            }
+            throw new NotSupportedException("JVMFieldLayout: cannot locate " + field.Name + " in " + typeof(T));
+        }
+
+        private static object allOnes(Type type)
+        {
+            if(type == typeof(bool)) return true;
+            if(type == typeof(byte)) return byte.MaxValue;
+            if(type == typeof(sbyte)) return (sbyte)-1;
+            if(type == typeof(char)) return char.MaxValue;
+            if(type == typeof(short)) return (short)-1;
+            if(type == typeof(long)) return -1L;
+            if(type == typeof(float)) return BitConverter.Int32BitsToSingle(-1);
+            if(type == typeof(double)) return BitConverter.Int64BitsToDouble(-1L);
+            if(type == typeof(IntPtr)) return new IntPtr(-1);
+            if(type.IsEnum) return Enum.ToObject(type, -1);
+            return -1;
+        }
+    }
+}
@@ -168,38 +168,44 @@ namespace QuantApp.Kernel.JVM
     {
         private JVMObject jenumerator;
         private JVMIDictionary jdic;
+        private JVMIteratorChunk chunk = new JVMIteratorChunk();
 
         public JVMDictionaryIEnumerator(JVMIDictionary jobj)
         {
             this.jdic = jobj;
             dynamic dyn = jobj;
-            this.jenumerator = dyn.Keys.iterator();
+            this.jenumerator = dyn.entrySet().iterator();
         }
 
         private KeyValuePair<object, object> _current;
         private bool _init = false;
 
+        private object[] _keys;
+        private object[] _values;
+        private int _index;
+        private bool _done;
+
         public bool MoveNext()
         {
             this._init = true;
-            dynamic jenum = this.jenumerator;
-            if(jenum.hasNext())
+            while(_values == null || _index >= _values.Length)
             {
-                object key = jenum.next();
-                _current = new KeyValuePair<object, object>(key, this.jdic[key]);
-                return true;
+                if(_done)
+                    return false;
+                long start = chunk.Start();
+                _values = Runtime.drainMapEntries(this.jenumerator, chunk.Size, out _keys, out _done);
+                _index = 0;
+                chunk.Next(start);
             }
-            return false;
+
+            _current = new KeyValuePair<object, object>(_keys[_index], _values[_index]);
+            _index++;
+            return true;
         }
 
         public void Reset()
         {
-            dynamic jenum = this.jenumerator;
-            while(jenum.hasNext()) 
-            {
-                object key = jenum.next();
-                _current = new KeyValuePair<object, object>(key, this.jdic[key]);
-            }
+            while(this.MoveNext()) {}
         }
 
         public KeyValuePair<object, object> Current
@@ -46,6 +46,7 @@ namespace QuantApp.Kernel.JVM
     {
         private JVMObject jenumerator;
         private JVMObject jobj;
+        private JVMIteratorChunk chunk = new JVMIteratorChunk();
 
         public JVMIEnumerator(JVMObject jobj)
         {
@@ -57,23 +58,30 @@ namespace QuantApp.Kernel.JVM
         private object _current;
         private bool _init = false;
 
+        private object[] _buffer;
+        private int _index;
+        private bool _done;
+
         public bool MoveNext()
         {
             this._init = true;
-            dynamic jenum = this.jenumerator;
-            if(jenum.hasNext())
+            while(_buffer == null || _index >= _buffer.Length)
             {
-                _current = jenum.next();
-                return true;
+                if(_done)
+                    return false;
+                long start = chunk.Start();
+                _buffer = Runtime.drainIterator(this.jenumerator, chunk.Size, out _done);
+                _index = 0;
+                chunk.Next(start);
             }
-            return false;
+
+            _current = _buffer[_index++];
+            return true;
         }
 
         public void Reset()
         {
-            dynamic jenum = this.jenumerator;
-            while(jenum.hasNext()) 
-               _current = jenum.next();
+            while(this.MoveNext()) {}
         }
 
         public object Current
@@ -120,4 +128,32 @@ namespace QuantApp.Kernel.JVM
             this.disposedValue = true;
         }
     }
+
+    /// <summary>
+    /// Chunk size for draining a Java iterator. Starts small so a loop that stops early does not pull the whole
+    /// collection, doubles while refills are quick and halves when one takes too long.
+    /// </summary>
+    internal class JVMIteratorChunk
+    {
+        private const int MinSize = 16;
+        private const int MaxSize = 4096;
+        private static readonly long FastTicks = System.Diagnostics.Stopwatch.Frequency / 500;   // 2ms
+        private static readonly long SlowTicks = System.Diagnostics.Stopwatch.Frequency / 50;    // 20ms
+
+        public int Size { get; private set; } = MinSize;
+
+        public long Start()
+        {
+            return System.Diagnostics.Stopwatch.GetTimestamp();
+        }
+
+        public void Next(long start)
+        {
+            long elapsed = System.Diagnostics.Stopwatch.GetTimestamp() - start;
+            if(elapsed < FastTicks && Size < MaxSize)
+                Size *= 2;
+            else if(elapsed > SlowTicks && Size > MinSize)
+                Size /= 2;
+        }
+    }
 }
\ No newline at end of file
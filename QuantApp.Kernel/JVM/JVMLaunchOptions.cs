@@ -0,0 +1,181 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+
+using Newtonsoft.Json;
+
+namespace QuantApp.Kernel.JVM
+{
+    public enum JVMSharedArchive
+    {
+        Off,
+        Use,
+        Dump,
+        Auto
+    }
+
+    /// <summary>
+    /// Launch profile for the embedded JVM, passed to Runtime.InitJVM.
+    /// The server reads it from the "JVM" section of coflows_config.json, e.g.
+    /// { "MaxHeap": "4g", "GC": "ZGC", "SharedArchive": "Auto", "SharedArchiveFile": "mnt/coflows.jsa", "Options": [ "-XX:+AlwaysPreTouch" ] }
+    /// </summary>
+    public class JVMLaunchOptions
+    {
+        /// <summary>
+        /// Maximum and initial heap sizes as given to -Xmx / -Xms, e.g. "4g".
+        /// </summary>
+        public string MaxHeap { get; set; }
+        public string InitialHeap { get; set; }
+
+        /// <summary>
+        /// Collector name without the Use/GC affixes: "G1", "Parallel", "Serial", "Z" or "Shenandoah".
+        /// </summary>
+        public string GC { get; set; }
+
+        public bool LargePages { get; set; }
+
+        /// <summary>
+        /// Application class data sharing for app.quant.clr.jar and the user jars.
+        /// Use maps an existing archive. Auto uses the archive if it exists; otherwise the first start records the
+        /// loaded classes next to the archive and the next one builds the archive from that list with java -Xshare:dump
+        /// before the JVM is created, which works on every JDK since 10 and does not need the JVM to exit.
+        /// Dump only records the list, except on JDK 13 and later where it writes the archive itself when the JVM
+        /// exits (see Runtime.DestroyJVM). Directories on the class path must be empty for the JVM to accept an archive.
+        /// </summary>
+        public JVMSharedArchive SharedArchive { get; set; }
+        public string SharedArchiveFile { get; set; }
+
+        /// <summary>
+        /// Native threads attached to the JVM at start up that run Runtime.InvokeAsync calls.
+        /// 0 starts one per processor and a negative value starts none, InvokeAsync then uses the ThreadPool.
+        /// </summary>
+        public int AsyncWorkers { get; set; }
+
+        /// <summary>
+        /// Raw options appended after the ones above, e.g. "-XX:+UseStringDeduplication".
+        /// </summary>
+        public List<string> Options { get; set; } = new List<string>();
+
+        public static JVMLaunchOptions FromJson(string json)
+        {
+            return string.IsNullOrWhiteSpace(json) ? new JVMLaunchOptions() : JsonConvert.DeserializeObject<JVMLaunchOptions>(json);
+        }
+
+        /// <summary>
+        /// Feature version of the JDK in JAVA_HOME, read from its release file, 0 when it cannot be told.
+        /// </summary>
+        public static int JavaVersion()
+        {
+            string home = Environment.GetEnvironmentVariable("JAVA_HOME");
+            string release = string.IsNullOrEmpty(home) ? null : Path.Combine(home, "release");
+            if(release == null || !File.Exists(release))
+                return 0;
+
+            foreach(var line in File.ReadAllLines(release))
+            {
+                if(!line.StartsWith("JAVA_VERSION="))
+                    continue;
+
+                // "11.0.13", "17" or "1.8.0_292"
+                var parts = line.Substring("JAVA_VERSION=".Length).Trim('"').Split('.', '_', '-', '+');
+                int version;
+                if(!int.TryParse(parts[0], out version))
+                    return 0;
+                if(version == 1 && parts.Length > 1)
+                    int.TryParse(parts[1], out version);
+                return version;
+            }
+            return 0;
+        }
+
+        internal string[] Build(string classpath)
+        {
+            var res = new List<string>();
+
+            if(!string.IsNullOrWhiteSpace(InitialHeap))
+                res.Add("-Xms" + InitialHeap);
+            if(!string.IsNullOrWhiteSpace(MaxHeap))
+                res.Add("-Xmx" + MaxHeap);
+
+            if(!string.IsNullOrWhiteSpace(GC))
+            {
+                string gc = GC.Trim();
+                if(gc.EndsWith("GC", StringComparison.OrdinalIgnoreCase))
+                    gc = gc.Substring(0, gc.Length - 2);
+                res.Add("-XX:+Use" + gc + "GC");
+            }
+
+            if(LargePages)
+                res.Add("-XX:+UseLargePages");
+
+            if(SharedArchive != JVMSharedArchive.Off)
+            {
+                if(string.IsNullOrWhiteSpace(SharedArchiveFile))
+                    throw new ArgumentException("JVMLaunchOptions: SharedArchiveFile is required when SharedArchive is " + SharedArchive);
+
+                // -XX:ArchiveClassesAtExit is JDK 13+, unknown versions take the class list route.
+                bool atExit = SharedArchive == JVMSharedArchive.Dump && JavaVersion() >= 13;
+                string classList = ClassListFile;
+
+                bool use = SharedArchive == JVMSharedArchive.Use || (SharedArchive == JVMSharedArchive.Auto &&
+                    (File.Exists(SharedArchiveFile) || (File.Exists(classList) && dumpSharedArchive(classpath, classList))));
+                if(use)
+                {
+                    res.Add("-XX:SharedArchiveFile=" + SharedArchiveFile);
+                    res.Add("-Xshare:auto");
+                }
+                else if(atExit)
+                    res.Add("-XX:ArchiveClassesAtExit=" + SharedArchiveFile);
+                else
+                    res.Add("-XX:DumpLoadedClassList=" + classList);
+            }
+
+            if(Options != null)
+                foreach(var option in Options)
+                    if(!string.IsNullOrWhiteSpace(option))
+                        res.Add(option.Trim());
+
+            return res.ToArray();
+        }
+
+        private string ClassListFile
+        {
+            get { return Path.ChangeExtension(SharedArchiveFile, ".classlist"); }
+        }
+
+        // Archives the classes listed by an earlier run with a separate java -Xshare:dump over the same class path.
+        private bool dumpSharedArchive(string classpath, string classList)
+        {
+            string home = Environment.GetEnvironmentVariable("JAVA_HOME");
+            var info = new ProcessStartInfo(string.IsNullOrEmpty(home) ? "java" : Path.Combine(home, "bin", "java"),
+                "-Xshare:dump -XX:SharedClassListFile=\"" + classList + "\" -XX:SharedArchiveFile=\"" + SharedArchiveFile + "\" -cp \"" + classpath + "\"");
+            info.UseShellExecute = false;
+
+            try
+            {
+                using(var process = Process.Start(info))
+                {
+                    process.WaitForExit();
+                    if(process.ExitCode == 0 && File.Exists(SharedArchiveFile))
+                        return true;
+                }
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("JVMLaunchOptions: java -Xshare:dump not started: " + e.Message);
+            }
+
+            Console.WriteLine("JVMLaunchOptions: class data archive " + SharedArchiveFile + " not created, starting without it");
+            return false;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+
+namespace QuantApp.Kernel.JVM
+{
+    /// <summary>
+    /// Scope for the JNI local references created on the current thread.
+    /// Threads attached from .NET never return to Java, so marshalling loops open one frame per element
+    /// and every reference created inside it is released when the frame is disposed.
+    /// Anything that must outlive the frame has to be stored in a Java object or registered by hash first.
+    /// </summary>
+    internal unsafe struct JVMLocalFrame : IDisposable
+    {
+        private readonly void* pEnv;
+        private readonly bool pushed;
+
+        public JVMLocalFrame(void* pEnv, int capacity)
+        {
+            this.pEnv = pEnv;
+            this.pushed = Runtime.PushFrame(pEnv, capacity) == 0;
+        }
+
+        public void Dispose()
+        {
+            if(pushed)
+                Runtime.PopFrame(pEnv, null, null);
+        }
+    }
+}
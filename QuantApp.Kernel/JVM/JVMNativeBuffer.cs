@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ 
+using System;
+
+namespace QuantApp.Kernel.JVM
+{
+    /// <summary>
+    /// Block of native memory, 64 byte aligned and recycled through a pool, that can be shared with Java
+    /// as direct ByteBuffers (see Runtime.GetJavaBuffer) for long lived data.
+    /// The memory is freed once this object is disposed and Java has dropped every buffer built on it.
+    /// </summary>
+    public unsafe sealed class JVMNativeBuffer : IDisposable
+    {
+        private long token;
+        private void* pData;
+        private readonly long capacity;
+
+        public JVMNativeBuffer(long capacity)
+        {
+            void* data;
+            this.token = Runtime.AllocNativeBuffer(capacity, &data);
+            if(this.token == 0)
+                throw new OutOfMemoryException("JVMNativeBuffer: could not allocate " + capacity + " bytes");
+
+            this.pData = data;
+            this.capacity = capacity;
+        }
+
+        ~JVMNativeBuffer()
+        {
+            Release();
+        }
+
+        public long Capacity { get { return capacity; } }
+
+        public IntPtr Address { get { return new IntPtr(Data()); } }
+
+        internal long Token
+        {
+            get
+            {
+                if(token == 0)
+                    throw new ObjectDisposedException("JVMNativeBuffer");
+                return token;
+            }
+        }
+
+        public Span<T> AsSpan<T>() where T : unmanaged
+        {
+            return new Span<T>(Data(), checked((int)(capacity / sizeof(T))));
+        }
+
+        public JVMObject ToJava()
+        {
+            return Runtime.GetJavaBuffer(this);
+        }
+
+        public void Dispose()
+        {
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        private void Release()
+        {
+            if(token == 0)
+                return;
+
+            Runtime.ReleaseNativeBuffer(token);
+            token = 0;
+            pData = null;
+        }
+
+        private void* Data()
+        {
+            if(pData == null)
+                throw new ObjectDisposedException("JVMNativeBuffer");
+            return pData;
+        }
+    }
+}
@@ -15,6 +15,7 @@ using System.Reflection;
 
 using System.Runtime.InteropServices;
 using System.Runtime.CompilerServices;
+using System.Threading.Tasks;
 
 using Python.Runtime;
 
@@ -51,17 +52,56 @@ namespace QuantApp.Kernel.JVM
         [DllImport(JVMDll)] private unsafe static extern int  JNI_CreateJavaVM(void** ppVm, void** ppEnv, void* pArgs);
         [DllImport(InvokerDll)] private unsafe static extern void SetfnGetProperty(void* func);
         [DllImport(InvokerDll)] private unsafe static extern void SetfnRemoveObject(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnRemoveObjects(void* func);
         [DllImport(InvokerDll)] private unsafe static extern void SetfnSetProperty(void* func);
         [DllImport(InvokerDll)] private unsafe static extern void SetfnInvokeFunc(void* func);
         [DllImport(InvokerDll)] private unsafe static extern void SetfnCreateInstance(void* func);
         [DllImport(InvokerDll)] public unsafe static extern void SetfnInvoke(void* func);
         [DllImport(InvokerDll)] public unsafe static extern void SetfnRegisterFunc(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnReleasePin(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnBindMethod(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallV(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallDV(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallDDV(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallDD(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallDDD(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallJJ(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallII(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnCallArrDD(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern int ThrowNewException(void* pEnv, string message);
         
         
-        [DllImport(InvokerDll)] private unsafe static extern int  AttacheThread(void* ppVm, void** pEnv);
-        [DllImport(InvokerDll)] private unsafe static extern int  DetacheThread(void* ppVm);
+        [DllImport(InvokerDll)] private unsafe static extern void* EnterThread(void* ppVm, string name);
+        [DllImport(InvokerDll), SuppressGCTransition] private unsafe static extern void* GetThreadEnv();
+        [DllImport(InvokerDll)] private unsafe static extern int  LeaveThread(void* ppVm);
         [DllImport(InvokerDll)] private unsafe static extern int  MakeJavaVMInitArgs(string classpath, string libpath, void** ppArgs );
+        [DllImport(InvokerDll)] private unsafe static extern int  MakeJavaVMInitArgsEx(string classpath, string libpath, int nExtra, string[] pExtra, void** ppArgs );
         [DllImport(InvokerDll)] private unsafe static extern void FreeJavaVMInitArgs( void* pArgs );
+        [DllImport(InvokerDll)] private unsafe static extern int  InitJNICache( void* pEnv );
+
+        [DllImport(InvokerDll)] internal unsafe static extern int  PushFrame( void* pEnv, int capacity);
+        [DllImport(InvokerDll)] internal unsafe static extern int  PopFrame( void* pEnv, void* result, void** pResult);
+        [DllImport(InvokerDll)] internal unsafe static extern int  DeleteLocalRef( void* pEnv, void* obj);
+        [DllImport(InvokerDll)] internal unsafe static extern int  NewGlobalRef( void* pEnv, void* obj, void** pRef);
+        [DllImport(InvokerDll)] internal unsafe static extern int  DeleteGlobalRef( void* pEnv, void* obj);
+        [DllImport(InvokerDll)] private unsafe static extern int  GetLocalRefStats( int* pCurrent, int* pPeak, int* pDepth);
+        [DllImport(InvokerDll)] private unsafe static extern int  EnableBoxCache( void* pEnv, int low, int high);
+        [DllImport(InvokerDll)] private unsafe static extern void ResetLocalRefPeak();
+
+        [DllImport(InvokerDll)] private unsafe static extern int  MetricsEnabled();
+        [DllImport(InvokerDll)] private unsafe static extern void SetMetricsEnabled( int enabled );
+        [DllImport(InvokerDll)] private unsafe static extern int  GetMetricCount();
+        [DllImport(InvokerDll)] private unsafe static extern IntPtr GetMetricName( int id );
+        [DllImport(InvokerDll)] private unsafe static extern int  GetMetricBucketCount();
+        [DllImport(InvokerDll)] private unsafe static extern long GetMetricBucketLowerBound( int bucket );
+        [DllImport(InvokerDll)] private unsafe static extern int  SnapshotMetrics( long* pSnapshots, int count );
+        [DllImport(InvokerDll)] private unsafe static extern void ResetMetrics();
+
+        [DllImport(InvokerDll)] private unsafe static extern void SetfnRunWork(void* func);
+        [DllImport(InvokerDll)] private unsafe static extern int  StartExecutor( void* pVM, int threads, int capacity);
+        [DllImport(InvokerDll)] private unsafe static extern int  SubmitWork( long token);
+        [DllImport(InvokerDll)] private unsafe static extern int  StopExecutor();
+        [DllImport(InvokerDll)] private unsafe static extern int  GetExecutorStats( int* pThreads, long* pSubmitted, long* pCompleted, long* pStolen);
 
         [DllImport(InvokerDll)] internal unsafe static extern int  FindClass( void* pEnv, String sClass, void** ppClass);
         
@@ -89,6 +129,10 @@ namespace QuantApp.Kernel.JVM
         [DllImport(InvokerDll)] private unsafe static extern int CallVoidMethod(void* pEnv, void* pClass, void* pMid, int len, void** pArgs);
 
         [DllImport(InvokerDll)] private unsafe static extern int GetObjectClass(void* pEnv, void* pObject, void** pClass, void** nameClass);
+        [DllImport(InvokerDll)] private unsafe static extern int UnboxObject(void* pEnv, void* pObject, TaggedValue* pResult);
+        [DllImport(InvokerDll)] private unsafe static extern int DrainIterator(void* pEnv, void* pIterator, int max, void** ppArgs, void** ppData, int* pCount, int* pDone);
+        [DllImport(InvokerDll)] private unsafe static extern int DrainMapEntries(void* pEnv, void* pIterator, int max, void** ppKeys, void** ppKeyData, void** ppValues, void** ppValueData, int* pCount, int* pDone);
+        [DllImport(InvokerDll)] private unsafe static extern void FreeTaggedArgs(void* pEnv, void* pArgs);
         [DllImport(InvokerDll)] internal unsafe static extern int CallStaticObjectMethod(void* pEnv, void* pClass, void* pMid, void** pObject, int len, void** pArgs);
         [DllImport(InvokerDll)] private unsafe static extern int CallObjectMethod(void* pEnv, void* pClass, void* pMid, void** pObject, int len, void** pArgs);
         [DllImport(InvokerDll)] private unsafe static extern int GetStaticObjectField(void* pEnv, void* pClass, void* pMid, void** pObject);
@@ -159,10 +203,14 @@ namespace QuantApp.Kernel.JVM
         [DllImport(InvokerDll)] private unsafe static extern int SetShortField(void* pEnv, void* pClass, void* pMid, short val);
 
 
-        [DllImport(InvokerDll)] internal unsafe static extern void* GetJavaString( void* pEnv, string str );
-        [DllImport(InvokerDll)] internal unsafe static extern string GetNetString( void* pEnv, void* jstr );
+        [DllImport(InvokerDll)] private unsafe static extern int GetStringUTF16( void* pEnv, void* jstr, char* pBuffer, int capacity, int* pLength );
+        [DllImport(InvokerDll)] private unsafe static extern void* NewStringUTF16( void* pEnv, char* pChars, int len );
+        [DllImport(InvokerDll)] private unsafe static extern void* InternStringUTF16( void* pEnv, char* pChars, int len );
 
-        [DllImport(InvokerDll)] internal unsafe static extern string GetException( void* pEnv );
+        [DllImport(InvokerDll)] private unsafe static extern int TakeException( void* pEnv, int captureDetail, void** pThrowable, void** pClassName, void** pMessage );
+        [DllImport(InvokerDll)] private unsafe static extern int DescribeException( void* pEnv, void* pThrowable, void** pTrace );
+        [DllImport(InvokerDll)] private unsafe static extern int GetExceptionCause( void* pEnv, void* pThrowable, void** pCause, void** pClassName, void** pMessage );
+        [DllImport(InvokerDll)] private unsafe static extern int ReleaseException( void* pEnv, void* pThrowable );
 
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewObjectArrayP( void*  pEnv, int nDimension, void* pClass, void** ppArray );
@@ -174,39 +222,109 @@ namespace QuantApp.Kernel.JVM
         [DllImport(InvokerDll)] internal unsafe static extern int NewIntArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetIntArrayElement( void* pEnv, void* pArray, int index, int value);
         [DllImport(InvokerDll)] internal unsafe static extern int GetIntArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetIntArrayRegion( void* pEnv, void* pArray, int offset, int count, int* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetIntArrayRegion( void* pEnv, void* pArray, int offset, int count, int* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewIntArrayFrom( void* pEnv, int* pSrc, int len, void** ppArray );
         
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewLongArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetLongArrayElement( void* pEnv, void* pArray, int index, long value);
         [DllImport(InvokerDll)] internal unsafe static extern long GetLongArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetLongArrayRegion( void* pEnv, void* pArray, int offset, int count, long* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetLongArrayRegion( void* pEnv, void* pArray, int offset, int count, long* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewLongArrayFrom( void* pEnv, long* pSrc, int len, void** ppArray );
         
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewFloatArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetFloatArrayElement( void* pEnv, void* pArray, int index, float value);
         [DllImport(InvokerDll)] internal unsafe static extern float GetFloatArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetFloatArrayRegion( void* pEnv, void* pArray, int offset, int count, float* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetFloatArrayRegion( void* pEnv, void* pArray, int offset, int count, float* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewFloatArrayFrom( void* pEnv, float* pSrc, int len, void** ppArray );
 
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewDoubleArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetDoubleArrayElement( void* pEnv, void* pArray, int index, double value);
         [DllImport(InvokerDll)] internal unsafe static extern double GetDoubleArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetDoubleArrayRegion( void* pEnv, void* pArray, int offset, int count, double* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetDoubleArrayRegion( void* pEnv, void* pArray, int offset, int count, double* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewDoubleArrayFrom( void* pEnv, double* pSrc, int len, void** ppArray );
 
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewBooleanArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetBooleanArrayElement( void* pEnv, void* pArray, int index, bool value);
         [DllImport(InvokerDll)] internal unsafe static extern bool GetBooleanArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetBooleanArrayRegion( void* pEnv, void* pArray, int offset, int count, bool* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetBooleanArrayRegion( void* pEnv, void* pArray, int offset, int count, bool* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewBooleanArrayFrom( void* pEnv, bool* pSrc, int len, void** ppArray );
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewByteArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetByteArrayElement( void* pEnv, void* pArray, int index, byte value);
         [DllImport(InvokerDll)] internal unsafe static extern byte GetByteArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetByteArrayRegion( void* pEnv, void* pArray, int offset, int count, byte* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetByteArrayRegion( void* pEnv, void* pArray, int offset, int count, byte* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewByteArrayFrom( void* pEnv, byte* pSrc, int len, void** ppArray );
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewShortArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetShortArrayElement( void* pEnv, void* pArray, int index, short value);
         [DllImport(InvokerDll)] internal unsafe static extern short GetShortArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetShortArrayRegion( void* pEnv, void* pArray, int offset, int count, short* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetShortArrayRegion( void* pEnv, void* pArray, int offset, int count, short* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewShortArrayFrom( void* pEnv, short* pSrc, int len, void** ppArray );
         
 
         [DllImport(InvokerDll)] internal unsafe static extern int NewCharArray( void* pEnv, int nDimension, void** ppArray );
         [DllImport(InvokerDll)] internal unsafe static extern int SetCharArrayElement( void* pEnv, void* pArray, int index, char value);
         [DllImport(InvokerDll)] internal unsafe static extern char GetCharArrayElement( void* pEnv, void* pArray, int index);
+        [DllImport(InvokerDll)] internal unsafe static extern int GetCharArrayRegion( void* pEnv, void* pArray, int offset, int count, char* pDst);
+        [DllImport(InvokerDll)] internal unsafe static extern int SetCharArrayRegion( void* pEnv, void* pArray, int offset, int count, char* pSrc);
+        [DllImport(InvokerDll)] internal unsafe static extern int NewCharArrayFrom( void* pEnv, char* pSrc, int len, void** ppArray );
+        
+
+        [DllImport(InvokerDll)] internal unsafe static extern int GetArrayCritical( void* pEnv, void* pArray, string sType, void** ppData, int* pLength );
+        [DllImport(InvokerDll)] internal unsafe static extern int ReleaseArrayCritical( void* pEnv, void* pArray, void* pData, int mode );
+        [DllImport(InvokerDll)] internal unsafe static extern int GetArrayElements( void* pEnv, void* pArray, string sType, void** ppData, int* pLength, bool* pIsCopy );
+        [DllImport(InvokerDll)] internal unsafe static extern int ReleaseArrayElements( void* pEnv, void* pArray, string sType, void* pData, int mode );
+
+        [DllImport(InvokerDll)] private unsafe static extern int CollectionSize( void* pEnv, void* pCollection, int* pSize );
+        [DllImport(InvokerDll)] private unsafe static extern int CollectionToDoubleArray( void* pEnv, void* pCollection, double* pDst, int cap, int* pCount );
+        [DllImport(InvokerDll)] private unsafe static extern int CollectionToLongArray( void* pEnv, void* pCollection, long* pDst, int cap, int* pCount );
+        [DllImport(InvokerDll)] private unsafe static extern int CollectionToIntArray( void* pEnv, void* pCollection, int* pDst, int cap, int* pCount );
+        [DllImport(InvokerDll)] private unsafe static extern int CollectionToFloatArray( void* pEnv, void* pCollection, float* pDst, int cap, int* pCount );
+        [DllImport(InvokerDll)] private unsafe static extern int NewDoubleArrayList( void* pEnv, double* pSrc, int len, void** ppList );
+        [DllImport(InvokerDll)] private unsafe static extern int NewLongArrayList( void* pEnv, long* pSrc, int len, void** ppList );
+        [DllImport(InvokerDll)] private unsafe static extern int NewIntArrayList( void* pEnv, int* pSrc, int len, void** ppList );
+        [DllImport(InvokerDll)] private unsafe static extern int NewFloatArrayList( void* pEnv, float* pSrc, int len, void** ppList );
+
+        [DllImport(InvokerDll)] private unsafe static extern int GetMatrixShape( void* pEnv, void* pArray, string sType, int rows, int* pLengths );
+        [DllImport(InvokerDll)] private unsafe static extern int GetMatrixRows( void* pEnv, void* pArray, string sType, int rows, void** pRows, int* pLengths, int threads );
+        [DllImport(InvokerDll)] private unsafe static extern int NewMatrix( void* pEnv, string sType, int rows, void** pRows, int* pLengths, int threads, void** ppArray );
+
+        [DllImport(InvokerDll)] internal unsafe static extern long AllocNativeBuffer( long size, void** ppData );
+        [DllImport(InvokerDll)] internal unsafe static extern int ReleaseNativeBuffer( long token );
+        [DllImport(InvokerDll)] private unsafe static extern int NewDirectBuffer( void* pEnv, long token, void** ppBuffer );
+        [DllImport(InvokerDll)] private unsafe static extern int NewPinnedDirectBuffer( void* pEnv, void* pAddress, long capacity, void* pPin, void** ppBuffer );
+
+        [DllImport(InvokerDll)] internal unsafe static extern long NewHandle( void* value );
+        [DllImport(InvokerDll)] internal unsafe static extern int FreeHandle( long handle );
+        [DllImport(InvokerDll)] internal unsafe static extern int GetHandleValue( long handle, void** pValue );
+        [DllImport(InvokerDll)] internal unsafe static extern int SetHandleValue( long handle, void* value );
+        [DllImport(InvokerDll)] internal unsafe static extern int HandleToID( long handle );
+        [DllImport(InvokerDll)] internal unsafe static extern long HandleFromID( int id );
+        [DllImport(InvokerDll)] internal unsafe static extern int NewGlobalHandle( void* pEnv, void* pObj, int weak, long* pHandle );
+        [DllImport(InvokerDll)] internal unsafe static extern int GetGlobalHandle( void* pEnv, long handle, void** ppObj );
+        [DllImport(InvokerDll)] internal unsafe static extern int RetainHandle( long handle );
+        [DllImport(InvokerDll)] internal unsafe static extern int ReleaseHandle( long handle );
+        [DllImport(InvokerDll)] internal unsafe static extern int ReleaseID( int id );
+
+        [DllImport(InvokerDll)] private unsafe static extern int NewFieldLayout( void* pEnv, void* pClass, int count, string[] names, string kinds, int[] offsets, void** ppLayout );
+        [DllImport(InvokerDll)] private unsafe static extern int FreeFieldLayout( void* pEnv, void* pLayout );
+        [DllImport(InvokerDll)] private unsafe static extern int GetFields( void* pEnv, void* pLayout, void* pObj, void* pStruct );
+        [DllImport(InvokerDll)] private unsafe static extern int SetFields( void* pEnv, void* pLayout, void* pObj, void* pStruct );
+        [DllImport(InvokerDll)] private unsafe static extern int NewObjectFromFields( void* pEnv, void* pLayout, void* pStruct, void** ppObj );
+
+        [DllImport(InvokerDll)] private unsafe static extern int CallBatch( void* pEnv, BatchCall* pCalls, int count, long* pArgs, BatchResult* pResults, int stopOnError );
+        [DllImport(InvokerDll)] private unsafe static extern int ThrowException( void* pEnv, void* pException );
         
 
         [DllImport(InvokerDll)] private unsafe static extern int DestroyJavaVM( void* pJVM );
@@ -215,6 +333,11 @@ namespace QuantApp.Kernel.JVM
 
         public static bool Loaded = false;
 
+        /// <summary>
+        /// Launch profile of the host, e.g. the "JVM" section of coflows_config.json, for callers of InitJVM to pass on.
+        /// </summary>
+        public static JVMLaunchOptions LaunchOptions { get; set; }
+
         private static SetCreateInstance delCreateInstance;
         private static GCHandle gchCallFunc;
         private static SetInvoke delInvoke;
@@ -229,8 +352,10 @@ namespace QuantApp.Kernel.JVM
         private static GCHandle gchGetProperty;
         private static SetRemoveObject delRemoveObject;
         private static GCHandle gchRemoveObject;
+        private static SetReleasePin delReleasePin;
+        private static GCHandle gchReleasePin;
         
-        public unsafe static int InitJVM(string classpath = ".:app.quant.clr.jar", string libpath = ".")
+        public unsafe static int InitJVM(string classpath = ".:app.quant.clr.jar", string libpath = ".", JVMLaunchOptions options = null)
         {
             delCreateInstance = new SetCreateInstance(Java_app_quant_clr_CLRRuntime_nativeCreateInstance);
             gchCallFunc = GCHandle.Alloc(delCreateInstance);
@@ -259,89 +384,68 @@ namespace QuantApp.Kernel.JVM
             delRemoveObject = new SetRemoveObject(Java_app_quant_clr_CLRRuntime_nativeRemoveObject);
             gchRemoveObject = GCHandle.Alloc(delRemoveObject);
             SetfnRemoveObject(Marshal.GetFunctionPointerForDelegate<SetRemoveObject>(delRemoveObject).ToPointer());
+            SetfnRemoveObjects(pinCallback<SetRemoveObjects>(Java_app_quant_clr_CLRRuntime_nativeRemoveObjects));
+
+            delReleasePin = new SetReleasePin(Java_app_quant_clr_CLRRuntime_nativeReleasePin);
+            gchReleasePin = GCHandle.Alloc(delReleasePin);
+            SetfnReleasePin(Marshal.GetFunctionPointerForDelegate<SetReleasePin>(delReleasePin).ToPointer());
+
+            SetfnBindMethod(pinCallback<SetBindMethod>(Java_app_quant_clr_CLRRuntime_nativeBindMethod));
+            SetfnCallV(pinCallback<SetCallV>(Java_app_quant_clr_CLRRuntime_nativeCallV));
+            SetfnCallDV(pinCallback<SetCallDV>(Java_app_quant_clr_CLRRuntime_nativeCallDV));
+            SetfnCallDDV(pinCallback<SetCallDDV>(Java_app_quant_clr_CLRRuntime_nativeCallDDV));
+            SetfnCallDD(pinCallback<SetCallDD>(Java_app_quant_clr_CLRRuntime_nativeCallDD));
+            SetfnCallDDD(pinCallback<SetCallDDD>(Java_app_quant_clr_CLRRuntime_nativeCallDDD));
+            SetfnCallJJ(pinCallback<SetCallJJ>(Java_app_quant_clr_CLRRuntime_nativeCallJJ));
+            SetfnCallII(pinCallback<SetCallII>(Java_app_quant_clr_CLRRuntime_nativeCallII));
+            SetfnCallArrDD(pinCallback<SetCallArrDD>(Java_app_quant_clr_CLRRuntime_nativeCallArrDD));
+            SetfnRunWork(pinCallback<SetRunWork>(runWork));
 
             void*  pJVM;    // JVM struct
             void*  pEnv;    // JVM environment
             void*  pVMArgs; // VM args
             
             // Fill the pVMArgs structs
-            MakeJavaVMInitArgs(classpath, libpath, &pVMArgs );
+            var extraOptions = options == null ? new string[0] : options.Build(classpath);
+            MakeJavaVMInitArgsEx(classpath, libpath, extraOptions.Length, extraOptions, &pVMArgs );
             
             // Create JVM
             int nRes = JNI_CreateJavaVM( &pJVM, &pEnv, pVMArgs );
+            FreeJavaVMInitArgs( pVMArgs );
             
             if(nRes == 0)
             {
                 JVMPtr = (IntPtr)pJVM;
                 Loaded = true;
+
+                // Resolve the boxing and error-path classes once instead of on every call
+                if(InitJNICache(pEnv) != 0)
+                    Console.WriteLine("CLR InitJVM: app/quant/clr/CLRRuntime not found in class path");
+
+                int workers = options == null || options.AsyncWorkers == 0 ? Environment.ProcessorCount : options.AsyncWorkers;
+                if(workers > 0 && StartExecutor(pJVM, workers, asyncQueueCapacity) != 0)
+                    Console.WriteLine("CLR InitJVM: async workers not started, InvokeAsync runs on the ThreadPool");
             }
 
             var classpathList = classpath.Substring(1).Split(':');
 
             SetClassPath(classpathList);
 
-            // Background thread to clean null entries in the caches.
-
-            var th = new System.Threading.Thread(() => {
-                while(true)
-                {
-                    try
-                    {
-                        System.Threading.Thread.Sleep(10000);
-                        foreach(var _id in __DB.Keys.ToArray())
-                        {
-                            object ob;
-                            if(__DB.TryGetValue(_id, out ob))
-                            {
-                                if(ob == null)
-                                {
-                                    __DB.TryRemove(_id, out ob);
-
-                                    if(MethodDB.ContainsKey(_id)) //NO
-                                    {
-                                        ConcurrentDictionary<string,MethodInfo> _o;
-                                        MethodDB.TryRemove(_id, out _o);
-                                    }
-                                }
-                            }
-                        }
-
-                        foreach(var _id in DB.Keys.ToArray())
-                        {
-                            WeakReference ob;
-                            if(DB.TryGetValue(_id, out ob))
-                            {
-                                if(ob == null)
-                                {
-                                    DB.TryRemove(_id, out ob);
-
-                                    if(MethodDB.ContainsKey(_id)) //NO
-                                    {
-                                        ConcurrentDictionary<string,MethodInfo> _o;
-                                        MethodDB.TryRemove(_id, out _o);
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    catch{}
-                }
-            });
-            th.Start();
 
 
             return nRes;        
         }
 
         internal static ConditionalWeakTable<object, object> DBID = new ConditionalWeakTable<object, object>();
-        private readonly static object objLock_GetID = new object();
+        // GetID is check-then-create per object, so it is serialized per stripe of objects rather than globally.
+        private readonly static object[] objLocks_GetID = Enumerable.Range(0, 64).Select(_ => new object()).ToArray();
         public static unsafe int GetID(object obj, bool cache)
         {
-            lock(objLock_GetID)
-            {
-                if(obj == null)
-                    return 0;
+            if(obj == null)
+                return 0;
 
+            lock(objLocks_GetID[(RuntimeHelpers.GetHashCode(obj) & 0x7fffffff) % objLocks_GetID.Length])
+            {
                 var _type = obj.GetType();
                 
                 object _id;
@@ -366,182 +470,500 @@ namespace QuantApp.Kernel.JVM
             }
         }
 
-        private readonly static object objLock_CreateID = new object();
         internal unsafe static int CreateID()
         {
-            lock(objLock_CreateID)
+            // IDs come straight from the native handle table shared with Java. It never reissues an ID, so once its
+            // 31 bit space is used up there is nothing safe to fall back to.
+            int id = HandleToID(NewHandle(null));
+            if(id == 0)
+                throw new Exception("CreateID: bridge handle table exhausted, no object IDs left");
+            return id;
+        }
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeRemoveObject(void* pEnv, int ptr)
+        {
+            if(__DB.ContainsKey(ptr))
             {
-                void*  pEnv;
-                if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
-                void* pNetBridgeClass;
-                void* pSetPathMethod;
+                object oo;
+                __DB.TryRemove(ptr, out oo);
+            }
+            unbindMethods(ptr);
+            return 0;
+        }
+        private unsafe delegate int SetRemoveObject(void* pEnv, int hashCode);
 
-                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0 )
-                {
-                    if( GetStaticMethodID( pEnv, pNetBridgeClass, "CreateID", "()I", &pSetPathMethod ) == 0 )
-                    {
-                        void** pArg_lcs = stackalloc void*[0];
-                        
-                        int _res = 0;
-                        if(CallStaticIntMethod( pEnv, pNetBridgeClass, pSetPathMethod, 0, pArg_lcs,  &_res) != 0)
-                            Console.WriteLine("CLR JAVA CreateID Object error");
+        private static unsafe void Java_app_quant_clr_CLRRuntime_nativeRemoveObjects(void* pEnv, int* ids, int count)
+        {
+            for(int i = 0; i < count; i++)
+                Java_app_quant_clr_CLRRuntime_nativeRemoveObject(pEnv, ids[i]);
+        }
+        private unsafe delegate void SetRemoveObjects(void* pEnv, int* ids, int count);
 
-                        return _res;
-                    }
-                    else
-                        Console.WriteLine("CreateID method not found");
+        private static unsafe void Java_app_quant_clr_CLRRuntime_nativeReleasePin(void* pin)
+        {
+            GCHandle.FromIntPtr(new IntPtr(pin)).Free();
+        }
+        private unsafe delegate void SetReleasePin(void* pin);
 
-                    
+        /*
+        Primitive callbacks: Java binds a .NET method once (CLRObject.InvokeDouble and friends) and then calls it
+        through a typed function pointer, without boxing the arguments into an Object[].
+        */
+        private class BoundMethod
+        {
+            public int HashCode;
+            public Delegate Func;
+        }
+
+        private static readonly ConcurrentDictionary<int, BoundMethod> BoundDB = new ConcurrentDictionary<int, BoundMethod>();
+        // Tokens bound per object, so releasing an object does not scan every bound method.
+        private static readonly ConcurrentDictionary<int, List<int>> BoundTokens = new ConcurrentDictionary<int, List<int>>();
+        private static int lastBoundToken = 0;
+        private static readonly List<GCHandle> gchPrimitiveCallbacks = new List<GCHandle>();
+
+        private static readonly Dictionary<string, Type> boundShapes = new Dictionary<string, Type>
+        {
+            { "()V", typeof(Action) },
+            { "(D)V", typeof(Action<double>) },
+            { "(DD)V", typeof(Action<double, double>) },
+            { "(D)D", typeof(Func<double, double>) },
+            { "(DD)D", typeof(Func<double, double, double>) },
+            { "(J)J", typeof(Func<long, long>) },
+            { "(I)I", typeof(Func<int, int>) },
+            { "([D)D", typeof(Func<double[], double>) }
+        };
+
+        // ([D)D target that reads the pinned Java array in place. Methods taking a double[] instead get a copy.
+        private delegate double ArraySpanFunc(ReadOnlySpan<double> values);
+
+        private unsafe static void* pinCallback<T>(T del) where T : Delegate
+        {
+            gchPrimitiveCallbacks.Add(GCHandle.Alloc(del));
+            return Marshal.GetFunctionPointerForDelegate<T>(del).ToPointer();
+        }
+
+        private static void unbindMethods(int hashCode)
+        {
+            List<int> tokens;
+            if(!BoundTokens.TryRemove(hashCode, out tokens))
+                return;
+
+            lock(tokens)
+            {
+                BoundMethod bm;
+                foreach(var token in tokens)
+                    BoundDB.TryRemove(token, out bm);
+            }
+        }
+
+        private static MethodInfo boundMethod(Type type, string funcname, bool isStatic, Type shape)
+        {
+            var invoke = shape.GetMethod("Invoke");
+            var types = invoke.GetParameters().Select(p => p.ParameterType).ToArray();
+
+            var method = type.GetMethod(funcname, BindingFlags.Public | (isStatic ? BindingFlags.Static : BindingFlags.Instance) | BindingFlags.FlattenHierarchy, null, types, null);
+            return method == null || method.ReturnType != invoke.ReturnType ? null : method;
+        }
+
+        private static unsafe int callbackError(void* pEnv, string name, int token, Exception e)
+        {
+            ThrowNewException(pEnv, "CLR " + name + "(" + token + "): " + (e.InnerException ?? e).Message);
+            return -1;
+        }
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeBindMethod(void* pEnv, int hashCode, string funcname, string signature)
+        {
+            try
+            {
+                Type shape;
+                if(!boundShapes.TryGetValue(signature, out shape))
+                    throw new Exception("unsupported signature " + signature);
+
+                WeakReference wr;
+                object obj = DB.TryGetValue(hashCode, out wr) ? wr.Target : null;
+                if(obj == null)
+                    throw new Exception("no hashCode in DB: " + hashCode);
+
+                bool isStatic = obj is Type;
+                Type type = isStatic ? obj as Type : obj.GetType();
+
+                MethodInfo method = null;
+                if(shape == typeof(Func<double[], double>))
+                {
+                    method = boundMethod(type, funcname, isStatic, typeof(ArraySpanFunc));
+                    if(method != null)
+                        shape = typeof(ArraySpanFunc);
                 }
+                if(method == null)
+                    method = boundMethod(type, funcname, isStatic, shape);
+                if(method == null)
+                    throw new Exception(type + "." + funcname + signature + " not found");
+
+                var func = isStatic ? Delegate.CreateDelegate(shape, method) : Delegate.CreateDelegate(shape, obj, method);
+
+                int token = System.Threading.Interlocked.Increment(ref lastBoundToken);
+                BoundDB[token] = new BoundMethod{ HashCode = hashCode, Func = func };
 
+                var tokens = BoundTokens.GetOrAdd(hashCode, _ => new List<int>());
+                lock(tokens)
+                    tokens.Add(token);
+                return token;
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeBindMethod(" + hashCode + "): " + funcname + signature + " " + e.Message);
+                return -1;
+            }
+        }
+        private unsafe delegate int SetBindMethod(void* pEnv, int hashCode, string funcname, string signature);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallV(void* pEnv, int token)
+        {
+            try { ((Action)BoundDB[token].Func)(); return 0; }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallV", token, e); }
+        }
+        private unsafe delegate int SetCallV(void* pEnv, int token);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallDV(void* pEnv, int token, double a)
+        {
+            try { ((Action<double>)BoundDB[token].Func)(a); return 0; }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallDV", token, e); }
+        }
+        private unsafe delegate int SetCallDV(void* pEnv, int token, double a);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallDDV(void* pEnv, int token, double a, double b)
+        {
+            try { ((Action<double, double>)BoundDB[token].Func)(a, b); return 0; }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallDDV", token, e); }
+        }
+        private unsafe delegate int SetCallDDV(void* pEnv, int token, double a, double b);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallDD(void* pEnv, int token, double a, double* pResult)
+        {
+            try { *pResult = ((Func<double, double>)BoundDB[token].Func)(a); return 0; }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallDD", token, e); }
+        }
+        private unsafe delegate int SetCallDD(void* pEnv, int token, double a, double* pResult);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallDDD(void* pEnv, int token, double a, double b, double* pResult)
+        {
+            try { *pResult = ((Func<double, double, double>)BoundDB[token].Func)(a, b); return 0; }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallDDD", token, e); }
+        }
+        private unsafe delegate int SetCallDDD(void* pEnv, int token, double a, double b, double* pResult);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallJJ(void* pEnv, int token, long a, long* pResult)
+        {
+            try { *pResult = ((Func<long, long>)BoundDB[token].Func)(a); return 0; }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallJJ", token, e); }
+        }
+        private unsafe delegate int SetCallJJ(void* pEnv, int token, long a, long* pResult);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallII(void* pEnv, int token, int a, int* pResult)
+        {
+            try { *pResult = ((Func<int, int>)BoundDB[token].Func)(a); return 0; }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallII", token, e); }
+        }
+        private unsafe delegate int SetCallII(void* pEnv, int token, int a, int* pResult);
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCallArrDD(void* pEnv, int token, double* pArray, int len, double* pResult)
+        {
+            try
+            {
+                var values = new ReadOnlySpan<double>(pArray, len);
+                var func = BoundDB[token].Func;
+
+                var spanFunc = func as ArraySpanFunc;
+                *pResult = spanFunc != null ? spanFunc(values) : ((Func<double[], double>)func)(values.ToArray());
                 return 0;
             }
+            catch(Exception e) { return callbackError(pEnv, "nativeCallArrDD", token, e); }
         }
+        private unsafe delegate int SetCallArrDD(void* pEnv, int token, double* pArray, int len, double* pResult);
 
-        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeRemoveObject(void* pEnv, int ptr)
+        [StructLayout(LayoutKind.Sequential)]
+        private unsafe struct TaggedArg
         {
-            if(__DB.ContainsKey(ptr))
+            public long Value;
+            public int Kind;
+            public int Length;
+            public int ElementKind;
+            public int Reserved;
+        }
+
+        /// <summary>
+        /// Converts the callback arguments decoded by JNIWrapper (see CallbackArgs) into .NET objects.
+        /// Scalars and strings are read straight from the buffer, only objects and arrays go back to the JVM.
+        /// </summary>
+        private unsafe static object[] getCallbackArgs(void* pEnv, int len, void* args)
+        {
+            var result = new object[len];
+            TaggedArg* pArgs = (TaggedArg*)args;
+            void* pNetBridgeClass = null;
+
+            for(int i = 0; i < len; i++)
             {
-                object oo;
-                __DB.TryRemove(ptr, out oo);
+                TaggedArg arg = pArgs[i];
+                switch((char)arg.Kind)
+                {
+                    case '\0': result[i] = null; break;
+                    case 'Z': result[i] = (arg.Value & 0xff) != 0; break;
+                    case 'B': result[i] = (byte)arg.Value; break;
+                    case 'C': result[i] = (char)(ushort)arg.Value; break;
+                    case 'S': result[i] = (short)arg.Value; break;
+                    case 'I': result[i] = (int)arg.Value; break;
+                    case 'J': result[i] = arg.Value; break;
+                    case 'F': result[i] = BitConverter.Int32BitsToSingle((int)arg.Value); break;
+                    case 'D': result[i] = BitConverter.Int64BitsToDouble(arg.Value); break;
+                    case 'T': result[i] = new string((char*)arg.Value, 0, arg.Length); break;
+                    case '[':
+                        if(pNetBridgeClass == null && FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0)
+                            throw GetJavaException(pEnv);
+                        string signature = arg.ElementKind == 'L' ? "[Ljava/lang/Object;" : "[" + (char)arg.ElementKind;
+                        result[i] = getJavaArray(pEnv, pNetBridgeClass, arg.Length, (void*)arg.Value, signature);
+                        break;
+                    default:
+                        void* pObj = (void*)arg.Value;
+                        int hashID_res = GetJVMID(pEnv, pObj, true);
+
+                        if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive) //check if it is a JVMDelegate
+                            result[i] = ((JVMDelegate)JVMDelegate.DB[hashID_res].Target).func;
+
+                        else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive) //check if it is a JVMObject
+                            result[i] = JVMObject.DB[hashID_res].Target;
+
+                        else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive) //check if it is a CLRObject
+                            result[i] = Runtime.DB[hashID_res].Target;
+
+                        else
+                            result[i] = getObject(pEnv, null, pObj);
+                        break;
+                }
             }
-            return 0;
+            return result;
+        }
+
+        /// <summary>
+        /// Reads up to max elements of a java.util.Iterator in one crossing. done is set once the iterator has no more elements.
+        /// </summary>
+        internal unsafe static object[] drainIterator(JVMObject iterator, int max, out bool done)
+        {
+            object[] keys;
+            return drainIterator(iterator, max, false, out keys, out done);
+        }
+
+        /// <summary>
+        /// Reads up to max entries of an iterator over a Map's entrySet in one crossing, keys and values as parallel arrays.
+        /// </summary>
+        internal unsafe static object[] drainMapEntries(JVMObject iterator, int max, out object[] keys, out bool done)
+        {
+            return drainIterator(iterator, max, true, out keys, out done);
         }
-        private unsafe delegate int SetRemoveObject(void* pEnv, int hashCode);
 
-        private readonly static object objLock_Java_app_quant_clr_CLRRuntime_nativeCreateInstance = new object();
-        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCreateInstance(void* pEnv, string classname, int len, void** args)
+        private unsafe static object[] drainIterator(JVMObject iterator, int max, bool entries, out object[] keys, out bool done)
         {
-            lock(objLock_Java_app_quant_clr_CLRRuntime_nativeCreateInstance)
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
             {
+                void* pNetBridgeClass;
+                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+
+                void* pIterator = GetJVMObject(pEnv, pNetBridgeClass, iterator.JavaHashCode);
+                if(pIterator == IntPtr.Zero.ToPointer())
+                    throw new Exception("Runtime Object not found: " + iterator.JavaHashCode);
+
+                void* pKeys = null;
+                void* pKeyData = null;
+                void* pValues;
+                void* pValueData;
+                int count;
+                int _done;
+                int res = entries ?
+                    DrainMapEntries(pEnv, pIterator, max, &pKeys, &pKeyData, &pValues, &pValueData, &count, &_done) :
+                    DrainIterator(pEnv, pIterator, max, &pValues, &pValueData, &count, &_done);
+
+                if(res == -2)
+                    throw new ArgumentException("Runtime drain: object is not a java.util.Iterator" + (entries ? " of Map.Entry" : ""));
+                else if(res != 0)
+                    throw GetJavaException(pEnv);
+
                 try
                 {
-                    void*  pNetBridgeClass;
-                    if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
+                    keys = entries ? getCallbackArgs(pEnv, count, pKeyData) : null;
+                    done = _done != 0;
+                    return getCallbackArgs(pEnv, count, pValueData);
+                }
+                finally
+                {
+                    FreeTaggedArgs(pEnv, pKeys);
+                    FreeTaggedArgs(pEnv, pValues);
+                }
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        private static unsafe int Java_app_quant_clr_CLRRuntime_nativeCreateInstance(void* pEnv, string classname, int len, void* args)
+        {
+            try
+            {
+                object[] classes_obj = len == 0 ? null : getCallbackArgs(pEnv, len, args);
+                
+                Type ct = null;
+                Assembly asm = System.Reflection.Assembly.GetEntryAssembly();
+                ct = asm.GetType(classname);
+
+                if(ct == null)
+                {
+                    asm = System.Reflection.Assembly.GetExecutingAssembly();
+                    ct = asm.GetType(classname);
+                }
 
-                    object[] classes_obj = len == 0 ? null : getJavaArray(pEnv, pNetBridgeClass, len, args, "[Ljava/lang/Object;");
-                    
-                    Type ct = null;
-                    Assembly asm = System.Reflection.Assembly.GetEntryAssembly();
+                if(ct == null)
+                {
+                    asm = System.Reflection.Assembly.GetCallingAssembly();
                     ct = asm.GetType(classname);
+                }
 
-                    if(ct == null)
+                
+                if(ct == null)
+                    foreach(Assembly assembly in M._compiledAssemblies.Values)
                     {
-                        asm = System.Reflection.Assembly.GetExecutingAssembly();
+                        asm = assembly;
                         ct = asm.GetType(classname);
+                        if(ct != null)
+                            break;
                     }
 
-                    if(ct == null)
+                if(ct == null)
+                    foreach(AssemblyName assemblyName in System.Reflection.Assembly.GetEntryAssembly().GetReferencedAssemblies())
                     {
-                        asm = System.Reflection.Assembly.GetCallingAssembly();
+                        asm = System.Reflection.Assembly.Load(assemblyName);
                         ct = asm.GetType(classname);
+                        if(ct != null)
+                            break;
                     }
 
-                    
-                    if(ct == null)
-                        foreach(Assembly assembly in M._compiledAssemblies.Values)
-                        {
-                            asm = assembly;
-                            ct = asm.GetType(classname);
-                            if(ct != null)
-                                break;
-                        }
-
-                    if(ct == null)
-                        foreach(AssemblyName assemblyName in System.Reflection.Assembly.GetEntryAssembly().GetReferencedAssemblies())
-                        {
-                            asm = System.Reflection.Assembly.Load(assemblyName);
-                            ct = asm.GetType(classname);
-                            if(ct != null)
-                                break;
-                        }
-
-                    if(ct == null)
-                        foreach(AssemblyName assemblyName in System.Reflection.Assembly.GetExecutingAssembly().GetReferencedAssemblies())
-                        {
-                            asm = System.Reflection.Assembly.Load(assemblyName);
-                            ct = asm.GetType(classname);
-                            if(ct != null)
-                                break;
-                        }
-
-
-                    if(ct == null)
-                        foreach(AssemblyName assemblyName in System.Reflection.Assembly.GetCallingAssembly().GetReferencedAssemblies())
-                        {
-                            asm = System.Reflection.Assembly.Load(assemblyName);
-                            ct = asm.GetType(classname);
-                            if(ct != null)
-                                break;
-                        }
-
-                    object obj = null;
-                    
-                    try
+                if(ct == null)
+                    foreach(AssemblyName assemblyName in System.Reflection.Assembly.GetExecutingAssembly().GetReferencedAssemblies())
                     {
-                        obj = asm.CreateInstance(
-                            typeName: classname, // string including namespace of the type
-                            ignoreCase: false,
-                            bindingAttr: BindingFlags.Default,
-                            binder: null,  // use default binder
-                            args: classes_obj,
-                            culture: null, // use CultureInfo from current thread
-                            activationAttributes: null
-                        );
-                    }
-                    catch(System.MissingMethodException e)
-                    {
-                        obj = ct;
+                        asm = System.Reflection.Assembly.Load(assemblyName);
+                        ct = asm.GetType(classname);
+                        if(ct != null)
+                            break;
                     }
 
-                    if(obj == null)
+
+                if(ct == null)
+                    foreach(AssemblyName assemblyName in System.Reflection.Assembly.GetCallingAssembly().GetReferencedAssemblies())
                     {
-                        Console.WriteLine("CLR Java_app_quant_clr_CLRRuntime_nativeCreateInstance obj null: " + classname + " (" + len + ") " + classes_obj);
-                        return 0;
+                        asm = System.Reflection.Assembly.Load(assemblyName);
+                        ct = asm.GetType(classname);
+                        if(ct != null)
+                            break;
                     }
 
-                    int hashCode = GetID(obj, true); // IMPORTANT TRUE
+                object obj = null;
                 
-                    if(!(obj is JVMObject) && !(obj is IJVMTuple))
-                        DB[hashCode] = new WeakReference(obj);
-
-                    return hashCode;
+                try
+                {
+                    obj = asm.CreateInstance(
+                        typeName: classname, // string including namespace of the type
+                        ignoreCase: false,
+                        bindingAttr: BindingFlags.Default,
+                        binder: null,  // use default binder
+                        args: classes_obj,
+                        culture: null, // use CultureInfo from current thread
+                        activationAttributes: null
+                    );
+                }
+                catch(System.MissingMethodException e)
+                {
+                    obj = ct;
                 }
-                catch(Exception e)
+
+                if(obj == null)
                 {
-                    Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeCreateInstance(" + classname + "): " + e);
-                    return -1;
+                    Console.WriteLine("CLR Java_app_quant_clr_CLRRuntime_nativeCreateInstance obj null: " + classname + " (" + len + ") " + classes_obj);
+                    return 0;
                 }
+
+                int hashCode = GetID(obj, true); // IMPORTANT TRUE
+            
+                if(!(obj is JVMObject) && !(obj is IJVMTuple))
+                    DB[hashCode] = new WeakReference(obj);
+
+                return hashCode;
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeCreateInstance(" + classname + "): " + e);
+                return -1;
             }
         }
-        private unsafe delegate int SetCreateInstance(void* pEnv, string classname, int len, void** args);
+        private unsafe delegate int SetCreateInstance(void* pEnv, string classname, int len, void* args);
         
-        internal static ConcurrentDictionary<int,ConcurrentDictionary<string,MethodInfo>> MethodDB = new ConcurrentDictionary<int,ConcurrentDictionary<string,MethodInfo>>();
-        private readonly static object objLock_Java_app_quant_clr_CLRRuntime_nativeInvoke = new object();
-        private static unsafe void* Java_app_quant_clr_CLRRuntime_nativeInvoke(void* pEnv, int hashCode, string funcname, int len, void** args)
+        /*
+        Java calls into .NET from any number of threads and the callbacks below run concurrently, none of them takes a
+        global lock. Objects of a type marked with JVMSerialized are the exception: calls into the same object take
+        one of a fixed set of monitors picked by its ID, so unrelated objects never wait on each other.
+        */
+        private readonly static object[] objLocks_Callback = Enumerable.Range(0, 64).Select(_ => new object()).ToArray();
+        private readonly static ConcurrentDictionary<Type, bool> serializedTypes = new ConcurrentDictionary<Type, bool>();
+
+        private struct CallbackGate : IDisposable
         {
-            lock(objLock_Java_app_quant_clr_CLRRuntime_nativeInvoke)
-            {                
-                try
+            private object monitor;
+
+            public static CallbackGate Enter(int hashCode, object obj)
+            {
+                var gate = new CallbackGate();
+                if(obj != null && serializedTypes.GetOrAdd(obj as Type ?? obj.GetType(), t => t.IsDefined(typeof(JVMSerializedAttribute), true)))
                 {
-                    void*  pNetBridgeClass;
-                    if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
+                    gate.monitor = objLocks_Callback[(hashCode & 0x7fffffff) % objLocks_Callback.Length];
+                    System.Threading.Monitor.Enter(gate.monitor);
+                }
+                return gate;
+            }
 
-                    object[] classes_obj = len == 0 ? null : getJavaArray(pEnv, pNetBridgeClass, len, args, "[Ljava/lang/Object;");
+            public void Dispose()
+            {
+                if(monitor != null)
+                    System.Threading.Monitor.Exit(monitor);
+            }
+        }
 
-                    if(DB.ContainsKey(hashCode) && DB[hashCode].IsAlive)
-                    {
-                        object obj = DB[hashCode].Target;
+        // Lock free for the lookups, a method missed by two threads at once is resolved twice and one of them is kept.
+        internal static ConcurrentDictionary<int,ConcurrentDictionary<string,MethodInfo>> MethodDB = new ConcurrentDictionary<int,ConcurrentDictionary<string,MethodInfo>>();
 
+        private static MethodInfo getCallbackMethod(int hashCode, Type type, string funcname, int len)
+        {
+            var methods = MethodDB.GetOrAdd(hashCode, _ => new ConcurrentDictionary<string,MethodInfo>());
+            var key = hashCode + funcname + len;
+
+            MethodInfo method;
+            if(methods.TryGetValue(key, out method))
+                return method;
+            return methods.GetOrAdd(key, getSuperMethod(type, funcname));
+        }
+        private static unsafe void* Java_app_quant_clr_CLRRuntime_nativeInvoke(void* pEnv, int hashCode, string funcname, int len, void* args)
+        {
+            try
+            {
+                object[] classes_obj = len == 0 ? null : getCallbackArgs(pEnv, len, args);
+
+                WeakReference reference;
+                object obj = DB.TryGetValue(hashCode, out reference) ? reference.Target : null;
+                if(obj != null)
+                {
+                    using(CallbackGate.Enter(hashCode, obj))
+                    {
                         if(obj is Type)
                         {
-                            var key = hashCode + funcname + len;
-                            if(!MethodDB.ContainsKey(hashCode))
-                                MethodDB.TryAdd(hashCode, new ConcurrentDictionary<string,MethodInfo>());
-
-                            if(!MethodDB[hashCode].ContainsKey(key))
-                                MethodDB[hashCode].TryAdd(key, getSuperMethod(obj as Type, funcname));
-                            MethodInfo method = MethodDB[hashCode][key];
+                            MethodInfo method = getCallbackMethod(hashCode, obj as Type, funcname, len);
                         
                             if(method == null)
                             {
@@ -571,14 +993,7 @@ namespace QuantApp.Kernel.JVM
                         }
                         else
                         {
-                            var key = hashCode + funcname + len;
-
-                            if(!MethodDB.ContainsKey(hashCode))
-                                MethodDB.TryAdd(hashCode, new ConcurrentDictionary<string,MethodInfo>());
-                                
-                            if(!MethodDB[hashCode].ContainsKey(key))
-                                MethodDB[hashCode].TryAdd(key, getSuperMethod(obj.GetType(), funcname));
-                            MethodInfo method = MethodDB[hashCode][key];
+                            MethodInfo method = getCallbackMethod(hashCode, obj.GetType(), funcname, len);
 
                             if(method == null)
                             {
@@ -595,18 +1010,17 @@ namespace QuantApp.Kernel.JVM
                             return ret;
                         }
                     }
-                    throw new Exception("Java_app_quant_clr_CLRRuntime_nativeInvoke: no hashCode in DB: " + hashCode);
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeInvoke(" + hashCode + "): " + funcname + " " + e);
                 }
-
-                return null;
+                throw new Exception("Java_app_quant_clr_CLRRuntime_nativeInvoke: no hashCode in DB: " + hashCode);
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeInvoke(" + hashCode + "): " + funcname + " " + e);
             }
+
+            return null;
         }
 
-        private readonly static object objLock_getSuperMethod = new object();
         private static MethodInfo getSuperMethod(Type type, string funcname)
         {
             if(type == null)
@@ -629,7 +1043,6 @@ namespace QuantApp.Kernel.JVM
             return method;
         }
 
-        private readonly static object objLock_getSuperField = new object();
         private static FieldInfo getSuperField(Type type, string funcname)
         {
             if(type == null)
@@ -653,7 +1066,6 @@ namespace QuantApp.Kernel.JVM
             return field;
         }
 
-        private readonly static object objLock_getSuperProperty = new object();
         private static PropertyInfo getSuperProperty(Type type, string funcname)
         {
             if(type == null)
@@ -676,661 +1088,608 @@ namespace QuantApp.Kernel.JVM
 
             return property;
         }
-        private unsafe delegate void* SetInvoke(void* pEnv, int ptr, string funcname, int len, void** args);
+        private unsafe delegate void* SetInvoke(void* pEnv, int ptr, string funcname, int len, void* args);
 
-        private readonly static object objLock_Java_app_quant_clr_CLRRuntime_nativeRegisterFunc = new object();
         private static unsafe void* Java_app_quant_clr_CLRRuntime_nativeRegisterFunc(void* pEnv, string funcname, int hashCode)
         {
-            lock(objLock_Java_app_quant_clr_CLRRuntime_nativeRegisterFunc)
+            try
             {
-                try
-                {
-                    JVMDelegate del = new JVMDelegate(funcname, hashCode);
-                    int hsh = GetID(del, false);
-                    if(DB.ContainsKey(hsh))
-                        Console.WriteLine("----- CLR 762 HASH Conflict");
-                    return IntPtr.Zero.ToPointer();
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeRegisterFunc: " + funcname + " " + e);
-                    return IntPtr.Zero.ToPointer();
-                }
+                JVMDelegate del = new JVMDelegate(funcname, hashCode);
+                GetID(del, false);
+                return IntPtr.Zero.ToPointer();
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeRegisterFunc: " + funcname + " " + e);
+                return IntPtr.Zero.ToPointer();
             }
             
         }
         private unsafe delegate void* SetRegisterFunc(void* pEnv, string funcname, int hashCode);
         
-        private readonly static object objLock_InvokeFunc = new object();
         public static unsafe object InvokeFunc(int hashCode, object[] args)
         {
-            lock(objLock_InvokeFunc)
+            try
             {
-                try
-                {
-                    void*  pEnv;
-                    if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+                void*  pEnv;
+                if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+                using var scope = new ThreadScope();
 
-                    bool nullResult = false;
+                bool nullResult = false;
 
-                    void*  pNetBridgeClass;
-                    if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0)
+                void*  pNetBridgeClass;
+                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0)
+                {
+                    void*  pInvokeMethod;
+                    if(GetStaticMethodID( pEnv, pNetBridgeClass, "InvokeDelegate", "(I[Ljava/lang/Object;)Ljava/lang/Object;", &pInvokeMethod ) == 0)
                     {
-                        void*  pInvokeMethod;
-                        if(GetStaticMethodID( pEnv, pNetBridgeClass, "InvokeDelegate", "(I[Ljava/lang/Object;)Ljava/lang/Object;", &pInvokeMethod ) == 0)
-                        {
-                            object[] pAr_len_data = args == null ? new object[]{ hashCode } : new object[]{ hashCode, args };
-                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                        object[] pAr_len_data = args == null ? new object[]{ hashCode } : new object[]{ hashCode, args };
+                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                            void*  pGetCLRObject;
-                            if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pInvokeMethod, &pGetCLRObject, args == null ? 1 : 2, pAr_len) == 0)
+                        void*  pGetCLRObject;
+                        if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pInvokeMethod, &pGetCLRObject, args == null ? 1 : 2, pAr_len) == 0)
+                        {
+                            if(new IntPtr(pGetCLRObject) != IntPtr.Zero)
                             {
-                                if(new IntPtr(pGetCLRObject) != IntPtr.Zero)
+                                void* pClass;
+                                void* pNameClass;
+                                if(GetObjectClass(pEnv, pGetCLRObject, &pClass, &pNameClass) == 0)
                                 {
-                                    void* pClass;
-                                    void* pNameClass;
-                                    if(GetObjectClass(pEnv, pGetCLRObject, &pClass, &pNameClass) == 0)
+                                    string clsName = GetNetString(pEnv, pNameClass);
+
+                                    switch(clsName)
                                     {
-                                        string clsName = GetNetString(pEnv, pNameClass);
+                                        case "java.lang.Boolean":
+                                            void*  pInvokeMethod_boolean;
+                                            GetMethodID( pEnv, pGetCLRObject, "booleanValue", "()Z", &pInvokeMethod_boolean );
+                                            
+                                            
+                                            void** pAr_boolean = stackalloc void*[1];
+                                            bool res_bool;
+                                            if(CallBooleanMethod( pEnv, pGetCLRObject, pInvokeMethod_boolean, 1, pAr_boolean, &res_bool) != 0)
+                                                throw GetJavaException(pEnv);
+                                            
+                                            return res_bool;
 
-                                        switch(clsName)
-                                        {
-                                            case "java.lang.Boolean":
-                                                void*  pInvokeMethod_boolean;
-                                                GetMethodID( pEnv, pGetCLRObject, "booleanValue", "()Z", &pInvokeMethod_boolean );
-                                                
-                                                
-                                                void** pAr_boolean = stackalloc void*[1];
-                                                bool res_bool;
-                                                if(CallBooleanMethod( pEnv, pGetCLRObject, pInvokeMethod_boolean, 1, pAr_boolean, &res_bool) != 0)
-                                                    throw new Exception(GetException(pEnv));
-                                                
-                                                DetacheThread((void*)JVMPtr);
-                                                return res_bool;
+                                        case "java.lang.Byte":
+                                            void*  pInvokeMethod_byte;
+                                            GetMethodID( pEnv, pGetCLRObject, "byteValue", "()B", &pInvokeMethod_byte );
+                                            
+                                            
+                                            void** pAr_byte = stackalloc void*[1];
+                                            byte res_byte;
+                                            if(CallByteMethod( pEnv, pGetCLRObject, pInvokeMethod_byte, 1, pAr_byte, &res_byte) != 0)
+                                                throw GetJavaException(pEnv);
+                                            return res_byte;
 
-                                            case "java.lang.Byte":
-                                                void*  pInvokeMethod_byte;
-                                                GetMethodID( pEnv, pGetCLRObject, "byteValue", "()B", &pInvokeMethod_byte );
-                                                
-                                                
-                                                void** pAr_byte = stackalloc void*[1];
-                                                byte res_byte;
-                                                if(CallByteMethod( pEnv, pGetCLRObject, pInvokeMethod_byte, 1, pAr_byte, &res_byte) != 0)
-                                                    throw new Exception(GetException(pEnv));
-                                                DetacheThread((void*)JVMPtr);
-                                                return res_byte;
-
-                                            case "java.lang.Character":
-                                                void*  pInvokeMethod_char;
-                                                GetMethodID( pEnv, pGetCLRObject, "charValue", "()C", &pInvokeMethod_char );
-                                                
-                                                
-                                                void** pAr_char = stackalloc void*[1];
-                                                char _res;
-                                                if(CallCharMethod( pEnv, pGetCLRObject, pInvokeMethod_char, 1, pAr_char, &_res) != 0)
-                                                    throw new Exception(GetException(pEnv));
-                                                
-                                                DetacheThread((void*)JVMPtr);
-                                                return _res;
+                                        case "java.lang.Character":
+                                            void*  pInvokeMethod_char;
+                                            GetMethodID( pEnv, pGetCLRObject, "charValue", "()C", &pInvokeMethod_char );
+                                            
+                                            
+                                            void** pAr_char = stackalloc void*[1];
+                                            char _res;
+                                            if(CallCharMethod( pEnv, pGetCLRObject, pInvokeMethod_char, 1, pAr_char, &_res) != 0)
+                                                throw GetJavaException(pEnv);
+                                            
+                                            return _res;
 
-                                            case "java.lang.Short":
-                                                void*  pInvokeMethod_short;
-                                                GetMethodID( pEnv, pGetCLRObject, "shortValue", "()S", &pInvokeMethod_short );
-                                                
-                                                
-                                                void** pAr_short = stackalloc void*[1];
-                                                short res_short;
-                                                if(CallShortMethod( pEnv, pGetCLRObject, pInvokeMethod_short, 1, pAr_short, &res_short) != 0)
-                                                    throw new Exception(GetException(pEnv));
-                                                
-                                                DetacheThread((void*)JVMPtr);
-                                                return res_short;
+                                        case "java.lang.Short":
+                                            void*  pInvokeMethod_short;
+                                            GetMethodID( pEnv, pGetCLRObject, "shortValue", "()S", &pInvokeMethod_short );
+                                            
+                                            
+                                            void** pAr_short = stackalloc void*[1];
+                                            short res_short;
+                                            if(CallShortMethod( pEnv, pGetCLRObject, pInvokeMethod_short, 1, pAr_short, &res_short) != 0)
+                                                throw GetJavaException(pEnv);
+                                            
+                                            return res_short;
 
-                                            case "java.lang.Integer":
-                                                void*  pInvokeMethod_int;
-                                                GetMethodID( pEnv, pGetCLRObject, "intValue", "()I", &pInvokeMethod_int );
-                                                
-                                                
-                                                void** pAr_int = stackalloc void*[1];
-                                                int res_int;
-                                                if(CallIntMethod( pEnv, pGetCLRObject, pInvokeMethod_int, 1, pAr_int, &res_int) != 0)
-                                                    throw new Exception(GetException(pEnv));
+                                        case "java.lang.Integer":
+                                            void*  pInvokeMethod_int;
+                                            GetMethodID( pEnv, pGetCLRObject, "intValue", "()I", &pInvokeMethod_int );
+                                            
+                                            
+                                            void** pAr_int = stackalloc void*[1];
+                                            int res_int;
+                                            if(CallIntMethod( pEnv, pGetCLRObject, pInvokeMethod_int, 1, pAr_int, &res_int) != 0)
+                                                throw GetJavaException(pEnv);
 
-                                                DetacheThread((void*)JVMPtr);
-                                                return res_int;
+                                            return res_int;
 
-                                            case "java.lang.Long":
-                                                void*  pInvokeMethod_long;
-                                                GetMethodID( pEnv, pGetCLRObject, "longValue", "()J", &pInvokeMethod_long );
-                                                
-                                                
-                                                void** pAr_long = stackalloc void*[1];
-                                                long res_long;
-                                                if(CallLongMethod( pEnv, pGetCLRObject, pInvokeMethod_long, 1, pAr_long, &res_long) != 0)
-                                                    throw new Exception(GetException(pEnv));
+                                        case "java.lang.Long":
+                                            void*  pInvokeMethod_long;
+                                            GetMethodID( pEnv, pGetCLRObject, "longValue", "()J", &pInvokeMethod_long );
+                                            
+                                            
+                                            void** pAr_long = stackalloc void*[1];
+                                            long res_long;
+                                            if(CallLongMethod( pEnv, pGetCLRObject, pInvokeMethod_long, 1, pAr_long, &res_long) != 0)
+                                                throw GetJavaException(pEnv);
 
-                                                DetacheThread((void*)JVMPtr);
-                                                return res_long;
+                                            return res_long;
 
 
-                                            case "java.lang.Float":
-                                                void*  pInvokeMethod_float;
-                                                GetMethodID( pEnv, pGetCLRObject, "floatValue", "()F", &pInvokeMethod_float );
-                                                
-                                                
-                                                void** pAr_float = stackalloc void*[1];
-                                                float res_float;
-                                                if(CallFloatMethod( pEnv, pGetCLRObject, pInvokeMethod_float, 1, pAr_float, &res_float) != 0)
-                                                    throw new Exception(GetException(pEnv));
+                                        case "java.lang.Float":
+                                            void*  pInvokeMethod_float;
+                                            GetMethodID( pEnv, pGetCLRObject, "floatValue", "()F", &pInvokeMethod_float );
+                                            
+                                            
+                                            void** pAr_float = stackalloc void*[1];
+                                            float res_float;
+                                            if(CallFloatMethod( pEnv, pGetCLRObject, pInvokeMethod_float, 1, pAr_float, &res_float) != 0)
+                                                throw GetJavaException(pEnv);
 
-                                                DetacheThread((void*)JVMPtr);
-                                                return res_float;
+                                            return res_float;
 
-                                            case "java.lang.Double":
-                                                void*  pInvokeMethod_double;
-                                                GetMethodID( pEnv, pGetCLRObject, "doubleValue", "()D", &pInvokeMethod_double );
-                                                
-                                                
-                                                void** pAr_double = stackalloc void*[1];
-                                                double res_double;
-                                                if(CallDoubleMethod( pEnv, pGetCLRObject, pInvokeMethod_double, 1, pAr_double, &res_double) != 0)
-                                                    throw new Exception(GetException(pEnv));
+                                        case "java.lang.Double":
+                                            void*  pInvokeMethod_double;
+                                            GetMethodID( pEnv, pGetCLRObject, "doubleValue", "()D", &pInvokeMethod_double );
+                                            
+                                            
+                                            void** pAr_double = stackalloc void*[1];
+                                            double res_double;
+                                            if(CallDoubleMethod( pEnv, pGetCLRObject, pInvokeMethod_double, 1, pAr_double, &res_double) != 0)
+                                                throw GetJavaException(pEnv);
 
-                                                DetacheThread((void*)JVMPtr);
-                                                return res_double;
+                                            return res_double;
 
 
-                                            case "java.lang.String":
-                                                var _ret_str = GetNetString(pEnv, pGetCLRObject);
-                                                DetacheThread((void*)JVMPtr);
-                                                return _ret_str;
+                                        case "java.lang.String":
+                                            var _ret_str = GetNetString(pEnv, pGetCLRObject);
+                                            return _ret_str;
 
 
-                                            case "java.time.LocalDateTime":
-                                                var _ret_dt = GetNetDateTime(pEnv, pGetCLRObject);
-                                                DetacheThread((void*)JVMPtr);
-                                                return _ret_dt;
+                                        case "java.time.LocalDateTime":
+                                            var _ret_dt = GetNetDateTime(pEnv, pGetCLRObject);
+                                            return _ret_dt;
 
-                                            default:
-                                                if(clsName.StartsWith("["))
+                                        default:
+                                            if(clsName.StartsWith("["))
+                                            {
+                                                int arr_len = getArrayLength(pEnv, pGetCLRObject);
+                                                var ret = getJavaArray(pEnv, pNetBridgeClass, arr_len, pGetCLRObject, clsName);
+                                                return ret;
+                                            }
+                                            else
+                                            {
+                                                int hashID_res = GetJVMID(pEnv, pGetCLRObject, true);
+
+                                                
+                                                if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive) //check if it is a CLRObject
+                                                {
+                                                    return JVMDelegate.DB[hashID_res].Target;
+                                                }
+
+                                                else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive) //check if it is a JVMObject
+                                                {
+                                                    return Runtime.DB[hashID_res].Target;
+                                                }
+
+
+                                                else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive) //check if it is a JVMObject
                                                 {
-                                                    int arr_len = getArrayLength(pEnv, pGetCLRObject);
-                                                    var ret = getJavaArray(pEnv, pNetBridgeClass, arr_len, pGetCLRObject, clsName);
-                                                    DetacheThread((void*)JVMPtr);
-                                                    return ret;
+                                                    return JVMObject.DB[hashID_res].Target;
                                                 }
+
                                                 else
                                                 {
-                                                    int hashID_res = GetJVMID(pEnv, pGetCLRObject, true);
+                                                    string cls = clsName.StartsWith("L") && clsName.EndsWith(";") ? clsName.Substring(1).Replace(";","") : clsName;
 
-                                                    
-                                                    if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive) //check if it is a CLRObject
-                                                    {
-                                                        DetacheThread((void*)JVMPtr);
-                                                        return JVMDelegate.DB[hashID_res].Target;
-                                                    }
-
-                                                    else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive) //check if it is a JVMObject
-                                                    {
-                                                        DetacheThread((void*)JVMPtr);
-                                                        return Runtime.DB[hashID_res].Target;
-                                                    }
-
-
-                                                    else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive) //check if it is a JVMObject
-                                                    {
-                                                        DetacheThread((void*)JVMPtr);
-                                                        return JVMObject.DB[hashID_res].Target;
-                                                    }
-
-                                                    else
-                                                    {
-                                                        string cls = clsName.StartsWith("L") && clsName.EndsWith(";") ? clsName.Substring(1).Replace(";","") : clsName;
-
-
-                                                        var _ret = CreateInstancePtr(pEnv, cls, null, new IntPtr(pGetCLRObject), null );
-                                                        DetacheThread((void*)JVMPtr);
-                                                        return _ret;
-                                                    }
+
+                                                    var _ret = CreateInstancePtr(pEnv, cls, null, new IntPtr(pGetCLRObject), null );
+                                                    return _ret;
                                                 }
-                                        }
-                                    
+                                            }
                                     }
-                                }
-                                else
-                                {
-                                    DetacheThread((void*)JVMPtr);
-                                    return null;
+                                
                                 }
                             }
                             else
                             {
-                                Console.WriteLine("---InvokeFunc(" + hashCode + "): " + args);
+                                return null;
                             }
-
                         }
+                        else
+                        {
+                            Console.WriteLine("---InvokeFunc(" + hashCode + "): " + args);
+                        }
+
                     }
-                    return null;
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CS InvokeFunc: " + e);
-                    return null;
                 }
+                return null;
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CS InvokeFunc: " + e);
+                return null;
             }
         }
 
-        private readonly static object objLock_getObjectPointer = new object();
         private static unsafe void* getObjectPointer(void* pEnv, object res)
         {
-            lock(objLock_getObjectPointer)
+            try
             {
-                try
+                if(res == null)
+                {
+                    Console.WriteLine("CLR getObjectPointer 1 not found: " + res);
+                    return IntPtr.Zero.ToPointer();
+                }
+
+                if(res is PyObject)
                 {
-                    if(res == null)
+                    var pres = res as PyObject;
+                    if(PyString.IsStringType(pres))
                     {
-                        Console.WriteLine("CLR getObjectPointer 1 not found: " + res);
-                        return IntPtr.Zero.ToPointer();
+                        res = pres.AsManagedObject(typeof(string));
                     }
 
-                    if(res is PyObject)
+                    else if(PyFloat.IsFloatType(pres))
                     {
-                        var pres = res as PyObject;
-                        if(PyString.IsStringType(pres))
-                        {
-                            res = pres.AsManagedObject(typeof(string));
-                        }
-
-                        else if(PyFloat.IsFloatType(pres))
-                        {
-                            res = pres.AsManagedObject(typeof(float));
-                        }
+                        res = pres.AsManagedObject(typeof(float));
+                    }
 
-                        else if(PyInt.IsIntType(pres))
-                        {
-                            res = pres.AsManagedObject(typeof(int));
-                        }
+                    else if(PyInt.IsIntType(pres))
+                    {
+                        res = pres.AsManagedObject(typeof(int));
+                    }
 
-                        else if(PyDict.IsDictType(pres))
-                        {
-                            res = pres.AsManagedObject(typeof(Dictionary<object, object>));
-                        }
+                    else if(PyDict.IsDictType(pres))
+                    {
+                        res = pres.AsManagedObject(typeof(Dictionary<object, object>));
+                    }
 
-                        else if(PyLong.IsLongType(pres))
-                        {
-                            res = pres.AsManagedObject(typeof(long));
-                        }
+                    else if(PyLong.IsLongType(pres))
+                    {
+                        res = pres.AsManagedObject(typeof(long));
+                    }
 
-                        else if(PyTuple.IsTupleType(pres))
-                        {
-                            res = pres.AsManagedObject(typeof(System.Tuple));
-                        }
+                    else if(PyTuple.IsTupleType(pres))
+                    {
+                        res = pres.AsManagedObject(typeof(System.Tuple));
                     }
+                }
 
 
-                    Type type = res == null ? null : res.GetType();
-        
-                    switch(Type.GetTypeCode(type))
-                    { 
-                        case TypeCode.Boolean:
-                            void* res_bool;
-                            if(NewBooleanObject(pEnv, (bool)res, &res_bool) == 0)
-                                return res_bool;
-                            else
-                                throw new Exception(GetException(pEnv));
-                            
-                        case TypeCode.Byte:
-                            void* res_byte;
-                            if(NewByteObject(pEnv, (byte)res, &res_byte) == 0)
-                                return res_byte;
-                            else
-                                throw new Exception(GetException(pEnv));
+                Type type = res == null ? null : res.GetType();
 
-                        case TypeCode.Char:
-                            void* res_char;
-                            if(NewCharacterObject(pEnv, (char)res, &res_char) == 0)
-                                return res_char;
-                            else
-                                throw new Exception(GetException(pEnv));
+                switch(Type.GetTypeCode(type))
+                { 
+                    case TypeCode.Boolean:
+                        void* res_bool;
+                        if(NewBooleanObject(pEnv, (bool)res, &res_bool) == 0)
+                            return res_bool;
+                        else
+                            throw GetJavaException(pEnv);
+                        
+                    case TypeCode.Byte:
+                        void* res_byte;
+                        if(NewByteObject(pEnv, (byte)res, &res_byte) == 0)
+                            return res_byte;
+                        else
+                            throw GetJavaException(pEnv);
 
-                        case TypeCode.Int16:
-                            void* res_short;
-                            if(NewShortObject(pEnv, (short)res, &res_short) == 0)
-                                return res_short;
-                            else
-                                throw new Exception(GetException(pEnv));
+                    case TypeCode.Char:
+                        void* res_char;
+                        if(NewCharacterObject(pEnv, (char)res, &res_char) == 0)
+                            return res_char;
+                        else
+                            throw GetJavaException(pEnv);
 
-                        case TypeCode.Int32: 
-                            void* res_int;
-                            if(NewIntegerObject(pEnv, (int)res, &res_int) == 0)
-                                return res_int;
-                            else
-                                throw new Exception(GetException(pEnv));
+                    case TypeCode.Int16:
+                        void* res_short;
+                        if(NewShortObject(pEnv, (short)res, &res_short) == 0)
+                            return res_short;
+                        else
+                            throw GetJavaException(pEnv);
 
-                        case TypeCode.Int64:
-                            void* res_long;
-                            if(NewLongObject(pEnv, (long)res, &res_long) == 0)
-                                return res_long;
-                            else
-                                throw new Exception(GetException(pEnv));
+                    case TypeCode.Int32: 
+                        void* res_int;
+                        if(NewIntegerObject(pEnv, (int)res, &res_int) == 0)
+                            return res_int;
+                        else
+                            throw GetJavaException(pEnv);
 
-                        case TypeCode.Single:
-                            void* res_float;
-                            if(NewFloatObject(pEnv, (float)res, &res_float) == 0)
-                                return res_float;
-                            else
-                                throw new Exception(GetException(pEnv));
+                    case TypeCode.Int64:
+                        void* res_long;
+                        if(NewLongObject(pEnv, (long)res, &res_long) == 0)
+                            return res_long;
+                        else
+                            throw GetJavaException(pEnv);
 
-                        case TypeCode.Double:
-                            void* res_double;
-                            if(NewDoubleObject(pEnv, (double)res, &res_double) == 0)
-                                return res_double;
-                            else
-                                throw new Exception(GetException(pEnv));
+                    case TypeCode.Single:
+                        void* res_float;
+                        if(NewFloatObject(pEnv, (float)res, &res_float) == 0)
+                            return res_float;
+                        else
+                            throw GetJavaException(pEnv);
 
-                        case TypeCode.String:
-                            void* string_arg = GetJavaString(pEnv, (string)res);
-                            return (void**)string_arg;
+                    case TypeCode.Double:
+                        void* res_double;
+                        if(NewDoubleObject(pEnv, (double)res, &res_double) == 0)
+                            return res_double;
+                        else
+                            throw GetJavaException(pEnv);
 
-                        case TypeCode.DateTime:
-                            void* date_arg = GetJavaDateTime(pEnv, (DateTime)res);
-                            return (void**)date_arg;
-                            
+                    case TypeCode.String:
+                        void* string_arg = GetJavaString(pEnv, (string)res);
+                        return (void**)string_arg;
 
-                        default:
+                    case TypeCode.DateTime:
+                        void* date_arg = GetJavaDateTime(pEnv, (DateTime)res);
+                        return (void**)date_arg;
+                        
 
-                            void*  pNetBridgeClass;
-                            if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception("Class not found");
+                    default:
 
-                            var id = GetID(res, true);
-                            
-                            if(res != null)
-                                res.RegisterGCEvent(id, delegate(object _obj, int _id)
-                                {
-                                    Runtime.RemoveID(_id);
-                                });
+                        void*  pNetBridgeClass;
+                        if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception("Class not found");
 
-                            if(res != null && JVMDelegate.DB.ContainsKey(id))
+                        var id = GetID(res, true);
+                        
+                        if(res != null)
+                            res.RegisterGCEvent(id, delegate(object _obj, int _id)
                             {
-                                JVMDelegate jobj = res as JVMDelegate; 
-                                return (void *)(jobj.Pointer);
-                            }
+                                Runtime.RemoveID(_id);
+                            });
+
+                        if(res != null && JVMDelegate.DB.ContainsKey(id))
+                        {
+                            JVMDelegate jobj = res as JVMDelegate; 
+                            return (void *)(jobj.Pointer);
+                        }
 
-                            else if(res != null && DB.ContainsKey(id))
+                        else if(res != null && DB.ContainsKey(id))
+                        {
+                            void*  pGetCLRObjectMethod;
+                            if(GetStaticMethodID( pEnv, pNetBridgeClass, "GetCLRObject", "(I)Lapp/quant/clr/CLRObject;", &pGetCLRObjectMethod ) == 0)
                             {
-                                void*  pGetCLRObjectMethod;
-                                if(GetStaticMethodID( pEnv, pNetBridgeClass, "GetCLRObject", "(I)Lapp/quant/clr/CLRObject;", &pGetCLRObjectMethod ) == 0)
-                                {
-                                    object[] pAr_len_data = new object[]{ id };
-                                    void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                object[] pAr_len_data = new object[]{ id };
+                                void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                    void*  pGetCLRObject;
-                                    if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pGetCLRObjectMethod, &pGetCLRObject, 1, pAr_len) == 0)
-                                    {
-                                        return pGetCLRObject;
-                                    }
-                                    else
-                                        throw new Exception(GetException(pEnv));
+                                void*  pGetCLRObject;
+                                if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pGetCLRObjectMethod, &pGetCLRObject, 1, pAr_len) == 0)
+                                {
+                                    return pGetCLRObject;
                                 }
                                 else
-                                    throw new Exception(GetException(pEnv));
+                                    throw GetJavaException(pEnv);
                             }
+                            else
+                                throw GetJavaException(pEnv);
+                        }
 
-                            else if(res is IJVMTuple)
-                            {
-                                IJVMTuple jobj = res as IJVMTuple; 
-                                void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JVMObject.JavaHashCode);
-                                return ptr;
-                            }
-                            else if(res is JVMTuple)
-                            {
-                                JVMTuple jobj = res as JVMTuple; 
-                                void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JavaHashCode);
-                                return ptr;
-                            }
-                            
-                            else if(res is JVMObject)
-                            {
-                                JVMObject jobj = res as JVMObject; 
+                        else if(res is IJVMTuple)
+                        {
+                            IJVMTuple jobj = res as IJVMTuple; 
+                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JVMObject.JavaHashCode);
+                            return ptr;
+                        }
+                        else if(res is JVMTuple)
+                        {
+                            JVMTuple jobj = res as JVMTuple; 
+                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JavaHashCode);
+                            return ptr;
+                        }
+                        
+                        else if(res is JVMObject)
+                        {
+                            JVMObject jobj = res as JVMObject; 
 
-                                void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JavaHashCode);
-                                return ptr;
-                            }
+                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JavaHashCode);
+                            return ptr;
+                        }
 
-                            else if(res is Array)
-                            {
-                                Array sub = res as Array;
-                                
-                                JVMObject javaArray = getJavaArray(pEnv, pNetBridgeClass, sub);
-                                
-                                void* ptr = GetJVMObject(pEnv, pNetBridgeClass, javaArray.JavaHashCode);
-                                return ptr;
-                            }
+                        else if(res is Array)
+                        {
+                            Array sub = res as Array;
+                            
+                            JVMObject javaArray = getJavaArray(pEnv, pNetBridgeClass, sub);
+                            
+                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, javaArray.JavaHashCode);
+                            return ptr;
+                        }
 
-                            else if(res is IEnumerable<object> || (res is PyObject && PyList.IsListType((PyObject)res)))
-                            {
-                                if(res is PyObject && PyList.IsListType((PyObject)res))
-                                    res = new PyList((PyObject)res);
-                                
-                                object[] pAr_len_data = new object[]{ res.GetType().ToString(), id };
-                                void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                        else if(res is IEnumerable<object> || (res is PyObject && PyList.IsListType((PyObject)res)))
+                        {
+                            if(res is PyObject && PyList.IsListType((PyObject)res))
+                                res = new PyList((PyObject)res);
+                            
+                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), id };
+                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                void* pObj;
-                                void* CLRObjClass;
-                                void*  pLoadClassMethod; // The executed method struct
-                                if(FindClass( pEnv, "app/quant/clr/CLRIterable", &CLRObjClass) == 0)
+                            void* pObj;
+                            void* CLRObjClass;
+                            void*  pLoadClassMethod; // The executed method struct
+                            if(FindClass( pEnv, "app/quant/clr/CLRIterable", &CLRObjClass) == 0)
+                            {
+                                void* pClass;
+                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                 {
-                                    void* pClass;
-                                    if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                    {
-                                        if(DB.ContainsKey(id))
-                                            Console.WriteLine("CLR 1238 Hash Conflict");
+                                    if(DB.ContainsKey(id))
+                                        Console.WriteLine("CLR 1238 Hash Conflict");
 
-                                        if(!(res is JVMObject) && !(res is IJVMTuple))
-                                            DB[id] = new WeakReference(res);
-                                        return pObj;
-                                    }
-                                    else
-                                        throw new Exception(GetException(pEnv));
+                                    if(!(res is JVMObject) && !(res is IJVMTuple))
+                                        DB[id] = new WeakReference(res);
+                                    return pObj;
                                 }
                                 else
-                                    throw new Exception(GetException(pEnv));
+                                    throw GetJavaException(pEnv);
                             }
+                            else
+                                throw GetJavaException(pEnv);
+                        }
 
-                            else if(res is IEnumerator<object>)
-                            {
-                                void* ptr_res = (void *)(res.GetHashCode());
+                        else if(res is IEnumerator<object>)
+                        {
+                            void* ptr_res = (void *)(res.GetHashCode());
 
-                                object[] pAr_len_data = new object[]{ res.GetType().ToString(), id };
-                                void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), id };
+                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                void* pObj;
-                                void* CLRObjClass;
-                                void*  pLoadClassMethod; // The executed method struct
-                                if(FindClass( pEnv, "app/quant/clr/CLRIterator", &CLRObjClass) == 0)
+                            void* pObj;
+                            void* CLRObjClass;
+                            void*  pLoadClassMethod; // The executed method struct
+                            if(FindClass( pEnv, "app/quant/clr/CLRIterator", &CLRObjClass) == 0)
+                            {
+                                void* pClass;
+                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                 {
-                                    void* pClass;
-                                    if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                    {
-                                        if(DB.ContainsKey(id))
-                                            Console.WriteLine("CLR 1268 Hash Conflict");
+                                    if(DB.ContainsKey(id))
+                                        Console.WriteLine("CLR 1268 Hash Conflict");
 
-                                        if(!(res is JVMObject) && !(res is IJVMTuple))
-                                            DB[id] = new WeakReference(res);
+                                    if(!(res is JVMObject) && !(res is IJVMTuple))
+                                        DB[id] = new WeakReference(res);
 
-                                        return pObj;
-                                    }
-                                    else
-                                        throw new Exception(GetException(pEnv));
+                                    return pObj;
                                 }
                                 else
-                                    throw new Exception(GetException(pEnv));
+                                    throw GetJavaException(pEnv);
                             }
-
                             else
-                            {
-                                object[] pAr_len_data = new object[]{ res.GetType().ToString(), id, false };
-                                
-                                void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
-
-                                void* pObj;
-                                void* CLRObjClass;
-                                void*  pLoadClassMethod; // The executed method struct
-                                if(FindClass( pEnv, "app/quant/clr/CLRObject", &CLRObjClass) == 0)
-                                {
-                                    void* pClass;
-                                    if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                    {
-                                        if(DB.ContainsKey(id))
-                                            Console.WriteLine("CLR 1299 Hash Conflict");
+                                throw GetJavaException(pEnv);
+                        }
 
-                                        if(!(res is JVMObject) && !(res is IJVMTuple))
-                                        {
-                                            DB[id] = new WeakReference(res);
-                                        }
-                                        return pObj;
+                        else
+                        {
+                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), id, false };
+                            
+                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+
+                            void* pObj;
+                            void* CLRObjClass;
+                            void*  pLoadClassMethod; // The executed method struct
+                            if(FindClass( pEnv, "app/quant/clr/CLRObject", &CLRObjClass) == 0)
+                            {
+                                void* pClass;
+                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
+                                {
+                                    if(DB.ContainsKey(id))
+                                        Console.WriteLine("CLR 1299 Hash Conflict");
+
+                                    if(!(res is JVMObject) && !(res is IJVMTuple))
+                                    {
+                                        DB[id] = new WeakReference(res);
                                     }
-                                    else
-                                        throw new Exception(GetException(pEnv));
+                                    return pObj;
                                 }
                                 else
-                                    throw new Exception(GetException(pEnv));
+                                    throw GetJavaException(pEnv);
                             }
-                                
-
-                            break;
-                    }
+                            else
+                                throw GetJavaException(pEnv);
+                        }
+                            
 
-                    Console.WriteLine("CLR getObjectPointer 2 not found: " + res);
-                    return IntPtr.Zero.ToPointer();
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR getObjectPointer error: " + e);
-                    return IntPtr.Zero.ToPointer();
+                        break;
                 }
+
+                Console.WriteLine("CLR getObjectPointer 2 not found: " + res);
+                return IntPtr.Zero.ToPointer();
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR getObjectPointer error: " + e);
+                return IntPtr.Zero.ToPointer();
             }
         }
 
-        private readonly static object objLock_Java_app_quant_clr_CLRRuntime_nativeInvokeFunc = new object();
-        private static unsafe void* Java_app_quant_clr_CLRRuntime_nativeInvokeFunc(void* pEnv, int hashCode, int len, void** args)
+        private static unsafe void* Java_app_quant_clr_CLRRuntime_nativeInvokeFunc(void* pEnv, int hashCode, int len, void* args)
         {
-            lock(objLock_Java_app_quant_clr_CLRRuntime_nativeInvokeFunc)
+            try
             {
-                try
-                {
-                    void*  pNetBridgeClass;
-                    if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0)
-                    {
-                        void*  pArrayClassesMethod;
-                        if(GetStaticMethodID( pEnv, pNetBridgeClass, "ArrayClasses", "([Ljava/lang/Object;)[Ljava/lang/String;", &pArrayClassesMethod ) == 0)
-                        {
-                            object[] classes_obj = getJavaArray(pEnv, pNetBridgeClass, len, args, "[Ljava/lang/Object;");
+                object[] classes_obj = getCallbackArgs(pEnv, len, args);
 
-                            if(JVMDelegate.DB.ContainsKey(hashCode) && JVMDelegate.DB[hashCode].IsAlive)
-                            {
-                                object res = ((JVMDelegate)JVMDelegate.DB[hashCode].Target).Invoke(classes_obj);
-                                var ret =  getObjectPointer(pEnv, res);
-                                return ret;
-                            }
-                            throw new Exception("JVMDelegate not found");
-                        }
-                    }
-                    
-                    throw new Exception(GetException(pEnv));
-                }
-                catch(Exception e)
+                WeakReference reference;
+                var del = JVMDelegate.DB.TryGetValue(hashCode, out reference) ? reference.Target as JVMDelegate : null;
+                if(del != null)
                 {
-                    Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeInvokeFunc: " + hashCode + " " + e);
+                    object res;
+                    using(CallbackGate.Enter(hashCode, del.func == null ? null : del.func.Target))
+                        res = del.Invoke(classes_obj);
+                    var ret =  getObjectPointer(pEnv, res);
+                    return ret;
                 }
-                return null;
+                throw new Exception("JVMDelegate not found");
             }
+            catch(Exception e)
+            {
+                Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeInvokeFunc: " + hashCode + " " + e);
+            }
+            return null;
         }
-        private unsafe delegate void* SetInvokeFunc(void* pEnv, int hashCode, int len, void** args);
+        private unsafe delegate void* SetInvokeFunc(void* pEnv, int hashCode, int len, void* args);
         
-        private readonly static object objLock_Java_app_quant_clr_CLRRuntime_nativeSetProperty = new object();
-        private static unsafe void Java_app_quant_clr_CLRRuntime_nativeSetProperty(void* pEnv, int hashCode, string name, void** args)
+        private static unsafe void Java_app_quant_clr_CLRRuntime_nativeSetProperty(void* pEnv, int hashCode, string name, int len, void* args)
         {
-            lock(objLock_Java_app_quant_clr_CLRRuntime_nativeSetProperty)
+            try
             {
-                try
+                WeakReference reference;
+                if(DB.TryGetValue(hashCode, out reference))
                 {
-                    void*  pNetBridgeClass;
-                    if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0)
+                    object obj = reference.Target;
+                    if(obj == null)
                     {
-                        void*  pArrayClassesMethod;
-                        if(GetStaticMethodID( pEnv, pNetBridgeClass, "ArrayClasses", "([Ljava/lang/Object;)[Ljava/lang/String;", &pArrayClassesMethod ) == 0)
-                        {
-                            if(DB.ContainsKey(hashCode))
-                            {
-                                object obj = DB[hashCode].Target;
-                                if(obj == null)
-                                {
-                                    return;
-                                }
+                        return;
+                    }
 
-                                
-                                if(obj is DynamicObject)
-                                {
-                                    Dynamic.InvokeSet(obj, name, obj);
-                                }
-                                else if(obj is ExpandoObject)
-                                {
-                                    var exp = obj as IDictionary<string, object>;
-                                    exp.Add(name, obj);
-                                }
-                                else
-                                {
-                                    Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeSetProperty");
-                                    int _arr_len = getArrayLength(pEnv, args);
-                                    object[] classes_obj = getJavaArray(pEnv, pNetBridgeClass, _arr_len, args, "[Ljava/lang/Object;");
+                    object[] classes_obj = getCallbackArgs(pEnv, len, args);
+                    object value = classes_obj != null && classes_obj.Length > 0 ? classes_obj[0] : null;
 
-                                    FieldInfo field = getSuperField(obj.GetType(), name);
-                                    if(field != null)
-                                        field.SetValue(obj, classes_obj[0]);
-                                    else
-                                    {
-                                        PropertyInfo property = getSuperProperty(obj.GetType(), name);
-                                        if(property != null)
-                                            property.SetValue(obj, classes_obj[0]);
-                                    }
-                                }
-                            }
+                    using(CallbackGate.Enter(hashCode, obj))
+                    {
+                        if(obj is DynamicObject)
+                        {
+                            Dynamic.InvokeSet(obj, name, value);
+                        }
+                        else if(obj is ExpandoObject)
+                        {
+                            var exp = obj as IDictionary<string, object>;
+                            exp[name] = value;
                         }
                         else
-                            throw new Exception("Get static ArrayClasses method");
+                        {
+                            FieldInfo field = getSuperField(obj.GetType(), name);
+                            if(field != null)
+                                field.SetValue(obj, value);
+                            else
+                            {
+                                PropertyInfo property = getSuperProperty(obj.GetType(), name);
+                                if(property != null)
+                                    property.SetValue(obj, value);
+                            }
+                        }
                     }
-                    else
-                        throw new Exception("Find CLRRuntime class error");
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR Java_app_quant_clr_CLRRuntime_nativeSetProperty: " + e);
                 }
             }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR Java_app_quant_clr_CLRRuntime_nativeSetProperty: " + e);
+            }
         }
-        private unsafe delegate void SetSetProperty(void* pEnv, int hashCode, string name, void** pObj);
+        private unsafe delegate void SetSetProperty(void* pEnv, int hashCode, string name, int len, void* args);
         
-        private readonly static object objLock_Java_app_quant_clr_CLRRuntime_nativeGetProperty = new object();
         private static unsafe void* Java_app_quant_clr_CLRRuntime_nativeGetProperty(void* pEnv, int hashCode, string name)
         {
-            lock(objLock_Java_app_quant_clr_CLRRuntime_nativeGetProperty)
+            try
             {
-                try
+                WeakReference reference;
+                if(DB.TryGetValue(hashCode, out reference))
                 {
-                    if(DB.ContainsKey(hashCode))
+                    object obj = reference.Target;
+                    if(obj == null)
+                        return null;
+                    
+                    using(CallbackGate.Enter(hashCode, obj))
                     {
-                        object obj = DB[hashCode].Target;
-                        if(obj == null)
-                            return null;
-                        
                         if(obj is DynamicObject)
                         {
                             try
                             {
 
                                 var res = Dynamic.InvokeGet(obj, name);
-                                
+                            
                                 if(res == null)
                                 {
                                     return IntPtr.Zero.ToPointer();
@@ -1362,10 +1721,10 @@ namespace QuantApp.Kernel.JVM
                             try
                             {
                                 FieldInfo field = getSuperField(obj.GetType(), name);
-                                
-                                
+                            
+                            
                                 object res;
-                                
+                            
                                 if(field != null)
                                     res = field.GetValue(obj);
                                 else
@@ -1390,15 +1749,15 @@ namespace QuantApp.Kernel.JVM
                             }
                         }
                     }
-
-                    Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeGetProperty ERROR NOT FOUND(" + hashCode + "): " + name);
-                    return null;
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR Java_app_quant_clr_CLRRuntime_nativeGetProperty: " + e);
-                    return (void*)IntPtr.Zero;
                 }
+
+                Console.WriteLine("Java_app_quant_clr_CLRRuntime_nativeGetProperty ERROR NOT FOUND(" + hashCode + "): " + name);
+                return null;
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR Java_app_quant_clr_CLRRuntime_nativeGetProperty: " + e);
+                return (void*)IntPtr.Zero;
             }
         }
         private unsafe delegate void* SetGetProperty(void* pEnv, int hashCode, string name);
@@ -1409,114 +1768,211 @@ namespace QuantApp.Kernel.JVM
         public delegate T wrapGetProperty<T>();
         public delegate void wrapSetProperty(object args);
 
-        private readonly static object objLock_GetNetDateTime = new object();
         public static unsafe DateTime GetNetDateTime(void* pEnv, void* pDate)
         {
-            lock(objLock_GetNetDateTime)
+            try
             {
-                try
+                if(pDate != IntPtr.Zero.ToPointer())
                 {
-                    if(pDate != IntPtr.Zero.ToPointer())
-                    {
-                        object[] pAr_len_data = new object[]{  };
-                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                    object[] pAr_len_data = new object[]{  };
+                    void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                        void*  pDateClass;
-                        if(FindClass( pEnv, "java/time/LocalDateTime", &pDateClass) == 0)
+                    void*  pDateClass;
+                    if(FindClass( pEnv, "java/time/LocalDateTime", &pDateClass) == 0)
+                    {
+                        void*  pInvokeMethod;
+                        if(GetMethodID( pEnv, pDate, "toString", "()Ljava/lang/String;", &pInvokeMethod ) == 0)
                         {
-                            void*  pInvokeMethod;
-                            if(GetMethodID( pEnv, pDate, "toString", "()Ljava/lang/String;", &pInvokeMethod ) == 0)
+                            void*  pDateStr;
+                            if(CallObjectMethod( pEnv, pDate, pInvokeMethod, &pDateStr, 0, pAr_len) == 0)
                             {
-                                void*  pDateStr;
-                                if(CallObjectMethod( pEnv, pDate, pInvokeMethod, &pDateStr, 0, pAr_len) == 0)
+                                if(new IntPtr(pDateStr) != IntPtr.Zero)
                                 {
-                                    if(new IntPtr(pDateStr) != IntPtr.Zero)
-                                    {
-                                        string str = GetNetString(pEnv, pDateStr);
-                                        return DateTime.Parse(str);
-                                    }
+                                    string str = GetNetString(pEnv, pDateStr);
+                                    return DateTime.Parse(str);
                                 }
-                                else
-                                    throw new Exception(GetException(pEnv));
                             }
                             else
-                                throw new Exception(GetException(pEnv));
+                                throw GetJavaException(pEnv);
                         }
                         else
-                            throw new Exception(GetException(pEnv));
+                            throw GetJavaException(pEnv);
                     }
-                
-                    return DateTime.MinValue;
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR GetNetDateTime: " + e);
-                    return DateTime.MinValue;
+                    else
+                        throw GetJavaException(pEnv);
                 }
+            
+                return DateTime.MinValue;
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR GetNetDateTime: " + e);
+                return DateTime.MinValue;
             }
         }
 
-        private readonly static object objLock_GetJavaDateTime = new object();
         public static unsafe void* GetJavaDateTime(void* pEnv, DateTime date)
         {
-            lock(objLock_GetJavaDateTime)
+            try
             {
-                try
-                {
-                    object[] pAr_len_data = new object[]{ date.Year, date.Month, date.Day, date.Hour, date.Minute, date.Second, date.Millisecond * 1000000 };
-                    void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                object[] pAr_len_data = new object[]{ date.Year, date.Month, date.Day, date.Hour, date.Minute, date.Second, date.Millisecond * 1000000 };
+                void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                    void*  pDateClass;
-                    if(FindClass( pEnv, "java/time/LocalDateTime", &pDateClass) == 0)
+                void*  pDateClass;
+                if(FindClass( pEnv, "java/time/LocalDateTime", &pDateClass) == 0)
+                {
+                    void*  pInvokeMethod;
+                    if(GetStaticMethodID( pEnv, pDateClass, "of", "(IIIIIII)Ljava/time/LocalDateTime;", &pInvokeMethod ) == 0)
                     {
-                        void*  pInvokeMethod;
-                        if(GetStaticMethodID( pEnv, pDateClass, "of", "(IIIIIII)Ljava/time/LocalDateTime;", &pInvokeMethod ) == 0)
-                        {
 
-                            void* pDate;
-                            if(CallStaticObjectMethod( pEnv, pDateClass, pInvokeMethod, &pDate, 7, pAr_len) == 0)
-                                return pDate;
-                            else
-                                throw new Exception(GetException(pEnv));
-                        }
+                        void* pDate;
+                        if(CallStaticObjectMethod( pEnv, pDateClass, pInvokeMethod, &pDate, 7, pAr_len) == 0)
+                            return pDate;
                         else
-                            throw new Exception(GetException(pEnv));
+                            throw GetJavaException(pEnv);
                     }
                     else
-                        throw new Exception(GetException(pEnv));
-
-                    return IntPtr.Zero.ToPointer();
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR GetJavaDateTime: " + e);
-                    return IntPtr.Zero.ToPointer();
+                        throw GetJavaException(pEnv);
                 }
+                else
+                    throw GetJavaException(pEnv);
+
+                return IntPtr.Zero.ToPointer();
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR GetJavaDateTime: " + e);
+                return IntPtr.Zero.ToPointer();
             }
         }
 
-        private readonly static object objLock_getJavaArray_1 = new object();
         private unsafe static JVMObject getJavaArray(void* pEnv, void* pNetBridgeClass, object[] array)
         {
-            lock(objLock_getJavaArray_1)
+            try
             {
-                try
+                if(true)
                 {
-                    if(true)
+                    if(array == null)
                     {
-                        if(array == null)
+                        Console.WriteLine("CLR getJavaArray JVMObject null");
+                        return null;
+                    }
+                    Array sub = array as Array;
+
+                    object lastObject = null;
+                    object[] values = new object[sub.Length];
+                    int idx = 0;
+
+                    string cls = "";
+                    foreach(var o_s in sub)
+                    {
+                        object res = o_s;
+                        if(res is PyObject)
                         {
-                            Console.WriteLine("CLR getJavaArray JVMObject null");
-                            return null;
+                            var pres = res as PyObject;
+                            if(PyString.IsStringType(pres))
+                                res = pres.AsManagedObject(typeof(string));
+
+                            else if(PyFloat.IsFloatType(pres))
+                                res = pres.AsManagedObject(typeof(float));
+
+                            else if(PyInt.IsIntType(pres))
+                                res = pres.AsManagedObject(typeof(int));
+
+                            else if(PyDict.IsDictType(pres))
+                                res = pres.AsManagedObject(typeof(Dictionary<object, object>));
+
+                            else if(PyList.IsListType(pres))
+                                res = pres.AsManagedObject(typeof(List<object>));
+
+                            else if(PyLong.IsLongType(pres))
+                                res = pres.AsManagedObject(typeof(long));
+
+                            else if(PySequence.IsSequenceType(pres))
+                                res = pres.AsManagedObject(typeof(IEnumerable<object>));
+
+                            else if(PyTuple.IsTupleType(pres))
+                                res = pres.AsManagedObject(typeof(System.Tuple));
                         }
-                        Array sub = array as Array;
 
-                        object lastObject = null;
+                        object o = res;
+                        values[idx++] = o;
 
-                        string cls = "";
-                        foreach(var o_s in sub)
+                        string ocls = o is JVMObject ? ((JVMObject)o).JavaClass : Runtime.TransformType(o);
+
+                        if(String.IsNullOrEmpty(cls))
+                            cls = ocls;
+                        else if(cls != ocls)
+                        {
+                            cls = "java/lang/Object";
+                            break;
+                        }
+                        lastObject = o;
+                    }
+
+                    bool isObject = false;
+                    void*  pJArray;
+                    int arrLength = sub.Length;
+                    switch(cls)
+                    {
+                        case "Z":
+                            pJArray = GetJavaBooleanArray(pEnv, Array.ConvertAll(values, x => (bool)x));
+                            break;
+
+                        case "B":
+                            pJArray = GetJavaByteArray(pEnv, Array.ConvertAll(values, x => (byte)x));
+                            break;
+
+                        case "C":
+                            pJArray = GetJavaCharArray(pEnv, Array.ConvertAll(values, x => (char)x));
+                            break;
+
+                        case "S":
+                            pJArray = GetJavaShortArray(pEnv, Array.ConvertAll(values, x => (short)x));
+                            break;
+
+                        case "I":
+                            pJArray = GetJavaIntArray(pEnv, Array.ConvertAll(values, x => (int)x));
+                            break;
+
+                        case "J":
+                            pJArray = GetJavaLongArray(pEnv, Array.ConvertAll(values, x => (long)x));
+                            break;
+
+                        case "F":
+                            pJArray = GetJavaFloatArray(pEnv, Array.ConvertAll(values, x => (float)x));
+                            break;
+
+                        case "D":
+                            pJArray = GetJavaDoubleArray(pEnv, Array.ConvertAll(values, x => (double)x));
+                            break;
+
+                        default:
+                            isObject = true;
+
+                            if(arrLength == 0)
+                                return null;
+
+                            if(!cls.Contains("java/lang/String"))
+                                cls = "java/lang/Object";
+
+
+                            if(NewObjectArray( pEnv, arrLength, cls, &pJArray ) != 0)
+                                throw GetJavaException(pEnv);
+                            break;
+                    }
+
+
+                    for(int ii = 0; isObject && ii < arrLength; ii++)
+                    {
+                        using var frame = new JVMLocalFrame(pEnv, 16);
+                        var sub_element = sub.GetValue(ii);
+                        if(sub_element == null)
+                            SetObjectArrayElement(pEnv, pJArray, ii, IntPtr.Zero.ToPointer());
+
+                        else
                         {
-                            object res = o_s;
+                            object res = sub_element;
                             if(res is PyObject)
                             {
                                 var pres = res as PyObject;
@@ -1545,1072 +2001,2333 @@ namespace QuantApp.Kernel.JVM
                                     res = pres.AsManagedObject(typeof(System.Tuple));
                             }
 
-                            object o = res;
+                            sub_element = res;
+                            
+                            var sub_type = sub_element.GetType();
+                            switch(Type.GetTypeCode(sub_type))
+                            { 
+                                case TypeCode.Boolean:
+                                    if(!isObject)
+                                        SetBooleanArrayElement(pEnv, pJArray, ii, (bool)sub_element);
+                                    else
+                                    {
+                                        void* pObjBool;
+                                        if(NewBooleanObject(pEnv, (bool)sub_element, &pObjBool) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjBool);
+                                    }
 
-                            string ocls = o is JVMObject ? ((JVMObject)o).JavaClass : Runtime.TransformType(o);
+                                    break;
 
-                            if(String.IsNullOrEmpty(cls))
-                                cls = ocls;
-                            else if(cls != ocls)
-                            {
-                                cls = "java/lang/Object";
-                                break;
-                            }
-                            lastObject = o;
-                        }
+                                case TypeCode.Byte:
+                                    if(!isObject)
+                                        SetByteArrayElement(pEnv, pJArray, ii, (byte)sub_element);
+                                    else
+                                    {
+                                        void* pObjB;
+                                        if(NewByteObject(pEnv, (byte)sub_element, &pObjB) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjB);
+                                    }
+                                    break;
 
-                        bool isObject = false;
-                        void*  pJArray;
-                        int arrLength = sub.Length;
-                        switch(cls)
-                        {
-                            case "Z":
-                                if(NewBooleanArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                case TypeCode.Char:
+                                    if(!isObject)
+                                        SetCharArrayElement(pEnv, pJArray, ii, (char)sub_element);
+                                    else
+                                    {
+                                        void* pObjC;
+                                        if(NewCharacterObject(pEnv, (char)sub_element, &pObjC) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjC);
+                                    }
+                                    break;
 
-                            case "B":
-                                if(NewByteArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                case TypeCode.Int16:
+                                    if(!isObject)
+                                        SetShortArrayElement(pEnv, pJArray, ii, (short)sub_element);
+                                    else
+                                    {
+                                        void* pObjS;
+                                        if(NewShortObject(pEnv, (short)sub_element, &pObjS) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjS);
+                                    }
+                                    break;
 
-                            case "C":
-                                if(NewCharArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                case TypeCode.Int32: 
+                                    if(!isObject)
+                                        SetIntArrayElement(pEnv, pJArray, ii, (int)sub_element);
+                                    else
+                                    {
+                                        void* pObjI;
+                                        if(NewIntegerObject(pEnv, (int)sub_element, &pObjI) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjI);
+                                    }
+                                    break;
+                                    
+                                case TypeCode.Int64:
+                                    if(!isObject)
+                                        SetLongArrayElement(pEnv, pJArray, ii, (long)sub_element);
+                                    else
+                                    {
+                                        void* pObjL;
+                                        if(NewLongObject(pEnv, (long)sub_element, &pObjL) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjL);
+                                    }
+                                    break;
 
-                            case "S":
-                                if(NewShortArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                case TypeCode.Single:
+                                    if(!isObject)
+                                        SetFloatArrayElement(pEnv, pJArray, ii, (float)sub_element);
+                                    else
+                                    {
+                                        void* pObjF;
+                                        if(NewFloatObject(pEnv, (float)sub_element, &pObjF) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjF);
+                                    }
+                                    break;
 
-                            case "I":
-                                if(NewIntArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                case TypeCode.Double:
+                                    if(!isObject)
+                                        SetDoubleArrayElement(pEnv, pJArray, ii, (double)sub_element);
+                                    else
+                                    {
+                                        void* pObjD;
+                                        if(NewDoubleObject(pEnv, (double)sub_element, &pObjD) != 0)
+                                            throw GetJavaException(pEnv);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, pObjD);
+                                    }
+                                    break;
 
-                            case "J":
-                                if(NewLongArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                case TypeCode.String:
+                                    void* string_arg_s = GetJavaString(pEnv, (string)sub_element);
+                                    SetObjectArrayElement(pEnv, pJArray, ii, string_arg_s);
+                                    break;
 
-                            case "F":
-                                if(NewFloatArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                case TypeCode.DateTime:
+                                    void* pDate = GetJavaDateTime(pEnv, (DateTime)sub_element);
+                                    SetObjectArrayElement(pEnv, pJArray, ii, pDate);
+                                    break;
 
-                            case "D":
-                                if(NewDoubleArray( pEnv, arrLength, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
+                                default:
 
-                            default:
-                                isObject = true;
+                                    var subID = GetID(sub_element, false);
 
-                                if(arrLength == 0)
-                                    return null;
-
-                                if(!cls.Contains("java/lang/String"))
-                                    cls = "java/lang/Object";
-
-
-                                if(NewObjectArray( pEnv, arrLength, cls, &pJArray ) != 0)
-                                    throw new Exception(GetException(pEnv));
-                                break;
-                        }
-
-                        
-                        for(int ii = 0; ii < arrLength; ii++)
-                        {
-                            var sub_element = sub.GetValue(ii);
-                            if(sub_element == null)
-                                SetObjectArrayElement(pEnv, pJArray, ii, IntPtr.Zero.ToPointer());
-
-                            else
-                            {
-                                object res = sub_element;
-                                if(res is PyObject)
-                                {
-                                    var pres = res as PyObject;
-                                    if(PyString.IsStringType(pres))
-                                        res = pres.AsManagedObject(typeof(string));
-
-                                    else if(PyFloat.IsFloatType(pres))
-                                        res = pres.AsManagedObject(typeof(float));
-
-                                    else if(PyInt.IsIntType(pres))
-                                        res = pres.AsManagedObject(typeof(int));
-
-                                    else if(PyDict.IsDictType(pres))
-                                        res = pres.AsManagedObject(typeof(Dictionary<object, object>));
-
-                                    else if(PyList.IsListType(pres))
-                                        res = pres.AsManagedObject(typeof(List<object>));
-
-                                    else if(PyLong.IsLongType(pres))
-                                        res = pres.AsManagedObject(typeof(long));
-
-                                    else if(PySequence.IsSequenceType(pres))
-                                        res = pres.AsManagedObject(typeof(IEnumerable<object>));
-
-                                    else if(PyTuple.IsTupleType(pres))
-                                        res = pres.AsManagedObject(typeof(System.Tuple));
-                                }
-
-                                sub_element = res;
-                                
-                                var sub_type = sub_element.GetType();
-                                switch(Type.GetTypeCode(sub_type))
-                                { 
-                                    case TypeCode.Boolean:
-                                        if(!isObject)
-                                            SetBooleanArrayElement(pEnv, pJArray, ii, (bool)sub_element);
-                                        else
-                                        {
-                                            void* pObjBool;
-                                            if(NewBooleanObject(pEnv, (bool)sub_element, &pObjBool) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjBool);
-                                        }
-
-                                        break;
-
-                                    case TypeCode.Byte:
-                                        if(!isObject)
-                                            SetByteArrayElement(pEnv, pJArray, ii, (byte)sub_element);
-                                        else
-                                        {
-                                            void* pObjB;
-                                            if(NewByteObject(pEnv, (byte)sub_element, &pObjB) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjB);
-                                        }
-                                        break;
-
-                                    case TypeCode.Char:
-                                        if(!isObject)
-                                            SetCharArrayElement(pEnv, pJArray, ii, (char)sub_element);
-                                        else
-                                        {
-                                            void* pObjC;
-                                            if(NewCharacterObject(pEnv, (char)sub_element, &pObjC) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjC);
-                                        }
-                                        break;
+                                    if(JVMDelegate.DB.ContainsKey(subID))
+                                    {
+                                        JVMDelegate jobj = sub_element as JVMDelegate; 
+                                        void* ptr = (void *)(jobj.Pointer);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, ptr);
+                                    }
 
-                                    case TypeCode.Int16:
-                                        if(!isObject)
-                                            SetShortArrayElement(pEnv, pJArray, ii, (short)sub_element);
-                                        else
+                                    else if(DB.ContainsKey(subID))
+                                    {
+                                        void*  pGetCLRObjectMethod;
+                                        if(GetStaticMethodID( pEnv, pNetBridgeClass, "GetCLRObject", "(I)Lapp/quant/clr/CLRObject;", &pGetCLRObjectMethod ) == 0)
                                         {
-                                            void* pObjS;
-                                            if(NewShortObject(pEnv, (short)sub_element, &pObjS) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjS);
-                                        }
-                                        break;
+                                            object[] pAr_len_data = new object[]{ subID };
+                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                    case TypeCode.Int32: 
-                                        if(!isObject)
-                                            SetIntArrayElement(pEnv, pJArray, ii, (int)sub_element);
-                                        else
-                                        {
-                                            void* pObjI;
-                                            if(NewIntegerObject(pEnv, (int)sub_element, &pObjI) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjI);
-                                        }
-                                        break;
-                                        
-                                    case TypeCode.Int64:
-                                        if(!isObject)
-                                            SetLongArrayElement(pEnv, pJArray, ii, (long)sub_element);
-                                        else
-                                        {
-                                            void* pObjL;
-                                            if(NewLongObject(pEnv, (long)sub_element, &pObjL) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjL);
-                                        }
-                                        break;
+                                            void*  pGetCLRObject;
+                                            if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pGetCLRObjectMethod, &pGetCLRObject, 1, pAr_len) != 0)
+                                                throw GetJavaException(pEnv);
 
-                                    case TypeCode.Single:
-                                        if(!isObject)
-                                            SetFloatArrayElement(pEnv, pJArray, ii, (float)sub_element);
-                                        else
-                                        {
-                                            void* pObjF;
-                                            if(NewFloatObject(pEnv, (float)sub_element, &pObjF) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjF);
+                                            SetObjectArrayElement(pEnv, pJArray, ii, pGetCLRObject);
                                         }
-                                        break;
-
-                                    case TypeCode.Double:
-                                        if(!isObject)
-                                            SetDoubleArrayElement(pEnv, pJArray, ii, (double)sub_element);
                                         else
                                         {
-                                            void* pObjD;
-                                            if(NewDoubleObject(pEnv, (double)sub_element, &pObjD) != 0)
-                                                throw new Exception(GetException(pEnv));
-                                            SetObjectArrayElement(pEnv, pJArray, ii, pObjD);
+                                            Console.WriteLine("CLR getJavaArray - GetCLRObject error");
+                                            throw GetJavaException(pEnv);
                                         }
-                                        break;
+                                    }
 
-                                    case TypeCode.String:
-                                        void* string_arg_s = GetJavaString(pEnv, (string)sub_element);
-                                        SetObjectArrayElement(pEnv, pJArray, ii, string_arg_s);
-                                        break;
+                                    else if(sub_element is JVMTuple)
+                                    {
+                                        JVMTuple jobj = sub_element as JVMTuple; 
+                                        void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.jVMObject.JavaHashCode);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, ptr);
+                                    }
+                                    else if(sub_element is IJVMTuple)
+                                    {
+                                        IJVMTuple jobj = sub_element as IJVMTuple; 
+                                        void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JVMObject.JavaHashCode);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, ptr);
+                                    }
 
-                                    case TypeCode.DateTime:
-                                        void* pDate = GetJavaDateTime(pEnv, (DateTime)sub_element);
-                                        SetObjectArrayElement(pEnv, pJArray, ii, pDate);
-                                        break;
+                                    else if(sub_element is JVMObject)
+                                    {
+                                        JVMObject jobj = sub_element as JVMObject; 
+                                        void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JavaHashCode);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, ptr);
+                                    }
 
-                                    default:
+                                    else if(sub_element is Array)
+                                    {                                    
+                                        Array sub_array = sub_element as Array;
+                                        JVMObject javaArray = getJavaArray(pEnv, pNetBridgeClass, sub_array);
 
-                                        var subID = GetID(sub_element, false);
+                                        void* ptr = GetJVMObject(pEnv, pNetBridgeClass, javaArray.JavaHashCode);
+                                        SetObjectArrayElement(pEnv, pJArray, ii, ptr);
+                                    }
 
-                                        if(JVMDelegate.DB.ContainsKey(subID))
-                                        {
-                                            JVMDelegate jobj = sub_element as JVMDelegate; 
-                                            void* ptr = (void *)(jobj.Pointer);
-                                            SetObjectArrayElement(pEnv, pJArray, ii, ptr);
-                                        }
+                                    else if(sub_element is IEnumerable<object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ sub_element.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                        else if(DB.ContainsKey(subID))
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/CLRIterable", &CLRObjClass) == 0)
                                         {
-                                            void*  pGetCLRObjectMethod;
-                                            if(GetStaticMethodID( pEnv, pNetBridgeClass, "GetCLRObject", "(I)Lapp/quant/clr/CLRObject;", &pGetCLRObjectMethod ) == 0)
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                object[] pAr_len_data = new object[]{ subID };
-                                                void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 1983 Hash Conflict");
 
-                                                void*  pGetCLRObject;
-                                                if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pGetCLRObjectMethod, &pGetCLRObject, 1, pAr_len) != 0)
-                                                    throw new Exception(GetException(pEnv));
-
-                                                SetObjectArrayElement(pEnv, pJArray, ii, pGetCLRObject);
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                            {
-                                                Console.WriteLine("CLR getJavaArray - GetCLRObject error");
-                                                throw new Exception(GetException(pEnv));
-                                            }
-                                        }
-
-                                        else if(sub_element is JVMTuple)
-                                        {
-                                            JVMTuple jobj = sub_element as JVMTuple; 
-                                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.jVMObject.JavaHashCode);
-                                            SetObjectArrayElement(pEnv, pJArray, ii, ptr);
-                                        }
-                                        else if(sub_element is IJVMTuple)
-                                        {
-                                            IJVMTuple jobj = sub_element as IJVMTuple; 
-                                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JVMObject.JavaHashCode);
-                                            SetObjectArrayElement(pEnv, pJArray, ii, ptr);
-                                        }
-
-                                        else if(sub_element is JVMObject)
-                                        {
-                                            JVMObject jobj = sub_element as JVMObject; 
-                                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, jobj.JavaHashCode);
-                                            SetObjectArrayElement(pEnv, pJArray, ii, ptr);
+                                                throw GetJavaException(pEnv);
                                         }
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
 
-                                        else if(sub_element is Array)
-                                        {                                    
-                                            Array sub_array = sub_element as Array;
-                                            JVMObject javaArray = getJavaArray(pEnv, pNetBridgeClass, sub_array);
-
-                                            void* ptr = GetJVMObject(pEnv, pNetBridgeClass, javaArray.JavaHashCode);
-                                            SetObjectArrayElement(pEnv, pJArray, ii, ptr);
-                                        }
+                                    else if(res is IEnumerator<object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                        else if(sub_element is IEnumerable<object>)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/CLRIterator", &CLRObjClass) == 0)
                                         {
-                                            object[] pAr_len_data = new object[]{ sub_element.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
-
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/CLRIterable", &CLRObjClass) == 0)
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 1983 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2015 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                            
+                                                
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
 
-                                        else if(res is IEnumerator<object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                    else if(res is System.Func<Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/CLRIterator", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction1", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2015 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2047 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
                                                 
-                                                    
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                        else if(res is System.Func<Object, Object>)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction2", &CLRObjClass) == 0)
                                         {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
-
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction1", &CLRObjClass) == 0)
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2047 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2077 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction2", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction3", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2077 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2114 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
 
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction3", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction4", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2114 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2146 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction4", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction5", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2146 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2173 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction5", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction6", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2173 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2200 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction6", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction7", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2200 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2227 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction7", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction8", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2227 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2254 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction8", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction9", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2254 Hash Conflict");
-
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2281 Hash Conflict");
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction9", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction10", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2281 Hash Conflict");
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2308 Hash Conflict");
+
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction10", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction11", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2308 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2335 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction11", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction12", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2335 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2361 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction12", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction13", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2361 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2389 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction13", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction14", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2389 Hash Conflict");
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2416 Hash Conflict");
 
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
+                                    {
+                                        object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction14", &CLRObjClass) == 0)
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/function/CLRFunction15", &CLRObjClass) == 0)
+                                        {
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2416 Hash Conflict");
-
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2443 Hash Conflict");
+                                                if(!(res is JVMObject) && !(res is IJVMTuple))
+                                                    DB[subID] = new WeakReference(res);
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
-                                        {
-                                            object[] pAr_len_data = new object[]{ res.GetType().ToString(), subID };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
 
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/function/CLRFunction15", &CLRObjClass) == 0)
-                                            {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;I)V", 2, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2443 Hash Conflict");
-                                                    if(!(res is JVMObject) && !(res is IJVMTuple))
-                                                        DB[subID] = new WeakReference(res);
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
-                                            }
-                                            else
-                                                throw new Exception(GetException(pEnv));
-                                        }
+                                    else
+                                    {
+                                        object[] pAr_len_data = new object[]{ sub_element.GetType().ToString(), subID, false };
+                                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                                        else
+                                        void* pObj;
+                                        void* CLRObjClass;
+                                        void*  pLoadClassMethod; // The executed method struct
+                                        if(FindClass( pEnv, "app/quant/clr/CLRObject", &CLRObjClass) == 0)
                                         {
-                                            object[] pAr_len_data = new object[]{ sub_element.GetType().ToString(), subID, false };
-                                            void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
-
-                                            void* pObj;
-                                            void* CLRObjClass;
-                                            void*  pLoadClassMethod; // The executed method struct
-                                            if(FindClass( pEnv, "app/quant/clr/CLRObject", &CLRObjClass) == 0)
+                                            void* pClass;
+                                            if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;IZ)V", 3, pAr_len, &pObj ) == 0)
                                             {
-                                                void* pClass;
-                                                if(NewObjectP( pEnv, CLRObjClass, "(Ljava/lang/String;IZ)V", 3, pAr_len, &pObj ) == 0)
-                                                {
-                                                    if(DB.ContainsKey(subID))
-                                                        Console.WriteLine("CLR 2470 Hash Conflict");
-                                                    SetObjectArrayElement(pEnv, pJArray, ii, pObj);
-                                                    if(!(sub_element is JVMObject) && !(sub_element is IJVMTuple))
-                                                        DB[subID] = new WeakReference(sub_element);
-                                                }
-                                                else
-                                                    throw new Exception(GetException(pEnv));
+                                                if(DB.ContainsKey(subID))
+                                                    Console.WriteLine("CLR 2470 Hash Conflict");
+                                                SetObjectArrayElement(pEnv, pJArray, ii, pObj);
+                                                if(!(sub_element is JVMObject) && !(sub_element is IJVMTuple))
+                                                    DB[subID] = new WeakReference(sub_element);
                                             }
                                             else
-                                                throw new Exception(GetException(pEnv));
+                                                throw GetJavaException(pEnv);
                                         }
-                                        break;
-                                }
+                                        else
+                                            throw GetJavaException(pEnv);
+                                    }
+                                    break;
                             }
                         }
+                    }
 
-                        int hashID = GetJVMID(pEnv, pJArray, true);
-                        
-                        sub.RegisterGCEvent(hashID, delegate(object _obj, int _id)
-                        {
-                            RemoveID(_id);
-                        });
+                    int hashID = GetJVMID(pEnv, pJArray, true);
+                    
+                    sub.RegisterGCEvent(hashID, delegate(object _obj, int _id)
+                    {
+                        RemoveID(_id);
+                    });
 
-                        var jo = new JVMObject(hashID, cls, true, "javaArray 2475"); // IMPORTANT TRUE
-                        return jo;
-                    }
-                    else
-                        throw new Exception(GetException(pEnv));
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR getJavaArray ERROR: " + e);
-                    return null;
+                    var jo = new JVMObject(hashID, cls, true, "javaArray 2475"); // IMPORTANT TRUE
+                    return jo;
                 }
+                else
+                    throw GetJavaException(pEnv);
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR getJavaArray ERROR: " + e);
+                return null;
             }
         }
 
-        private readonly static object objLock_getJavaArray_2 = new object();
         private unsafe static object[] getJavaArray(void* pEnv, void* pNetBridgeClass, int len, void* pObjResult, string returnSignature)//, IntPtr pNetBridgeClassPtr, IntPtr ArrayClassesMethodPtr)
         {
-            lock(objLock_getJavaArray_2)
+            try
             {
-                try
+                if(pObjResult == (void*)IntPtr.Zero)
                 {
-                    if(pObjResult == (void*)IntPtr.Zero)
-                    {
-                        Console.WriteLine("CLR getJavaArray pointer null");
-                    }
-                    int HashCode = GetJVMID(pEnv, pObjResult, true);
+                    Console.WriteLine("CLR getJavaArray pointer null");
+                }
+                int HashCode = GetJVMID(pEnv, pObjResult, true);
 
-                    void* _pNetBridgeClass = pNetBridgeClass;
-                    int ret_arr_len = len;
+                void* _pNetBridgeClass = pNetBridgeClass;
+                int ret_arr_len = len;
 
-                    object[] resultArray = new object[ret_arr_len];
+                object[] resultArray = new object[ret_arr_len];
 
-                    if(returnSignature == "[Z")
-                    {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetBooleanArrayElement(pEnv, pObjResult, i);
-                    }
-                    else if(returnSignature == "[B")
-                    {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetByteArrayElement(pEnv, pObjResult, i);
-                    }
-                    else if(returnSignature == "[C")
-                    {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetCharArrayElement(pEnv, pObjResult, i);
-                    }
-                    else if(returnSignature == "[S")
-                    {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetShortArrayElement(pEnv, pObjResult, i);
-                    }
-                    else if(returnSignature == "[I")
-                    {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetIntArrayElement(pEnv, pObjResult, i);
-                    }
-                    else if(returnSignature == "[J")
-                    {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetLongArrayElement(pEnv, pObjResult, i);
-                    }
-                    else if(returnSignature == "[F")
-                    {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetFloatArrayElement(pEnv, pObjResult, i);
-                    }
-                    else if(returnSignature == "[D")
+                if(returnSignature == "[Z")
+                {
+                    bool[] data = GetNetBooleanArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature == "[B")
+                {
+                    byte[] data = GetNetByteArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature == "[C")
+                {
+                    char[] data = GetNetCharArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature == "[S")
+                {
+                    short[] data = GetNetShortArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature == "[I")
+                {
+                    int[] data = GetNetIntArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature == "[J")
+                {
+                    long[] data = GetNetLongArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature == "[F")
+                {
+                    float[] data = GetNetFloatArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature == "[D")
+                {
+                    double[] data = GetNetDoubleArray(pEnv, pObjResult, ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
+                        resultArray[i] = data[i];
+                }
+                else if(returnSignature.Length == 3 && returnSignature.StartsWith("[[") && matrixNetType(returnSignature.Substring(2)) != null)
+                {
+                    //rows keep the object[] shape of the element path, only the copy is done a row at a time
+                    Array[] rows = GetNetMatrix(pEnv, pObjResult, returnSignature.Substring(2), ret_arr_len);
+                    for(int i = 0; i < ret_arr_len; i++)
                     {
-                        for(int i = 0; i < ret_arr_len; i++)
-                            resultArray[i] = GetDoubleArrayElement(pEnv, pObjResult, i);
+                        if(rows[i] == null)
+                            continue;
+                        object[] row = new object[rows[i].Length];
+                        Array.Copy(rows[i], row, row.Length);
+                        resultArray[i] = row;
                     }
-                    else
-                    {
-                        void*  pArrayClassesMethod;
-                        if(GetStaticMethodID( pEnv, pNetBridgeClass, "ArrayClasses", "([Ljava/lang/Object;)[Ljava/lang/String;", &pArrayClassesMethod ) != 0)
-                            throw new Exception(GetException(pEnv));
+                }
+                else
+                {
+                    void*  pArrayClassesMethod;
+                    if(GetStaticMethodID( pEnv, pNetBridgeClass, "ArrayClasses", "([Ljava/lang/Object;)[Ljava/lang/String;", &pArrayClassesMethod ) != 0)
+                        throw GetJavaException(pEnv);
 
-                        var size = Unsafe.SizeOf<object[]>();
-                        void** _ptr = (void**)Marshal.AllocHGlobal(size);
-                        _ptr[0] = pObjResult;
+                    var size = Unsafe.SizeOf<object[]>();
+                    void** _ptr = (void**)Marshal.AllocHGlobal(size);
+                    _ptr[0] = pObjResult;
 
+                    
+                    void* pArrClasses = IntPtr.Zero.ToPointer();
+                    int resArrClasses = CallStaticObjectMethod( pEnv, pNetBridgeClass, pArrayClassesMethod, &pArrClasses, 1, _ptr);
+                    Marshal.FreeHGlobal((IntPtr)_ptr);
+                    if(resArrClasses != 0) throw GetJavaException(pEnv);
+                    
+                    for(int i = 0; i < ret_arr_len; i++)
+                    {
+                        using var frame = new JVMLocalFrame(pEnv, 16);
+                        
+                        void* pElementClass;
+                        if(GetObjectArrayElement(pEnv, pArrClasses, i, &pElementClass) != 0)
+                        {
+                            Console.WriteLine("----ERROR: " + i + " " + ret_arr_len);
+                            throw GetJavaException(pEnv);
+                        }
                         
-                        void* pArrClasses = IntPtr.Zero.ToPointer();
-                        if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pArrayClassesMethod, &pArrClasses, 1, _ptr) != 0) throw new Exception(GetException(pEnv));
+                        if(new IntPtr(pElementClass) == IntPtr.Zero)
+                            resultArray[i] = null;
                         
-                        for(int i = 0; i < ret_arr_len; i++)
+                        else
                         {
-                            
-                            void* pElementClass;
-                            if(GetObjectArrayElement(pEnv, pArrClasses, i, &pElementClass) != 0)
-                            {
-                                Console.WriteLine("----ERROR: " + i + " " + ret_arr_len);
-                                throw new Exception(GetException(pEnv));
-                            }
-                            
-                            if(new IntPtr(pElementClass) == IntPtr.Zero)
-                                resultArray[i] = null;
-                            
-                            else
+                            string retElementClass = GetNetString(pEnv, pElementClass);
+
+                            if(retElementClass.StartsWith("prim-"))
                             {
-                                string retElementClass = GetNetString(pEnv, pElementClass);
+                                retElementClass = retElementClass.Replace("prim-","");
+                                string ttype = retElementClass.Substring(0, retElementClass.LastIndexOf("-"));
+                                string value = retElementClass.Substring(retElementClass.LastIndexOf("-") + 1);
 
-                                if(retElementClass.StartsWith("prim-"))
+                                switch(ttype)
                                 {
-                                    retElementClass = retElementClass.Replace("prim-","");
-                                    string ttype = retElementClass.Substring(0, retElementClass.LastIndexOf("-"));
-                                    string value = retElementClass.Substring(retElementClass.LastIndexOf("-") + 1);
-
-                                    switch(ttype)
-                                    {
-                                        case "java.lang.Boolean":
-                                            resultArray[i] = Boolean.Parse(value);
-                                            break;
-                                        case "java.lang.Byte":
-                                            resultArray[i] = Byte.Parse(value);
-                                            break;
-                                        case "java.lang.Character":
-                                            resultArray[i] = Char.Parse(value);
-                                            break;
-                                        case "java.lang.Short":
-                                            resultArray[i] = Int16.Parse(value);
-                                            break;
-                                        case "java.lang.Integer":
-                                            resultArray[i] = Int32.Parse(value);
-                                            
-                                            break;
-                                        case "java.lang.Long":
-                                            resultArray[i] = Int64.Parse(value);
-                                            break;
-                                        case "java.lang.Float":
-                                            resultArray[i] = Single.Parse(value);
-                                            break;
-                                        case "java.lang.Double":
-                                            resultArray[i] = Double.Parse(value);
-
-                                            break;
-                                    }
+                                    case "java.lang.Boolean":
+                                        resultArray[i] = Boolean.Parse(value);
+                                        break;
+                                    case "java.lang.Byte":
+                                        resultArray[i] = Byte.Parse(value);
+                                        break;
+                                    case "java.lang.Character":
+                                        resultArray[i] = Char.Parse(value);
+                                        break;
+                                    case "java.lang.Short":
+                                        resultArray[i] = Int16.Parse(value);
+                                        break;
+                                    case "java.lang.Integer":
+                                        resultArray[i] = Int32.Parse(value);
+                                        
+                                        break;
+                                    case "java.lang.Long":
+                                        resultArray[i] = Int64.Parse(value);
+                                        break;
+                                    case "java.lang.Float":
+                                        resultArray[i] = Single.Parse(value);
+                                        break;
+                                    case "java.lang.Double":
+                                        resultArray[i] = Double.Parse(value);
 
+                                        break;
                                 }
-                                else if(retElementClass == "java.lang.String")
-                                {
-                                    void* pElement_string;
-                                    GetObjectArrayElement(pEnv, pObjResult, i, &pElement_string);
-                                    if(IntPtr.Zero.ToPointer() == pElement_string)
-                                        resultArray[i] = null;
-                                    else
-                                        resultArray[i] = GetNetString(pEnv, pElement_string);
-                                }
-                                else if(retElementClass == "java.time.LocalDateTime")
+
+                            }
+                            else if(retElementClass == "java.lang.String")
+                            {
+                                void* pElement_string;
+                                GetObjectArrayElement(pEnv, pObjResult, i, &pElement_string);
+                                if(IntPtr.Zero.ToPointer() == pElement_string)
+                                    resultArray[i] = null;
+                                else
+                                    resultArray[i] = GetNetString(pEnv, pElement_string);
+                            }
+                            else if(retElementClass == "java.time.LocalDateTime")
+                            {
+                                void* pElement_date;
+                                GetObjectArrayElement(pEnv, pObjResult, i, &pElement_date);
+                                if(IntPtr.Zero.ToPointer() == pElement_date)
+                                    resultArray[i] = null;
+                                else
+                                    resultArray[i] = GetNetDateTime(pEnv, pElement_date);
+                            }
+                            else
+                            {
+                                void* pElement_object;
+                                GetObjectArrayElement(pEnv, pObjResult, i, &pElement_object);
+                                
+                                if(IntPtr.Zero.ToPointer() == pElement_object)
                                 {
-                                    void* pElement_date;
-                                    GetObjectArrayElement(pEnv, pObjResult, i, &pElement_date);
-                                    if(IntPtr.Zero.ToPointer() == pElement_date)
-                                        resultArray[i] = null;
-                                    else
-                                        resultArray[i] = GetNetDateTime(pEnv, pElement_date);
+                                    Console.WriteLine("NULL OBJ: " + i);
+                                    resultArray[i] = null;
                                 }
                                 else
                                 {
-                                    void* pElement_object;
-                                    GetObjectArrayElement(pEnv, pObjResult, i, &pElement_object);
-                                    
-                                    if(IntPtr.Zero.ToPointer() == pElement_object)
+                                    if(!retElementClass.StartsWith("["))
                                     {
-                                        Console.WriteLine("NULL OBJ: " + i);
-                                        resultArray[i] = null;
-                                    }
-                                    else
-                                    {
-                                        if(!retElementClass.StartsWith("["))
-                                        {
-                                            int hashID_res = GetJVMID(pEnv, pElement_object, true);
+                                        int hashID_res = GetJVMID(pEnv, pElement_object, true);
 
-                                            if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive) //check if it is a JVMDelegate
-                                                resultArray[i] = ((JVMDelegate)JVMDelegate.DB[hashID_res].Target).func;
+                                        if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive) //check if it is a JVMDelegate
+                                            resultArray[i] = ((JVMDelegate)JVMDelegate.DB[hashID_res].Target).func;
 
-                                            else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive) //check if it is a JVMObject
-                                                resultArray[i] = JVMObject.DB[hashID_res].Target;
-                                            
-                                            else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive) //check if it is a CLRObject
-                                            {
-                                                resultArray[i] = Runtime.DB[hashID_res].Target;
-                                            }
-
-                                            else
-                                            {
-                                                string cls = retElementClass.StartsWith("L") && retElementClass.EndsWith(";") ? retElementClass.Substring(1).Replace(";","") : retElementClass;
-
-                                                resultArray[i] =  getObject(pEnv, cls, pElement_object);
-                                            }
+                                        else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive) //check if it is a JVMObject
+                                            resultArray[i] = JVMObject.DB[hashID_res].Target;
+                                        
+                                        else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive) //check if it is a CLRObject
+                                        {
+                                            resultArray[i] = Runtime.DB[hashID_res].Target;
                                         }
+
                                         else
                                         {
-                                            int _ret_arr_len = getArrayLength(pEnv, pElement_object); //TESTING
-                                            resultArray[i] =  getJavaArray(pEnv, _pNetBridgeClass, _ret_arr_len, pElement_object, retElementClass);
+                                            string cls = retElementClass.StartsWith("L") && retElementClass.EndsWith(";") ? retElementClass.Substring(1).Replace(";","") : retElementClass;
+
+                                            resultArray[i] =  getObject(pEnv, cls, pElement_object);
                                         }
                                     }
+                                    else
+                                    {
+                                        int _ret_arr_len = getArrayLength(pEnv, pElement_object); //TESTING
+                                        resultArray[i] =  getJavaArray(pEnv, _pNetBridgeClass, _ret_arr_len, pElement_object, retElementClass);
+                                    }
                                 }
-                                
                             }
+                            
                         }
-                        
                     }
 
-                    return resultArray;
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR getJavaArray 2: " + e);
-                    return null;
+                    DeleteLocalRef(pEnv, pArrClasses);
                 }
+
+                return resultArray;
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR getJavaArray 2: " + e);
+                return null;
             }
         }
 
-        private readonly static object objLock_getJavaArray_3 = new object();
         private unsafe static JVMObject getJavaArray(void* pEnv, void* pNetBridgeClass, IEnumerable<object> array)
         {
-            lock(objLock_getJavaArray_3)
-            {
-                int arrLength = array.Count();
-                object[] res = new object[arrLength];
+            int arrLength = array.Count();
+            object[] res = new object[arrLength];
 
-                for(int i = 0; i < arrLength; i++)
-                    res[i] = array.ElementAt(i);
-                
+            for(int i = 0; i < arrLength; i++)
+                res[i] = array.ElementAt(i);
+            
 
-                return getJavaArray(pEnv, pNetBridgeClass, res);
-            }
+            return getJavaArray(pEnv, pNetBridgeClass, res);
         }
 
-        private readonly static object objLock_getJavaArray_4 = new object();
         private unsafe static JVMObject getJavaArray(void* pEnv, void* pNetBridgeClass, Array array)
         {
-            lock(objLock_getJavaArray_4)
+            void* pJArray = null;
+            string cls = null;
+            if(array is double[]) { pJArray = GetJavaDoubleArray(pEnv, (double[])array); cls = "D"; }
+            else if(array is int[]) { pJArray = GetJavaIntArray(pEnv, (int[])array); cls = "I"; }
+            else if(array is long[]) { pJArray = GetJavaLongArray(pEnv, (long[])array); cls = "J"; }
+            else if(array is float[]) { pJArray = GetJavaFloatArray(pEnv, (float[])array); cls = "F"; }
+            else if(array is bool[]) { pJArray = GetJavaBooleanArray(pEnv, (bool[])array); cls = "Z"; }
+            else if(array is byte[]) { pJArray = GetJavaByteArray(pEnv, (byte[])array); cls = "B"; }
+            else if(array is short[]) { pJArray = GetJavaShortArray(pEnv, (short[])array); cls = "S"; }
+            else if(array is char[]) { pJArray = GetJavaCharArray(pEnv, (char[])array); cls = "C"; }
+            else if((pJArray = GetJavaMatrix(pEnv, array, out string sType)) != null) cls = "[" + sType;
+
+            if(cls != null)
             {
-                int arrLength = array.Length;
-                object[] res = new object[arrLength];
+                int hashID = GetJVMID(pEnv, pJArray, true);
+                array.RegisterGCEvent(hashID, delegate(object _obj, int _id)
+                {
+                    RemoveID(_id);
+                });
+                return new JVMObject(hashID, cls, true, "javaArray primitive");
+            }
+
+            int arrLength = array.Length;
+            object[] res = new object[arrLength];
+
+            for(int i = 0; i < arrLength; i++)
+                res[i] = array.GetValue(i);
 
-                for(int i = 0; i < arrLength; i++)
-                    res[i] = array.GetValue(i);
+            return getJavaArray(pEnv, pNetBridgeClass, res);
+        }
 
-                return getJavaArray(pEnv, pNetBridgeClass, res);
+        /*
+        Primitive array marshalling in a single crossing. The element data is copied with
+        Get/Set<Type>ArrayRegion so neither side is pinned longer than the call.
+        */
+        internal unsafe static bool[] GetNetBooleanArray(void* pEnv, void* pArray, int len)
+        {
+            bool[] data = new bool[len];
+            if(len == 0)
+                return data;
+            fixed(bool* pData = data)
+            {
+                if(GetBooleanArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
             }
+            return data;
         }
 
-        public unsafe static object Python(System.Func<object[], object> func)
+        internal unsafe static void* GetJavaBooleanArray(void* pEnv, bool[] data)
         {
-            using(Py.GIL())
+            void* pArray;
+            fixed(bool* pData = data)
             {
-                return func(null);
+                if(NewBooleanArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
             }
+            return pArray;
         }
 
-        private readonly static object objLock_TransformType_1 = new object();
-        internal static String TransformType(Type type)
+        internal unsafe static byte[] GetNetByteArray(void* pEnv, void* pArray, int len)
         {
-            switch(Type.GetTypeCode(type))
-            { 
-                case TypeCode.Boolean:
-                    return "Z";
+            byte[] data = new byte[len];
+            if(len == 0)
+                return data;
+            fixed(byte* pData = data)
+            {
+                if(GetByteArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return data;
+        }
 
-                case TypeCode.Byte:
-                    return "B";
+        internal unsafe static void* GetJavaByteArray(void* pEnv, byte[] data)
+        {
+            void* pArray;
+            fixed(byte* pData = data)
+            {
+                if(NewByteArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return pArray;
+        }
 
-                case TypeCode.Char:
-                    return "C";
+        internal unsafe static char[] GetNetCharArray(void* pEnv, void* pArray, int len)
+        {
+            char[] data = new char[len];
+            if(len == 0)
+                return data;
+            fixed(char* pData = data)
+            {
+                if(GetCharArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return data;
+        }
 
-                case TypeCode.Int16:
-                    return "S";
+        internal unsafe static void* GetJavaCharArray(void* pEnv, char[] data)
+        {
+            void* pArray;
+            fixed(char* pData = data)
+            {
+                if(NewCharArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return pArray;
+        }
 
-                case TypeCode.Int32: 
-                    return "I";
-                    
-                case TypeCode.Int64:
-                    return "J";
+        internal unsafe static short[] GetNetShortArray(void* pEnv, void* pArray, int len)
+        {
+            short[] data = new short[len];
+            if(len == 0)
+                return data;
+            fixed(short* pData = data)
+            {
+                if(GetShortArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return data;
+        }
 
-                case TypeCode.Single:
-                    return "F";
+        internal unsafe static void* GetJavaShortArray(void* pEnv, short[] data)
+        {
+            void* pArray;
+            fixed(short* pData = data)
+            {
+                if(NewShortArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return pArray;
+        }
 
-                case TypeCode.Double:
-                    return "D";
+        internal unsafe static int[] GetNetIntArray(void* pEnv, void* pArray, int len)
+        {
+            int[] data = new int[len];
+            if(len == 0)
+                return data;
+            fixed(int* pData = data)
+            {
+                if(GetIntArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return data;
+        }
 
-                case TypeCode.Empty:
-                    return "V";
+        internal unsafe static void* GetJavaIntArray(void* pEnv, int[] data)
+        {
+            void* pArray;
+            fixed(int* pData = data)
+            {
+                if(NewIntArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return pArray;
+        }
 
-                case TypeCode.String:
-                    return "Ljava/lang/String;";
+        internal unsafe static long[] GetNetLongArray(void* pEnv, void* pArray, int len)
+        {
+            long[] data = new long[len];
+            if(len == 0)
+                return data;
+            fixed(long* pData = data)
+            {
+                if(GetLongArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return data;
+        }
 
-                case TypeCode.DateTime:
-                    return "Ljava/time/LocalDateTime;";
-                
-                default:
-                    if(type == typeof(ObjectWrapper))
-                        return "Ljava/lang/Object;";
+        internal unsafe static void* GetJavaLongArray(void* pEnv, long[] data)
+        {
+            void* pArray;
+            fixed(long* pData = data)
+            {
+                if(NewLongArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return pArray;
+        }
+
+        internal unsafe static float[] GetNetFloatArray(void* pEnv, void* pArray, int len)
+        {
+            float[] data = new float[len];
+            if(len == 0)
+                return data;
+            fixed(float* pData = data)
+            {
+                if(GetFloatArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return data;
+        }
+
+        internal unsafe static void* GetJavaFloatArray(void* pEnv, float[] data)
+        {
+            void* pArray;
+            fixed(float* pData = data)
+            {
+                if(NewFloatArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return pArray;
+        }
+
+        internal unsafe static double[] GetNetDoubleArray(void* pEnv, void* pArray, int len)
+        {
+            double[] data = new double[len];
+            if(len == 0)
+                return data;
+            fixed(double* pData = data)
+            {
+                if(GetDoubleArrayRegion(pEnv, pArray, 0, len, pData) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return data;
+        }
+
+        internal unsafe static void* GetJavaDoubleArray(void* pEnv, double[] data)
+        {
+            void* pArray;
+            fixed(double* pData = data)
+            {
+                if(NewDoubleArrayFrom(pEnv, pData, data.Length, &pArray) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return pArray;
+        }
+
+        /*
+        Primitive matrices. A .NET T[,] or T[][] of double, float, int, long, short or byte crosses as a Java T[][]
+        with one region copy per row, spread over several threads for large matrices, instead of one call per element.
+        */
+        private static string matrixElementType(Type type)
+        {
+            if(type == typeof(double)) return "D";
+            else if(type == typeof(float)) return "F";
+            else if(type == typeof(int)) return "I";
+            else if(type == typeof(long)) return "J";
+            else if(type == typeof(short)) return "S";
+            else if(type == typeof(byte)) return "B";
+            return null;
+        }
+
+        private static Type matrixNetType(string sType)
+        {
+            switch(sType)
+            {
+                case "D": return typeof(double);
+                case "F": return typeof(float);
+                case "I": return typeof(int);
+                case "J": return typeof(long);
+                case "S": return typeof(short);
+                case "B": return typeof(byte);
+            }
+            return null;
+        }
+
+        //Element signature of a T[,] or T[][] that crosses as a matrix, null for any other type.
+        private static string matrixElementType(Type type, out bool rectangular)
+        {
+            rectangular = false;
+            if(type == null || !type.IsArray)
+                return null;
+
+            Type elementType = type.GetElementType();
+            if(type.GetArrayRank() == 2)
+            {
+                rectangular = true;
+                return matrixElementType(elementType);
+            }
+            else if(type.GetArrayRank() == 1 && elementType.IsArray && elementType.GetArrayRank() == 1)
+                return matrixElementType(elementType.GetElementType());
+            return null;
+        }
+
+        private unsafe static int[] getMatrixShape(void* pEnv, void* pArray, string sType, int rows)
+        {
+            int[] lengths = new int[rows];
+            fixed(int* pLengths = lengths)
+            {
+                int res = GetMatrixShape(pEnv, pArray, sType, rows, pLengths);
+                if(res == -2)
+                    throw new ArgumentException("Runtime matrix: object is not a Java " + sType + "[][]");
+                else if(res != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return lengths;
+        }
+
+        /// <summary>
+        /// Copies a Java sType[][] into .NET rows, a null entry for each null row.
+        /// </summary>
+        internal unsafe static Array[] GetNetMatrix(void* pEnv, void* pArray, string sType, int rows)
+        {
+            int[] lengths = getMatrixShape(pEnv, pArray, sType, rows);
+            Type type = matrixNetType(sType);
+
+            Array[] result = new Array[rows];
+            IntPtr[] rowPtrs = new IntPtr[rows];
+            GCHandle[] handles = new GCHandle[rows];
+            try
+            {
+                for(int i = 0; i < rows; i++)
+                {
+                    if(lengths[i] < 0)
+                        continue;
+                    result[i] = Array.CreateInstance(type, lengths[i]);
+                    handles[i] = GCHandle.Alloc(result[i], GCHandleType.Pinned);
+                    rowPtrs[i] = handles[i].AddrOfPinnedObject();
+                }
+
+                fixed(IntPtr* pRows = rowPtrs)
+                fixed(int* pLengths = lengths)
+                {
+                    if(GetMatrixRows(pEnv, pArray, sType, rows, (void**)pRows, pLengths, Environment.ProcessorCount) != 0)
+                        throw GetJavaException(pEnv);
+                }
+            }
+            finally
+            {
+                for(int i = 0; i < rows; i++)
+                    if(handles[i].IsAllocated)
+                        handles[i].Free();
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Copies a rectangular Java sType[][] straight into a new .NET T[,]. Throws if the rows differ in length or are null.
+        /// </summary>
+        internal unsafe static Array GetNetRectangularMatrix(void* pEnv, void* pArray, string sType, int rows)
+        {
+            int[] lengths = getMatrixShape(pEnv, pArray, sType, rows);
+            int cols = rows > 0 ? lengths[0] : 0;
+            for(int i = 0; i < rows; i++)
+                if(lengths[i] != cols)
+                    throw new ArgumentException("Runtime matrix: Java " + sType + "[][] is not rectangular");
+
+            if(cols < 0)
+                throw new ArgumentException("Runtime matrix: Java " + sType + "[][] has null rows");
+
+            Array result = Array.CreateInstance(matrixNetType(sType), rows, cols);
+            int rowBytes = cols * Marshal.SizeOf(matrixNetType(sType));
+
+            IntPtr[] rowPtrs = new IntPtr[rows];
+            fixed(byte* pData = &MemoryMarshal.GetArrayDataReference(result))
+            fixed(IntPtr* pRows = rowPtrs)
+            fixed(int* pLengths = lengths)
+            {
+                for(int i = 0; i < rows; i++)
+                    rowPtrs[i] = (IntPtr)(pData + (long)i * rowBytes);
+
+                if(GetMatrixRows(pEnv, pArray, sType, rows, (void**)pRows, pLengths, Environment.ProcessorCount) != 0)
+                    throw GetJavaException(pEnv);
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Creates a Java T[][] from a .NET T[,] or jagged T[][] of a matrix element type. Returns null, and leaves
+        /// sType null, for any other array so the caller can take the general path.
+        /// </summary>
+        internal unsafe static void* GetJavaMatrix(void* pEnv, Array array, out string sType)
+        {
+            bool rectangular;
+            sType = matrixElementType(array.GetType(), out rectangular);
+            if(sType == null)
+                return null;
+
+            int rows = array.GetLength(0);
+            int[] lengths = new int[rows];
+            IntPtr[] rowPtrs = new IntPtr[rows];
+            void* pArray;
+
+            if(rectangular)
+            {
+                int cols = array.GetLength(1);
+                int rowBytes = cols * Marshal.SizeOf(array.GetType().GetElementType());
+
+                fixed(byte* pData = &MemoryMarshal.GetArrayDataReference(array))
+                fixed(IntPtr* pRows = rowPtrs)
+                fixed(int* pLengths = lengths)
+                {
+                    for(int i = 0; i < rows; i++)
+                    {
+                        rowPtrs[i] = (IntPtr)(pData + (long)i * rowBytes);
+                        lengths[i] = cols;
+                    }
+
+                    if(NewMatrix(pEnv, sType, rows, (void**)pRows, pLengths, Environment.ProcessorCount, &pArray) != 0)
+                        throw GetJavaException(pEnv);
+                }
+                return pArray;
+            }
+
+            GCHandle[] handles = new GCHandle[rows];
+            try
+            {
+                for(int i = 0; i < rows; i++)
+                {
+                    Array row = (Array)array.GetValue(i);
+                    if(row == null)
+                    {
+                        lengths[i] = -1;
+                        continue;
+                    }
+                    lengths[i] = row.Length;
+                    handles[i] = GCHandle.Alloc(row, GCHandleType.Pinned);
+                    rowPtrs[i] = handles[i].AddrOfPinnedObject();
+                }
+
+                fixed(IntPtr* pRows = rowPtrs)
+                fixed(int* pLengths = lengths)
+                {
+                    if(NewMatrix(pEnv, sType, rows, (void**)pRows, pLengths, Environment.ProcessorCount, &pArray) != 0)
+                        throw GetJavaException(pEnv);
+                }
+            }
+            finally
+            {
+                for(int i = 0; i < rows; i++)
+                    if(handles[i].IsAllocated)
+                        handles[i].Free();
+            }
+            return pArray;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private unsafe struct BatchCall
+        {
+            public void* Target;
+            public void* Method;
+            public IntPtr Name;
+            public IntPtr Signature;
+            public int Kind;
+            public int Flags;
+            public int ArgOffset;
+            public int ArgCount;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private unsafe struct TaggedValue
+        {
+            public long Value;
+            public void* Name;
+            public int Kind;
+            public int Reserved;
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct BatchResult
+        {
+            public long Value;
+            public int Status;
+            public int Reserved;
+        }
+
+        [ThreadStatic] private static bool errorCodesOnly;
+
+        /// <summary>
+        /// When set, Java exceptions raised on the current thread are cleared without reading their class, message
+        /// or stack, and surface as a bare JVMException. Meant for hot retry loops where only failure matters.
+        /// </summary>
+        public static bool ErrorCodesOnly
+        {
+            get { return errorCodesOnly; }
+            set { errorCodesOnly = value; }
+        }
+
+        /// <summary>
+        /// Takes the pending Java exception of the thread. Only the class name and message are read here.
+        /// </summary>
+        internal unsafe static JVMException GetJavaException(void* pEnv)
+        {
+            void* pThrowable, pClassName, pMessage;
+            if(TakeException(pEnv, errorCodesOnly ? 0 : 1, &pThrowable, &pClassName, &pMessage) != 0)
+                return new JVMException(IntPtr.Zero, null, null);
+
+            return newJavaException(pEnv, pThrowable, pClassName, pMessage);
+        }
+
+        /// <summary>
+        /// Formatted description of the pending Java exception, stack trace included.
+        /// </summary>
+        internal unsafe static string GetException(void* pEnv)
+        {
+            // Described and released on the caller's env: the caller is inside a thread scope whose locals it still uses.
+            var exception = GetJavaException(pEnv);
+            IntPtr throwable = exception.TakeThrowable();
+            if(throwable == IntPtr.Zero)
+                return exception.Message;
+
+            string trace = describeJavaException(pEnv, throwable);
+            ReleaseException(pEnv, throwable.ToPointer());
+            return trace ?? exception.Message;
+        }
+
+        private unsafe static JVMException newJavaException(void* pEnv, void* pThrowable, void* pClassName, void* pMessage)
+        {
+            string className = pClassName == null ? null : GetNetString(pEnv, pClassName);
+            string message = pMessage == null ? null : GetNetString(pEnv, pMessage);
+            DeleteLocalRef(pEnv, pClassName);
+            DeleteLocalRef(pEnv, pMessage);
+
+            return new JVMException(new IntPtr(pThrowable), className, message);
+        }
+
+        internal unsafe static string DescribeJavaException(IntPtr throwable)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
+
+            return describeJavaException(pEnv, throwable);
+        }
+
+        private unsafe static string describeJavaException(void* pEnv, IntPtr throwable)
+        {
+            void* pTrace;
+            if(DescribeException(pEnv, throwable.ToPointer(), &pTrace) != 0)
+                return null;
+
+            string trace = GetNetString(pEnv, pTrace);
+            DeleteLocalRef(pEnv, pTrace);
+            return trace;
+        }
+
+        internal unsafe static JVMException GetJavaExceptionCause(IntPtr throwable)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+
+            try
+            {
+                void* pCause, pClassName, pMessage;
+                if(GetExceptionCause(pEnv, throwable.ToPointer(), &pCause, &pClassName, &pMessage) != 0)
+                    return null;
+
+                return newJavaException(pEnv, pCause, pClassName, pMessage);
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        internal unsafe static void ReleaseJavaException(IntPtr throwable)
+        {
+            if(!Loaded)
+                return;
+
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0)
+                return;
+            using var scope = new ThreadScope();
+
+            ReleaseException(pEnv, throwable.ToPointer());
+        }
+
+        private const int StringStackBuffer = 256;
+        private const int StringInternLength = 64;
+
+        /// <summary>
+        /// Creates a java.lang.String from the UTF-16 characters of str. Short interned .NET strings (literals and
+        /// identifiers) are served from the native intern table so repeated names are not created again.
+        /// </summary>
+        internal unsafe static void* GetJavaString(void* pEnv, string str)
+        {
+            if(str == null)
+                return null;
+
+            fixed(char* pChars = str)
+            {
+                if(str.Length <= StringInternLength && string.IsInterned(str) != null)
+                    return InternStringUTF16(pEnv, pChars, str.Length);
+                return NewStringUTF16(pEnv, pChars, str.Length);
+            }
+        }
+
+        /// <summary>
+        /// Copies a java.lang.String into a .NET string without going through UTF-8. Short strings are read into a
+        /// stack buffer, longer ones straight into the new string.
+        /// </summary>
+        internal unsafe static string GetNetString(void* pEnv, void* jstr)
+        {
+            if(jstr == null)
+                return "";
+
+            char* pBuffer = stackalloc char[StringStackBuffer];
+            int len;
+            if(GetStringUTF16(pEnv, jstr, pBuffer, StringStackBuffer, &len) != 0)
+                return "";
+
+            if(len <= StringStackBuffer)
+                return new string(pBuffer, 0, len);
+
+            return string.Create(len, (new IntPtr(pEnv), new IntPtr(jstr)), (span, state) =>
+            {
+                fixed(char* pChars = span)
+                {
+                    int _len;
+                    GetStringUTF16(state.Item1.ToPointer(), state.Item2.ToPointer(), pChars, span.Length, &_len);
+                }
+            });
+        }
+
+        /// <summary>
+        /// Runs the calls collected by a JVMBatch in one crossing. Targets, method names and arguments are resolved
+        /// here, inside a single attach scope, so every local reference lives until the results are converted.
+        /// The results hold no local references, they are converted before LeaveThread frees the scope.
+        /// </summary>
+        internal unsafe static object[] RunBatch(List<JVMBatch.Call> calls, bool stopOnError)
+        {
+            int count = calls.Count;
+            var results = new object[count];
+            if(count == 0)
+                return results;
+
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+
+            var strings = new Dictionary<string, IntPtr>();
+            var classes = new Dictionary<string, IntPtr>();
+            var wrappers = new List<StructWrapper>();
+            try
+            {
+                void* pNetBridgeClass;
+                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("Find Class");
+
+                int argTotal = 0;
+                foreach(var call in calls)
+                    argTotal += call.Args == null ? 0 : call.Args.Length;
+
+                var records = new BatchCall[count];
+                var args = new long[Math.Max(argTotal, 1)];
+                var res = new BatchResult[count];
+
+                int argOffset = 0;
+                for(int i = 0; i < count; i++)
+                {
+                    var call = calls[i];
+
+                    void* pTarget;
+                    if(call.Target != null)
+                        pTarget = GetJVMObject(pEnv, pNetBridgeClass, call.Target.JavaHashCode);
+                    else
+                    {
+                        IntPtr pClass;
+                        if(!classes.TryGetValue(call.JavaClass, out pClass))
+                        {
+                            void* _pClass;
+                            if(FindClass( pEnv, call.JavaClass, &_pClass) != 0)
+                                throw GetJavaException(pEnv);
+                            pClass = new IntPtr(_pClass);
+                            classes[call.JavaClass] = pClass;
+                        }
+                        pTarget = pClass.ToPointer();
+                    }
+
+                    IntPtr pName, pSignature;
+                    if(!strings.TryGetValue(call.Name, out pName))
+                        strings[call.Name] = pName = Marshal.StringToCoTaskMemUTF8(call.Name);
+                    if(!strings.TryGetValue(call.Signature, out pSignature))
+                        strings[call.Signature] = pSignature = Marshal.StringToCoTaskMemUTF8(call.Signature);
+
+                    int argCount = call.Args == null ? 0 : call.Args.Length;
+                    if(argCount > 0)
+                    {
+                        var wrapper = new StructWrapper(pEnv, call.Args);
+                        wrappers.Add(wrapper);
+                        void** pArgs = (void**)wrapper.Ptr;
+                        for(int k = 0; k < argCount; k++)
+                            args[argOffset + k] = (long)pArgs[k];
+                    }
+
+                    records[i].Target = pTarget;
+                    records[i].Name = pName;
+                    records[i].Signature = pSignature;
+                    records[i].Kind = call.ReturnSignature[0];
+                    records[i].Flags = call.Target == null ? 1 : 0;
+                    records[i].ArgOffset = argOffset;
+                    records[i].ArgCount = argCount;
+                    argOffset += argCount;
+                }
+
+                fixed(BatchCall* pCalls = records)
+                fixed(long* pArgs = args)
+                fixed(BatchResult* pResults = res)
+                {
+                    if(CallBatch(pEnv, pCalls, count, pArgs, pResults, stopOnError ? 1 : 0) < 0)
+                        throw new Exception("JVMBatch: invalid batch");
+                }
+
+                for(int i = 0; i < count; i++)
+                {
+                    long value = res[i].Value;
+                    switch(res[i].Status)
+                    {
+                        case 0:
+                            results[i] = getBatchResult(pEnv, pNetBridgeClass, calls[i].ReturnSignature, value);
+                            break;
+                        case -1:
+                            ThrowException(pEnv, (void*)value);
+                            results[i] = GetJavaException(pEnv);
+                            break;
+                        default:
+                            results[i] = new Exception("JVMBatch: " + calls[i].Name + calls[i].Signature + " was not run");
+                            break;
+                    }
+                }
+            }
+            finally
+            {
+                foreach(var wrapper in wrappers)
+                    wrapper.Dispose();
+                foreach(var ptr in strings.Values)
+                    Marshal.FreeCoTaskMem(ptr);
+                LeaveThread((void*)JVMPtr);
+            }
+
+            return results;
+        }
+
+        // Field layouts, see JVMFieldLayout. Reference fields sit in the struct as local references while in native code
+        // and are converted here, before the thread's frame is popped.
+
+        internal unsafe static void* newFieldLayout(string javaClass, string[] names, string kinds, int[] offsets)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
+            {
+                void* pClass;
+                if(FindClass( pEnv, javaClass, &pClass) != 0)
+                    throw GetJavaException(pEnv);
+
+                void* pLayout;
+                int res = NewFieldLayout(pEnv, pClass, names.Length, names, kinds, offsets, &pLayout);
+                if(res == -1)
+                    throw GetJavaException(pEnv);
+                else if(res != 0)
+                    throw new ArgumentException("JVMFieldLayout: the struct does not match the fields of " + javaClass);
+
+                return pLayout;
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        internal unsafe static void freeFieldLayout(void* pLayout)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
+            FreeFieldLayout(pEnv, pLayout);
+        }
+
+        internal unsafe static object[] getFields(void* pLayout, int hashCode, void* pStruct, int[] referenceOffsets)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
+            {
+                void* pObj = getFieldTarget(pEnv, hashCode);
+                int res = GetFields(pEnv, pLayout, pObj, pStruct);
+                if(res == -2)
+                    throw new ArgumentException("JVMFieldLayout: object " + hashCode + " is not an instance of the layout's class");
+                else if(res != 0)
+                    throw GetJavaException(pEnv);
+
+                var references = new object[referenceOffsets.Length];
+                for(int i = 0; i < referenceOffsets.Length; i++)
+                {
+                    void** pRef = (void**)((byte*)pStruct + referenceOffsets[i]);
+                    references[i] = *pRef == null ? null : getObject(pEnv, null, *pRef);
+                    *pRef = null;
+                }
+                return references;
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        internal unsafe static void setFields(void* pLayout, int hashCode, void* pStruct, int[] referenceOffsets, object[] references)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
+            {
+                void* pObj = getFieldTarget(pEnv, hashCode);
+                setFieldReferences(pEnv, pStruct, referenceOffsets, references);
+                int res = SetFields(pEnv, pLayout, pObj, pStruct);
+                if(res == -2)
+                    throw new ArgumentException("JVMFieldLayout: object " + hashCode + " is not an instance of the layout's class");
+                else if(res != 0)
+                    throw GetJavaException(pEnv);
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        internal unsafe static object newObjectFromFields(void* pLayout, void* pStruct, int[] referenceOffsets, object[] references)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
+            {
+                setFieldReferences(pEnv, pStruct, referenceOffsets, references);
+
+                void* pObj;
+                if(NewObjectFromFields(pEnv, pLayout, pStruct, &pObj) != 0)
+                    throw GetJavaException(pEnv);
+
+                return getObject(pEnv, null, pObj);
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        private unsafe static void* getFieldTarget(void* pEnv, int hashCode)
+        {
+            void* pNetBridgeClass;
+            if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("Find Class");
+
+            void* pObj = GetJVMObject(pEnv, pNetBridgeClass, hashCode);
+            if(pObj == IntPtr.Zero.ToPointer())
+                throw new Exception("Runtime Object not found: " + hashCode);
+            return pObj;
+        }
+
+        private unsafe static void setFieldReferences(void* pEnv, void* pStruct, int[] referenceOffsets, object[] references)
+        {
+            for(int i = 0; i < referenceOffsets.Length; i++)
+            {
+                object value = references == null || i >= references.Length ? null : references[i];
+                *(void**)((byte*)pStruct + referenceOffsets[i]) = value == null ? null : getObjectPointer(pEnv, value);
+            }
+        }
+
+        private unsafe static object getBatchResult(void* pEnv, void* pNetBridgeClass, string returnSignature, long value)
+        {
+            switch(returnSignature[0])
+            {
+                case 'V': return null;
+                case 'Z': return (value & 0xff) != 0;
+                case 'B': return (byte)value;
+                case 'C': return (char)(ushort)value;
+                case 'S': return (short)value;
+                case 'I': return (int)value;
+                case 'J': return value;
+                case 'F': return BitConverter.Int32BitsToSingle((int)value);
+                case 'D': return BitConverter.Int64BitsToDouble(value);
+            }
+
+            void* pObjResult = (void*)value;
+            if(pObjResult == null)
+                return null;
+
+            if(returnSignature == "Ljava/lang/String;")
+                return GetNetString(pEnv, pObjResult);
+
+            if(returnSignature.StartsWith("["))
+                return getJavaArray(pEnv, pNetBridgeClass, getArrayLength(pEnv, pObjResult), pObjResult, returnSignature);
+
+            int hashID_res = GetJVMID(pEnv, pObjResult, true);
+
+            if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive)
+                return JVMDelegate.DB[hashID_res].Target;
+
+            else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive)
+                return Runtime.DB[hashID_res].Target;
+
+            else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive)
+            {
+                if(JVMObject.DB[hashID_res].Target is JVMTuple)
+                    return (JVMObject.DB[hashID_res].Target as JVMTuple).jVMTuple;
+                return JVMObject.DB[hashID_res].Target;
+            }
+
+            string cls = returnSignature.StartsWith("L") && returnSignature.EndsWith(";") ? returnSignature.Substring(1).Replace(";","").Replace("/",".") : returnSignature;
+            return getObject(pEnv, cls, pObjResult);
+        }
+
+        /// <summary>
+        /// Preallocates boxed java.lang.Integer and java.lang.Long values for [low, high] so scalars in that range
+        /// are handed to Java without an allocation or a call into the JVM. The range is set once per process
+        /// and is limited to 65536 values.
+        /// </summary>
+        public unsafe static void BoxCache(int low, int high)
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+
+            try
+            {
+                int res = EnableBoxCache(pEnv, low, high);
+                if(res == -1)
+                    throw GetJavaException(pEnv);
+                else if(res != 0)
+                    throw new Exception("BoxCache: invalid range or already enabled");
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        /// <summary>
+        /// JNI local references held by the calling thread: the live estimate, the peak since the last reset
+        /// and the number of open frames. A peak that keeps growing on a long lived thread points to a leak.
+        /// </summary>
+        public unsafe static void LocalRefStats(out int current, out int peak, out int depth, bool resetPeak = false)
+        {
+            int _current, _peak, _depth;
+            GetLocalRefStats(&_current, &_peak, &_depth);
+            current = _current;
+            peak = _peak;
+            depth = _depth;
+
+            if(resetPeak)
+                ResetLocalRefPeak();
+        }
+
+        /*
+        Asynchronous calls. The work runs on one of the native executor threads, which were attached to the JVM once
+        by InitJVM, and completes its Task there. Continuations are queued to the ThreadPool so they never hold up an
+        executor thread. While the executor is not running, or all of its queues are full, the work runs on the
+        ThreadPool instead.
+        */
+        private const int asyncQueueCapacity = 1024;
+
+        private sealed class AsyncWork
+        {
+            public Func<object> Func;
+            public TaskCompletionSource<object> Completion;
+        }
+
+        /// <summary>
+        /// Runs func on a thread that is already attached to the JVM, without blocking the caller.
+        /// func can use the JVM API and JVMObject members as on any other thread.
+        /// </summary>
+        public static Task<object> InvokeAsync(Func<object> func)
+        {
+            if(func == null)
+                throw new ArgumentNullException("func");
+
+            var work = new AsyncWork{ Func = func, Completion = new TaskCompletionSource<object>(TaskCreationOptions.RunContinuationsAsynchronously) };
+            var handle = GCHandle.Alloc(work);
+            if(SubmitWork((long)GCHandle.ToIntPtr(handle)) != 0)
+            {
+                handle.Free();
+                return Task.Run(func);
+            }
+            return work.Completion.Task;
+        }
+
+        /// <summary>
+        /// Calls a method of a Java object on an executor thread, see InvokeAsync(Func&lt;object&gt;).
+        /// </summary>
+        public static Task<object> InvokeAsync(JVMObject target, string method, params object[] args)
+        {
+            if(target == null)
+                throw new ArgumentNullException("target");
+            return InvokeAsync(() => target.InvokeMember(method, args));
+        }
+
+        private unsafe static int runWork(void* pEnv, long token)
+        {
+            var handle = GCHandle.FromIntPtr((IntPtr)token);
+            var work = (AsyncWork)handle.Target;
+            handle.Free();
+
+            try { work.Completion.SetResult(work.Func()); }
+            catch(Exception e) { work.Completion.SetException(e); }
+            return 0;
+        }
+        private unsafe delegate int SetRunWork(void* pEnv, long token);
+
+        /// <summary>
+        /// Executor threads running, calls submitted and completed since start up, and calls a worker took from
+        /// another worker's queue.
+        /// </summary>
+        public unsafe static void AsyncStats(out int threads, out long submitted, out long completed, out long stolen)
+        {
+            int _threads;
+            long _submitted, _completed, _stolen;
+            GetExecutorStats(&_threads, &_submitted, &_completed, &_stolen);
+            threads = _threads;
+            submitted = _submitted;
+            completed = _completed;
+            stolen = _stolen;
+        }
+
+        /// <summary>
+        /// Turns the per entry point call metrics of JNIWrapper on or off at run time. Always false when the library
+        /// was built with JNIWRAPPER_NO_METRICS.
+        /// </summary>
+        public static bool CallMetricsEnabled
+        {
+            get { return MetricsEnabled() != 0; }
+            set { SetMetricsEnabled(value ? 1 : 0); }
+        }
+
+        /// <summary>
+        /// Call counts, exceptions, bytes marshalled and latency histograms of every JNIWrapper entry point called
+        /// since the last ResetCallMetrics, merged over all threads.
+        /// </summary>
+        public unsafe static JVMCallMetric[] GetCallMetrics()
+        {
+            int count = GetMetricCount();
+            int bucketCount = GetMetricBucketCount();
+            int stride = 4 + bucketCount;   // calls, exceptions, bytes, nanoseconds, buckets
+
+            long[] data = new long[Math.Max(count, 1) * stride];
+            fixed(long* pData = data)
+                count = SnapshotMetrics(pData, count);
+
+            var result = new JVMCallMetric[count];
+            for(int i = 0; i < count; i++)
+            {
+                int offset = i * stride;
+                long[] buckets = new long[bucketCount];
+                Array.Copy(data, offset + 4, buckets, 0, bucketCount);
+                result[i] = new JVMCallMetric(Marshal.PtrToStringAnsi(GetMetricName(i)), data[offset], data[offset + 1], data[offset + 2], data[offset + 3], buckets);
+            }
+            return result;
+        }
+
+        /// <summary>
+        /// Starts the call metrics from zero again. Threads calling at the same time are not disturbed.
+        /// </summary>
+        public static void ResetCallMetrics()
+        {
+            ResetMetrics();
+        }
+
+        /// <summary>
+        /// Smallest latency in nanoseconds counted in a bucket of JVMCallMetric.Histogram.
+        /// </summary>
+        public static long MetricBucketLowerBound(int bucket)
+        {
+            return GetMetricBucketLowerBound(bucket);
+        }
+
+        /// <summary>
+        /// Pins the storage of a Java primitive array and exposes it as a span without copying.
+        /// The view holds its own global reference to the array, so it stays valid after other calls on the thread.
+        /// It must be disposed on the thread that created it. In critical mode no other call into the JVM
+        /// may be made from that thread until the view is disposed.
+        /// </summary>
+        public unsafe static JVMArrayView<T> PinArray<T>(JVMObject array, JVMArrayAccess access = JVMArrayAccess.ReadOnly, bool critical = false) where T : unmanaged
+        {
+            return PinArray<T>(array, null, access, critical);
+        }
+
+        /// <summary>
+        /// Pins the primitive array held by a field of obj, or returned by its parameterless method of that name.
+        /// </summary>
+        public unsafe static JVMArrayView<T> PinArray<T>(JVMObject obj, string member, JVMArrayAccess access = JVMArrayAccess.ReadOnly, bool critical = false) where T : unmanaged
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+
+            void* pArray;
+            using(new ThreadScope())
+            {
+                void* pNetBridgeClass;
+                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+
+                void* pObj = GetJVMObject(pEnv, pNetBridgeClass, obj.JavaHashCode);
+                if(pObj == IntPtr.Zero.ToPointer())
+                    throw new Exception("Runtime Object not found: " + obj.JavaHashCode);
+
+                pArray = pObj;
+                if(member != null)
+                {
+                    string signature = "[" + TransformType(typeof(T));
+
+                    void* pField;
+                    void* pMethod;
+                    if(GetFieldID( pEnv, pObj, member, signature, &pField ) == 0)
+                    {
+                        if(GetObjectField( pEnv, pObj, pField, &pArray ) != 0)
+                            throw GetJavaException(pEnv);
+                    }
+                    else
+                    {
+                        GetException(pEnv);
+                        if(GetMethodID( pEnv, pObj, member, "()" + signature, &pMethod ) != 0)
+                            throw new Exception("Runtime array member not found: " + member + " " + signature);
+                        if(CallObjectMethod( pEnv, pObj, pMethod, &pArray, 0, null ) != 0)
+                            throw GetJavaException(pEnv);
+                    }
+
+                    if(pArray == IntPtr.Zero.ToPointer())
+                        throw new NullReferenceException("Runtime array member is null: " + member);
+                }
+
+                // The view outlives this scope, so it holds the array through a global reference of its own.
+                void* pGlobal;
+                if(NewGlobalRef(pEnv, pArray, &pGlobal) != 0)
+                    throw GetJavaException(pEnv);
+                pArray = pGlobal;
+            }
+
+            return new JVMArrayView<T>(pEnv, pArray, access, critical);
+        }
+
+        /// <summary>
+        /// Takes the pending Java exception of the thread for callers that are outside a thread scope.
+        /// </summary>
+        internal unsafe static JVMException TakeJavaException()
+        {
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
+
+            return GetJavaException(pEnv);
+        }
+
+        /// <summary>
+        /// Copies a Java T[][] (double, float, int, long, short or byte) into a jagged .NET array, one native copy per row.
+        /// Null rows stay null.
+        /// </summary>
+        public unsafe static T[][] GetMatrix<T>(JVMObject array) where T : unmanaged
+        {
+            Array[] rows = (Array[])getMatrix(array, typeof(T), false);
+            T[][] result = new T[rows.Length][];
+            for(int i = 0; i < rows.Length; i++)
+                result[i] = (T[])rows[i];
+            return result;
+        }
+
+        /// <summary>
+        /// Copies a rectangular Java T[][] into a .NET T[,]. Throws ArgumentException if its rows are null or differ in length.
+        /// </summary>
+        public unsafe static T[,] GetRectangularMatrix<T>(JVMObject array) where T : unmanaged
+        {
+            return (T[,])getMatrix(array, typeof(T), true);
+        }
+
+        private unsafe static object getMatrix(JVMObject array, Type type, bool rectangular)
+        {
+            if(array == null)
+                throw new ArgumentNullException("array");
+
+            string sType = matrixElementType(type);
+            if(sType == null)
+                throw new NotSupportedException("Runtime matrix: " + type + " is not a matrix element type");
+
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
+            {
+                void* pNetBridgeClass;
+                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+
+                void* pArray = GetJVMObject(pEnv, pNetBridgeClass, array.JavaHashCode);
+                if(pArray == IntPtr.Zero.ToPointer())
+                    throw new Exception("Runtime Object not found: " + array.JavaHashCode);
+
+                int rows = getArrayLength(pEnv, pArray);
+                if(rectangular)
+                    return GetNetRectangularMatrix(pEnv, pArray, sType, rows);
+                return GetNetMatrix(pEnv, pArray, sType, rows);
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        /// <summary>
+        /// Copies a Java Collection of boxed numbers (List&lt;Double&gt;, Collection&lt;Integer&gt;, ...) into a double[], long[],
+        /// int[] or float[]. The collection is read and unboxed inside JNIWrapper, in two crossings whatever its size.
+        /// </summary>
+        public unsafe static T[] CollectionToArray<T>(JVMObject collection) where T : unmanaged
+        {
+            if(collection == null)
+                throw new ArgumentNullException("collection");
+            if(typeof(T) != typeof(double) && typeof(T) != typeof(long) && typeof(T) != typeof(int) && typeof(T) != typeof(float))
+                throw new NotSupportedException("CollectionToArray: " + typeof(T) + " is not double, long, int or float");
+
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
+            {
+                void* pNetBridgeClass;
+                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+
+                void* pCollection = GetJVMObject(pEnv, pNetBridgeClass, collection.JavaHashCode);
+                if(pCollection == IntPtr.Zero.ToPointer())
+                    throw new Exception("Runtime Object not found: " + collection.JavaHashCode);
+
+                int size;
+                int res = CollectionSize(pEnv, pCollection, &size);
+                if(res == -2)
+                    throw new ArgumentException("CollectionToArray: object is not a java.util.Collection");
+                else if(res != 0)
+                    throw GetJavaException(pEnv);
+
+                T[] result = new T[size];
+                int count;
+                fixed(T* pDst = result)
+                {
+                    if(typeof(T) == typeof(double))
+                        res = CollectionToDoubleArray(pEnv, pCollection, (double*)pDst, size, &count);
+                    else if(typeof(T) == typeof(long))
+                        res = CollectionToLongArray(pEnv, pCollection, (long*)pDst, size, &count);
+                    else if(typeof(T) == typeof(int))
+                        res = CollectionToIntArray(pEnv, pCollection, (int*)pDst, size, &count);
+                    else
+                        res = CollectionToFloatArray(pEnv, pCollection, (float*)pDst, size, &count);
+                }
+
+                if(res == -2)
+                    throw new InvalidCastException("CollectionToArray: element " + count + " is null or not a java.lang.Number");
+                else if(res != 0)
+                    throw GetJavaException(pEnv);
+
+                // the collection may have shrunk between the two calls
+                if(count < size)
+                    Array.Resize(ref result, count);
+                return result;
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        /// <summary>
+        /// Builds a java.util.ArrayList of boxed Double, Long, Integer or Float from values in a single crossing.
+        /// </summary>
+        public unsafe static JVMObject NewJavaList<T>(ReadOnlySpan<T> values) where T : unmanaged
+        {
+            if(typeof(T) != typeof(double) && typeof(T) != typeof(long) && typeof(T) != typeof(int) && typeof(T) != typeof(float))
+                throw new NotSupportedException("NewJavaList: " + typeof(T) + " is not double, long, int or float");
+
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            try
+            {
+                void* pList;
+                int res;
+                fixed(T* pSrc = values)
+                {
+                    if(typeof(T) == typeof(double))
+                        res = NewDoubleArrayList(pEnv, (double*)pSrc, values.Length, &pList);
+                    else if(typeof(T) == typeof(long))
+                        res = NewLongArrayList(pEnv, (long*)pSrc, values.Length, &pList);
+                    else if(typeof(T) == typeof(int))
+                        res = NewIntArrayList(pEnv, (int*)pSrc, values.Length, &pList);
+                    else
+                        res = NewFloatArrayList(pEnv, (float*)pSrc, values.Length, &pList);
+                }
+                if(res != 0)
+                    throw GetJavaException(pEnv);
+
+                int hashID = GetJVMID(pEnv, pList, true);
+                return new JVMObject(hashID, "java/util/ArrayList", true, "NewJavaList");
+            }
+            finally
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        /// <summary>
+        /// Pins a primitive .NET array and hands it to Java as a direct ByteBuffer in native byte order, without copying.
+        /// The array stays pinned until Java no longer references the buffer or any view of it.
+        /// </summary>
+        public unsafe static JVMObject GetJavaBuffer(Array data)
+        {
+            if(data == null)
+                throw new ArgumentNullException("data");
+            if(data.Rank != 1 || !data.GetType().GetElementType().IsPrimitive)
+                throw new ArgumentException("GetJavaBuffer: only one dimensional primitive arrays can be pinned");
+
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
+
+            GCHandle pin = GCHandle.Alloc(data, GCHandleType.Pinned);
+            void* pBuffer;
+            if(NewPinnedDirectBuffer(pEnv, pin.AddrOfPinnedObject().ToPointer(), Buffer.ByteLength(data), GCHandle.ToIntPtr(pin).ToPointer(), &pBuffer) != 0)
+            {
+                pin.Free();
+                throw new Exception("GetJavaBuffer: " + GetException(pEnv));
+            }
+
+            int hashID = GetJVMID(pEnv, pBuffer, true);
+            return new JVMObject(hashID, "java/nio/ByteBuffer", true, "GetJavaBuffer");
+        }
+
+        /// <summary>
+        /// Hands a new Java direct ByteBuffer view over native memory. The memory lives until the buffer is disposed
+        /// and every Java view of it has been collected.
+        /// </summary>
+        public unsafe static JVMObject GetJavaBuffer(JVMNativeBuffer buffer)
+        {
+            // Token throws once the buffer is disposed, read it before a scope is opened.
+            long token = buffer.Token;
+
+            void*  pEnv;
+            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
+
+            void* pBuffer;
+            if(NewDirectBuffer(pEnv, token, &pBuffer) != 0)
+                throw new Exception("GetJavaBuffer: " + GetException(pEnv));
+
+            int hashID = GetJVMID(pEnv, pBuffer, true);
+            return new JVMObject(hashID, "java/nio/ByteBuffer", true, "GetJavaBuffer");
+        }
+
+        /// <summary>
+        /// Closes the scope of a successful AttacheThread when the block that opened it exits, throwing or not.
+        /// Scopes nest natively, so an unmatched or missing LeaveThread would free the caller's locals or keep them forever.
+        /// </summary>
+        private struct ThreadScope : IDisposable
+        {
+            public unsafe void Dispose()
+            {
+                LeaveThread((void*)JVMPtr);
+            }
+        }
+
+        [ThreadStatic] private static bool threadNamed;
+
+        /// <summary>
+        /// Critical JVMArrayViews open on this thread. JNI calls are not allowed until they are released.
+        /// </summary>
+        [ThreadStatic] internal static int criticalViews;
+
+        /// <summary>
+        /// Returns the JNIEnv of the calling thread. The env is cached natively per OS thread, so once the thread
+        /// is attached this is a thread local read. New threads are attached as daemons under the .NET thread name.
+        /// Every successful call opens a scope that must be closed by exactly one LeaveThread (ThreadScope) on the same
+        /// thread. The thread stays attached; closing the outermost scope frees every local reference handed out in it,
+        /// so nothing returned by JNIWrapper as a local may be used after that. Keep a JVMObject ID or a global ref instead.
+        /// </summary>
+        private unsafe static int AttacheThread(void* pVM, void** pEnv)
+        {
+            if(criticalViews > 0)
+                throw new InvalidOperationException("JVM call made while a critical JVMArrayView is open on this thread, dispose it first");
+
+            void* env = GetThreadEnv();
+            if(env == null)
+            {
+                string name = null;
+                if(!threadNamed)
+                {
+                    var thread = System.Threading.Thread.CurrentThread;
+                    name = thread.Name ?? ((thread.IsThreadPoolThread ? "CLR ThreadPool " : "CLR Thread ") + thread.ManagedThreadId);
+                    threadNamed = true;
+                }
+                env = EnterThread(pVM, name);
+            }
+
+            *pEnv = env;
+            return env == null ? -2 : 0;
+        }
+
+        public unsafe static object Python(System.Func<object[], object> func)
+        {
+            using(Py.GIL())
+            {
+                return func(null);
+            }
+        }
+
+        internal static String TransformType(Type type)
+        {
+            switch(Type.GetTypeCode(type))
+            { 
+                case TypeCode.Boolean:
+                    return "Z";
+
+                case TypeCode.Byte:
+                    return "B";
+
+                case TypeCode.Char:
+                    return "C";
+
+                case TypeCode.Int16:
+                    return "S";
+
+                case TypeCode.Int32: 
+                    return "I";
+                    
+                case TypeCode.Int64:
+                    return "J";
+
+                case TypeCode.Single:
+                    return "F";
+
+                case TypeCode.Double:
+                    return "D";
+
+                case TypeCode.Empty:
+                    return "V";
+
+                case TypeCode.String:
+                    return "Ljava/lang/String;";
+
+                case TypeCode.DateTime:
+                    return "Ljava/time/LocalDateTime;";
+                
+                default:
+                    if(type == typeof(ObjectWrapper))
+                        return "Ljava/lang/Object;";
 
                     if(type == typeof(void))
                         return "V";
@@ -2639,6 +4356,9 @@ namespace QuantApp.Kernel.JVM
                     else if(type.IsArrayOf<Double>())
                         return "[D";
 
+                    else if(matrixElementType(type, out bool _) is string sMatrix)
+                        return "[[" + sMatrix;
+
                     else if(type.IsArrayOf<string>())
                         return "[Ljava/lang/String;";
 
@@ -2687,7 +4407,6 @@ namespace QuantApp.Kernel.JVM
             } 
         }
 
-        private readonly static object objLock_TransformType_2 = new object();
         internal static String TransformType(Object obj)
         {
             if(obj == null)
@@ -2732,6 +4451,8 @@ namespace QuantApp.Kernel.JVM
                 default:
                     if(obj is ObjectWrapper)
                         return "Ljava/lang/Object;";
+                    else if(matrixElementType(type, out bool _) is string sMatrix)
+                        return "[[" + sMatrix;
                     else if(obj is Array)
                     {
                         var arr = obj as Array;
@@ -2796,40 +4517,36 @@ namespace QuantApp.Kernel.JVM
             } 
         }
 
-        private readonly static object objLock_getHashCode = new object();
         internal unsafe static int GetJVMID(void* pEnv, void* pObj, bool cache)
         {
-            lock(objLock_getHashCode)
-            { 
-                try
-                {
-                    void* pNetBridgeClass;
-                    void* pSetPathMethod;
+            try
+            {
+                void* pNetBridgeClass;
+                void* pSetPathMethod;
 
-                    if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0 )
+                if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0 )
+                {
+                    if( GetStaticMethodID( pEnv, pNetBridgeClass, "GetID", "(Ljava/lang/Object;Z)I", &pSetPathMethod ) == 0 )
                     {
-                        if( GetStaticMethodID( pEnv, pNetBridgeClass, "GetID", "(Ljava/lang/Object;Z)I", &pSetPathMethod ) == 0 )
-                        {
-                            void** pArg_lcs = stackalloc void*[2];
-                            pArg_lcs[0] = pObj;
-                            pArg_lcs[1] = *(void**)&cache;
-                            int _res;
-                            if(CallStaticIntMethod( pEnv, pNetBridgeClass, pSetPathMethod, 2, pArg_lcs, &_res) != 0)
-                                Console.WriteLine("JAVA Object not registered...");
-
-                            return _res;
-                        }
-                        else
-                            Console.WriteLine("getHashCode method not found");
-                    }
+                        void** pArg_lcs = stackalloc void*[2];
+                        pArg_lcs[0] = pObj;
+                        pArg_lcs[1] = *(void**)&cache;
+                        int _res;
+                        if(CallStaticIntMethod( pEnv, pNetBridgeClass, pSetPathMethod, 2, pArg_lcs, &_res) != 0)
+                            Console.WriteLine("JAVA Object not registered...");
 
-                    return 0;
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR GetID void: " + e);
-                    return 0;
+                        return _res;
+                    }
+                    else
+                        Console.WriteLine("getHashCode method not found");
                 }
+
+                return 0;
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR GetID void: " + e);
+                return 0;
             }
         }
 
@@ -2846,214 +4563,168 @@ namespace QuantApp.Kernel.JVM
                 ConcurrentDictionary<string,MethodInfo> _o;
                 MethodDB.TryRemove(id, out _o);
             }
-            
-            void*  pEnv;
-            if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
-            void* pNetBridgeClass;
-            void* pSetPathMethod;
-
-            if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0 )
-            {
-                if( GetStaticMethodID( pEnv, pNetBridgeClass, "RemoveID", "(I)V", &pSetPathMethod ) == 0 )
-                {
-                    void** pArg_lcs = stackalloc void*[1];
-                    pArg_lcs[0] = *(void**)&id;
-                    int _res = 0;
-                    if(CallStaticVoidMethod( pEnv, pNetBridgeClass, pSetPathMethod, 1, pArg_lcs) != 0)
-                        Console.WriteLine("JAVA RemoveID Object not registered...");
-
-                    return _res;
-                }
-                else
-                    Console.WriteLine("RemoveID method not found");
-
-                
-            }
 
-            return 0;
+            // Mostly called from finalizers: the JVM side is released in batches by JNIWrapper's release thread.
+            return ReleaseID(id);
         }
 
-        private readonly static object objLock_isIterable = new object();
         private unsafe static bool isIterable(void* pEnv, void* pNetBridgeClass, void* pObj)
         {
-            lock(objLock_isIterable)
+            try
             {
-                try
-                {
-                    if(pObj == IntPtr.Zero.ToPointer())
-                        return false;
-
-                    void** pArg_lcs = stackalloc void*[1];
-                    pArg_lcs[0] = *(void**)&pObj;
-                    
-                    void*  pMethodSigHashCode;
-                    if(GetStaticMethodID( pEnv, pNetBridgeClass, "isIterable", "(Ljava/lang/Object;)Z", &pMethodSigHashCode ) == 0)
-                    {
-                        bool _res;
-                        if(CallStaticBooleanMethod( pEnv, pNetBridgeClass, pMethodSigHashCode, 1, pArg_lcs, &_res) != 0)
-                            throw new Exception(GetException(pEnv));
+                if(pObj == IntPtr.Zero.ToPointer())
+                    return false;
 
-                        return _res;
-                    }
-                    else
-                        throw new Exception(GetException(pEnv));
-                }
-                catch(Exception e)
+                void** pArg_lcs = stackalloc void*[1];
+                pArg_lcs[0] = *(void**)&pObj;
+                
+                void*  pMethodSigHashCode;
+                if(GetStaticMethodID( pEnv, pNetBridgeClass, "isIterable", "(Ljava/lang/Object;)Z", &pMethodSigHashCode ) == 0)
                 {
-                    Console.WriteLine("CLR isIterable: " + e);
-                    return false;
+                    bool _res;
+                    if(CallStaticBooleanMethod( pEnv, pNetBridgeClass, pMethodSigHashCode, 1, pArg_lcs, &_res) != 0)
+                        throw GetJavaException(pEnv);
+
+                    return _res;
                 }
+                else
+                    throw GetJavaException(pEnv);
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR isIterable: " + e);
+                return false;
             }
         }
 
-        private readonly static object objLock_isMap = new object();
         private unsafe static bool isMap(void* pEnv, void* pNetBridgeClass, void* pObj)
         {
-            lock(objLock_isMap)
+            try
             {
-                try
-                {
-                    if(pObj == IntPtr.Zero.ToPointer())
-                        return false;
+                if(pObj == IntPtr.Zero.ToPointer())
+                    return false;
 
-                    void** pArg_lcs = stackalloc void*[1];
-                    pArg_lcs[0] = *(void**)&pObj;
-                    
-                    void*  pMethodSigHashCode;
-                    if(GetStaticMethodID( pEnv, pNetBridgeClass, "isMap", "(Ljava/lang/Object;)Z", &pMethodSigHashCode ) == 0)
-                    {
-                        bool _res;
-                        if(CallStaticBooleanMethod( pEnv, pNetBridgeClass, pMethodSigHashCode, 1, pArg_lcs, &_res) != 0)
-                            throw new Exception(GetException(pEnv));
-                        return _res;
-                    }
-                    else
-                        throw new Exception(GetException(pEnv));
-                }
-                catch(Exception e)
+                void** pArg_lcs = stackalloc void*[1];
+                pArg_lcs[0] = *(void**)&pObj;
+                
+                void*  pMethodSigHashCode;
+                if(GetStaticMethodID( pEnv, pNetBridgeClass, "isMap", "(Ljava/lang/Object;)Z", &pMethodSigHashCode ) == 0)
                 {
-                    Console.WriteLine("CLR isMap: " + e);
-                    return false;
+                    bool _res;
+                    if(CallStaticBooleanMethod( pEnv, pNetBridgeClass, pMethodSigHashCode, 1, pArg_lcs, &_res) != 0)
+                        throw GetJavaException(pEnv);
+                    return _res;
                 }
+                else
+                    throw GetJavaException(pEnv);
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR isMap: " + e);
+                return false;
             }
         }
 
-        private readonly static object objLock_isCollection = new object();
         private unsafe static bool isCollection(void* pEnv, void* pNetBridgeClass, void* pObj)
         {
-            lock(objLock_isCollection)
+            try
             {
-                try
-                {
-                    if(pObj == IntPtr.Zero.ToPointer())
-                        return false;
+                if(pObj == IntPtr.Zero.ToPointer())
+                    return false;
 
-                    void** pArg_lcs = stackalloc void*[1];
-                    pArg_lcs[0] = *(void**)&pObj;
-                    
-                    void*  pMethodSigHashCode;
-                    if(GetStaticMethodID( pEnv, pNetBridgeClass, "isCollection", "(Ljava/lang/Object;)Z", &pMethodSigHashCode ) == 0)
-                    {
-                        bool _res;
-                        if(CallStaticBooleanMethod( pEnv, pNetBridgeClass, pMethodSigHashCode, 1, pArg_lcs, &_res) != 0)
-                            throw new Exception(GetException(pEnv));
-                        return _res;
-                    }
-                    else
-                        throw new Exception(GetException(pEnv));
-                        
-                }
-                catch(Exception e)
+                void** pArg_lcs = stackalloc void*[1];
+                pArg_lcs[0] = *(void**)&pObj;
+                
+                void*  pMethodSigHashCode;
+                if(GetStaticMethodID( pEnv, pNetBridgeClass, "isCollection", "(Ljava/lang/Object;)Z", &pMethodSigHashCode ) == 0)
                 {
-                    Console.WriteLine("CLR isCollection: " + e);
-                    return false;
+                    bool _res;
+                    if(CallStaticBooleanMethod( pEnv, pNetBridgeClass, pMethodSigHashCode, 1, pArg_lcs, &_res) != 0)
+                        throw GetJavaException(pEnv);
+                    return _res;
                 }
+                else
+                    throw GetJavaException(pEnv);
+                    
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR isCollection: " + e);
+                return false;
             }
         }
 
-        private readonly static object objLock_getClass = new object();
         private unsafe static int getClass(void* pEnv, void* pObj, ref void* pClass)
         {
-            lock(objLock_getClass)
+            if(pObj == IntPtr.Zero.ToPointer())
             {
-                if(pObj == IntPtr.Zero.ToPointer())
-                {
-                    Console.WriteLine("CLR getClass null pointer 1");
-                    pClass = IntPtr.Zero.ToPointer();
-                    return -2;
-                }
-
-                void* pNameClass;
-                void* _pClass;
+                Console.WriteLine("CLR getClass null pointer 1");
+                pClass = IntPtr.Zero.ToPointer();
+                return -2;
+            }
 
-                if(GetObjectClass(pEnv, pObj, &_pClass, &pNameClass) == 0)
-                {
+            void* pNameClass;
+            void* _pClass;
 
-                    pClass = _pClass;
-                    return 0;
-                }
+            if(GetObjectClass(pEnv, pObj, &_pClass, &pNameClass) == 0)
+            {
 
-                Console.WriteLine("CLR getClass null pointer 2");
-                return -1;
+                pClass = _pClass;
+                return 0;
             }
+
+            Console.WriteLine("CLR getClass null pointer 2");
+            return -1;
         }
 
-        private readonly static object objLock_getClassName = new object();
         private unsafe static int getClassName(void* pEnv, void* pObj, ref string cName)
         {
-            lock(objLock_getClassName)
+            if(pObj == IntPtr.Zero.ToPointer())
+            {
+                Console.WriteLine("CLR getClassName null pointer 1");
+                cName =  null;
+                return -2;
+            }
+            void* pNameClass;
+            void* _pClass;
+            if(GetObjectClass(pEnv, pObj, &_pClass, &pNameClass) == 0)
             {
-                if(pObj == IntPtr.Zero.ToPointer())
-                {
-                    Console.WriteLine("CLR getClassName null pointer 1");
-                    cName =  null;
-                    return -2;
-                }
-                void* pNameClass;
-                void* _pClass;
-                if(GetObjectClass(pEnv, pObj, &_pClass, &pNameClass) == 0)
-                {
 
-                    cName = GetNetString(pEnv, pNameClass);
-                    return 0;
-                }
-                return -1;
+                cName = GetNetString(pEnv, pNameClass);
+                return 0;
             }
+            return -1;
         }
 
-        private readonly static object objLock_getArrayLength = new object();
         private unsafe static int getArrayLength(void* pEnv, void* arr)
         {
-            lock(objLock_getArrayLength)
-            { 
-                try
+            try
+            {
+                void* pArrayClass;
+                if(FindClass( pEnv, "java/lang/reflect/Array", &pArrayClass) == 0)
                 {
-                    void* pArrayClass;
-                    if(FindClass( pEnv, "java/lang/reflect/Array", &pArrayClass) == 0)
+                    void* pArrayLengthMethod;
+                    if(GetStaticMethodID( pEnv, pArrayClass, "getLength", "(Ljava/lang/Object;)I", &pArrayLengthMethod) == 0)
                     {
-                        void* pArrayLengthMethod;
-                        if(GetStaticMethodID( pEnv, pArrayClass, "getLength", "(Ljava/lang/Object;)I", &pArrayLengthMethod) == 0)
-                        {
-                            var size = Unsafe.SizeOf<object[]>();
-                            void** _ptr = (void**)Marshal.AllocHGlobal(size);
-                            _ptr[0] = arr;
-
-                            int _res;
-                            if(CallStaticIntMethod( pEnv, pArrayClass, pArrayLengthMethod, 1, _ptr, &_res) != 0)
-                                throw new Exception(GetException(pEnv));
-                            return _res;
-                        }
-                        else
-                            throw new Exception(GetException(pEnv));
+                        var size = Unsafe.SizeOf<object[]>();
+                        void** _ptr = (void**)Marshal.AllocHGlobal(size);
+                        _ptr[0] = arr;
+
+                        int _res;
+                        if(CallStaticIntMethod( pEnv, pArrayClass, pArrayLengthMethod, 1, _ptr, &_res) != 0)
+                            throw GetJavaException(pEnv);
+                        return _res;
                     }
                     else
-                        throw new Exception(GetException(pEnv));
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR getArrayLength: " + e);
-                    return 0;
+                        throw GetJavaException(pEnv);
                 }
+                else
+                    throw GetJavaException(pEnv);
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR getArrayLength: " + e);
+                return 0;
             }
         }
         
@@ -3061,6 +4732,7 @@ namespace QuantApp.Kernel.JVM
         {
             void*  pEnv;
             if(AttacheThread((void*)JVMPtr,&pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
             void* pNetBridgeClass;
             void* pSetPathMethod;
 
@@ -3078,7 +4750,21 @@ namespace QuantApp.Kernel.JVM
             }
         }
 
-        private readonly static object objLock_Signature = new object();
+        /// <summary>
+        /// Shuts the JVM down, waiting for its non-daemon threads. Needed for exit time work such as writing a
+        /// class data sharing archive requested with JVMSharedArchive.Dump.
+        /// </summary>
+        public unsafe static void DestroyJVM()
+        {
+            if(!Loaded)
+                return;
+
+            Loaded = false;
+            StopExecutor();
+            DestroyJavaVM((void*)JVMPtr);
+            JVMPtr = IntPtr.Zero;
+        }
+
         public static string[] Signature(object obj)
         {
             if(obj == null) return new string[]{};
@@ -3107,7 +4793,6 @@ namespace QuantApp.Kernel.JVM
             return arr.ToArray();
         }
 
-        private readonly static object objLock_RegisterJVMObject = new object();
         public unsafe static void RegisterJVMObject(void* pEnv, int hashCode, void* pObj)
         {
             void* pNetBridgeClass;
@@ -3129,264 +4814,161 @@ namespace QuantApp.Kernel.JVM
         }
         
 
-        private readonly static object objLock_GetJVMObject_2 = new object();
         public unsafe static void* GetJVMObject(void* pEnv, void* pNetBridgeClass, int hashCode)
         {
-            lock(objLock_GetJVMObject_2)
+            void* pGetJVMObjectMethod;
+            
+            if(true)
             {
-                void* pGetJVMObjectMethod;
-                
-                if(true)
+                if( GetStaticMethodID( pEnv, pNetBridgeClass, "GetObject", "(I)Ljava/lang/Object;", &pGetJVMObjectMethod ) == 0 )
                 {
-                    if( GetStaticMethodID( pEnv, pNetBridgeClass, "GetObject", "(I)Ljava/lang/Object;", &pGetJVMObjectMethod ) == 0 )
-                    {
-                        object[] pAr_len_data = new object[]{ hashCode };
-                        void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
+                    object[] pAr_len_data = new object[]{ hashCode };
+                    void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
-                        void*  pGetJVMObject;
-                        if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pGetJVMObjectMethod, &pGetJVMObject, 1, pAr_len) == 0)
-                            return pGetJVMObject;
-                        else
-                        {
-                            Console.WriteLine("GetObject error: " + GetException(pEnv));
-                            return IntPtr.Zero.ToPointer();
-                        }
-                    }
+                    void*  pGetJVMObject;
+                    if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pGetJVMObjectMethod, &pGetJVMObject, 1, pAr_len) == 0)
+                        return pGetJVMObject;
                     else
-                        Console.WriteLine("GetObject method not found: " + GetException(pEnv));
+                    {
+                        Console.WriteLine("GetObject error: " + GetException(pEnv));
+                        return IntPtr.Zero.ToPointer();
+                    }
                 }
-
-                return IntPtr.Zero.ToPointer();
+                else
+                    Console.WriteLine("GetObject method not found: " + GetException(pEnv));
             }
-        }
-        
-        private readonly static object objLock_getObject = new object();
-        public unsafe static object getObject(void* _pEnv, string cls, void* pObjResult)
-        {
-            lock(objLock_getObject)
-            {
-                try
-                {
-                    string cName = null;
-                    IntPtr returnPtr = new IntPtr(pObjResult);
-
-                    if(getClassName(_pEnv, pObjResult, ref cName) == 0)
-                    {
-                        switch(cName)
-                        {
-                            case "java.lang.Boolean":
-                                void*  pInvokeMethod_boolean;
-                                if(GetMethodID( _pEnv, pObjResult, "booleanValue", "()Z", &pInvokeMethod_boolean ) == 0)
-                                {
-                                    void** pAr_boolean = stackalloc void*[1];
-                                    {
-                                        bool _res;
-                                        if(CallBooleanMethod( _pEnv, pObjResult, pInvokeMethod_boolean, 1, pAr_boolean, &_res) != 0)
-                                            throw new Exception(GetException(_pEnv));
-                                        return _res;
-                                    }
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
-
-                            case "java.lang.Byte":
-                                void*  pInvokeMethod_byte;
-                                if(GetMethodID( _pEnv, pObjResult, "byteValue", "()B", &pInvokeMethod_byte ) == 0)
-                                {
-                                    void** pAr_byte = stackalloc void*[1];
-                                    byte _res;
-                                    if(CallByteMethod( _pEnv, pObjResult, pInvokeMethod_byte, 1, pAr_byte, &_res) != 0)
-                                        throw new Exception(GetException(_pEnv));
-                                    return _res;
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
-                            
-
-                            case "java.lang.Character":
-                                void*  pInvokeMethod_char;
-                                if(GetMethodID( _pEnv, pObjResult, "charValue", "()C", &pInvokeMethod_char ) == 0)
-                                {
-                                    void** pAr_char = stackalloc void*[1];
-                                    char res_char;
-                                    if(CallCharMethod( _pEnv, pObjResult, pInvokeMethod_char, 1, pAr_char, &res_char) != 0)
-                                        throw new Exception(GetException(_pEnv));
-                                    return res_char;
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
-
-                            case "java.lang.Short":
-                                void*  pInvokeMethod_short;
-
-                                if(GetMethodID( _pEnv, pObjResult, "shortValue", "()S", &pInvokeMethod_short ) == 0)
-                                {
-                                    void** pAr_short = stackalloc void*[1];
-                                    short _res;
-                                    if(CallShortMethod( _pEnv, pObjResult, pInvokeMethod_short, 1, pAr_short, &_res) != 0)
-                                        throw new Exception(GetException(_pEnv));
-                                    return _res;
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
-
-
-                            case "java.lang.Integer":
-                                void*  pInvokeMethod_int;
-                                if(GetMethodID( _pEnv, pObjResult, "intValue", "()I", &pInvokeMethod_int ) == 0)
-                                {
-                                    void** pAr_int = stackalloc void*[1];
-                                    int res;
-                                    if(CallIntMethod( _pEnv, pObjResult, pInvokeMethod_int, 1, pAr_int, &res) != 0)
-                                        throw new Exception(GetException(_pEnv));
-                                    return res;
-                                    
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
-
-                            case "java.lang.Long":
-                                void*  pInvokeMethod_long;
-                                if(GetMethodID( _pEnv, pObjResult, "longValue", "()J", &pInvokeMethod_long ) == 0)
-                                {
-                                    void** pAr_long = stackalloc void*[1];
-                                    
-                                    long res;
-                                    if(CallLongMethod( _pEnv, pObjResult, pInvokeMethod_long, 1, pAr_long, &res) != 0)
-                                        throw new Exception(GetException(_pEnv));
-                                    return res;
-                                    
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
 
-                            case "java.lang.Float":
-                                void*  pInvokeMethod_float;
-                                if(GetMethodID( _pEnv, pObjResult, "floatValue", "()F", &pInvokeMethod_float ) == 0)
-                                {
-                                    void** pAr_float = stackalloc void*[1];
-                                    float _res;
-                                    if(CallFloatMethod( _pEnv, pObjResult, pInvokeMethod_float, 1, pAr_float, &_res) != 0)
-                                        throw new Exception(GetException(_pEnv));
-                                    return _res;
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
+            return IntPtr.Zero.ToPointer();
+        }
+        
+        public unsafe static object getObject(void* _pEnv, string cls, void* pObjResult)
+        {
+            try
+            {
+                IntPtr returnPtr = new IntPtr(pObjResult);
 
+                // Classify and unbox in one crossing, only plain objects need their class name
+                TaggedValue tagged;
+                if(UnboxObject(_pEnv, pObjResult, &tagged) != 0)
+                    throw GetJavaException(_pEnv);
 
-                            case "java.lang.Double":
-                                void*  pInvokeMethod_double;
-                                if(GetMethodID( _pEnv, pObjResult, "doubleValue", "()D", &pInvokeMethod_double ) == 0)
-                                {
-                                    void** pAr_double = stackalloc void*[1];
-                                    double res;
-                                    if(CallDoubleMethod( _pEnv, pObjResult, pInvokeMethod_double, 1, pAr_double, &res) != 0)
-                                        throw new Exception(GetException(_pEnv));
-                                    return res;
-                                }
-                                else
-                                    throw new Exception(GetException(_pEnv));
+                switch((char)tagged.Kind)
+                {
+                    case '\0': return null;
+                    case 'Z': return (tagged.Value & 0xff) != 0;
+                    case 'B': return (byte)tagged.Value;
+                    case 'C': return (char)(ushort)tagged.Value;
+                    case 'S': return (short)tagged.Value;
+                    case 'I': return (int)tagged.Value;
+                    case 'J': return tagged.Value;
+                    case 'F': return BitConverter.Int32BitsToSingle((int)tagged.Value);
+                    case 'D': return BitConverter.Int64BitsToDouble(tagged.Value);
+                    case 'T': return GetNetString(_pEnv, pObjResult);
+                }
 
-                            case "java.lang.String":
-                                return GetNetString(_pEnv, pObjResult);
+                string cName = GetNetString(_pEnv, tagged.Name);
+                DeleteLocalRef(_pEnv, tagged.Name);
 
-                            case "java.time.LocalDateTime":
-                                return GetNetDateTime(_pEnv, pObjResult);
+                if(cName != null)
+                {
+                    switch(cName)
+                    {
 
-                            case "scala.Tuple1":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple1 tuple = new JVMTuple1(_tuple, _tuple._1());
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
-                            case "scala.Tuple2":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple2 tuple = new JVMTuple2(_tuple, _tuple._1(), _tuple._2());
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
-                            case "scala.Tuple3":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple3 tuple = new JVMTuple3(_tuple, _tuple._1(), _tuple._2(), _tuple._3());
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
-                            case "scala.Tuple4":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple4 tuple = new JVMTuple4(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4());
-                                
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
-                            case "scala.Tuple5":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple5 tuple = new JVMTuple5(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5());
-                                
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
-                            case "scala.Tuple6":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple6 tuple = new JVMTuple6(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5(), _tuple._6());
-                                
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
-                            case "scala.Tuple7":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple7 tuple = new JVMTuple7(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5(), _tuple._6(), _tuple._7());
-                                
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
-                            case "scala.Tuple8":
-                            {
-                                dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                JVMTuple8 tuple = new JVMTuple8(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5(), _tuple._6(), _tuple._7(), _tuple._8());
-                                
-                                var tp = new JVMTuple(_tuple, tuple);
-                                return tuple;
-                            }
+                        case "java.time.LocalDateTime":
+                            return GetNetDateTime(_pEnv, pObjResult);
 
-                            default:
-                                var __res = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
-                                return __res;
+                        case "scala.Tuple1":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple1 tuple = new JVMTuple1(_tuple, _tuple._1());
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
+                        }
+                        case "scala.Tuple2":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple2 tuple = new JVMTuple2(_tuple, _tuple._1(), _tuple._2());
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
+                        }
+                        case "scala.Tuple3":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple3 tuple = new JVMTuple3(_tuple, _tuple._1(), _tuple._2(), _tuple._3());
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
+                        }
+                        case "scala.Tuple4":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple4 tuple = new JVMTuple4(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4());
+                            
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
+                        }
+                        case "scala.Tuple5":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple5 tuple = new JVMTuple5(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5());
+                            
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
+                        }
+                        case "scala.Tuple6":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple6 tuple = new JVMTuple6(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5(), _tuple._6());
+                            
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
                         }
+                        case "scala.Tuple7":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple7 tuple = new JVMTuple7(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5(), _tuple._6(), _tuple._7());
+                            
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
+                        }
+                        case "scala.Tuple8":
+                        {
+                            dynamic _tuple = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            JVMTuple8 tuple = new JVMTuple8(_tuple, _tuple._1(), _tuple._2(), _tuple._3(), _tuple._4(), _tuple._5(), _tuple._6(), _tuple._7(), _tuple._8());
+                            
+                            var tp = new JVMTuple(_tuple, tuple);
+                            return tuple;
+                        }
+
+                        default:
+                            var __res = CreateInstancePtr(_pEnv, cName, null, returnPtr, null );
+                            return __res;
                     }
-                    else
-                        throw new Exception(GetException(_pEnv));
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CLR getObject: " + e);
-                    return null;
                 }
+                else
+                    throw GetJavaException(_pEnv);
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CLR getObject: " + e);
+                return null;
             }
         }
         
-        private readonly static object objLock_CreateInstance = new object();
         public unsafe static JVMObject CreateInstance( string sClass, params object[] args )
         {
             void*  _pEnv;
             if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
 
             var ret = CreateInstancePtr(_pEnv, sClass, null, IntPtr.Zero, args );
-            DetacheThread((void*)JVMPtr);
             return ret;            
         }
 
-        private readonly static object objLock_CreateInstancePath = new object();
         public unsafe static JVMObject CreateInstancePath( string sClass, string path, params object[] args )
         {
             void*  _pEnv;
             if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+            using var scope = new ThreadScope();
 
             void*  _pNetBridgeClass;
             if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) == 0)
@@ -3401,7 +4983,6 @@ namespace QuantApp.Kernel.JVM
                     if(CallStaticObjectMethod( _pEnv, _pNetBridgeClass, pLoadClassMethod, &_pClass, 2, pArg_lcs) == 0)
                     {
                         var ret = CreateInstancePtr(_pEnv, sClass, path, IntPtr.Zero, args );
-                        DetacheThread((void*)JVMPtr);
                         return ret;
                     }
                     else
@@ -3420,836 +5001,1219 @@ namespace QuantApp.Kernel.JVM
             }
         }
 
-        private readonly static object objLock_CreateInstancePtr = new object();
         private unsafe static JVMObject CreateInstancePtr(void* pEnv,  string sClass, string path, IntPtr objPtr, object[] args )
         {
-            lock(objLock_CreateInstancePtr)
+            void*  pNetBridgeClass;  // Class struct of the executed method
+            void*  pSignaturesMethod; // The executed method struct
+            void*  pArrayClassesMethod; // The executed method struct
+            
+            try
             {
-                void*  pNetBridgeClass;  // Class struct of the executed method
-                void*  pSignaturesMethod; // The executed method struct
-                void*  pArrayClassesMethod; // The executed method struct
-                
-                try
+                if(Loaded)
                 {
-                    if(Loaded)
+                    
+                    if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0 )
                     {
-                        
-                        if(FindClass( pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) == 0 )
+                        if(GetStaticMethodID( pEnv, pNetBridgeClass, "ArrayClasses", "([Ljava/lang/Object;)[Ljava/lang/String;", &pArrayClassesMethod ) == 0)
                         {
-                            if(GetStaticMethodID( pEnv, pNetBridgeClass, "ArrayClasses", "([Ljava/lang/Object;)[Ljava/lang/String;", &pArrayClassesMethod ) == 0)
+                            // Find the main method
+                            if( GetStaticMethodID( pEnv, pNetBridgeClass, "Signatures", "(Ljava/lang/String;)[Ljava/lang/String;", &pSignaturesMethod ) == 0 )
                             {
-                                // Find the main method
-                                if( GetStaticMethodID( pEnv, pNetBridgeClass, "Signatures", "(Ljava/lang/String;)[Ljava/lang/String;", &pSignaturesMethod ) == 0 )
-                                {
-                                    void*  pClass = pClass = IntPtr.Zero.ToPointer();
+                                void*  pClass = pClass = IntPtr.Zero.ToPointer();
 
-                                    int classFound = -1;
+                                int classFound = -1;
 
-                                    if(classFound != 0)
+                                if(classFound != 0)
+                                {
+                                    void*  pLoadClassMethod; // The executed method struct
+                                    
+                                    if( GetStaticMethodID( pEnv, pNetBridgeClass, "LoadClass", "([Ljava/lang/String;)Ljava/lang/Class;", &pLoadClassMethod ) == 0 )
                                     {
-                                        void*  pLoadClassMethod; // The executed method struct
+                                        object[] ar_data = new object[]{ path == null ? new string[]{ sClass } : new string[]{ sClass, path } };
+                                        void** pArg_lcs = (void**)(new StructWrapper(pEnv, ar_data)).Ptr;
                                         
-                                        if( GetStaticMethodID( pEnv, pNetBridgeClass, "LoadClass", "([Ljava/lang/String;)Ljava/lang/Class;", &pLoadClassMethod ) == 0 )
-                                        {
-                                            object[] ar_data = new object[]{ path == null ? new string[]{ sClass } : new string[]{ sClass, path } };
-                                            void** pArg_lcs = (void**)(new StructWrapper(pEnv, ar_data)).Ptr;
-                                            
-                                            classFound = CallStaticObjectMethod( pEnv, pNetBridgeClass, pLoadClassMethod, &pClass, 1, pArg_lcs);
-                                        }
-                                        else
-                                        {
-                                            Console.WriteLine("NetCore: LoadClass not found");
-                                            classFound = -1;
-                                            pClass = IntPtr.Zero.ToPointer();
-                                        }
+                                        classFound = CallStaticObjectMethod( pEnv, pNetBridgeClass, pLoadClassMethod, &pClass, 1, pArg_lcs);
+                                    }
+                                    else
+                                    {
+                                        Console.WriteLine("NetCore: LoadClass not found");
+                                        classFound = -1;
+                                        pClass = IntPtr.Zero.ToPointer();
                                     }
+                                }
 
 
-                                    //LoadClass
-                                    if(classFound == 0 )
+                                //LoadClass
+                                if(classFound == 0 )
+                                {
+                                    object[] ar_data = new object[]{ sClass };
+                                    void** pArg_sig = (void**)(new StructWrapper(pEnv, ar_data)).Ptr;
+                                    void* rArr;
+
+                                    if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pSignaturesMethod, &rArr, 1, pArg_sig) == 0)
                                     {
-                                        object[] ar_data = new object[]{ sClass };
-                                        void** pArg_sig = (void**)(new StructWrapper(pEnv, ar_data)).Ptr;
-                                        void* rArr;
+                                        int rArrLen = getArrayLength(pEnv, rArr);
 
-                                        if(CallStaticObjectMethod( pEnv, pNetBridgeClass, pSignaturesMethod, &rArr, 1, pArg_sig) == 0)
+                                        var signatures = new List<string>();
+                                        for(int i = 0; i < rArrLen; i++)
                                         {
-                                            int rArrLen = getArrayLength(pEnv, rArr);
-
-                                            var signatures = new List<string>();
-                                            for(int i = 0; i < rArrLen; i++)
-                                            {
-                                                void* pElement;
-                                                GetObjectArrayElement(pEnv, rArr, i, &pElement);
-                                                string signature = GetNetString(pEnv, pElement);
-                                                signatures.Add(signature);
-                                            }
+                                            void* pElement;
+                                            GetObjectArrayElement(pEnv, rArr, i, &pElement);
+                                            string signature = GetNetString(pEnv, pElement);
+                                            signatures.Add(signature);
+                                        }
 
-                                            void* pObj;
-                                            IntPtr ObjectPtr;
+                                        void* pObj;
+                                        IntPtr ObjectPtr;
 
-                                            if(objPtr == IntPtr.Zero)
+                                        if(objPtr == IntPtr.Zero)
+                                        {
+                                            if(args == null || args.Length == 0)
                                             {
-                                                if(args == null || args.Length == 0)
-                                                {
-                                                    void** ar_newInstance = stackalloc void*[1];
-                                                    if(NewObjectP( pEnv, pClass, "()V", 0, ar_newInstance, &pObj ) != 0)
-                                                    {
-                                                        var exm = GetException(pEnv);
-                                                        Console.WriteLine("Error instantiating object (): " + sClass + " " + exm);
-                                                        
-                                                        throw new Exception(exm);
-                                                    }
-                                                }
-                                                else
+                                                void** ar_newInstance = stackalloc void*[1];
+                                                if(NewObjectP( pEnv, pClass, "()V", 0, ar_newInstance, &pObj ) != 0)
                                                 {
-                                                    object[] args_object = new object[args.Length];
-                                                    string argSig = "";
-                                                    for(int i = 0; i < args.Length; i++)
-                                                    {
-                                                        argSig += TransformType(args[i]);
-                                                        args_object[i] = args[i];
-                                                    }
-
-                                                    void** ar_newInstance = (void**)(new StructWrapper(pEnv, args_object)).Ptr;
+                                                    var exm = GetException(pEnv);
+                                                    Console.WriteLine("Error instantiating object (): " + sClass + " " + exm);
                                                     
-                                                    if(NewObjectP( pEnv, pClass, "(" + argSig + ")V", args.Length, ar_newInstance, &pObj ) != 0)
-                                                        throw new Exception("CreateInstancePtr / NewObjectP: " + GetException(pEnv));
+                                                    throw new Exception(exm);
                                                 }
-                                                ObjectPtr = new IntPtr(pObj);
                                             }
                                             else
-                                                ObjectPtr = objPtr;
+                                            {
+                                                object[] args_object = new object[args.Length];
+                                                string argSig = "";
+                                                for(int i = 0; i < args.Length; i++)
+                                                {
+                                                    argSig += TransformType(args[i]);
+                                                    args_object[i] = args[i];
+                                                }
+
+                                                void** ar_newInstance = (void**)(new StructWrapper(pEnv, args_object)).Ptr;
+                                                
+                                                if(NewObjectP( pEnv, pClass, "(" + argSig + ")V", args.Length, ar_newInstance, &pObj ) != 0)
+                                                    throw new Exception("CreateInstancePtr / NewObjectP: " + GetException(pEnv));
+                                            }
+                                            ObjectPtr = new IntPtr(pObj);
+                                        }
+                                        else
+                                            ObjectPtr = objPtr;
 
 
-                                            int hashID = GetJVMID(pEnv, ObjectPtr.ToPointer(), true);
+                                        int hashID = GetJVMID(pEnv, ObjectPtr.ToPointer(), true);
 
-                                            dynamic expandoObject = new JVMObject(hashID, sClass, true, "EXPANDO 3901"); //IMPORTANT TRUE
-                                            
-                                            if(isMap(pEnv, pNetBridgeClass, ObjectPtr.ToPointer()))
-                                                expandoObject = new JVMIDictionary(expandoObject);
+                                        dynamic expandoObject = new JVMObject(hashID, sClass, true, "EXPANDO 3901"); //IMPORTANT TRUE
+                                        
+                                        if(isMap(pEnv, pNetBridgeClass, ObjectPtr.ToPointer()))
+                                            expandoObject = new JVMIDictionary(expandoObject);
 
-                                            else if(isCollection(pEnv, pNetBridgeClass, ObjectPtr.ToPointer()))
-                                                expandoObject = new JVMICollection(expandoObject);
+                                        else if(isCollection(pEnv, pNetBridgeClass, ObjectPtr.ToPointer()))
+                                            expandoObject = new JVMICollection(expandoObject);
 
-                                            else if(isIterable(pEnv, pNetBridgeClass, ObjectPtr.ToPointer()))
-                                                expandoObject = new JVMIEnumerable(expandoObject);
+                                        else if(isIterable(pEnv, pNetBridgeClass, ObjectPtr.ToPointer()))
+                                            expandoObject = new JVMIEnumerable(expandoObject);
 
-                                            foreach(var signature in signatures)
+                                        foreach(var signature in signatures)
+                                        {
+                                            if(signature.StartsWith("F/") || signature.StartsWith("S-F/"))
                                             {
-                                                if(signature.StartsWith("F/") || signature.StartsWith("S-F/"))
+                                                bool isStatic = signature.StartsWith("S-");
+                                                string name = signature.Replace("F/","").Replace("S-","");
+                                                name = name.Substring(0, name.IndexOf("-"));
+                                                string returnSignature = signature.Substring(signature.LastIndexOf("-") + 1);
+
+                                                switch (returnSignature)
                                                 {
-                                                    bool isStatic = signature.StartsWith("S-");
-                                                    string name = signature.Replace("F/","").Replace("S-","");
-                                                    name = name.Substring(0, name.IndexOf("-"));
-                                                    string returnSignature = signature.Substring(signature.LastIndexOf("-") + 1);
-
-                                                    switch (returnSignature)
-                                                    {
-                                                        case "Z": //Boolean
-                                                            expandoObject.TrySetField(name, 
-                                                                new Tuple<string, object, wrapSetProperty>(
-                                                                    "bool",
-                                                                    (wrapGetProperty<bool>)(() => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                    {
-                                                                                        bool _res;
-                                                                                        if(GetStaticBooleanField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception("CreateInstancePtr / GetStaticBooleanField: " + GetException(_pEnv));
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception("CreateInstancePtr / GetStaticBooleanFieldID: " + GetException(_pEnv));
-                                                                                else
-                                                                                    throw new Exception("CreateInstancePtr / GetStaticBooleanField Class: " + GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                    case "Z": //Boolean
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "bool",
+                                                                (wrapGetProperty<bool>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
                                                                                 {
                                                                                     bool _res;
-                                                                                    if(GetBooleanField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception("CreateInstancePtr / GetBooleanField: " + GetException(_pEnv));
-                                                                                    DetacheThread((void*)JVMPtr);
+                                                                                    if(GetStaticBooleanField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw new Exception("CreateInstancePtr / GetStaticBooleanField: " + GetException(_pEnv));
                                                                                     return _res;
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception("CreateInstancePtr / GetBooleanFieldID: " + GetException(_pEnv));
+                                                                                    throw new Exception("CreateInstancePtr / GetStaticBooleanFieldID: " + GetException(_pEnv));
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetStaticBooleanField Class: " + GetException(_pEnv));
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                bool _res;
+                                                                                if(GetBooleanField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw new Exception("CreateInstancePtr / GetBooleanField: " + GetException(_pEnv));
+                                                                                return _res;
                                                                             }
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetBooleanFieldID: " + GetException(_pEnv));
                                                                         }
-                                                                        else
-                                                                            throw new Exception("CreateInstancePtr / GetBooleanField Class: " + GetException(_pEnv));
-                                                                    }),
-                                                                    (wrapSetProperty)((val) => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticBooleanField( _pEnv, _pClass, pField, (bool) val);
-                                                                                    else
-                                                                                        throw new Exception("CreateInstancePtr / SetStaticBooleanFieldID: " + GetException(_pEnv));
-                                                                                else
-                                                                                    throw new Exception("CreateInstancePtr / SetStaticBooleanField Class: " + GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetBooleanField( _pEnv, _pObj, pField, (bool) val);
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("CreateInstancePtr / GetBooleanField Class: " + GetException(_pEnv));
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticBooleanField( _pEnv, _pClass, pField, (bool) val);
                                                                                 else
-                                                                                    throw new Exception("CreateInstancePtr / SetBooleanField: " + GetException(_pEnv));
-                                                                            }
+                                                                                    throw new Exception("CreateInstancePtr / SetStaticBooleanFieldID: " + GetException(_pEnv));
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / SetStaticBooleanField Class: " + GetException(_pEnv));
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetBooleanField( _pEnv, _pObj, pField, (bool) val);
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / SetBooleanField: " + GetException(_pEnv));
                                                                         }
-                                                                        else
-                                                                            new Exception("CreateInstancePtr / SetBooleanField NULL: " + GetException(_pEnv));
-
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
-                                                        case "B": //Byte
-                                                            expandoObject.TrySetField(name, 
-                                                                new Tuple<string, object, wrapSetProperty>(
-                                                                    "byte",
-                                                                    (wrapGetProperty<byte>)(() => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                    {
-                                                                                        byte _res;
-                                                                                        if(GetStaticByteField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception("CreateInstancePtr / GetStaticByteField: " + GetException(_pEnv));
-
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception("CreateInstancePtr / GetStaticByteFieldID: " + GetException(_pEnv));
-                                                                                else
-                                                                                    throw new Exception("CreateInstancePtr / GetStaticByteField Class: " + GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                    }
+                                                                    else
+                                                                        new Exception("CreateInstancePtr / SetBooleanField NULL: " + GetException(_pEnv));
+
+                                                                })
+                                                            ));
+                                                        break;
+                                                    case "B": //Byte
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "byte",
+                                                                (wrapGetProperty<byte>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
                                                                                 {
                                                                                     byte _res;
-                                                                                    if(GetByteField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception("CreateInstancePtr / GetByteField: " + GetException(_pEnv));
+                                                                                    if(GetStaticByteField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw new Exception("CreateInstancePtr / GetStaticByteField: " + GetException(_pEnv));
 
-                                                                                    DetacheThread((void*)JVMPtr);
                                                                                     return _res;
-
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception("CreateInstancePtr / GetByteFieldID: " + GetException(_pEnv));
-                                                                            }
-                                                                        }
-                                                                        else
-                                                                            throw new Exception("CreateInstancePtr / GetByteField NULL: " + GetException(_pEnv));
-                                                                    }),
-                                                                    (wrapSetProperty)((val) => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticByteField( _pEnv, _pClass, pField, (byte) val);
-                                                                                    else
-                                                                                        throw new Exception("CreateInstancePtr / SetStaticByteFieldID: " + GetException(_pEnv));
-                                                                                else
-                                                                                    throw new Exception("CreateInstancePtr / SetStaticByteFieldID Class: " + GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetByteField( _pEnv, _pObj, pField, (byte) val);
-                                                                                else
-                                                                                    throw new Exception("CreateInstancePtr / SetByteFieldID: " + GetException(_pEnv));
-                                                                            }
-                                                                        }
-                                                                        else
-                                                                            throw new Exception("CreateInstancePtr / SetByteField NULL: " + GetException(_pEnv));
+                                                                                    throw new Exception("CreateInstancePtr / GetStaticByteFieldID: " + GetException(_pEnv));
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetStaticByteField Class: " + GetException(_pEnv));
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                byte _res;
+                                                                                if(GetByteField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw new Exception("CreateInstancePtr / GetByteField: " + GetException(_pEnv));
 
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
-                                                    
-                                                        case "C": //Char
-                                                            expandoObject.TrySetField(name, 
-                                                                new Tuple<string, object, wrapSetProperty>(
-                                                                    "char",
-                                                                    (wrapGetProperty<char>)(() => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                    {
-                                                                                        char _res;
-                                                                                        if(GetStaticCharField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception("CreateInstancePtr / GetStaticCharField: " + GetException(_pEnv));
+                                                                                return _res;
 
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception("CreateInstancePtr / GetStaticCharFieldID: " + GetException(_pEnv));
+                                                                            }
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetByteFieldID: " + GetException(_pEnv));
+                                                                        }
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("CreateInstancePtr / GetByteField NULL: " + GetException(_pEnv));
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticByteField( _pEnv, _pClass, pField, (byte) val);
                                                                                 else
-                                                                                    throw new Exception("CreateInstancePtr / GetStaticCharField Class: " + GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                    throw new Exception("CreateInstancePtr / SetStaticByteFieldID: " + GetException(_pEnv));
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / SetStaticByteFieldID Class: " + GetException(_pEnv));
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetByteField( _pEnv, _pObj, pField, (byte) val);
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / SetByteFieldID: " + GetException(_pEnv));
+                                                                        }
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("CreateInstancePtr / SetByteField NULL: " + GetException(_pEnv));
+
+                                                                })
+                                                            ));
+                                                        break;
+                                                
+                                                    case "C": //Char
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "char",
+                                                                (wrapGetProperty<char>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
                                                                                 {
                                                                                     char _res;
-                                                                                    if(GetCharField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception("CreateInstancePtr / GetCharField: " + GetException(_pEnv));
+                                                                                    if(GetStaticCharField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw new Exception("CreateInstancePtr / GetStaticCharField: " + GetException(_pEnv));
 
-                                                                                    DetacheThread((void*)JVMPtr);
                                                                                     return _res;
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception("CreateInstancePtr / GetCharFieldID: " + GetException(_pEnv));
+                                                                                    throw new Exception("CreateInstancePtr / GetStaticCharFieldID: " + GetException(_pEnv));
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetStaticCharField Class: " + GetException(_pEnv));
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                char _res;
+                                                                                if(GetCharField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw new Exception("CreateInstancePtr / GetCharField: " + GetException(_pEnv));
+
+                                                                                return _res;
                                                                             }
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetCharFieldID: " + GetException(_pEnv));
                                                                         }
-                                                                        else
-                                                                            throw new Exception("CreateInstancePtr / GetCharField NULL: " + GetException(_pEnv));
-                                                                    }),
-                                                                    (wrapSetProperty)((val) => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticCharField( _pEnv, _pClass, pField, (char) val);
-                                                                                    else
-                                                                                        throw new Exception("CreateInstancePtr / SetStaticCharFieldID : " + GetException(_pEnv));
-                                                                                else
-                                                                                    throw new Exception("CreateInstancePtr / SetStaticCharField Class: " + GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetCharField( _pEnv, _pObj, pField, (char) val);
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("CreateInstancePtr / GetCharField NULL: " + GetException(_pEnv));
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticCharField( _pEnv, _pClass, pField, (char) val);
                                                                                 else
-                                                                                    throw new Exception("CreateInstancePtr / SetStaticCharFieldID: " + GetException(_pEnv));
-                                                                            }
+                                                                                    throw new Exception("CreateInstancePtr / SetStaticCharFieldID : " + GetException(_pEnv));
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / SetStaticCharField Class: " + GetException(_pEnv));
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetCharField( _pEnv, _pObj, pField, (char) val);
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / SetStaticCharFieldID: " + GetException(_pEnv));
                                                                         }
-                                                                        else
-                                                                            throw new Exception("CreateInstancePtr / SetCharField NULL: " + GetException(_pEnv));
-
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
-                                                        
-                                                        case "S": //Short
-                                                            expandoObject.TrySetField(name, 
-                                                                new Tuple<string, object, wrapSetProperty>(
-                                                                    "short",
-                                                                    (wrapGetProperty<short>)(() => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                    {
-                                                                                        short _res;
-                                                                                        if(GetStaticShortField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception("CreateInstancePtr / GetStaticShortield: " + GetException(_pEnv));
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("CreateInstancePtr / SetCharField NULL: " + GetException(_pEnv));
 
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception("CreateInstancePtr / GetStaticShortFieldID: " + GetException(_pEnv));
-                                                                                else
-                                                                                    throw new Exception("CreateInstancePtr / GetStaticShortField Class: " + GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                })
+                                                            ));
+                                                        break;
+                                                    
+                                                    case "S": //Short
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "short",
+                                                                (wrapGetProperty<short>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
                                                                                 {
                                                                                     short _res;
-                                                                                    if(GetShortField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception("CreateInstancePtr / GetShortField: " + GetException(_pEnv));
+                                                                                    if(GetStaticShortField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw new Exception("CreateInstancePtr / GetStaticShortield: " + GetException(_pEnv));
 
-                                                                                    DetacheThread((void*)JVMPtr);
                                                                                     return _res;
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception("CreateInstancePtr / GetShortField ID: " + GetException(_pEnv));
+                                                                                    throw new Exception("CreateInstancePtr / GetStaticShortFieldID: " + GetException(_pEnv));
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetStaticShortField Class: " + GetException(_pEnv));
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                short _res;
+                                                                                if(GetShortField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw new Exception("CreateInstancePtr / GetShortField: " + GetException(_pEnv));
+
+                                                                                return _res;
                                                                             }
+                                                                            else
+                                                                                throw new Exception("CreateInstancePtr / GetShortField ID: " + GetException(_pEnv));
                                                                         }
-                                                                        else
-                                                                            throw new Exception("CreateInstancePtr / GetSShortField NULL: " + GetException(_pEnv));
-                                                                    }),
-                                                                    (wrapSetProperty)((val) => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticShortField( _pEnv, _pClass, pField, (short) val);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Static Field not found: " + name);
-                                                                                else
-                                                                                    throw new Exception("Runtime Class not found: " + name);
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetShortField( _pEnv, _pObj, pField, (short) val);
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("CreateInstancePtr / GetSShortField NULL: " + GetException(_pEnv));
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticShortField( _pEnv, _pClass, pField, (short) val);
                                                                                 else
-                                                                                    throw new Exception("Runtime Field not found: " + name);
-                                                                            }
+                                                                                    throw new Exception("Runtime Static Field not found: " + name);
+                                                                            else
+                                                                                throw new Exception("Runtime Class not found: " + name);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetShortField( _pEnv, _pObj, pField, (short) val);
+                                                                            else
+                                                                                throw new Exception("Runtime Field not found: " + name);
                                                                         }
-                                                                        else
-                                                                            throw new Exception("Runtime Object not found: " + name);
-
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
-                                                        
-                                                        case "I": //Int
-                                                            expandoObject.TrySetField(name, 
-                                                                new Tuple<string, object, wrapSetProperty>(
-                                                                    "int",
-                                                                    (wrapGetProperty<int>)(() => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                    {
-                                                                                        int _res;
-                                                                                        if(GetStaticIntField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception(GetException(_pEnv));
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
 
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception(GetException(_pEnv));
-                                                                                else
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                })
+                                                            ));
+                                                        break;
+                                                    
+                                                    case "I": //Int
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "int",
+                                                                (wrapGetProperty<int>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
                                                                                 {
                                                                                     int _res;
-                                                                                    if(GetIntField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                    if(GetStaticIntField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw GetJavaException(_pEnv);
 
-                                                                                    DetacheThread((void*)JVMPtr);
                                                                                     return _res;
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw GetJavaException(_pEnv);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                int _res;
+                                                                                if(GetIntField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw GetJavaException(_pEnv);
+
+                                                                                return _res;
                                                                             }
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
                                                                         }
-                                                                        else
-                                                                            throw new Exception("Runtime Object not found: " + name);
-                                                                    }),
-                                                                    (wrapSetProperty)((val) => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticIntField( _pEnv, _pClass, pField, (int) val);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Static Field not found: " + name);
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticIntField( _pEnv, _pClass, pField, (int) val);
                                                                                 else
-                                                                                    throw new Exception("Runtime Class not found: " + name);
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetIntField( _pEnv, _pObj, pField, (int) val);
+                                                                                    throw new Exception("Runtime Static Field not found: " + name);
+                                                                            else
+                                                                                throw new Exception("Runtime Class not found: " + name);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetIntField( _pEnv, _pObj, pField, (int) val);
+                                                                            else
+                                                                                throw new Exception("Runtime Field not found: " + name);
+                                                                        }
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
+
+                                                                })
+                                                            ));
+                                                        break;
+                                                    
+                                                    case "J": //Long
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "long",
+                                                                (wrapGetProperty<long>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                {
+                                                                                    long _res;
+                                                                                    if(GetStaticLongField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw GetJavaException(_pEnv);
+
+                                                                                    return _res;
+                                                                                }
                                                                                 else
-                                                                                    throw new Exception("Runtime Field not found: " + name);
+                                                                                    throw new Exception("Runtime Static Field not found: " + name);
+                                                                            else
+                                                                                throw new Exception("Runtime Class not found: " + name);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                long _res;
+                                                                                if(GetLongField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw GetJavaException(_pEnv);
+
+                                                                                return _res;
                                                                             }
+                                                                            else
+                                                                                throw new Exception("Runtime Field not found: " + name);
                                                                         }
-                                                                        else
-                                                                            throw new Exception("Runtime Object not found: " + name);
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticLongField( _pEnv, _pClass, pField, (long) val);
+                                                                                else
+                                                                                    throw new Exception("Runtime Static Field not found: " + name);
+                                                                            else
+                                                                                throw new Exception("Runtime Class not found: " + name);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetLongField( _pEnv, _pObj, pField, (long) val);
+                                                                            else
+                                                                                throw new Exception("Runtime Field not found: " + name);
+                                                                        }
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
 
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
-                                                        
-                                                        case "J": //Long
-                                                            expandoObject.TrySetField(name, 
-                                                                new Tuple<string, object, wrapSetProperty>(
-                                                                    "long",
-                                                                    (wrapGetProperty<long>)(() => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                    {
-                                                                                        long _res;
-                                                                                        if(GetStaticLongField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception(GetException(_pEnv));
+                                                                })
+                                                            ));
+                                                        break;
+                                                    
+                                                    case "F": //Float
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "float",
+                                                                (wrapGetProperty<float>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                {
+                                                                                    float _res;
+                                                                                    if(GetStaticFloatField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw GetJavaException(_pEnv);
 
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception("Runtime Static Field not found: " + name);
+                                                                                    return _res;
+                                                                                }
                                                                                 else
-                                                                                    throw new Exception("Runtime Class not found: " + name);
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                    throw GetJavaException(_pEnv);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                float _res;
+                                                                                if(GetFloatField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw GetJavaException(_pEnv);
+
+                                                                                return _res;
+                                                                            }
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        }
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                    
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticFloatField( _pEnv, _pClass, pField, (float) val);
+                                                                                else
+                                                                                    throw new Exception("Runtime Static Field not found: " + name);
+                                                                            else
+                                                                                throw new Exception("Runtime Class not found: " + name);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetFloatField( _pEnv, _pObj, pField, (float) val);
+                                                                            else
+                                                                                throw new Exception("Runtime Field not found: " + name);
+                                                                        }
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
+
+                                                                })
+                                                            ));
+                                                        break;
+                                                    
+                                                    case "D": //Double
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "double",
+                                                                (wrapGetProperty<double>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
                                                                                 {
-                                                                                    long _res;
-                                                                                    if(GetLongField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                    double _res;
+                                                                                    if(GetStaticDoubleField( _pEnv, _pClass, pField, &_res) != 0)
+                                                                                        throw GetJavaException(_pEnv);
 
-                                                                                    DetacheThread((void*)JVMPtr);
                                                                                     return _res;
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception("Runtime Field not found: " + name);
+                                                                                    throw GetJavaException(_pEnv);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                            {
+                                                                                double _res;
+                                                                                if(GetDoubleField( _pEnv, _pObj, pField, &_res) != 0)
+                                                                                    throw GetJavaException(_pEnv);
+
+                                                                                return _res;
                                                                             }
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
                                                                         }
-                                                                        else
-                                                                            throw new Exception("Runtime Object not found: " + name);
-                                                                    }),
-                                                                    (wrapSetProperty)((val) => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticLongField( _pEnv, _pClass, pField, (long) val);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Static Field not found: " + name);
-                                                                                else
-                                                                                    throw new Exception("Runtime Class not found: " + name);
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetLongField( _pEnv, _pObj, pField, (long) val);
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticDoubleField( _pEnv, _pClass, pField, (double) val);
                                                                                 else
-                                                                                    throw new Exception("Runtime Field not found: " + name);
-                                                                            }
+                                                                                    throw new Exception("Runtime Static Field not found: " + name);
+                                                                            else
+                                                                                throw new Exception("Runtime Class not found: " + name);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetDoubleField( _pEnv, _pObj, pField, (double) val);
+                                                                            else
+                                                                                throw new Exception("Runtime Field not found: " + name);
                                                                         }
-                                                                        else
-                                                                            throw new Exception("Runtime Object not found: " + name);
+                                                                    }
+                                                                    else
+                                                                        throw new Exception("Runtime Object not found: " + name);
 
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
-                                                        
-                                                        case "F": //Float
-                                                            expandoObject.TrySetField(name, 
-                                                                new Tuple<string, object, wrapSetProperty>(
-                                                                    "float",
-                                                                    (wrapGetProperty<float>)(() => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                })
+                                                            ));
+                                                        break;
+                                                    
+                                                    case "Ljava/lang/String;": //String
+
+                                                        expandoObject.TrySetField(name, 
+                                                            new Tuple<string, object, wrapSetProperty>(
+                                                                "string",
+                                                                (wrapGetProperty<string>)(() => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* pObjResult;
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    if(GetStaticObjectField( _pEnv, _pClass, pField, &pObjResult) == 0)
                                                                                     {
-                                                                                        float _res;
-                                                                                        if(GetStaticFloatField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception(GetException(_pEnv));
-
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
+                                                                                        string _ret = GetNetString(_pEnv, pObjResult);
+                                                                                        return _ret;
                                                                                     }
                                                                                     else
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                        throw GetJavaException(_pEnv);
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                    throw GetJavaException(_pEnv);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            void* pObjResult;
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                if(GetObjectField( _pEnv, _pObj, pField, &pObjResult) == 0)
                                                                                 {
-                                                                                    float _res;
-                                                                                    if(GetFloatField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception(GetException(_pEnv));
-
-                                                                                    DetacheThread((void*)JVMPtr);
-                                                                                    return _res;
+                                                                                    string _ret = GetNetString(_pEnv, pObjResult);
+                                                                                    return _ret;
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            }
+                                                                                    throw GetJavaException(_pEnv);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
                                                                         }
-                                                                        else
-                                                                            throw new Exception("Runtime Object not found: " + name);
-                                                                    }),
-                                                                    (wrapSetProperty)((val) => {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != IntPtr.Zero.ToPointer())
-                                                                        {
-                                                                            void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticFloatField( _pEnv, _pClass, pField, (float) val);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Static Field not found: " + name);
-                                                                                else
-                                                                                    throw new Exception("Runtime Class not found: " + name);
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetFloatField( _pEnv, _pObj, pField, (float) val);
+                                                                    }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                }),
+                                                                (wrapSetProperty)((val) => {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != IntPtr.Zero.ToPointer())
+                                                                    {
+                                                                        void* jstring = GetJavaString(_pEnv, (string)val);
+                                                                        void*  pField;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, jstring);
                                                                                 else
-                                                                                    throw new Exception("Runtime Field not found: " + name);
-                                                                            }
+                                                                                    throw GetJavaException(_pEnv);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                SetObjectField( _pEnv, _pObj, pField, jstring);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
                                                                         }
-                                                                        else
-                                                                            throw new Exception("Runtime Object not found: " + name);
+                                                                    }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
 
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
+                                                                })
+                                                            ));
+                                                        break;
+
+                                                    default:
                                                         
-                                                        case "D": //Double
+                                                        if(returnSignature.StartsWith("["))
+                                                        {
                                                             expandoObject.TrySetField(name, 
                                                                 new Tuple<string, object, wrapSetProperty>(
-                                                                    "double",
-                                                                    (wrapGetProperty<double>)(() => {
-                                                                        void*  _pEnv;
+                                                                    "array",
+                                                                    (wrapGetProperty<object[]>)(() => {
+                                                                        void*  _pEnv;// = (void*)EnvPtr;
                                                                         if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                        using var scope = new ThreadScope();
                                                                         void* _pNetBridgeClass;
                                                                         if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
+                                                                    
                                                                         void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
                                                                         if(_pObj != IntPtr.Zero.ToPointer())
                                                                         {
                                                                             void*  pField;
                                                                             if(isStatic) 
                                                                             { 
+                                                                                void* pObjResult;
                                                                                 void* _pClass = IntPtr.Zero.ToPointer();
                                                                                 if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
                                                                                     if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                    {
-                                                                                        double _res;
-                                                                                        if(GetStaticDoubleField( _pEnv, _pClass, pField, &_res) != 0)
-                                                                                            throw new Exception(GetException(_pEnv));
+                                                                                        if(GetStaticObjectField( _pEnv, _pClass, pField, &pObjResult) == 0)
+                                                                                        {
+                                                                                            void*  pNetBridgeClass;
+                                                                                            if(FindClass(_pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
 
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _res;
-                                                                                    }
+                                                                                            int _arr_len = getArrayLength(_pEnv, pObjResult); //TESTING
+                                                                                            
+                                                                                            var _ret = getJavaArray(_pEnv, pNetBridgeClass, _arr_len, pObjResult, returnSignature);
+                                                                                            return _ret;
+                                                                                        }
+                                                                                        else
+                                                                                            throw new Exception("Runtime Calling Field not error: " + name);
                                                                                     else
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                        throw new Exception("Runtime Static Field not found: " + name);
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw new Exception("Runtime Class not found: " + name);
                                                                             } 
                                                                             else  
                                                                             { 
+                                                                                void* pObjResult;
                                                                                 if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                {
-                                                                                    double _res;
-                                                                                    if(GetDoubleField( _pEnv, _pObj, pField, &_res) != 0)
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                    if(GetObjectField( _pEnv, _pObj, pField, &pObjResult) == 0)
+                                                                                    {
+                                                                                        void*  pNetBridgeClass;
+                                                                                        if(FindClass(_pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
 
-                                                                                    DetacheThread((void*)JVMPtr);
-                                                                                    return _res;
-                                                                                }
+                                                                                        int _arr_len = getArrayLength(_pEnv, pObjResult); //IMPORTANT TRUE
+                                                                                        var _ret = getJavaArray(_pEnv, pNetBridgeClass, _arr_len, pObjResult, returnSignature);
+                                                                                        
+                                                                                        return _ret;
+                                                                                    }
+                                                                                    else
+                                                                                        throw new Exception("Runtime Calling Field not error: " + name);
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw new Exception("Runtime Field not found: " + name);
                                                                             }
                                                                         }
                                                                         else
                                                                             throw new Exception("Runtime Object not found: " + name);
+
+                                                                        
                                                                     }),
                                                                     (wrapSetProperty)((val) => {
+                                                                        
+                                                                        string typename = val.GetType().ToString();
                                                                         void*  _pEnv;
                                                                         if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                        using var scope = new ThreadScope();
                                                                         void* _pNetBridgeClass;
                                                                         if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
+                                                                    
                                                                         void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
                                                                         if(_pObj != IntPtr.Zero.ToPointer())
                                                                         {
                                                                             void*  pField;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                    if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticDoubleField( _pEnv, _pClass, pField, (double) val);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Static Field not found: " + name);
-                                                                                else
-                                                                                    throw new Exception("Runtime Class not found: " + name);
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetDoubleField( _pEnv, _pObj, pField, (double) val);
-                                                                                else
-                                                                                    throw new Exception("Runtime Field not found: " + name);
+                                                                            switch(typename)
+                                                                            {
+                                                                                case "System.Boolean[]":
+                                                                                    JVMObject vobj_bool = getJavaArray(_pEnv, _pNetBridgeClass, (bool[])val);
+                                                                                    void* _vobj_bool = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_bool.JavaHashCode);
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_bool);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_bool);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
+
+                                                                                case "System.Byte[]":
+                                                                                    JVMObject vobj_byte = getJavaArray(_pEnv, _pNetBridgeClass, (byte[])val);
+                                                                                    void* _vobj_byte = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_byte.JavaHashCode);
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_byte);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_byte);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
+                                                                                    
+                                                                                case "System.Char[]":
+                                                                                    JVMObject vobj_char = getJavaArray(_pEnv, _pNetBridgeClass, (char[])val);
+                                                                                    void* _vobj_char = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_char.JavaHashCode);
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_char);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_char);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+
+                                                                                    break;
+
+                                                                                case "System.Short[]":
+                                                                                    
+                                                                                    JVMObject vobj_short = getJavaArray(_pEnv, _pNetBridgeClass, (short[])val);
+                                                                                    void* _vobj_short = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_short.JavaHashCode);
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_short);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_short);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
+
+                                                                                case "System.Int32[]":
+                                                                                    JVMObject vobj_int = getJavaArray(_pEnv, _pNetBridgeClass, (int[])val);
+                                                                                    void* _vobj_int = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_int.JavaHashCode);
+
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_int);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_int);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
+
+                                                                                case "System.Int64[]":
+                                                                                    JVMObject vobj_long = getJavaArray(_pEnv, _pNetBridgeClass, (long[])val);
+                                                                                    void* _vobj_long = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_long.JavaHashCode);
+
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_long);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_long);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
+
+                                                                                case "System.Float[]":
+                                                                                    JVMObject vobj_float = getJavaArray(_pEnv, _pNetBridgeClass, (float[])val);
+                                                                                    void* _vobj_float = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_float.JavaHashCode);
+
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_float);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_float);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
+
+
+                                                                                case "System.Double[]":
+                                                                                    JVMObject vobj_double = getJavaArray(_pEnv, _pNetBridgeClass, (double[])val);
+                                                                                    void* _vobj_double = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_double.JavaHashCode);
+
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_double);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_double);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
+
+                                                                                default:
+                                                                                    JVMObject vobj_obj = getJavaArray(_pEnv, _pNetBridgeClass, (object[])val);
+                                                                                    void* _vobj_obj = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_obj.JavaHashCode);
+                                                                                    if(isStatic) 
+                                                                                    { 
+                                                                                        void* _pClass = IntPtr.Zero.ToPointer();
+                                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                                            if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
+                                                                                                SetStaticObjectField( _pEnv, _pClass, pField, _vobj_obj);
+                                                                                            else
+                                                                                                throw new Exception("Runtime Static Field not found: " + name);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Class not found: " + name);
+
+                                                                                    } 
+                                                                                    else  
+                                                                                    { 
+                                                                                        if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
+                                                                                            SetObjectField( _pEnv, _pObj, pField, _vobj_obj);
+                                                                                        else
+                                                                                            throw new Exception("Runtime Field not found: " + name);
+                                                                                    }
+                                                                                    break;
                                                                             }
+                                                                            
                                                                         }
                                                                         else
                                                                             throw new Exception("Runtime Object not found: " + name);
-
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                    })
-                                                                ));
-                                                            break;
-                                                        
-                                                        case "Ljava/lang/String;": //String
-
+                                                                        })
+                                                            ));
+                                                        }
+                                                        else
+                                                        {
                                                             expandoObject.TrySetField(name, 
                                                                 new Tuple<string, object, wrapSetProperty>(
-                                                                    "string",
-                                                                    (wrapGetProperty<string>)(() => {
+                                                                    "object",
+                                                                    (wrapGetProperty<object>)(() => {
                                                                         void*  _pEnv;
                                                                         if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                        using var scope = new ThreadScope();
                                                                         void* _pNetBridgeClass;
                                                                         if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
+                                                                    
                                                                         void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
                                                                         if(_pObj != IntPtr.Zero.ToPointer())
                                                                         {
@@ -4258,20 +6222,38 @@ namespace QuantApp.Kernel.JVM
                                                                             { 
                                                                                 void* pObjResult;
                                                                                 void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
                                                                                     if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
                                                                                         if(GetStaticObjectField( _pEnv, _pClass, pField, &pObjResult) == 0)
                                                                                         {
-                                                                                            string _ret = GetNetString(_pEnv, pObjResult);
-                                                                                            DetacheThread((void*)JVMPtr);
-                                                                                            return _ret;
+                                                                                            IntPtr returnPtr = new IntPtr(pObjResult);
+
+                                                                                            int hashID_res = GetJVMID(_pEnv, pObjResult, true);
+
+                                                                                            if(JVMObject.DB.ContainsKey(hashID_res))
+                                                                                            {
+                                                                                                return JVMObject.DB[hashID_res].Target;
+                                                                                            }
+
+                                                                                            else if(DB.ContainsKey(hashID_res))
+                                                                                            {
+                                                                                                return (JVMObject)DB[hashID_res].Target;
+                                                                                            }
+                                                                                            else
+                                                                                            {
+                                                                                                string cls = returnSignature.StartsWith("L") && returnSignature.EndsWith(";") ? returnSignature.Substring(1).Replace(";","").Replace("/",".") : returnSignature;
+
+                                                                                                var _ret =  getObject(_pEnv, cls, pObjResult);
+                                                                                                return _ret;
+                                                                                            }
                                                                                         }
                                                                                         else
-                                                                                            throw new Exception(GetException(_pEnv));
+                                                                                            throw new Exception("Runtime Calling Field not error: " + name);
                                                                                     else
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                        throw new Exception("Runtime Static Field not found: " + name);
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw new Exception("Runtime Class not found: " + name);
+                                                                                
                                                                             } 
                                                                             else  
                                                                             { 
@@ -4279,1342 +6261,898 @@ namespace QuantApp.Kernel.JVM
                                                                                 if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
                                                                                     if(GetObjectField( _pEnv, _pObj, pField, &pObjResult) == 0)
                                                                                     {
-                                                                                        string _ret = GetNetString(_pEnv, pObjResult);
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        return _ret;
+                                                                                        Console.WriteLine("CALLING FIELD");
+                                                                                        IntPtr returnPtr = new IntPtr(pObjResult);
+
+                                                                                        int hashID_res = GetJVMID(_pEnv, pObjResult, true);
+
+                                                                                        if(JVMObject.DB.ContainsKey(hashID_res))
+                                                                                        {
+                                                                                            var _ret = JVMObject.DB[hashID_res].Target;
+                                                                                            return _ret;
+                                                                                        }
+
+                                                                                        else if(DB.ContainsKey(hashID_res))
+                                                                                        {
+                                                                                            var _ret = (JVMObject)DB[hashID_res].Target;
+                                                                                            return _ret;
+                                                                                        }
+                                                                                        else
+                                                                                        {
+                                                                                            string cls = returnSignature.StartsWith("L") && returnSignature.EndsWith(";")? returnSignature.Substring(1).Replace(";","") : returnSignature;
+                                                                                            var _ret = CreateInstancePtr(_pEnv, cls, null, returnPtr, null );
+                                                                                            return _ret;
+                                                                                        }
                                                                                     }
+
                                                                                     else
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                        throw new Exception("Runtime Calling Field not error: " + name);
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw new Exception("Runtime Field not found: " + name);
                                                                             }
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw new Exception("Runtime Object not found: " + name);
                                                                     }),
                                                                     (wrapSetProperty)((val) => {
                                                                         void*  _pEnv;
                                                                         if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                        using var scope = new ThreadScope();
                                                                         void* _pNetBridgeClass;
                                                                         if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
+                                                                    
                                                                         void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
                                                                         if(_pObj != IntPtr.Zero.ToPointer())
                                                                         {
-                                                                            void* jstring = GetJavaString(_pEnv, (string)val);
+                                                                            JVMObject vobj = (JVMObject)val;
+                                                                            void* _vobj = GetJVMObject(_pEnv, _pNetBridgeClass, vobj.JavaHashCode);
                                                                             void*  pField;
                                                                             if(isStatic) 
                                                                             { 
                                                                                 void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj, ref _pClass) == 0)
+                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
                                                                                     if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                        SetStaticObjectField( _pEnv, _pClass, pField, jstring);
+                                                                                        SetStaticObjectField( _pEnv, _pClass, pField, _vobj);
                                                                                     else
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                        throw new Exception("Runtime Static Field not found: " + name);
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw new Exception("Runtime Class not found: " + name);
                                                                             } 
                                                                             else  
                                                                             { 
                                                                                 if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                    SetObjectField( _pEnv, _pObj, pField, jstring);
+                                                                                    SetObjectField( _pEnv, _pObj, pField, _vobj);
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw new Exception("Runtime Field not found: " + name);
                                                                             }
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw new Exception("Runtime Object not found: " + name);
 
-                                                                        DetacheThread((void*)JVMPtr);
                                                                     })
                                                                 ));
-                                                            break;
-
-                                                        default:
-                                                            
-                                                            if(returnSignature.StartsWith("["))
-                                                            {
-                                                                expandoObject.TrySetField(name, 
-                                                                    new Tuple<string, object, wrapSetProperty>(
-                                                                        "array",
-                                                                        (wrapGetProperty<object[]>)(() => {
-                                                                            void*  _pEnv;// = (void*)EnvPtr;
-                                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                            void* _pNetBridgeClass;
-                                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                            if(_pObj != IntPtr.Zero.ToPointer())
-                                                                            {
-                                                                                void*  pField;
-                                                                                if(isStatic) 
-                                                                                { 
-                                                                                    void* pObjResult;
-                                                                                    void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                        if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                            if(GetStaticObjectField( _pEnv, _pClass, pField, &pObjResult) == 0)
-                                                                                            {
-                                                                                                void*  pNetBridgeClass;
-                                                                                                if(FindClass(_pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
-
-                                                                                                int _arr_len = getArrayLength(_pEnv, pObjResult); //TESTING
-                                                                                                
-                                                                                                var _ret = getJavaArray(_pEnv, pNetBridgeClass, _arr_len, pObjResult, returnSignature);
-                                                                                                DetacheThread((void*)JVMPtr);
-                                                                                                return _ret;
-                                                                                            }
-                                                                                            else
-                                                                                                throw new Exception("Runtime Calling Field not error: " + name);
-                                                                                        else
-                                                                                            throw new Exception("Runtime Static Field not found: " + name);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Class not found: " + name);
-                                                                                } 
-                                                                                else  
-                                                                                { 
-                                                                                    void* pObjResult;
-                                                                                    if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                        if(GetObjectField( _pEnv, _pObj, pField, &pObjResult) == 0)
-                                                                                        {
-                                                                                            void*  pNetBridgeClass;
-                                                                                            if(FindClass(_pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
-
-                                                                                            int _arr_len = getArrayLength(_pEnv, pObjResult); //IMPORTANT TRUE
-                                                                                            var _ret = getJavaArray(_pEnv, pNetBridgeClass, _arr_len, pObjResult, returnSignature);
-                                                                                            
-                                                                                            DetacheThread((void*)JVMPtr);
-                                                                                            return _ret;
-                                                                                        }
-                                                                                        else
-                                                                                            throw new Exception("Runtime Calling Field not error: " + name);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Field not found: " + name);
-                                                                                }
-                                                                            }
-                                                                            else
-                                                                                throw new Exception("Runtime Object not found: " + name);
-
-                                                                            
-                                                                        }),
-                                                                        (wrapSetProperty)((val) => {
-                                                                            
-                                                                            string typename = val.GetType().ToString();
-                                                                            void*  _pEnv;
-                                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                            void* _pNetBridgeClass;
-                                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                            if(_pObj != IntPtr.Zero.ToPointer())
-                                                                            {
-                                                                                void*  pField;
-                                                                                switch(typename)
-                                                                                {
-                                                                                    case "System.Boolean[]":
-                                                                                        JVMObject vobj_bool = getJavaArray(_pEnv, _pNetBridgeClass, (bool[])val);
-                                                                                        void* _vobj_bool = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_bool.JavaHashCode);
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_bool);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_bool);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-
-                                                                                    case "System.Byte[]":
-                                                                                        JVMObject vobj_byte = getJavaArray(_pEnv, _pNetBridgeClass, (byte[])val);
-                                                                                        void* _vobj_byte = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_byte.JavaHashCode);
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_byte);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_byte);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-                                                                                        
-                                                                                    case "System.Char[]":
-                                                                                        JVMObject vobj_char = getJavaArray(_pEnv, _pNetBridgeClass, (char[])val);
-                                                                                        void* _vobj_char = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_char.JavaHashCode);
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_char);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_char);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-
-                                                                                        break;
-
-                                                                                    case "System.Short[]":
-                                                                                        
-                                                                                        JVMObject vobj_short = getJavaArray(_pEnv, _pNetBridgeClass, (short[])val);
-                                                                                        void* _vobj_short = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_short.JavaHashCode);
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_short);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_short);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-
-                                                                                    case "System.Int32[]":
-                                                                                        JVMObject vobj_int = getJavaArray(_pEnv, _pNetBridgeClass, (int[])val);
-                                                                                        void* _vobj_int = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_int.JavaHashCode);
-
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_int);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_int);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-
-                                                                                    case "System.Int64[]":
-                                                                                        JVMObject vobj_long = getJavaArray(_pEnv, _pNetBridgeClass, (long[])val);
-                                                                                        void* _vobj_long = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_long.JavaHashCode);
-
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_long);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_long);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-
-                                                                                    case "System.Float[]":
-                                                                                        JVMObject vobj_float = getJavaArray(_pEnv, _pNetBridgeClass, (float[])val);
-                                                                                        void* _vobj_float = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_float.JavaHashCode);
-
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_float);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_float);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-
-
-                                                                                    case "System.Double[]":
-                                                                                        JVMObject vobj_double = getJavaArray(_pEnv, _pNetBridgeClass, (double[])val);
-                                                                                        void* _vobj_double = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_double.JavaHashCode);
-
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_double);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_double);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-
-                                                                                    default:
-                                                                                        JVMObject vobj_obj = getJavaArray(_pEnv, _pNetBridgeClass, (object[])val);
-                                                                                        void* _vobj_obj = GetJVMObject(_pEnv, _pNetBridgeClass, vobj_obj.JavaHashCode);
-                                                                                        if(isStatic) 
-                                                                                        { 
-                                                                                            void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                                if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                                    SetStaticObjectField( _pEnv, _pClass, pField, _vobj_obj);
-                                                                                                else
-                                                                                                    throw new Exception("Runtime Static Field not found: " + name);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Class not found: " + name);
-
-                                                                                        } 
-                                                                                        else  
-                                                                                        { 
-                                                                                            if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                                SetObjectField( _pEnv, _pObj, pField, _vobj_obj);
-                                                                                            else
-                                                                                                throw new Exception("Runtime Field not found: " + name);
-                                                                                        }
-                                                                                        DetacheThread((void*)JVMPtr);
-                                                                                        break;
-                                                                                }
-                                                                                
-                                                                            }
-                                                                            else
-                                                                                throw new Exception("Runtime Object not found: " + name);
-                                                                            })
-                                                                ));
-                                                            }
-                                                            else
-                                                            {
-                                                                expandoObject.TrySetField(name, 
-                                                                    new Tuple<string, object, wrapSetProperty>(
-                                                                        "object",
-                                                                        (wrapGetProperty<object>)(() => {
-                                                                            void*  _pEnv;
-                                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                            void* _pNetBridgeClass;
-                                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                            if(_pObj != IntPtr.Zero.ToPointer())
-                                                                            {
-                                                                                void*  pField;
-                                                                                if(isStatic) 
-                                                                                { 
-                                                                                    void* pObjResult;
-                                                                                    void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                        if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                            if(GetStaticObjectField( _pEnv, _pClass, pField, &pObjResult) == 0)
-                                                                                            {
-                                                                                                IntPtr returnPtr = new IntPtr(pObjResult);
-
-                                                                                                int hashID_res = GetJVMID(_pEnv, pObjResult, true);
-
-                                                                                                if(JVMObject.DB.ContainsKey(hashID_res))
-                                                                                                {
-                                                                                                    DetacheThread((void*)JVMPtr);
-                                                                                                    return JVMObject.DB[hashID_res].Target;
-                                                                                                }
-
-                                                                                                else if(DB.ContainsKey(hashID_res))
-                                                                                                {
-                                                                                                    DetacheThread((void*)JVMPtr);
-                                                                                                    return (JVMObject)DB[hashID_res].Target;
-                                                                                                }
-                                                                                                else
-                                                                                                {
-                                                                                                    string cls = returnSignature.StartsWith("L") && returnSignature.EndsWith(";") ? returnSignature.Substring(1).Replace(";","").Replace("/",".") : returnSignature;
-
-                                                                                                    var _ret =  getObject(_pEnv, cls, pObjResult);
-                                                                                                    DetacheThread((void*)JVMPtr);
-                                                                                                    return _ret;
-                                                                                                }
-                                                                                            }
-                                                                                            else
-                                                                                                throw new Exception("Runtime Calling Field not error: " + name);
-                                                                                        else
-                                                                                            throw new Exception("Runtime Static Field not found: " + name);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Class not found: " + name);
-                                                                                    
-                                                                                } 
-                                                                                else  
-                                                                                { 
-                                                                                    void* pObjResult;
-                                                                                    if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                        if(GetObjectField( _pEnv, _pObj, pField, &pObjResult) == 0)
-                                                                                        {
-                                                                                            Console.WriteLine("CALLING FIELD");
-                                                                                            IntPtr returnPtr = new IntPtr(pObjResult);
-
-                                                                                            int hashID_res = GetJVMID(_pEnv, pObjResult, true);
-
-                                                                                            if(JVMObject.DB.ContainsKey(hashID_res))
-                                                                                            {
-                                                                                                var _ret = JVMObject.DB[hashID_res].Target;
-                                                                                                DetacheThread((void*)JVMPtr);
-                                                                                                return _ret;
-                                                                                            }
-
-                                                                                            else if(DB.ContainsKey(hashID_res))
-                                                                                            {
-                                                                                                var _ret = (JVMObject)DB[hashID_res].Target;
-                                                                                                DetacheThread((void*)JVMPtr);
-                                                                                                return _ret;
-                                                                                            }
-                                                                                            else
-                                                                                            {
-                                                                                                string cls = returnSignature.StartsWith("L") && returnSignature.EndsWith(";")? returnSignature.Substring(1).Replace(";","") : returnSignature;
-                                                                                                var _ret = CreateInstancePtr(_pEnv, cls, null, returnPtr, null );
-                                                                                                DetacheThread((void*)JVMPtr);
-                                                                                                return _ret;
-                                                                                            }
-                                                                                        }
-
-                                                                                        else
-                                                                                            throw new Exception("Runtime Calling Field not error: " + name);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Field not found: " + name);
-                                                                                }
-                                                                            }
-                                                                            else
-                                                                                throw new Exception("Runtime Object not found: " + name);
-                                                                        }),
-                                                                        (wrapSetProperty)((val) => {
-                                                                            void*  _pEnv;
-                                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                            void* _pNetBridgeClass;
-                                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                        
-                                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                            if(_pObj != IntPtr.Zero.ToPointer())
-                                                                            {
-                                                                                JVMObject vobj = (JVMObject)val;
-                                                                                void* _vobj = GetJVMObject(_pEnv, _pNetBridgeClass, vobj.JavaHashCode);
-                                                                                void*  pField;
-                                                                                if(isStatic) 
-                                                                                { 
-                                                                                    void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                        if(GetStaticFieldID( _pEnv, _pClass, name, returnSignature, &pField ) == 0)
-                                                                                            SetStaticObjectField( _pEnv, _pClass, pField, _vobj);
-                                                                                        else
-                                                                                            throw new Exception("Runtime Static Field not found: " + name);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Class not found: " + name);
-                                                                                } 
-                                                                                else  
-                                                                                { 
-                                                                                    if(GetFieldID( _pEnv, _pObj, name, returnSignature, &pField ) == 0)
-                                                                                        SetObjectField( _pEnv, _pObj, pField, _vobj);
-                                                                                    else
-                                                                                        throw new Exception("Runtime Field not found: " + name);
-                                                                                }
-                                                                            }
-                                                                            else
-                                                                                throw new Exception("Runtime Object not found: " + name);
-
-                                                                            DetacheThread((void*)JVMPtr);
-                                                                        })
-                                                                    ));
-                                                            }
-                                                            break;
-                                                            
-                                                    }
-
+                                                        }
+                                                        break;
+                                                        
                                                 }
 
-                                                else if(signature.StartsWith("M/") || signature.StartsWith("S-M/"))
+                                            }
+
+                                            else if(signature.StartsWith("M/") || signature.StartsWith("S-M/"))
+                                            {
+                                                bool isStatic = signature.StartsWith("S-");
+                                                string name = signature.Replace("M/","").Replace("S-","");
+                                                name = name.Substring(0, name.IndexOf("("));
+                                                string argsSignature = signature.Substring(signature.IndexOf("(") + 1, signature.LastIndexOf(")") - 1 - signature.IndexOf("("));
+                                                string returnSignature = signature.Substring(signature.IndexOf(")") + 1);
+
+                                                string preArgsSignature = argsSignature;
+                                                argsSignature = "-" + argsSignature;
+                                                
+                                                switch (returnSignature)
                                                 {
-                                                    bool isStatic = signature.StartsWith("S-");
-                                                    string name = signature.Replace("M/","").Replace("S-","");
-                                                    name = name.Substring(0, name.IndexOf("("));
-                                                    string argsSignature = signature.Substring(signature.IndexOf("(") + 1, signature.LastIndexOf(")") - 1 - signature.IndexOf("("));
-                                                    string returnSignature = signature.Substring(signature.IndexOf(")") + 1);
-
-                                                    string preArgsSignature = argsSignature;
-                                                    argsSignature = "-" + argsSignature;
-                                                    
-                                                    switch (returnSignature)
-                                                    {
-                                                        case "Z": //Boolean                                                    
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<bool>)((call_args) => {
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                    case "Z": //Boolean                                                    
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<bool>)((call_args) => {
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
 
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                bool _res;
-                                                                                if(CallStaticBooleanMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                                
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             bool _res;
-                                                                            if(CallBooleanMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
-
-                                                                            DetacheThread((void*)JVMPtr);
+                                                                            if(CallStaticBooleanMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
+                                                                            
                                                                             return _res;
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw GetJavaException(_pEnv);
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        bool _res;
+                                                                        if(CallBooleanMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
                                                                     }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
                                                                 }
-                                                                else
-                                                                    throw new Exception(GetException(_pEnv));
-                                                            }));
-                                                            break;
-                                                        case "B": //Byte
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<byte>)((call_args) => {
-                                                                
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                byte _res;
-                                                                                if(CallStaticByteMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                            }
+                                                            else
+                                                                throw GetJavaException(_pEnv);
+                                                        }));
+                                                        break;
+                                                    case "B": //Byte
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<byte>)((call_args) => {
+                                                            
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
 
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             byte _res;
-                                                                            if(CallByteMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticByteMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
 
-                                                                            DetacheThread((void*)JVMPtr);
                                                                             return _res;
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw GetJavaException(_pEnv);
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        byte _res;
+                                                                        if(CallByteMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
                                                                     }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
                                                                 }
-                                                                else
-                                                                    throw new Exception(GetException(_pEnv));
-                                                            }));
-                                                            break;
-                                                    
-                                                        case "C": //Char
+                                                            }
+                                                            else
+                                                                throw GetJavaException(_pEnv);
+                                                        }));
+                                                        break;
+                                                
+                                                    case "C": //Char
+                                                        
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<char>)((call_args) => {
                                                             
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<char>)((call_args) => {
-                                                                
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                char _res;
-                                                                                if(CallStaticCharMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
-
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             char _res;
-                                                                            if(CallCharMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticCharMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
 
-                                                                            DetacheThread((void*)JVMPtr);
                                                                             return _res;
                                                                         }
                                                                         else
-                                                                            throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                            throw GetJavaException(_pEnv);
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        char _res;
+                                                                        if(CallCharMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
                                                                     }
+                                                                    else
+                                                                        throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
                                                                 }
-                                                                else
-                                                                    throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                            }));
-                                                            break;
+                                                            }
+                                                            else
+                                                                throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                        }));
+                                                        break;
+                                                    
+                                                    case "S": //Short
                                                         
-                                                        case "S": //Short
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<short>)((call_args) => {
+                                                            
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
                                                             
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<short>)((call_args) => {
-                                                                
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                short _res;
-                                                                                if(CallStaticShortMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
 
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             short _res;
-                                                                            if(CallShortMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticShortMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
 
-                                                                            DetacheThread((void*)JVMPtr);
                                                                             return _res;
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw GetJavaException(_pEnv);
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        short _res;
+                                                                        if(CallShortMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
                                                                     }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
                                                                 }
-                                                                else
-                                                                    throw new Exception(GetException(_pEnv));
-                                                            }));
-                                                            break;
-                                                        
-                                                        case "I": //Int
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<int>)((call_args) => {
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                int _res;
-                                                                                if(CallStaticIntMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
-
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception("Runtime Static Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                                        else
-                                                                            throw new Exception("Runtime Class not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            }
+                                                            else
+                                                                throw GetJavaException(_pEnv);
+                                                        }));
+                                                        break;
+                                                    
+                                                    case "I": //Int
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<int>)((call_args) => {
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             int _res;
-                                                                            if(CallIntMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticIntMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
 
-                                                                            DetacheThread((void*)JVMPtr);
                                                                             return _res;
                                                                         }
                                                                         else
-                                                                            throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                            throw new Exception("Runtime Static Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                    else
+                                                                        throw new Exception("Runtime Class not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        int _res;
+                                                                        if(CallIntMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
                                                                     }
+                                                                    else
+                                                                        throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
                                                                 }
-                                                                else
-                                                                    throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                            }));
-                                                            break;
+                                                            }
+                                                            else
+                                                                throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                        }));
+                                                        break;
+                                                    
+                                                    case "J": //Long
                                                         
-                                                        case "J": //Long
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<long>)((call_args) => {
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
                                                             
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<long>)((call_args) => {
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                long _res;
-                                                                                if(CallStaticLongMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
 
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             long _res;
-                                                                            if(CallLongMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticLongMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
 
-                                                                            DetacheThread((void*)JVMPtr);
                                                                             return _res;
                                                                         }
                                                                         else
-                                                                            throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                            throw GetJavaException(_pEnv);
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        long _res;
+                                                                        if(CallLongMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
                                                                     }
+                                                                    else
+                                                                        throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
                                                                 }
-                                                                else
-                                                                    throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                            }));
-                                                            break;
-                                                        
-                                                        case "F": //Float
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<float>)((call_args) => {
-                                                                
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            }
+                                                            else
+                                                                throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                        }));
+                                                        break;
+                                                    
+                                                    case "F": //Float
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<float>)((call_args) => {
+                                                            
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
 
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                float _res;
-                                                                                if(CallStaticFloatMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
 
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             float _res;
-                                                                            if(CallFloatMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticFloatMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
 
-                                                                            DetacheThread((void*)JVMPtr);
                                                                             return _res;
-
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw GetJavaException(_pEnv);
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        float _res;
+                                                                        if(CallFloatMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
+
                                                                     }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
                                                                 }
-                                                                else
-                                                                    throw new Exception(GetException(_pEnv));
-                                                            }));
-                                                            break;
+                                                            }
+                                                            else
+                                                                throw GetJavaException(_pEnv);
+                                                        }));
+                                                        break;
+                                                    
+                                                    case "D": //Double
                                                         
-                                                        case "D": //Double
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<double>)((call_args) => {
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
                                                             
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<double>)((call_args) => {
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                double _res;
-                                                                                if(CallStaticDoubleMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
-
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _res;
-                                                                            }
-                                                                            else
-                                                                                throw new Exception("Runtime Static Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                                        else
-                                                                            throw new Exception("Runtime Class not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
                                                                             double _res;
-                                                                            if(CallDoubleMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticDoubleMethod( _pEnv, _pClass, pMethod, call_len, ar_call, &_res) != 0)
+                                                                                throw GetJavaException(_pEnv);
 
-                                                                            DetacheThread((void*)JVMPtr);
                                                                             return _res;
                                                                         }
                                                                         else
-                                                                            throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                            throw new Exception("Runtime Static Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                    else
+                                                                        throw new Exception("Runtime Class not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        double _res;
+                                                                        if(CallDoubleMethod( _pEnv, _pObj, pMethod, call_len, ar_call, &_res) != 0)
+                                                                            throw GetJavaException(_pEnv);
+
+                                                                        return _res;
                                                                     }
+                                                                    else
+                                                                        throw new Exception("Runtime Method not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
                                                                 }
-                                                                else
-                                                                    throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
-                                                            }));
-                                                            break;
-                                                        
-                                                        case "V": //Void
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapAction)((call_args) => {
-                                                                
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != IntPtr.Zero.ToPointer())
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                        {
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                if(CallStaticVoidMethod( _pEnv, _pClass, pMethod, call_len, ar_call) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        }
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            }
+                                                            else
+                                                                throw new Exception("Runtime Object not found: " + name + "(" + preArgsSignature + ")" + returnSignature );
+                                                        }));
+                                                        break;
+                                                    
+                                                    case "V": //Void
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapAction)((call_args) => {
+                                                            
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != IntPtr.Zero.ToPointer())
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                    {
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
-                                                                            if(CallVoidMethod( _pEnv, _pObj, pMethod, call_len, ar_call) != 0)
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticVoidMethod( _pEnv, _pClass, pMethod, call_len, ar_call) != 0)
+                                                                                throw GetJavaException(_pEnv);
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw GetJavaException(_pEnv);
+                                                                    }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                    {
+                                                                        if(CallVoidMethod( _pEnv, _pObj, pMethod, call_len, ar_call) != 0)
+                                                                        throw GetJavaException(_pEnv);
                                                                     }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
                                                                 }
-                                                                else
-                                                                    throw new Exception(GetException(_pEnv));
+                                                            }
+                                                            else
+                                                                throw GetJavaException(_pEnv);
 
-                                                                DetacheThread((void*)JVMPtr);
-                                                            }));
-                                                            break;
+                                                        }));
+                                                        break;
+                                                    
+                                                    case "Ljava/lang/String;": //String
                                                         
-                                                        case "Ljava/lang/String;": //String
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<string>)((call_args) => {
                                                             
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<string>)((call_args) => {
-                                                                
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* pObjResult = IntPtr.Zero.ToPointer();
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                if(_pObj != pObjResult)
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            
+                                                            void* pObjResult = IntPtr.Zero.ToPointer();
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            if(_pObj != pObjResult)
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
-                                                                            if(CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
+                                                                                throw GetJavaException(_pEnv);
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    }
-
-                                                                    if(new IntPtr(pObjResult) == IntPtr.Zero)
+                                                                            throw GetJavaException(_pEnv);
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                     {
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                        return null;
+                                                                        if(CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call) != 0)
+                                                                            throw GetJavaException(_pEnv);
                                                                     }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                }
 
-                                                                    var _ret = GetNetString(_pEnv, pObjResult);
-                                                                    DetacheThread((void*)JVMPtr);
-                                                                    return _ret;
+                                                                if(new IntPtr(pObjResult) == IntPtr.Zero)
+                                                                {
+                                                                    return null;
                                                                 }
-                                                                else
-                                                                    throw new Exception(GetException(_pEnv));
-                                                            }));
-                                                            break;
 
-                                                        case "Ljava/time/LocalDateTime;": //String
-                                                            
-                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<DateTime>)((call_args) => {
+                                                                var _ret = GetNetString(_pEnv, pObjResult);
+                                                                return _ret;
+                                                            }
+                                                            else
+                                                                throw GetJavaException(_pEnv);
+                                                        }));
+                                                        break;
 
-                                                                void*  _pEnv;
-                                                                if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                void* _pNetBridgeClass;
-                                                                if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                
+                                                    case "Ljava/time/LocalDateTime;": //String
+                                                        
+                                                        expandoObject.TrySetMember(name + argsSignature, (wrapFunction<DateTime>)((call_args) => {
 
-                                                                int call_len = call_args == null ? 0 : call_args.Length;
-                                                                void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
-                                                                
-                                                                void* pObjResult = IntPtr.Zero.ToPointer();
-                                                                void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                            void*  _pEnv;
+                                                            if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                            using var scope = new ThreadScope();
+                                                            void* _pNetBridgeClass;
+                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                            
 
-                                                                if(_pObj != pObjResult)
-                                                                {
-                                                                    void* pMethod;
-                                                                    if(isStatic) 
-                                                                    { 
-                                                                        void* _pClass = IntPtr.Zero.ToPointer();
-                                                                        if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                        {
-                                                                            if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                            {
-                                                                                if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            }
-                                                                            else
-                                                                                throw new Exception(GetException(_pEnv));
-                                                                        }
-                                                                        else
-                                                                            throw new Exception(GetException(_pEnv));
-                                                                    } 
-                                                                    else  
-                                                                    { 
-                                                                        if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                            int call_len = call_args == null ? 0 : call_args.Length;
+                                                            void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                            
+                                                            void* pObjResult = IntPtr.Zero.ToPointer();
+                                                            void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+
+                                                            if(_pObj != pObjResult)
+                                                            {
+                                                                void* pMethod;
+                                                                if(isStatic) 
+                                                                { 
+                                                                    void* _pClass = IntPtr.Zero.ToPointer();
+                                                                    if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                    {
+                                                                        if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                         {
-                                                                            if(CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call) != 0)
-                                                                                throw new Exception(GetException(_pEnv));
+                                                                            if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
+                                                                                throw GetJavaException(_pEnv);
                                                                         }
                                                                         else
-                                                                            throw new Exception(GetException(_pEnv));
+                                                                            throw GetJavaException(_pEnv);
                                                                     }
-
-                                                                    if(new IntPtr(pObjResult) == IntPtr.Zero)
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                } 
+                                                                else  
+                                                                { 
+                                                                    if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                     {
-                                                                        DetacheThread((void*)JVMPtr);
-                                                                        return DateTime.MinValue;
+                                                                        if(CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call) != 0)
+                                                                            throw GetJavaException(_pEnv);
                                                                     }
+                                                                    else
+                                                                        throw GetJavaException(_pEnv);
+                                                                }
 
-                                                                    var _ret = GetNetDateTime(_pEnv, pObjResult);
-                                                                    DetacheThread((void*)JVMPtr);
-                                                                    return _ret;
+                                                                if(new IntPtr(pObjResult) == IntPtr.Zero)
+                                                                {
+                                                                    return DateTime.MinValue;
                                                                 }
-                                                                else
-                                                                    throw new Exception(GetException(_pEnv));
-                                                            }));
-                                                            break;
 
-                                                        default:
-                                                            
-                                                            if(returnSignature.StartsWith("["))
-                                                            {
-                                                                expandoObject.TrySetMember(name + argsSignature, (wrapFunction<object[]>)((call_args)  => {
-                                                                    try
-                                                                    {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                    
+                                                                var _ret = GetNetDateTime(_pEnv, pObjResult);
+                                                                return _ret;
+                                                            }
+                                                            else
+                                                                throw GetJavaException(_pEnv);
+                                                        }));
+                                                        break;
 
-                                                                        int call_len = call_args == null ? 0 : call_args.Length;
-                                                                        void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                    default:
+                                                        
+                                                        if(returnSignature.StartsWith("["))
+                                                        {
+                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<object[]>)((call_args)  => {
+                                                                try
+                                                                {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                
 
+                                                                    int call_len = call_args == null ? 0 : call_args.Length;
+                                                                    void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
 
-                                                                        void* pObjResult = IntPtr.Zero.ToPointer();
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != pObjResult)
-                                                                        {
-                                                                            void* pMethod;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
-                                                                                {
-                                                                                    if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                                    {
-                                                                                        if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
-                                                                                            throw new Exception(GetException(_pEnv));
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception(GetException(_pEnv));
-                                                                                }
-                                                                                else
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+
+                                                                    void* pObjResult = IntPtr.Zero.ToPointer();
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != pObjResult)
+                                                                    {
+                                                                        void* pMethod;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                            {
+                                                                                if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                                 {
-                                                                                    if(CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call) != 0)
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                    if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
+                                                                                        throw GetJavaException(_pEnv);
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
+                                                                                    throw GetJavaException(_pEnv);
                                                                             }
-
-                                                                            IntPtr ptr = new IntPtr(pObjResult);
-
-                                                                            if(ptr == IntPtr.Zero)
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                             {
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return null;
+                                                                                if(CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call) != 0)
+                                                                                    throw GetJavaException(_pEnv);
                                                                             }
-                                                                        
-                                                                            void*  pNetBridgeClass;
-                                                                            if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
-
-                                                                            int _arr_len = getArrayLength(_pEnv, pObjResult);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        }
 
-                                                                            var _ret = getJavaArray(_pEnv, pNetBridgeClass, _arr_len, pObjResult, returnSignature);
-                                                                            DetacheThread((void*)JVMPtr);
+                                                                        IntPtr ptr = new IntPtr(pObjResult);
 
-                                                                            return _ret;
-                                                                        }
-                                                                        else
+                                                                        if(ptr == IntPtr.Zero)
                                                                         {
-                                                                            Console.WriteLine("CLR ARRAY: _pObj != pObjResult");
                                                                             return null;
                                                                         }
+                                                                    
+                                                                        void*  pNetBridgeClass;
+                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &pNetBridgeClass) != 0) throw new Exception ("getJavaArray Find class error");
+
+                                                                        int _arr_len = getArrayLength(_pEnv, pObjResult);
+
+                                                                        var _ret = getJavaArray(_pEnv, pNetBridgeClass, _arr_len, pObjResult, returnSignature);
+
+                                                                        return _ret;
                                                                     }
-                                                                    catch(Exception e)
+                                                                    else
                                                                     {
-                                                                        Console.WriteLine("CLR inner array invoke: " + e);
+                                                                        Console.WriteLine("CLR ARRAY: _pObj != pObjResult");
                                                                         return null;
                                                                     }
-                                                                }));
-                                                            }
-                                                            else
-                                                            {
-                                                                expandoObject.TrySetMember(name + argsSignature, (wrapFunction<object>)((call_args)  => {
-                                                                    try
-                                                                    {
-                                                                        void*  _pEnv;
-                                                                        if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
-                                                                        void* _pNetBridgeClass;
-                                                                        if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
-                                                                    
+                                                                }
+                                                                catch(Exception e)
+                                                                {
+                                                                    Console.WriteLine("CLR inner array invoke: " + e);
+                                                                    return null;
+                                                                }
+                                                            }));
+                                                        }
+                                                        else
+                                                        {
+                                                            expandoObject.TrySetMember(name + argsSignature, (wrapFunction<object>)((call_args)  => {
+                                                                try
+                                                                {
+                                                                    void*  _pEnv;
+                                                                    if(AttacheThread((void*)JVMPtr,&_pEnv) != 0) throw new Exception ("Attach to thread error");
+                                                                    using var scope = new ThreadScope();
+                                                                    void* _pNetBridgeClass;
+                                                                    if(FindClass( _pEnv, "app/quant/clr/CLRRuntime", &_pNetBridgeClass) != 0 ) throw new Exception ("Find Class");
+                                                                
 
-                                                                        int call_len = call_args == null ? 0 : call_args.Length;
-                                                                        
-                                                                        void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
+                                                                    int call_len = call_args == null ? 0 : call_args.Length;
+                                                                    
+                                                                    void** ar_call = (void**)(new StructWrapper(_pEnv, call_args)).Ptr;
 
-                                                                        void* pObjResult = IntPtr.Zero.ToPointer();
-                                                                        void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
-                                                                        if(_pObj != pObjResult)
-                                                                        {
-                                                                            void* pMethod;
-                                                                            if(isStatic) 
-                                                                            { 
-                                                                                void* _pClass = IntPtr.Zero.ToPointer();
-                                                                                if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                    void* pObjResult = IntPtr.Zero.ToPointer();
+                                                                    void* _pObj = GetJVMObject(_pEnv, _pNetBridgeClass, hashID);
+                                                                    if(_pObj != pObjResult)
+                                                                    {
+                                                                        void* pMethod;
+                                                                        if(isStatic) 
+                                                                        { 
+                                                                            void* _pClass = IntPtr.Zero.ToPointer();
+                                                                            if(getClass(_pEnv, _pObj,  ref _pClass) == 0)
+                                                                            {
+                                                                                if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
                                                                                 {
-                                                                                    if(GetStaticMethodID( _pEnv, _pClass, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                                    {
-                                                                                        if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
-                                                                                            throw new Exception(GetException(_pEnv));
-                                                                                    }
-                                                                                    else
-                                                                                        throw new Exception(GetException(_pEnv));
+                                                                                    if(CallStaticObjectMethod( _pEnv, _pClass, pMethod, &pObjResult, call_len, ar_call) != 0)
+                                                                                        throw GetJavaException(_pEnv);
                                                                                 }
                                                                                 else
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            } 
-                                                                            else  
-                                                                            { 
-                                                                                if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
-                                                                                    CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call);
-                                                                                else
-                                                                                    throw new Exception(GetException(_pEnv));
-                                                                            }
-                                                                            
-                                                                            IntPtr returnPtr = new IntPtr(pObjResult);
-
-                                                                            if(returnPtr == IntPtr.Zero)
-                                                                            {
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return null;
+                                                                                    throw GetJavaException(_pEnv);
                                                                             }
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        } 
+                                                                        else  
+                                                                        { 
+                                                                            if(GetMethodID( _pEnv, _pObj, name, "(" + preArgsSignature + ")" + returnSignature, &pMethod ) == 0)
+                                                                                CallObjectMethod( _pEnv, _pObj, pMethod, &pObjResult, call_len, ar_call);
+                                                                            else
+                                                                                throw GetJavaException(_pEnv);
+                                                                        }
+                                                                        
+                                                                        IntPtr returnPtr = new IntPtr(pObjResult);
 
-                                                                            int hashID_res = GetJVMID(_pEnv, pObjResult, true);
+                                                                        if(returnPtr == IntPtr.Zero)
+                                                                        {
+                                                                            return null;
+                                                                        }
 
-                                                                            
-                                                                            if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive)
-                                                                            {
-                                                                                var _ret = JVMDelegate.DB[hashID_res].Target;
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _ret;
-                                                                            }
+                                                                        int hashID_res = GetJVMID(_pEnv, pObjResult, true);
 
+                                                                        
+                                                                        if(JVMDelegate.DB.ContainsKey(hashID_res) && JVMDelegate.DB[hashID_res].IsAlive)
+                                                                        {
+                                                                            var _ret = JVMDelegate.DB[hashID_res].Target;
+                                                                            return _ret;
+                                                                        }
 
-                                                                            else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive)
-                                                                            {
-                                                                                var _ret = Runtime.DB[hashID_res].Target;
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _ret;
-                                                                            }
 
-                                                                            
-                                                                            else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive)
-                                                                            {
-                                                                                if(JVMObject.DB[hashID_res].Target is JVMTuple)
-                                                                                {
-                                                                                    JVMTuple jobj = JVMObject.DB[hashID_res].Target as JVMTuple;
-                                                                                    DetacheThread((void*)JVMPtr);
-                                                                                    return jobj.jVMTuple;
-                                                                                }
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return JVMObject.DB[hashID_res].Target;
-                                                                            }
+                                                                        else if(Runtime.DB.ContainsKey(hashID_res) && Runtime.DB[hashID_res].IsAlive)
+                                                                        {
+                                                                            var _ret = Runtime.DB[hashID_res].Target;
+                                                                            return _ret;
+                                                                        }
 
-                                                                            else
+                                                                        
+                                                                        else if(JVMObject.DB.ContainsKey(hashID_res) && JVMObject.DB[hashID_res].IsAlive)
+                                                                        {
+                                                                            if(JVMObject.DB[hashID_res].Target is JVMTuple)
                                                                             {
-                                                                                string cls = returnSignature.StartsWith("L") && returnSignature.EndsWith(";") ? returnSignature.Substring(1).Replace(";","").Replace("/",".") : returnSignature;
-
-                                                                                var _ret = getObject(_pEnv, cls, pObjResult);
-                                                                                DetacheThread((void*)JVMPtr);
-                                                                                return _ret;
+                                                                                JVMTuple jobj = JVMObject.DB[hashID_res].Target as JVMTuple;
+                                                                                return jobj.jVMTuple;
                                                                             }
+                                                                            return JVMObject.DB[hashID_res].Target;
                                                                         }
+
                                                                         else
                                                                         {
-                                                                            Console.WriteLine("CLR Object: _pObj != pObjResult");
-                                                                            return null;
+                                                                            string cls = returnSignature.StartsWith("L") && returnSignature.EndsWith(";") ? returnSignature.Substring(1).Replace(";","").Replace("/",".") : returnSignature;
+
+                                                                            var _ret = getObject(_pEnv, cls, pObjResult);
+                                                                            return _ret;
                                                                         }
                                                                     }
-                                                                    catch(Exception e)
+                                                                    else
                                                                     {
-                                                                        Console.WriteLine("CLR inner invoke: " + e);
+                                                                        Console.WriteLine("CLR Object: _pObj != pObjResult");
                                                                         return null;
                                                                     }
-                                                                }));
-                                                            }
+                                                                }
+                                                                catch(Exception e)
+                                                                {
+                                                                    Console.WriteLine("CLR inner invoke: " + e);
+                                                                    return null;
+                                                                }
+                                                            }));
+                                                        }
 
-                                                            break;
-                                                    }
-                                                
+                                                        break;
                                                 }
+                                            
                                             }
+                                        }
 
-                                            ((object)expandoObject).RegisterGCEvent(hashID, delegate(object _obj, int _id)
-                                            {
-                                                Runtime.RemoveID(_id);
-                                            });
+                                        ((object)expandoObject).RegisterGCEvent(hashID, delegate(object _obj, int _id)
+                                        {
+                                            Runtime.RemoveID(_id);
+                                        });
 
-                                            return expandoObject;
-                                        }
-                                        else
-                                            throw new Exception(GetException(pEnv));
+                                        return expandoObject;
                                     }
                                     else
-                                        throw new Exception(GetException(pEnv));
+                                        throw GetJavaException(pEnv);
                                 }
-                                else 
-                                    throw new Exception(GetException(pEnv));
+                                else
+                                    throw GetJavaException(pEnv);
                             }
                             else 
-                                throw new Exception(GetException(pEnv));
+                                throw GetJavaException(pEnv);
                         }
                         else 
-                            throw new Exception(GetException(pEnv));
+                            throw GetJavaException(pEnv);
                     }
                     else 
-                        throw new Exception("JVM Engine not loaded");
-                }
-                catch(Exception e)
-                {
-                    Console.WriteLine("CreateInstancePtr: " + e);
-                    Console.WriteLine(e.StackTrace);
-                    return null;
+                        throw GetJavaException(pEnv);
                 }
+                else 
+                    throw new Exception("JVM Engine not loaded");
+            }
+            catch(Exception e)
+            {
+                Console.WriteLine("CreateInstancePtr: " + e);
+                Console.WriteLine(e.StackTrace);
+                return null;
             }
         }
     }
@@ -5630,17 +7168,9 @@ namespace QuantApp.Kernel.JVM
 
         public static void RegisterGCEvent(this object obj, int id, Action<object, int> action)
         {
-            CallbackRef callbackRef;
-            bool found = _table.TryGetValue(obj, out callbackRef);
-            if (found)
-            {
-                callbackRef.Collected += action;
-                return;
-            }
-
-            callbackRef = new CallbackRef(obj, id);
+            // GetValue is atomic, a CallbackRef created by a losing thread has no handlers and finalizes silently.
+            CallbackRef callbackRef = _table.GetValue(obj, _obj => new CallbackRef(_obj, id));
             callbackRef.Collected += action;
-            _table.Add(obj, callbackRef);
         }
 
         public static void DeregisterGCEvent(this object obj, int id, Action<object, int> action)
@@ -5714,7 +7244,6 @@ namespace QuantApp.Kernel.JVM
     class StructWrapper : IDisposable 
     {
         public IntPtr Ptr { get; private set; }
-        private readonly static object objLock_InvokeFunc = new object();
 
         public unsafe StructWrapper(void* pEnv, object[] obj) 
         {
@@ -5896,10 +7425,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
 
                         else if(arg is System.Func<Object, Object>)
@@ -5921,10 +7450,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object>)
                         {
@@ -5945,10 +7474,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object>)
                         {
@@ -5969,10 +7498,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object>)
                         {
@@ -5993,10 +7522,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object>)
                         {
@@ -6017,10 +7546,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6041,10 +7570,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6065,10 +7594,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6089,10 +7618,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6113,10 +7642,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6137,10 +7666,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6161,10 +7690,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6185,10 +7714,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6209,10 +7738,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6233,10 +7762,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
                         else if(arg is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                         {
@@ -6259,10 +7788,10 @@ namespace QuantApp.Kernel.JVM
                                         Runtime.DB[argID] = new WeakReference(arg);
                                 }
                                 else
-                                    throw new Exception(Runtime.GetException(pEnv));
+                                    throw Runtime.GetJavaException(pEnv);
                             }
                             else
-                                throw new Exception(Runtime.GetException(pEnv));
+                                throw Runtime.GetJavaException(pEnv);
                         }
 
                         else
@@ -6295,7 +7824,6 @@ namespace QuantApp.Kernel.JVM
             }
         }
 
-        private readonly object objLock_getJavaArray_1 = new object();
         private unsafe JVMObject getJavaArray(void* pEnv, void* pNetBridgeClass, object[] array)
         {
             if(true)
@@ -6303,6 +7831,8 @@ namespace QuantApp.Kernel.JVM
                 Array sub = array as Array;
 
                 object lastObject = null;
+                object[] values = new object[sub.Length];
+                int idx = 0;
 
                 string cls = "";
                 foreach(var o_s in sub)
@@ -6337,6 +7867,7 @@ namespace QuantApp.Kernel.JVM
                     }
 
                     object o = res;
+                    values[idx++] = o;
 
                     string ocls = o is JVMObject ? ((JVMObject)o).JavaClass : Runtime.TransformType(o);
 
@@ -6356,43 +7887,35 @@ namespace QuantApp.Kernel.JVM
                 switch(cls)
                 {
                     case "Z":
-                        if(Runtime.NewBooleanArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaBooleanArray(pEnv, Array.ConvertAll(values, x => (bool)x));
                         break;
 
                     case "B":
-                        if(Runtime.NewByteArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaByteArray(pEnv, Array.ConvertAll(values, x => (byte)x));
                         break;
 
                     case "C":
-                        if(Runtime.NewCharArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaCharArray(pEnv, Array.ConvertAll(values, x => (char)x));
                         break;
 
                     case "S":
-                        if(Runtime.NewShortArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaShortArray(pEnv, Array.ConvertAll(values, x => (short)x));
                         break;
 
                     case "I":
-                        if(Runtime.NewIntArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaIntArray(pEnv, Array.ConvertAll(values, x => (int)x));
                         break;
 
                     case "J":
-                        if(Runtime.NewLongArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaLongArray(pEnv, Array.ConvertAll(values, x => (long)x));
                         break;
 
                     case "F":
-                        if(Runtime.NewFloatArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaFloatArray(pEnv, Array.ConvertAll(values, x => (float)x));
                         break;
 
                     case "D":
-                        if(Runtime.NewDoubleArray( pEnv, arrLength, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                        pJArray = Runtime.GetJavaDoubleArray(pEnv, Array.ConvertAll(values, x => (double)x));
                         break;
 
                     default:
@@ -6406,13 +7929,14 @@ namespace QuantApp.Kernel.JVM
 
 
                         if(Runtime.NewObjectArray( pEnv, arrLength, cls, &pJArray ) != 0)
-                            throw new Exception(Runtime.GetException(pEnv));
+                            throw Runtime.GetJavaException(pEnv);
                         break;
                 }
 
-                
-                for(int ii = 0; ii < arrLength; ii++)
+
+                for(int ii = 0; isObject && ii < arrLength; ii++)
                 {
+                    using var frame = new JVMLocalFrame(pEnv, 16);
                     var sub_element = sub.GetValue(ii);
                     if(sub_element == null)
                         Runtime.SetObjectArrayElement(pEnv, pJArray, ii, IntPtr.Zero.ToPointer());
@@ -6460,7 +7984,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjBool;
                                     if(Runtime.NewBooleanObject(pEnv, (bool)sub_element, &pObjBool) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjBool);
                                 }
 
@@ -6473,7 +7997,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjB;
                                     if(Runtime.NewByteObject(pEnv, (byte)sub_element, &pObjB) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjB);
                                 }
                                 break;
@@ -6485,7 +8009,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjC;
                                     if(Runtime.NewCharacterObject(pEnv, (char)sub_element, &pObjC) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjC);
                                 }
                                 break;
@@ -6497,7 +8021,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjS;
                                     if(Runtime.NewShortObject(pEnv, (short)sub_element, &pObjS) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjS);
                                 }
                                 break;
@@ -6509,7 +8033,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjI;
                                     if(Runtime.NewIntegerObject(pEnv, (int)sub_element, &pObjI) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjI);
                                 }
                                 break;
@@ -6521,7 +8045,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjL;
                                     if(Runtime.NewLongObject(pEnv, (long)sub_element, &pObjL) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjL);
                                 }
                                 break;
@@ -6533,7 +8057,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjF;
                                     if(Runtime.NewFloatObject(pEnv, (float)sub_element, &pObjF) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjF);
                                 }
                                 break;
@@ -6545,7 +8069,7 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void* pObjD;
                                     if(Runtime.NewDoubleObject(pEnv, (double)sub_element, &pObjD) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pObjD);
                                 }
                                 break;
@@ -6575,14 +8099,14 @@ namespace QuantApp.Kernel.JVM
                                 {
                                     void*  pGetCLRObjectMethod;
                                     if(Runtime.GetStaticMethodID( pEnv, pNetBridgeClass, "GetCLRObject", "(I)Lapp/quant/clr/CLRObject;", &pGetCLRObjectMethod ) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
 
                                     object[] pAr_len_data = new object[]{ subID };
                                     void** pAr_len = (void**)(new StructWrapper(pEnv, pAr_len_data)).Ptr;
 
                                     void*  pGetCLRObject;
                                     if(Runtime.CallStaticObjectMethod( pEnv, pNetBridgeClass, pGetCLRObjectMethod, &pGetCLRObject, 1, pAr_len) != 0)
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
 
                                     Runtime.SetObjectArrayElement(pEnv, pJArray, ii, pGetCLRObject);
                                     Runtime.RegisterJVMObject(pEnv, subID, pGetCLRObject);
@@ -6643,10 +8167,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
 
                                 
@@ -6670,10 +8194,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
 
                                 else if(res is System.Func<Object, Object>)
@@ -6695,10 +8219,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object>)
                                 {
@@ -6719,10 +8243,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object>)
                                 {
@@ -6743,10 +8267,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object>)
                                 {
@@ -6767,10 +8291,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6791,10 +8315,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6815,10 +8339,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6840,10 +8364,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6864,10 +8388,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6888,10 +8412,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6912,10 +8436,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6936,10 +8460,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6960,10 +8484,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -6984,10 +8508,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -7008,10 +8532,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 else if(res is System.Func<Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object, Object>)
                                 {
@@ -7032,10 +8556,10 @@ namespace QuantApp.Kernel.JVM
                                             Runtime.RegisterJVMObject(pEnv, subID, pObj);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
 
                                 else
@@ -7056,10 +8580,10 @@ namespace QuantApp.Kernel.JVM
                                                 Runtime.DB[subID] = new WeakReference(sub_element);
                                         }
                                         else
-                                            throw new Exception(Runtime.GetException(pEnv));
+                                            throw Runtime.GetJavaException(pEnv);
                                     }
                                     else
-                                        throw new Exception(Runtime.GetException(pEnv));
+                                        throw Runtime.GetJavaException(pEnv);
                                 }
                                 break;
                         }                            
@@ -7075,7 +8599,7 @@ namespace QuantApp.Kernel.JVM
             
             }
             else
-                throw new Exception(Runtime.GetException(pEnv));
+                throw Runtime.GetJavaException(pEnv);
         }
 
         private unsafe JVMObject getJavaArray(void* pEnv, void* pNetBridgeClass, IEnumerable<object> array)
@@ -7092,6 +8616,25 @@ namespace QuantApp.Kernel.JVM
 
         private unsafe JVMObject getJavaArray(void* pEnv, void* pNetBridgeClass, Array array)
         {
+            void* pJArray = null;
+            string cls = null;
+            if(array is double[]) { pJArray = Runtime.GetJavaDoubleArray(pEnv, (double[])array); cls = "D"; }
+            else if(array is int[]) { pJArray = Runtime.GetJavaIntArray(pEnv, (int[])array); cls = "I"; }
+            else if(array is long[]) { pJArray = Runtime.GetJavaLongArray(pEnv, (long[])array); cls = "J"; }
+            else if(array is float[]) { pJArray = Runtime.GetJavaFloatArray(pEnv, (float[])array); cls = "F"; }
+            else if(array is bool[]) { pJArray = Runtime.GetJavaBooleanArray(pEnv, (bool[])array); cls = "Z"; }
+            else if(array is byte[]) { pJArray = Runtime.GetJavaByteArray(pEnv, (byte[])array); cls = "B"; }
+            else if(array is short[]) { pJArray = Runtime.GetJavaShortArray(pEnv, (short[])array); cls = "S"; }
+            else if(array is char[]) { pJArray = Runtime.GetJavaCharArray(pEnv, (char[])array); cls = "C"; }
+            else if((pJArray = Runtime.GetJavaMatrix(pEnv, array, out string sType)) != null) cls = "[" + sType;
+
+            if(cls != null)
+            {
+                int hashID = Runtime.GetJVMID(pEnv, pJArray, false);
+                Runtime.RegisterJVMObject(pEnv, hashID, pJArray);
+                return new JVMObject(hashID, cls, false, "getJavaArray primitive");
+            }
+
             int arrLength = array.Length;
             object[] res = new object[arrLength];
 
@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+package app.quant.clr;
+
+import java.lang.ref.PhantomReference;
+import java.lang.ref.ReferenceQueue;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+
+/*
+    Direct buffers created by the native bridge over .NET or native memory.
+    Once a buffer, and every view sliced from it, is unreachable the memory is handed back
+    to the bridge through nativeReleaseBuffer.
+*/
+public class CLRBuffer extends PhantomReference<ByteBuffer>
+{
+    private static final ReferenceQueue<ByteBuffer> queue = new ReferenceQueue<ByteBuffer>();
+    private static final Set<CLRBuffer> live = ConcurrentHashMap.newKeySet();
+
+    static
+    {
+        Thread thread = new Thread("CLRBuffer release") {
+            public void run() {
+                while(true)
+                {
+                    try
+                    {
+                        CLRBuffer ref = (CLRBuffer)queue.remove();
+                        live.remove(ref);
+                        CLRRuntime.nativeReleaseBuffer(ref.token);
+                    }
+                    catch(InterruptedException e)
+                    {
+                        return;
+                    }
+                    catch(Exception e){}
+                }
+            }
+        };
+        thread.setDaemon(true);
+        thread.start();
+    }
+
+    private final long token;
+
+    private CLRBuffer(ByteBuffer buffer, long token)
+    {
+        super(buffer, queue);
+        this.token = token;
+    }
+
+    public static ByteBuffer Track(ByteBuffer buffer, long token)
+    {
+        live.add(new CLRBuffer(buffer, token));
+        return buffer.order(ByteOrder.nativeOrder());
+    }
+}
@@ -26,6 +26,7 @@ public class CLRObject
         this.Pointer = ptr;
         this.ClassName = classname;
         DB.put(ptr, new WeakReference(this));
+        CallbackRef.Track(this, ptr);
     }
 
     public CLRObject(String classname, int ptr)
@@ -35,64 +36,116 @@ public class CLRObject
         __DB.put(ptr, this);
         __cache = true;
         DB.put(ptr, new WeakReference(this));
+        CallbackRef.Track(this, ptr);
     }
 
-    public synchronized Object Invoke(String funcname, Object... args)
+    // Calls from different Java threads run concurrently. .NET types that are not thread safe opt in to serialized
+    // calls with the JVMSerialized attribute.
+    public Object Invoke(String funcname, Object... args)
     {
         return CLRRuntime.Invoke(Pointer, funcname, args);
     }
 
-    public synchronized Object InvokeArr(String funcname, Object[] args)
+    public Object InvokeArr(String funcname, Object[] args)
     {
         return CLRRuntime.Invoke(Pointer, funcname, args);
     }
 
-    public synchronized Object GetProperty(String name)
+    public Object GetProperty(String name)
     {
         return CLRRuntime.GetProperty(Pointer, name);
     }
 
-    public synchronized void SetProperty(String name, Object value)
+    public void SetProperty(String name, Object value)
     {
         CLRRuntime.SetProperty(Pointer, name, value);
     }
 
-    @Override
-    public int hashCode() 
+    /*
+    Typed calls for numeric .NET methods. The method is bound once per name and shape and the primitives are
+    passed through without boxing, so a tight loop of calls does not allocate.
+    */
+    private static final int SHAPE_V = 0, SHAPE_DV = 1, SHAPE_DDV = 2, SHAPE_DD = 3, SHAPE_DDD = 4, SHAPE_JJ = 5, SHAPE_II = 6, SHAPE_ARRDD = 7;
+    private static final String[] SHAPES = { "()V", "(D)V", "(DD)V", "(D)D", "(DD)D", "(J)J", "(I)I", "([D)D" };
+
+    @SuppressWarnings("unchecked")
+    private final ConcurrentHashMap<String, Integer>[] bound = new ConcurrentHashMap[SHAPES.length];
+
+    private int bind(String funcname, int shape)
     {
-		return Pointer;
+        ConcurrentHashMap<String, Integer> methods = bound[shape];
+        if(methods == null)
+        {
+            synchronized(bound)
+            {
+                if(bound[shape] == null)
+                    bound[shape] = new ConcurrentHashMap<String, Integer>();
+                methods = bound[shape];
+            }
+        }
+
+        Integer token = methods.get(funcname);
+        if(token == null)
+        {
+            int _token = CLRRuntime.nativeBindMethod(Pointer, funcname, SHAPES[shape]);
+            if(_token < 0)
+                throw new RuntimeException("CLRObject: " + ClassName + "." + funcname + SHAPES[shape] + " not found");
+            token = _token;
+            methods.put(funcname, token);
+        }
+        return token;
     }
 
-    @Override
-    public String toString() 
+    public void InvokeVoid(String funcname)
     {
-		return "CLRObject: " + ClassName;
+        CLRRuntime.nativeCallV(bind(funcname, SHAPE_V));
     }
-    
-    @Override
-    protected void finalize() throws Throwable 
+
+    public void InvokeVoid(String funcname, double a)
     {
-        if(__DB.containsKey(Pointer))
-            __DB.remove(Pointer);
+        CLRRuntime.nativeCallDV(bind(funcname, SHAPE_DV), a);
+    }
 
-        if(DB.containsKey(Pointer))
-            DB.remove(Pointer);
+    public void InvokeVoid(String funcname, double a, double b)
+    {
+        CLRRuntime.nativeCallDDV(bind(funcname, SHAPE_DDV), a, b);
+    }
 
-        if(CLRRuntime._DBID.containsKey(Pointer))
-        {
-            CLRRuntime._DBID.remove(Pointer);
-        }
-        if(CLRRuntime._SDBID.containsKey(Pointer))
-        {
-            CLRRuntime._SDBID.remove(Pointer); 
-        }
+    public double InvokeDouble(String funcname, double a)
+    {
+        return CLRRuntime.nativeCallDD(bind(funcname, SHAPE_DD), a);
+    }
 
-        System.out.println("JAVA FINALISE 2(" + Pointer + "): " + this + " " + CLRRuntime.__DB.size() + " <-> " + CLRRuntime.DB.size() + " " + CLRRuntime._DBID.size() + " " + CLRRuntime._SDBID.size());
+    public double InvokeDouble(String funcname, double a, double b)
+    {
+        return CLRRuntime.nativeCallDDD(bind(funcname, SHAPE_DDD), a, b);
+    }
 
+    // The .NET method may take a ReadOnlySpan<double>, which reads the array in place, or a double[], which gets a copy.
+    public double InvokeDouble(String funcname, double[] a)
+    {
+        return CLRRuntime.nativeCallArrDD(bind(funcname, SHAPE_ARRDD), a);
+    }
 
-            
-        CLRRuntime.nativeRemoveObject(Pointer);
-        super.finalize();
+    public long InvokeLong(String funcname, long a)
+    {
+        return CLRRuntime.nativeCallJJ(bind(funcname, SHAPE_JJ), a);
     }
 
+    public int InvokeInt(String funcname, int a)
+    {
+        return CLRRuntime.nativeCallII(bind(funcname, SHAPE_II), a);
+    }
+
+    @Override
+    public int hashCode() 
+    {
+		return Pointer;
+    }
+
+    @Override
+    public String toString() 
+    {
+		return "CLRObject: " + ClassName;
+    }
 }
@@ -30,66 +30,13 @@ public class CLRRuntime
 
         */
         System.loadLibrary("JNIWrapper");
-
-        Thread thread = new Thread() {
-            public void run() {
-                while(true)
-                {
-
-                    try
-                    {
-                        Thread.sleep(10000);
-                        for(Map.Entry<Integer, Integer> entry : CLRRuntime._DBID.entrySet()) {
-                            Integer key = entry.getKey();
-                            Integer value = entry.getValue();
-                
-                            if(CLRRuntime.DB.containsKey(key) && CLRRuntime.DB.get(key) == null)
-                            {
-                                CLRRuntime._DBID.remove(key);
-                                CLRRuntime.DB.remove(key);
-                            }
-                        }
-                
-                        for(Map.Entry<Integer, Integer> entry : CLRRuntime._SDBID.entrySet()) {
-                            Integer key = entry.getKey();
-                            Integer value = entry.getValue();
-                
-                            if(CLRRuntime.DB.containsKey(key) && CLRRuntime.DB.get(key) == null)
-                            {
-                                CLRRuntime._SDBID.remove(key);
-                                CLRRuntime.DB.remove(key);
-                            }
-                        }
-                
-                        for(Map.Entry<Integer, WeakReference> entry : CLRRuntime.DB.entrySet()) {
-                            Integer key = entry.getKey();
-                            WeakReference value = entry.getValue();
-                            
-                            if(value == null)
-                                CLRRuntime.DB.remove(key);
-                        }
-                
-                        for(Map.Entry<Integer, Object> entry : CLRRuntime.__DB.entrySet()) {
-                            Integer key = entry.getKey();
-                            Object value = entry.getValue();
-                
-                            if(value == null)
-                                CLRRuntime.__DB.remove(key);
-                        }
-                    }
-                    catch(Exception e){}
-                }
-            }
-        };
-        
-        thread.start();
     }
 
      
     public CLRRuntime() {
     }
 
-    public static String GetError(Exception ex)
+    public static String GetError(Throwable ex)
     {
         StringWriter errors = new StringWriter();
         ex.printStackTrace(new PrintWriter(errors));
@@ -153,26 +100,39 @@ public class CLRRuntime
         nativeSetProperty(ptr, name, new Object[]{ value });
     }
 
+    // A single get: the entry can be removed between a containsKey and the get by a concurrent release.
     public static CLRObject GetCLRObject(int ptr)
     {
-        if(CLRObject.DB.containsKey(ptr))
-        {
-            CLRObject res = (CLRObject)CLRObject.DB.get(ptr).get();
-    
-            return res;
-        }
-        return null;
+        WeakReference ref = CLRObject.DB.get(ptr);
+        return ref == null ? null : (CLRObject)ref.get();
     }
 
     
-    public static WeakHashMap<Object, Integer> DBID = new WeakHashMap<Object, Integer>();
-    public static Map<Integer, Integer> _DBID = new HashMap<Integer, Integer>();
+    // The object to ID maps are WeakHashMaps, which are not thread safe. They are split into stripes by hash code,
+    // each with its own lock, so callbacks from many threads only wait on each other when their objects share a stripe.
+    private static final class IDStripe
+    {
+        final WeakHashMap<Object, Integer> DBID = new WeakHashMap<Object, Integer>();
+        final WeakHashMap<Object, Integer> SDBID = new WeakHashMap<Object, Integer>();
+    }
+
+    private static final IDStripe[] IDStripes = new IDStripe[64];
+    static
+    {
+        for(int i = 0; i < IDStripes.length; i++)
+            IDStripes[i] = new IDStripe();
+    }
+
+    private static IDStripe IDStripeOf(Object obj)
+    {
+        return IDStripes[(obj.hashCode() & 0x7fffffff) % IDStripes.length];
+    }
 
-    public static WeakHashMap<Object, Integer> SDBID = new WeakHashMap<Object, Integer>();
-    public static Map<Integer, Integer> _SDBID = new HashMap<Integer, Integer>();
+    public static Map<Integer, Integer> _DBID = new ConcurrentHashMap<Integer, Integer>();
+    public static Map<Integer, Integer> _SDBID = new ConcurrentHashMap<Integer, Integer>();
     
 
-    public synchronized static int GetID(Object obj, boolean cache)
+    public static int GetID(Object obj, boolean cache)
     {
         if(obj == null || obj.hashCode() == 0)
         {
@@ -184,7 +144,16 @@ public class CLRRuntime
             return ((CLRObject)obj).Pointer;
         }
 
-        else if(SDBID.containsKey(obj))
+        IDStripe stripe = IDStripeOf(obj);
+        synchronized(stripe)
+        {
+            return GetID(stripe.DBID, stripe.SDBID, obj, cache);
+        }
+    }
+
+    private static int GetID(WeakHashMap<Object, Integer> DBID, WeakHashMap<Object, Integer> SDBID, Object obj, boolean cache)
+    {
+        if(SDBID.containsKey(obj))
             return SDBID.get(obj);
 
         else if(!DBID.containsKey(obj))
@@ -215,64 +184,70 @@ public class CLRRuntime
             //     }
             // }
         }
-        return DBID.get(obj);
+
+        // .NET may have released the ID while the object lived on, hold it again for the new reference.
+        int id = DBID.get(obj);
+        if(cache)
+            __DB.putIfAbsent(id, obj);
+        return id;
     }
 
-    public synchronized static int CreateID()
+    // IDs come from the native handle table shared with .NET, so they are unique without any locking here.
+    // The table only has 31 bit IDs to give and never reissues one, see JNIWrapper's handle table.
+    public static int CreateID()
     {
-        for(int i = 0; i < 100; i++)
-        {
-            UUID uuid = UUID.randomUUID();
-            String randomUUIDString = uuid.toString();
-            int id = randomUUIDString.hashCode();
-            if(!_DBID.containsKey(id))
-            {
-                _DBID.put(id, id);
-                return id;
-            }
-        }
-
-        System.out.println("JVM ERROR CREATEID");
-        return 0;
+        int id = nativeCreateID();
+        if(id == 0)
+            throw new IllegalStateException("CLRRuntime: bridge handle table exhausted, no object IDs left");
+        return id;
     }
 
     public static void RemoveID(int id)
     {
-        if(__DB.containsKey(id))
-        {
-            __DB.remove(id);
-        }
+        RemoveIDs(new int[]{ id });
+    }
 
-        if(CLRRuntime._DBID.containsKey(id))
+    // Called by JNIWrapper's release thread with the IDs .NET dropped since its last batch. Only the strong reference
+    // kept for .NET goes: the object can still cross again under the same ID, so every other registry and the native
+    // slot are cleared by CallbackRef once the object is collected.
+    public static void RemoveIDs(int[] ids)
+    {
+        for(int id : ids)
         {
-            CLRRuntime._DBID.remove(id);
+            __DB.remove(id);
+            _DBID.remove(id);
         }
     }
 
     public static void SetID(Object obj, int id)
     {
-        if(!SDBID.containsKey(obj))
+        IDStripe stripe = IDStripeOf(obj);
+        synchronized(stripe)
         {
-            if(!_SDBID.containsKey(id))
+            if(!stripe.SDBID.containsKey(obj))
             {
-                _SDBID.put(id, id);
-                SDBID.put(obj, id);
-                DB.put(id, new WeakReference(obj));
+                if(!_SDBID.containsKey(id))
+                {
+                    _SDBID.put(id, id);
+                    stripe.SDBID.put(obj, id);
+                    DB.put(id, new WeakReference(obj));
 
-                GCInterceptor.RegisterGCEvent(obj, id);
+                    GCInterceptor.RegisterGCEvent(obj, id);
+                }
             }
         }
     }
 
-    public static Map<Integer, Object> __DB = new HashMap<Integer, Object>();
-    public static Map<Integer, WeakReference> DB = new HashMap<Integer, WeakReference>();
+    // .NET calls in from many threads at once, the registries are concurrent and the WeakHashMaps are only touched under their stripe lock.
+    public static Map<Integer, Object> __DB = new ConcurrentHashMap<Integer, Object>();
+    public static Map<Integer, WeakReference> DB = new ConcurrentHashMap<Integer, WeakReference>();
     public static Object GetObject(int ptr)
     {
-        if(DB.containsKey(ptr) && DB.get(ptr).get() != null)
+        WeakReference ref = DB.get(ptr);
+        Object obj = ref == null ? null : ref.get();
+        if(obj != null)
         {
-            Object obj = DB.get(ptr).get();
-            if(!__DB.containsKey(ptr))
-                __DB.put(ptr, obj); //IMPORTANT CHECK... NOT SURE YET
+            __DB.putIfAbsent(ptr, obj); //IMPORTANT CHECK... NOT SURE YET
 
             GCInterceptor.RegisterGCEvent(obj, ptr);
             return obj;
@@ -374,6 +349,24 @@ public class CLRRuntime
     public static native Object nativeGetProperty(int ptr, String name);
     public static native void nativeSetProperty(int ptr, String name, Object[] value);
     public static native void nativeRemoveObject(int ptr);
+    public static native void nativeReleaseBuffer(long token);
+
+    // Primitive callbacks, registered by JNIWrapper in JNI_OnLoad. See CLRObject.InvokeDouble and friends.
+    public static native int nativeBindMethod(int ptr, String funcname, String signature);
+    public static native void nativeCallV(int token);
+    public static native void nativeCallDV(int token, double a);
+    public static native void nativeCallDDV(int token, double a, double b);
+    public static native double nativeCallDD(int token, double a);
+    public static native double nativeCallDDD(int token, double a, double b);
+    public static native long nativeCallJJ(int token, long a);
+    public static native int nativeCallII(int token, int a);
+    public static native double nativeCallArrDD(int token, double[] a);
+
+    // Handle table shared with .NET, registered by JNIWrapper in JNI_OnLoad.
+    public static native int nativeCreateID();
+    public static native boolean nativeReleaseID(int id);
+    public static native long nativeHandleFromID(int id);
+    public static native void nativeReleaseObjects(int[] ids);
 
     public static String TransformType(Type stype)
     {
@@ -433,6 +426,22 @@ public class CLRRuntime
         } 
     }
 
+    // Type of an instance field declared by cls or one of its superclasses, null if there is none. Used by JNIWrapper's field layouts.
+    public static Class<?> FieldType(Class<?> cls, String name)
+    {
+        for(Class<?> c = cls; c != null; c = c.getSuperclass())
+        {
+            try
+            {
+                Field field = c.getDeclaredField(name);
+                if(!Modifier.isStatic(field.getModifiers()))
+                    return field.getType();
+            }
+            catch(NoSuchFieldException e){}
+        }
+        return null;
+    }
+
     public static String TransformNetType(Type stype)
     {
         if(stype == null)
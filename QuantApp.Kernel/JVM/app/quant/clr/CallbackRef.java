@@ -6,51 +6,95 @@
  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
- // NEED TO IMPLEMENT https://docs.oracle.com/javase/7/docs/api/java/util/WeakHashMap.html
- 
- package app.quant.clr;
+package app.quant.clr;
 
- import java.io.*;
- import java.lang.ref.WeakReference;
- import java.lang.reflect.*;
- import java.util.*;
- import java.util.concurrent.*;
- import java.util.function.*;
- 
- import java.net.*;
+import java.lang.ref.PhantomReference;
+import java.lang.ref.Reference;
+import java.lang.ref.ReferenceQueue;
+import java.util.Arrays;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
 
+/*
+    Tells .NET when a Java object it holds an ID for, or a CLRObject wrapping a .NET object, has been collected.
+    The GC queues the phantom reference and one thread releases whatever has been queued since its last pass,
+    with a single nativeReleaseObjects call per batch instead of a finalizer and a native call per object.
+*/
+public class CallbackRef extends PhantomReference<Object> implements AutoCloseable
+{
+    private static final int BATCH = 1024;
+    private static final ReferenceQueue<Object> queue = new ReferenceQueue<Object>();
+    private static final Set<CallbackRef> live = ConcurrentHashMap.newKeySet();
 
+    static
+    {
+        Thread thread = new Thread("CLRRuntime release") {
+            public void run() {
+                int[] ids = new int[BATCH];
+                while(true)
+                {
+                    try
+                    {
+                        int count = 0;
+                        Reference<?> ref = queue.remove();
+                        while(ref != null)
+                        {
+                            CallbackRef callbackRef = (CallbackRef)ref;
+                            if(callbackRef.forget())
+                                ids[count++] = callbackRef._id;
 
-public class CallbackRef implements AutoCloseable
-{
-    private int _id;
-    public CallbackRef(Object obj, int id)
+                            ref = count < BATCH ? queue.poll() : null;
+                        }
+
+                        if(count > 0)
+                            CLRRuntime.nativeReleaseObjects(Arrays.copyOf(ids, count));
+                    }
+                    catch(InterruptedException e)
+                    {
+                        return;
+                    }
+                    catch(Exception e){}
+                }
+            }
+        };
+        thread.setDaemon(true);
+        thread.start();
+    }
+
+    private final int _id;
+
+    private CallbackRef(Object obj, int id)
     {
+        super(obj, queue);
         _id = id;
     }
 
-    @Override
-    public void close()
+    public static CallbackRef Track(Object obj, int id)
+    {
+        CallbackRef callbackRef = new CallbackRef(obj, id);
+        live.add(callbackRef);
+        return callbackRef;
+    }
+
+    // Drops the Java side entries for the ID, only the first caller gets true.
+    private boolean forget()
     {
-        CLRRuntime.nativeRemoveObject(_id);
+        if(!live.remove(this))
+            return false;
+
+        clear();
+        CLRObject.__DB.remove(_id);
+        CLRObject.DB.remove(_id);
+        CLRRuntime.DB.remove(_id);
+        CLRRuntime._DBID.remove(_id);
+        CLRRuntime._SDBID.remove(_id);
+        return true;
     }
 
     @Override
-    protected void finalize() throws Throwable 
-    // public void close()
-    {        
-        CLRRuntime.nativeRemoveObject(_id);
-
-        if(CLRObject.__DB.containsKey(_id))
-        {
-            System.out.println("JAVA GC Finalize CALLBACK: " + _id);
-            CLRObject.__DB.remove(_id);
-        }
-
-        if(CLRRuntime._DBID.containsKey(_id))
-            CLRRuntime._DBID.remove(_id);
-
-        if(CLRRuntime._SDBID.containsKey(_id))
-            CLRRuntime._SDBID.remove(_id);
+    public void close()
+    {
+        if(forget())
+            CLRRuntime.nativeReleaseObjects(new int[]{ _id });
     }
 }
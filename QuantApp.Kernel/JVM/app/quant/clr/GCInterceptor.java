@@ -6,8 +6,6 @@
  * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
- // NEED TO IMPLEMENT https://docs.oracle.com/javase/7/docs/api/java/util/WeakHashMap.html
- 
  package app.quant.clr;
 
  import java.io.*;
@@ -22,24 +20,26 @@
 
 public class GCInterceptor
 {
-    private static WeakHashMap<Object, CallbackRef> _table = new WeakHashMap<Object, CallbackRef>();
-    
+    // Striped by hash code like the ID maps in CLRRuntime, so registering results of concurrent callbacks does not serialize them.
+    @SuppressWarnings("unchecked")
+    private static final WeakHashMap<Object, CallbackRef>[] _tables = new WeakHashMap[64];
+    static
+    {
+        for(int i = 0; i < _tables.length; i++)
+            _tables[i] = new WeakHashMap<Object, CallbackRef>();
+    }
+
     public static void RegisterGCEvent(Object obj, int id)
     {
-        if(!_table.containsKey(obj))
+        // Null results of callbacks have nothing to collect.
+        if(obj == null)
+            return;
+
+        WeakHashMap<Object, CallbackRef> _table = _tables[(obj.hashCode() & 0x7fffffff) % _tables.length];
+        synchronized(_table)
         {
-            CallbackRef callbackRef = new CallbackRef(obj, id);
-            _table.put(obj, callbackRef);
+            if(!_table.containsKey(obj))
+                _table.put(obj, CallbackRef.Track(obj, id));
         }
     }
-
-    // public static void DeregisterGCEvent(this object obj, int id, Action<object, int> action)
-    // {
-    //     CallbackRef callbackRef;
-    //     bool found = _table.TryGetValue(obj, out callbackRef);
-    //     if (!found)
-    //         throw new Exception("No events registered");
-
-    //     callbackRef.Collected -= action;
-    // }
-}
\ No newline at end of file
+}
@@ -59,6 +59,14 @@ JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeSetProperty
 JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeRemoveObject
   (JNIEnv *, jclass, jint);
 
+/*
+ * Class:     app_quant_clr_CLRRuntime
+ * Method:    nativeReleaseBuffer
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_app_quant_clr_CLRRuntime_nativeReleaseBuffer
+  (JNIEnv *, jclass, jlong);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1747 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+Microbenchmarks for JNIWrapper.
+The harness embeds a JVM with JNI_CreateJavaVM, links the same libJNIWrapper the server loads and drives its exports
+the way Runtime.cs does: boxing, Call<Type>Method for every return type and 0 to 15 arguments, fields, strings,
+arrays from 1e2 to 1e7 elements, batches, collections, matrices, the exception paths and the CLRRuntime native
+callbacks, which are answered by the stub callbacks below instead of .NET. The parallel group enters the callbacks from
+a Java parallel stream on 1 to all cores, so ns per call should fall as the threads go up. The scope group fails
+when a nested thread scope frees the locals of the scope around it. The threads group makes the same calls from
+1 to all cores of attached native threads, the way .NET threads call into the JVM. The startup group times new JVMs with and
+without class data sharing.
+
+Each case is run in batches sized to take about --batch-ms, the first --warmup batches are dropped and the remaining
+--reps are reported in ns per operation. Results are written as JSON keyed by group, name and param so two runs can be
+compared with compare.py.
+
+    ./build.lnx.sh
+    ./JNIWrapperBench --out before.json [--filter array/] [--quick] [--no-metrics] [--cds-archive bench.jsa] [-Xmx4g ...]
+
+The JVM loads libJNIWrapper from --libpath through CLRRuntime's static initializer; it must be the library the
+harness was linked against or the callbacks land in another copy; build.lnx.sh puts both in its output directory,
+which is the default --libpath when the harness is run from there.
+*/
+
+#include <inttypes.h>
+#include <jni.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//JNIWrapper exports, declared as Runtime.cs imports them.
+extern "C" {
+
+    struct TaggedValue
+    {
+        jvalue value;
+        jstring name;
+        int kind;
+        int reserved;
+    };
+
+    struct TaggedArg
+    {
+        jvalue value;
+        int kind;
+        int length;
+        int elementKind;
+        int reserved;
+    };
+
+    struct BatchCall
+    {
+        jobject target;
+        jmethodID method;
+        const char* name;
+        const char* signature;
+        int kind;
+        int flags;
+        int argOffset;
+        int argCount;
+    };
+
+    struct BatchResult
+    {
+        jvalue value;
+        int status;
+        int reserved;
+    };
+
+    int MakeJavaVMInitArgsEx(char* classpath, char* libpath, int nExtra, char** pExtra, void** ppArgs);
+    void FreeJavaVMInitArgs(void* pArgs);
+    int InitJNICache(JNIEnv* pEnv);
+    int DestroyJavaVM(JavaVM* pJVM);
+
+    void* EnterThread(JavaVM* pVM, const char* szName);
+    void* GetThreadEnv();
+    int LeaveThread(JavaVM* pVM);
+
+    int MetricsEnabled();
+    void SetMetricsEnabled(int enabled);
+
+    int FindClass(JNIEnv* pEnv, const char* szClass, jclass* pClass);
+    int NewObject(JNIEnv* pEnv, const char* szType, const char* szArgs, int len, void** pArgs, jobject* pobj);
+    int DeleteLocalRef(JNIEnv* pEnv, jobject obj);
+    int GetStaticMethodID(JNIEnv* pEnv, jclass pClass, const char* szName, const char* szArgs, jmethodID* pMid);
+    int GetMethodID(JNIEnv* pEnv, jobject pObj, const char* szName, const char* szArgs, jmethodID* pMid);
+    int GetStaticFieldID(JNIEnv* pEnv, jclass pClass, const char* szName, const char* sig, jfieldID* pFid);
+    int GetFieldID(JNIEnv* pEnv, jobject pObj, const char* szName, const char* sig, jfieldID* pFid);
+
+    int EnableBoxCache(JNIEnv* pEnv, int low, int high);
+    int NewBooleanObject(JNIEnv* pEnv, bool val, jobject* pobj);
+    int NewByteObject(JNIEnv* pEnv, jbyte val, jobject* pobj);
+    int NewCharacterObject(JNIEnv* pEnv, char val, jobject* pobj);
+    int NewShortObject(JNIEnv* pEnv, short val, jobject* pobj);
+    int NewIntegerObject(JNIEnv* pEnv, int val, jobject* pobj);
+    int NewLongObject(JNIEnv* pEnv, long val, jobject* pobj);
+    int NewFloatObject(JNIEnv* pEnv, float val, jobject* pobj);
+    int NewDoubleObject(JNIEnv* pEnv, double val, jobject* pobj);
+    int UnboxObject(JNIEnv* pEnv, jobject obj, TaggedValue* pResult);
+
+    int CallStaticVoidMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs);
+    int CallVoidMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs);
+    int CallStaticObjectMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, jobject* pobj, int len, void** pArgs);
+    int CallObjectMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, jobject* pobj, int len, void** pArgs);
+    int CallStaticBooleanMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, bool* val);
+    int CallBooleanMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, bool* val);
+    int CallStaticByteMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, jbyte* val);
+    int CallByteMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, jbyte* val);
+    int CallStaticCharMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, char* val);
+    int CallCharMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, char* val);
+    int CallStaticShortMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, short* val);
+    int CallShortMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, short* val);
+    int CallStaticIntMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, int* res);
+    int CallIntMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, int* res);
+    int CallStaticLongMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, long* val);
+    int CallLongMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, long* val);
+    int CallStaticFloatMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, float* val);
+    int CallFloatMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, float* val);
+    int CallStaticDoubleMethod(JNIEnv* pEnv, jclass pClass, jmethodID pMid, int len, void** pArgs, double* val);
+    int CallDoubleMethod(JNIEnv* pEnv, jobject pObject, jmethodID pMid, int len, void** pArgs, double* val);
+    int CallBatch(JNIEnv* pEnv, const BatchCall* pCalls, int count, const jvalue* pArgs, BatchResult* pResults, int stopOnError);
+
+    int GetStaticIntField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, int* res);
+    int GetIntField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, int* res);
+    int SetStaticIntField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, int val);
+    int SetIntField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, int val);
+    int GetStaticDoubleField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, double* val);
+    int GetDoubleField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, double* val);
+    int SetStaticDoubleField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, double val);
+    int SetDoubleField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, double val);
+    int GetStaticObjectField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jobject* pobj);
+    int GetObjectField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jobject* pobj);
+    int SetStaticObjectField(JNIEnv* pEnv, jclass pClass, jfieldID pMid, jobject val);
+    int SetObjectField(JNIEnv* pEnv, jobject pObject, jfieldID pMid, jobject val);
+
+    jstring GetJavaString(JNIEnv* pEnv, const char* nString);
+    int GetStringUTF16(JNIEnv* pEnv, jstring jString, jchar* pBuffer, int capacity, int* pLength);
+    jstring NewStringUTF16(JNIEnv* pEnv, const jchar* pChars, int len);
+    jstring InternStringUTF16(JNIEnv* pEnv, const jchar* pChars, int len);
+
+    int TakeException(JNIEnv* pEnv, int captureDetail, jobject* pThrowable, jstring* pClassName, jstring* pMessage);
+    int DescribeException(JNIEnv* pEnv, jobject throwable, jstring* pTrace);
+    int GetExceptionCause(JNIEnv* pEnv, jobject throwable, jobject* pCause, jstring* pClassName, jstring* pMessage);
+    int ReleaseException(JNIEnv* pEnv, jobject throwable);
+    const char* GetException(JNIEnv* pEnv);
+
+    int NewIntArrayFrom(JNIEnv* pEnv, const jint* pSrc, int len, jintArray* pArray);
+    int GetIntArrayRegion(JNIEnv* pEnv, jintArray pArray, int offset, int count, jint* pDst);
+    int SetIntArrayRegion(JNIEnv* pEnv, jintArray pArray, int offset, int count, const jint* pSrc);
+    int GetIntArrayElement(JNIEnv* pEnv, jintArray pArray, int index);
+    int SetIntArrayElement(JNIEnv* pEnv, jintArray pArray, int index, int value);
+    int NewLongArrayFrom(JNIEnv* pEnv, const jlong* pSrc, int len, jlongArray* pArray);
+    int GetLongArrayRegion(JNIEnv* pEnv, jlongArray pArray, int offset, int count, jlong* pDst);
+    int SetLongArrayRegion(JNIEnv* pEnv, jlongArray pArray, int offset, int count, const jlong* pSrc);
+    long GetLongArrayElement(JNIEnv* pEnv, jlongArray pArray, int index);
+    int SetLongArrayElement(JNIEnv* pEnv, jlongArray pArray, int index, long value);
+    int NewDoubleArrayFrom(JNIEnv* pEnv, const jdouble* pSrc, int len, jdoubleArray* pArray);
+    int GetDoubleArrayRegion(JNIEnv* pEnv, jdoubleArray pArray, int offset, int count, jdouble* pDst);
+    int SetDoubleArrayRegion(JNIEnv* pEnv, jdoubleArray pArray, int offset, int count, const jdouble* pSrc);
+    double GetDoubleArrayElement(JNIEnv* pEnv, jdoubleArray pArray, int index);
+    int SetDoubleArrayElement(JNIEnv* pEnv, jdoubleArray pArray, int index, double value);
+    int NewByteArrayFrom(JNIEnv* pEnv, const jbyte* pSrc, int len, jbyteArray* pArray);
+    int GetByteArrayRegion(JNIEnv* pEnv, jbyteArray pArray, int offset, int count, jbyte* pDst);
+    int SetByteArrayRegion(JNIEnv* pEnv, jbyteArray pArray, int offset, int count, const jbyte* pSrc);
+    jbyte GetByteArrayElement(JNIEnv* pEnv, jbyteArray pArray, int index);
+    int SetByteArrayElement(JNIEnv* pEnv, jbyteArray pArray, int index, jbyte value);
+    int GetArrayCritical(JNIEnv* pEnv, jarray pArray, const char* szType, void** ppData, int* pLength);
+    int ReleaseArrayCritical(JNIEnv* pEnv, jarray pArray, void* pData, int mode);
+
+    int CollectionToDoubleArray(JNIEnv* pEnv, jobject collection, jdouble* pDst, int cap, int* pCount);
+    int NewDoubleArrayList(JNIEnv* pEnv, const jdouble* pSrc, int len, jobject* pList);
+
+    int GetMatrixRows(JNIEnv* pEnv, jobjectArray array, const char* sType, int rows, void** pRows, const int* pLengths, int threads);
+    int NewMatrix(JNIEnv* pEnv, const char* sType, int rows, void** pRows, const int* pLengths, int threads, jobjectArray* pArray);
+
+    void SetfnCreateInstance(void* cb);
+    void SetfnInvoke(void* cb);
+    void SetfnGetProperty(void* cb);
+    void SetfnSetProperty(void* cb);
+    void SetfnRegisterFunc(void* cb);
+    void SetfnInvokeFunc(void* cb);
+    void SetfnRemoveObject(void* cb);
+    void SetfnRemoveObjects(void* cb);
+    void SetfnBindMethod(void* cb);
+    void SetfnCallV(void* cb);
+    void SetfnCallDV(void* cb);
+    void SetfnCallDDV(void* cb);
+    void SetfnCallDD(void* cb);
+    void SetfnCallDDD(void* cb);
+    void SetfnCallJJ(void* cb);
+    void SetfnCallII(void* cb);
+    void SetfnCallArrDD(void* cb);
+}
+
+//stub callbacks
+/*
+Stand-ins for the .NET side of the CLRRuntime natives. They read their arguments so the decoding work is not wasted,
+and return the cheapest valid answer, so a callback case measures the native trampoline and not the .NET work.
+*/
+
+static volatile double g_sink = 0;
+//The stubs are entered from many threads by the parallel cases, so they must not share a cache line.
+static thread_local volatile double t_stubSink = 0;
+
+static double TouchArgs(void* args, int len)
+{
+    TaggedArg* tagged = (TaggedArg*)args;
+    double sum = 0;
+    for(int i = 0; i < len; i++)
+        sum += tagged[i].kind == 'D' ? tagged[i].value.d : (double)tagged[i].length;
+    return sum;
+}
+
+static int StubCreateInstance(void* pEnv, const char* szClass, int len, void* args) { t_stubSink = t_stubSink + TouchArgs(args, len); return 1; }
+static jobject StubInvoke(void* pEnv, int ptr, const char* szName, int len, void* args) { t_stubSink = t_stubSink + TouchArgs(args, len); return NULL; }
+static jobject StubGetProperty(void* pEnv, int ptr, const char* szName) { return NULL; }
+static jobject StubSetProperty(void* pEnv, int ptr, const char* szName, int len, void* args) { t_stubSink = t_stubSink + TouchArgs(args, len); return NULL; }
+static jobject StubRegisterFunc(void* pEnv, const char* szName, int hash) { return NULL; }
+static jobject StubInvokeFunc(void* pEnv, int ptr, int len, void* args) { t_stubSink = t_stubSink + TouchArgs(args, len); return NULL; }
+static jobject StubRemoveObject(void* pEnv, int ptr) { return NULL; }
+static void StubRemoveObjects(void* pEnv, jint* ids, int count) { }
+static int StubBindMethod(void* pEnv, int ptr, const char* szName, const char* szSignature) { return 1; }
+static int StubCallV(void* pEnv, int token) { return 0; }
+static int StubCallDV(void* pEnv, int token, jdouble a) { return 0; }
+static int StubCallDDV(void* pEnv, int token, jdouble a, jdouble b) { return 0; }
+static int StubCallDD(void* pEnv, int token, jdouble a, jdouble* pResult) { *pResult = a; return 0; }
+static int StubCallDDD(void* pEnv, int token, jdouble a, jdouble b, jdouble* pResult) { *pResult = a + b; return 0; }
+static int StubCallJJ(void* pEnv, int token, jlong a, jlong* pResult) { *pResult = a; return 0; }
+static int StubCallII(void* pEnv, int token, jint a, jint* pResult) { *pResult = a; return 0; }
+
+static int StubCallArrDD(void* pEnv, int token, const jdouble* a, int len, jdouble* pResult)
+{
+    jdouble sum = 0;
+    for(int i = 0; i < len; i++)
+        sum += a[i];
+    *pResult = sum;
+    return 0;
+}
+
+static void InstallStubCallbacks()
+{
+    SetfnCreateInstance((void*)StubCreateInstance);
+    SetfnInvoke((void*)StubInvoke);
+    SetfnGetProperty((void*)StubGetProperty);
+    SetfnSetProperty((void*)StubSetProperty);
+    SetfnRegisterFunc((void*)StubRegisterFunc);
+    SetfnInvokeFunc((void*)StubInvokeFunc);
+    SetfnRemoveObject((void*)StubRemoveObject);
+    SetfnRemoveObjects((void*)StubRemoveObjects);
+    SetfnBindMethod((void*)StubBindMethod);
+    SetfnCallV((void*)StubCallV);
+    SetfnCallDV((void*)StubCallDV);
+    SetfnCallDDV((void*)StubCallDDV);
+    SetfnCallDD((void*)StubCallDD);
+    SetfnCallDDD((void*)StubCallDDD);
+    SetfnCallJJ((void*)StubCallJJ);
+    SetfnCallII((void*)StubCallII);
+    SetfnCallArrDD((void*)StubCallArrDD);
+}
+
+//harness
+
+struct BenchOptions
+{
+    string classpath;
+    string libpath;
+    string out;
+    string filter;
+    int reps;
+    int warmup;
+    double batchMs;
+    bool quick;
+    bool metrics;
+    string cdsArchive;
+    bool startupChild;
+    string self;
+    vector<string> jvmOptions;
+};
+
+struct BenchResult
+{
+    string group;
+    string name;
+    long param;
+    long ops;
+    double bytesPerOp;
+    vector<double> samples;     // ns per operation, one per measured batch
+    string error;
+};
+
+//Runs n operations, false once a wrapper reports an error.
+typedef std::function<bool(long n)> BenchBody;
+
+static BenchOptions g_options;
+static vector<BenchResult> g_results;
+static JNIEnv* g_env = NULL;
+
+static double ElapsedNanos(std::chrono::steady_clock::time_point start)
+{
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool Selected(const string& group, const string& name)
+{
+    return g_options.filter.empty() || (group + "/" + name).find(g_options.filter) != string::npos;
+}
+
+static string PendingException(JNIEnv* pEnv)
+{
+    if(pEnv->ExceptionCheck() != JNI_TRUE)
+        return "";
+    const char* szError = GetException(pEnv);
+    return szError == NULL ? "java exception" : szError;
+}
+
+/*
+Times body in batches. The batch size doubles from 1 until a batch takes --batch-ms, capped at maxOps for the large
+transfers, then --warmup batches are run and dropped and --reps batches are kept.
+*/
+static void Bench(const string& group, const string& name, long param, double bytesPerOp, long maxOps, const BenchBody& body)
+{
+    if(!Selected(group, name))
+        return;
+
+    BenchResult result;
+    result.group = group;
+    result.name = name;
+    result.param = param;
+    result.bytesPerOp = bytesPerOp;
+    result.ops = 1;
+
+    double target = g_options.batchMs * 1e6;
+    bool ok = true;
+    while(ok)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ok = body(result.ops);
+        if(!ok || ElapsedNanos(start) >= target || result.ops >= maxOps)
+            break;
+        result.ops = std::min(result.ops * 2, maxOps);
+    }
+
+    for(int i = 0; ok && i < g_options.warmup; i++)
+        ok = body(result.ops);
+
+    for(int i = 0; ok && i < g_options.reps; i++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ok = body(result.ops);
+        result.samples.push_back(ElapsedNanos(start) / result.ops);
+    }
+
+    if(!ok)
+    {
+        result.samples.clear();
+        result.error = PendingException(g_env);
+        if(result.error.empty())
+            result.error = "wrapper returned an error";
+    }
+
+    fprintf(stderr, "%-10s %-40s %10ld  ", group.c_str(), name.c_str(), param);
+    if(ok)
+    {
+        vector<double> sorted(result.samples);
+        std::sort(sorted.begin(), sorted.end());
+        fprintf(stderr, "%12.1f ns/op\n", sorted[sorted.size() / 2]);
+    }
+    else
+        fprintf(stderr, "failed: %s\n", result.error.c_str());
+
+    g_results.push_back(result);
+}
+
+static void Bench(const string& group, const string& name, long param, const BenchBody& body)
+{
+    Bench(group, name, param, 0, 1L << 40, body);
+}
+
+//Sizes from 1e2 up to max by powers of ten.
+static vector<int> Sizes(int max)
+{
+    vector<int> sizes;
+    for(int n = 100; n <= max; n *= 10)
+        sizes.push_back(n);
+    return sizes;
+}
+
+static void DeleteRefs(JNIEnv* pEnv, jobject a, jobject b = NULL, jobject c = NULL)
+{
+    if(a != NULL) DeleteLocalRef(pEnv, a);
+    if(b != NULL) DeleteLocalRef(pEnv, b);
+    if(c != NULL) DeleteLocalRef(pEnv, c);
+}
+
+//boxing
+/*
+Values outside the JDK's -128..127 valueOf caches, so the allocating path is timed. The cached variants run last,
+after EnableBoxCache, which cannot be undone.
+*/
+
+template<typename T>
+static void BenchBox(JNIEnv* pEnv, const char* szName, int (*fn)(JNIEnv*, T, jobject*), T value)
+{
+    Bench("box", szName, 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            jobject obj = NULL;
+            if(fn(pEnv, value, &obj) != 0)
+                return false;
+            DeleteLocalRef(pEnv, obj);
+        }
+        return true;
+    });
+}
+
+static void BenchUnbox(JNIEnv* pEnv, const char* szName, jobject obj)
+{
+    Bench("box", szName, 0, [=](long n) {
+        TaggedValue value;
+        for(long i = 0; i < n; i++)
+        {
+            if(UnboxObject(pEnv, obj, &value) != 0)
+                return false;
+            if(value.name != NULL)
+                DeleteLocalRef(pEnv, value.name);
+        }
+        return true;
+    });
+}
+
+static void BenchBoxing(JNIEnv* pEnv)
+{
+    BenchBox<bool>(pEnv, "NewBooleanObject", NewBooleanObject, true);
+    BenchBox<jbyte>(pEnv, "NewByteObject", NewByteObject, (jbyte)100);
+    BenchBox<char>(pEnv, "NewCharacterObject", NewCharacterObject, 'x');
+    BenchBox<short>(pEnv, "NewShortObject", NewShortObject, (short)1000);
+    BenchBox<int>(pEnv, "NewIntegerObject", NewIntegerObject, 1000);
+    BenchBox<long>(pEnv, "NewLongObject", NewLongObject, 1000L);
+    BenchBox<float>(pEnv, "NewFloatObject", NewFloatObject, 1.5f);
+    BenchBox<double>(pEnv, "NewDoubleObject", NewDoubleObject, 1.5);
+
+    jobject boxes[5] = { NULL, NULL, NULL, NULL, NULL };
+    NewDoubleObject(pEnv, 1.5, &boxes[0]);
+    NewIntegerObject(pEnv, 1000, &boxes[1]);
+    NewLongObject(pEnv, 1000L, &boxes[2]);
+    NewBooleanObject(pEnv, true, &boxes[3]);
+    boxes[4] = GetJavaString(pEnv, "bench");
+
+    BenchUnbox(pEnv, "UnboxObject.Double", boxes[0]);
+    BenchUnbox(pEnv, "UnboxObject.Integer", boxes[1]);
+    BenchUnbox(pEnv, "UnboxObject.Long", boxes[2]);
+    BenchUnbox(pEnv, "UnboxObject.Boolean", boxes[3]);
+    BenchUnbox(pEnv, "UnboxObject.String", boxes[4]);
+
+    for(int i = 0; i < 5; i++)
+        DeleteRefs(pEnv, boxes[i]);
+
+    if(Selected("box", "NewIntegerObject.cached") || Selected("box", "NewLongObject.cached"))
+    {
+        if(EnableBoxCache(pEnv, -128, 1023) == 0)
+        {
+            BenchBox<int>(pEnv, "NewIntegerObject.cached", NewIntegerObject, 1000);
+            BenchBox<long>(pEnv, "NewLongObject.cached", NewLongObject, 1000L);
+        }
+        else
+            fprintf(stderr, "box cache not enabled\n");
+    }
+}
+
+//calls
+
+static jmethodID StaticMethod(JNIEnv* pEnv, jclass cls, const char* szName, const char* szSignature)
+{
+    jmethodID mid = NULL;
+    if(GetStaticMethodID(pEnv, cls, szName, szSignature, &mid) != 0)
+        fprintf(stderr, "%s%s not found\n", szName, szSignature);
+    return mid;
+}
+
+static jmethodID InstanceMethod(JNIEnv* pEnv, jobject obj, const char* szName, const char* szSignature)
+{
+    jmethodID mid = NULL;
+    if(GetMethodID(pEnv, obj, szName, szSignature, &mid) != 0)
+        fprintf(stderr, "%s%s not found\n", szName, szSignature);
+    return mid;
+}
+
+//Runs one call of the given return kind through the matching wrapper, static when obj is NULL.
+static bool CallKind(JNIEnv* pEnv, char kind, jclass cls, jobject obj, jmethodID mid, int len, jvalue* args)
+{
+    void** pArgs = (void**)args;
+    int res = 0;
+    switch(kind)
+    {
+        case 'V':
+            res = obj == NULL ? CallStaticVoidMethod(pEnv, cls, mid, len, pArgs) : CallVoidMethod(pEnv, (jclass)obj, mid, len, pArgs);
+            break;
+        case 'Z': { bool val; res = obj == NULL ? CallStaticBooleanMethod(pEnv, cls, mid, len, pArgs, &val) : CallBooleanMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'B': { jbyte val; res = obj == NULL ? CallStaticByteMethod(pEnv, cls, mid, len, pArgs, &val) : CallByteMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'C': { char val; res = obj == NULL ? CallStaticCharMethod(pEnv, cls, mid, len, pArgs, &val) : CallCharMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'S': { short val; res = obj == NULL ? CallStaticShortMethod(pEnv, cls, mid, len, pArgs, &val) : CallShortMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'I': { int val; res = obj == NULL ? CallStaticIntMethod(pEnv, cls, mid, len, pArgs, &val) : CallIntMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'J': { long val; res = obj == NULL ? CallStaticLongMethod(pEnv, cls, mid, len, pArgs, &val) : CallLongMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'F': { float val; res = obj == NULL ? CallStaticFloatMethod(pEnv, cls, mid, len, pArgs, &val) : CallFloatMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'D': { double val; res = obj == NULL ? CallStaticDoubleMethod(pEnv, cls, mid, len, pArgs, &val) : CallDoubleMethod(pEnv, obj, mid, len, pArgs, &val); break; }
+        case 'L':
+        {
+            jobject val = NULL;
+            res = obj == NULL ? CallStaticObjectMethod(pEnv, cls, mid, &val, len, pArgs) : CallObjectMethod(pEnv, obj, mid, &val, len, pArgs);
+            if(val != NULL)
+                DeleteLocalRef(pEnv, val);
+            break;
+        }
+    }
+    return res == 0;
+}
+
+static void BenchCall(JNIEnv* pEnv, const string& name, long param, char kind, jclass cls, jobject obj, jmethodID mid, const vector<jvalue>& args)
+{
+    if(mid == NULL)
+        return;
+
+    Bench("call", name, param, [=](long n) {
+        vector<jvalue> _args(args);
+        jvalue* pArgs = _args.empty() ? NULL : &_args[0];
+        for(long i = 0; i < n; i++)
+            if(!CallKind(pEnv, kind, cls, obj, mid, (int)_args.size(), pArgs))
+                return false;
+        return true;
+    });
+}
+
+static string Signature(int arity, const char* szArg, const char* szReturn)
+{
+    string signature = "(";
+    for(int i = 0; i < arity; i++)
+        signature += szArg;
+    return signature + ")" + szReturn;
+}
+
+static void BenchCalls(JNIEnv* pEnv, jclass cls, jobject target)
+{
+    const char kinds[] = { 'V', 'Z', 'B', 'C', 'S', 'I', 'J', 'F', 'D', 'L' };
+    const char* returns[] = { "V", "Z", "B", "C", "S", "I", "J", "F", "D", "Ljava/lang/Object;" };
+    const char* wrappers[] = { "Void", "Boolean", "Byte", "Char", "Short", "Int", "Long", "Float", "Double", "Object" };
+
+    vector<jvalue> one(1);
+    one[0].i = 7;
+
+    for(int k = 0; k < 10; k++)
+    {
+        string signature = string("(I)") + returns[k];
+        BenchCall(pEnv, string("CallStatic") + wrappers[k] + "Method", 1, kinds[k], cls, NULL,
+            StaticMethod(pEnv, cls, (string("static") + kinds[k]).c_str(), signature.c_str()), one);
+        BenchCall(pEnv, string("Call") + wrappers[k] + "Method", 1, kinds[k], cls, target,
+            InstanceMethod(pEnv, target, (string("instance") + kinds[k]).c_str(), signature.c_str()), one);
+    }
+
+    jobject text = GetJavaString(pEnv, "bench");
+    for(int arity = 0; arity <= 15; arity++)
+    {
+        vector<jvalue> ints(arity), doubles(arity), objects(arity);
+        for(int i = 0; i < arity; i++)
+        {
+            ints[i].i = i;
+            doubles[i].d = i;
+            objects[i].l = text;
+        }
+
+        BenchCall(pEnv, "CallStaticIntMethod.arity", arity, 'I', cls, NULL,
+            StaticMethod(pEnv, cls, ("sumI" + to_string(arity)).c_str(), Signature(arity, "I", "I").c_str()), ints);
+        BenchCall(pEnv, "CallStaticDoubleMethod.arity", arity, 'D', cls, NULL,
+            StaticMethod(pEnv, cls, ("sumD" + to_string(arity)).c_str(), Signature(arity, "D", "D").c_str()), doubles);
+        BenchCall(pEnv, "CallStaticObjectMethod.arity", arity, 'L', cls, NULL,
+            StaticMethod(pEnv, cls, ("firstL" + to_string(arity)).c_str(), Signature(arity, "Ljava/lang/Object;", "Ljava/lang/Object;").c_str()), objects);
+    }
+
+    //the same static int call submitted through CallBatch, per call
+    jmethodID mid = StaticMethod(pEnv, cls, "staticI", "(I)I");
+    for(int size = 1; mid != NULL && size <= 1024; size *= 32)
+    {
+        Bench("call", "CallBatch", size, [=](long n) {
+            vector<BatchCall> calls(size);
+            vector<jvalue> args(size);
+            vector<BatchResult> results(size);
+            for(int i = 0; i < size; i++)
+            {
+                BatchCall call = { cls, mid, NULL, NULL, 'I', 1, i, 1 };
+                calls[i] = call;
+                args[i].i = i;
+            }
+
+            for(long done = 0; done < n; done += size)
+                if(CallBatch(pEnv, &calls[0], size, &args[0], &results[0], 1) != 0)
+                    return false;
+            return true;
+        });
+    }
+
+    DeleteRefs(pEnv, text);
+}
+
+//fields
+
+static void BenchFields(JNIEnv* pEnv, jclass cls, jobject target)
+{
+    jfieldID sInt = NULL, sDouble = NULL, sObject = NULL, iInt = NULL, iDouble = NULL, iObject = NULL;
+    if(GetStaticFieldID(pEnv, cls, "staticInt", "I", &sInt) != 0 ||
+        GetStaticFieldID(pEnv, cls, "staticDouble", "D", &sDouble) != 0 ||
+        GetStaticFieldID(pEnv, cls, "staticObject", "Ljava/lang/Object;", &sObject) != 0 ||
+        GetFieldID(pEnv, target, "instanceInt", "I", &iInt) != 0 ||
+        GetFieldID(pEnv, target, "instanceDouble", "D", &iDouble) != 0 ||
+        GetFieldID(pEnv, target, "instanceObject", "Ljava/lang/Object;", &iObject) != 0)
+    {
+        fprintf(stderr, "bench fields not found\n");
+        return;
+    }
+
+    jobject value = GetJavaString(pEnv, "bench");
+    jobject global = pEnv->NewGlobalRef(value);
+    DeleteRefs(pEnv, value);
+
+    Bench("field", "GetStaticIntField", 0, [=](long n) { int v; for(long i = 0; i < n; i++) if(GetStaticIntField(pEnv, cls, sInt, &v) != 0) return false; return true; });
+    Bench("field", "SetStaticIntField", 0, [=](long n) { for(long i = 0; i < n; i++) if(SetStaticIntField(pEnv, cls, sInt, (int)i) != 0) return false; return true; });
+    Bench("field", "GetIntField", 0, [=](long n) { int v; for(long i = 0; i < n; i++) if(GetIntField(pEnv, target, iInt, &v) != 0) return false; return true; });
+    Bench("field", "SetIntField", 0, [=](long n) { for(long i = 0; i < n; i++) if(SetIntField(pEnv, target, iInt, (int)i) != 0) return false; return true; });
+    Bench("field", "GetStaticDoubleField", 0, [=](long n) { double v; for(long i = 0; i < n; i++) if(GetStaticDoubleField(pEnv, cls, sDouble, &v) != 0) return false; return true; });
+    Bench("field", "SetStaticDoubleField", 0, [=](long n) { for(long i = 0; i < n; i++) if(SetStaticDoubleField(pEnv, cls, sDouble, (double)i) != 0) return false; return true; });
+    Bench("field", "GetDoubleField", 0, [=](long n) { double v; for(long i = 0; i < n; i++) if(GetDoubleField(pEnv, target, iDouble, &v) != 0) return false; return true; });
+    Bench("field", "SetDoubleField", 0, [=](long n) { for(long i = 0; i < n; i++) if(SetDoubleField(pEnv, target, iDouble, (double)i) != 0) return false; return true; });
+
+    Bench("field", "SetStaticObjectField", 0, [=](long n) { for(long i = 0; i < n; i++) if(SetStaticObjectField(pEnv, cls, sObject, global) != 0) return false; return true; });
+    Bench("field", "SetObjectField", 0, [=](long n) { for(long i = 0; i < n; i++) if(SetObjectField(pEnv, target, iObject, global) != 0) return false; return true; });
+    Bench("field", "GetStaticObjectField", 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            jobject v = NULL;
+            if(GetStaticObjectField(pEnv, cls, sObject, &v) != 0)
+                return false;
+            DeleteRefs(pEnv, v);
+        }
+        return true;
+    });
+    Bench("field", "GetObjectField", 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            jobject v = NULL;
+            if(GetObjectField(pEnv, target, iObject, &v) != 0)
+                return false;
+            DeleteRefs(pEnv, v);
+        }
+        return true;
+    });
+
+    pEnv->DeleteGlobalRef(global);
+}
+
+//strings
+/*
+ASCII text, so the UTF-8 and UTF-16 paths carry the same characters. InternStringUTF16 only keeps strings up to
+256 characters, longer ones show its fallback cost.
+*/
+
+static void BenchStrings(JNIEnv* pEnv)
+{
+    int lengths[] = { 1, 16, 256, 4096, 65536 };
+    for(size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++)
+    {
+        int len = lengths[l];
+        string utf8(len, 'a');
+        for(int i = 0; i < len; i++)
+            utf8[i] = (char)('a' + i % 26);
+        vector<jchar> utf16(utf8.begin(), utf8.end());
+
+        Bench("string", "GetJavaString", len, len, 1L << 40, [=](long n) {
+            for(long i = 0; i < n; i++)
+            {
+                jstring s = GetJavaString(pEnv, utf8.c_str());
+                if(s == NULL)
+                    return false;
+                DeleteRefs(pEnv, s);
+            }
+            return true;
+        });
+
+        Bench("string", "NewStringUTF16", len, len * sizeof(jchar), 1L << 40, [=](long n) {
+            for(long i = 0; i < n; i++)
+            {
+                jstring s = NewStringUTF16(pEnv, &utf16[0], len);
+                if(s == NULL)
+                    return false;
+                DeleteRefs(pEnv, s);
+            }
+            return true;
+        });
+
+        Bench("string", "InternStringUTF16", len, len * sizeof(jchar), 1L << 40, [=](long n) {
+            for(long i = 0; i < n; i++)
+            {
+                jstring s = InternStringUTF16(pEnv, &utf16[0], len);
+                if(s == NULL)
+                    return false;
+                DeleteRefs(pEnv, s);
+            }
+            return true;
+        });
+
+        jstring value = NewStringUTF16(pEnv, &utf16[0], len);
+        jstring global = (jstring)pEnv->NewGlobalRef(value);
+        DeleteRefs(pEnv, value);
+
+        Bench("string", "GetStringUTF16", len, len * sizeof(jchar), 1L << 40, [=](long n) {
+            vector<jchar> buffer(len);
+            int length = 0;
+            for(long i = 0; i < n; i++)
+                if(GetStringUTF16(pEnv, global, &buffer[0], len, &length) != 0 || length != len)
+                    return false;
+            return true;
+        });
+
+        Bench("string", "roundtrip.UTF16", len, 2 * len * sizeof(jchar), 1L << 40, [=](long n) {
+            vector<jchar> buffer(len);
+            int length = 0;
+            for(long i = 0; i < n; i++)
+            {
+                jstring s = NewStringUTF16(pEnv, &utf16[0], len);
+                if(s == NULL || GetStringUTF16(pEnv, s, &buffer[0], len, &length) != 0)
+                    return false;
+                DeleteRefs(pEnv, s);
+            }
+            return true;
+        });
+
+        pEnv->DeleteGlobalRef(global);
+    }
+}
+
+//arrays
+/*
+Each primitive family is timed in both directions: creating a Java array from native memory, copying a region out,
+copying a region in and borrowing the elements with GetArrayCritical. The element at a time wrappers are only run up
+to 1e5 elements, they are there to show what the bulk calls replace.
+*/
+
+template<typename T, typename A, typename E>
+struct ArrayFamily
+{
+    const char* name;
+    const char* type;
+    int (*newFrom)(JNIEnv*, const T*, int, A*);
+    int (*getRegion)(JNIEnv*, A, int, int, T*);
+    int (*setRegion)(JNIEnv*, A, int, int, const T*);
+    E (*getElement)(JNIEnv*, A, int);
+    int (*setElement)(JNIEnv*, A, int, E);
+};
+
+template<typename T, typename A, typename E>
+static void BenchArrays(JNIEnv* pEnv, const ArrayFamily<T, A, E>& family, int maxSize)
+{
+    string name(family.name);
+    vector<int> sizes = Sizes(maxSize);
+    for(size_t s = 0; s < sizes.size(); s++)
+    {
+        int size = sizes[s];
+        double bytes = (double)size * sizeof(T);
+        long maxOps = std::max(1L, (long)(2e9 / bytes));
+
+        vector<T>* data = new vector<T>(size);
+        for(int i = 0; i < size; i++)
+            (*data)[i] = (T)(i & 0x7f);
+
+        A local = NULL;
+        if(family.newFrom(pEnv, &(*data)[0], size, &local) != 0 || local == NULL)
+        {
+            fprintf(stderr, "%s[%d] could not be created: %s\n", family.name, size, PendingException(pEnv).c_str());
+            delete data;
+            continue;
+        }
+        A array = (A)pEnv->NewGlobalRef(local);
+        DeleteRefs(pEnv, local);
+        T* buffer = &(*data)[0];
+
+        Bench("array", "New" + name + "ArrayFrom", size, bytes, maxOps, [=](long n) {
+            for(long i = 0; i < n; i++)
+            {
+                A a = NULL;
+                if(family.newFrom(pEnv, buffer, size, &a) != 0)
+                    return false;
+                DeleteRefs(pEnv, a);
+            }
+            return true;
+        });
+
+        Bench("array", "Get" + name + "ArrayRegion", size, bytes, maxOps, [=](long n) {
+            for(long i = 0; i < n; i++)
+                if(family.getRegion(pEnv, array, 0, size, buffer) != 0)
+                    return false;
+            return true;
+        });
+
+        Bench("array", "Set" + name + "ArrayRegion", size, bytes, maxOps, [=](long n) {
+            for(long i = 0; i < n; i++)
+                if(family.setRegion(pEnv, array, 0, size, buffer) != 0)
+                    return false;
+            return true;
+        });
+
+        Bench("array", "GetArrayCritical." + name, size, bytes, maxOps, [=](long n) {
+            for(long i = 0; i < n; i++)
+            {
+                void* elements = NULL;
+                int length = 0;
+                if(GetArrayCritical(pEnv, array, family.type, &elements, &length) != 0)
+                    return false;
+                memcpy(buffer, elements, (size_t)length * sizeof(T));
+                ReleaseArrayCritical(pEnv, array, elements, JNI_ABORT);
+            }
+            return true;
+        });
+
+        if(size <= 100000)
+        {
+            Bench("array", "Get" + name + "ArrayElement.loop", size, bytes, maxOps, [=](long n) {
+                for(long i = 0; i < n; i++)
+                    for(int j = 0; j < size; j++)
+                        buffer[j] = (T)family.getElement(pEnv, array, j);
+                return pEnv->ExceptionCheck() != JNI_TRUE;
+            });
+
+            Bench("array", "Set" + name + "ArrayElement.loop", size, bytes, maxOps, [=](long n) {
+                for(long i = 0; i < n; i++)
+                    for(int j = 0; j < size; j++)
+                        if(family.setElement(pEnv, array, j, (E)buffer[j]) != 0)
+                            return false;
+                return true;
+            });
+        }
+
+        pEnv->DeleteGlobalRef(array);
+        delete data;
+    }
+}
+
+static void BenchAllArrays(JNIEnv* pEnv)
+{
+    int maxSize = g_options.quick ? 100000 : 10000000;
+
+    ArrayFamily<jdouble, jdoubleArray, double> doubles = { "Double", "D", NewDoubleArrayFrom, GetDoubleArrayRegion, SetDoubleArrayRegion, GetDoubleArrayElement, SetDoubleArrayElement };
+    ArrayFamily<jint, jintArray, int> ints = { "Int", "I", NewIntArrayFrom, GetIntArrayRegion, SetIntArrayRegion, GetIntArrayElement, SetIntArrayElement };
+    ArrayFamily<jlong, jlongArray, long> longs = { "Long", "J", NewLongArrayFrom, GetLongArrayRegion, SetLongArrayRegion, GetLongArrayElement, SetLongArrayElement };
+    ArrayFamily<jbyte, jbyteArray, jbyte> bytes = { "Byte", "B", NewByteArrayFrom, GetByteArrayRegion, SetByteArrayRegion, GetByteArrayElement, SetByteArrayElement };
+
+    BenchArrays(pEnv, doubles, maxSize);
+    BenchArrays(pEnv, ints, maxSize);
+    BenchArrays(pEnv, longs, maxSize);
+    BenchArrays(pEnv, bytes, maxSize);
+}
+
+//collections and matrices
+
+static void BenchCollections(JNIEnv* pEnv)
+{
+    vector<int> sizes = Sizes(g_options.quick ? 10000 : 1000000);
+    for(size_t s = 0; s < sizes.size(); s++)
+    {
+        int size = sizes[s];
+        double bytes = (double)size * sizeof(jdouble);
+        vector<jdouble>* data = new vector<jdouble>(size, 1.5);
+        jdouble* buffer = &(*data)[0];
+
+        jobject local = NULL;
+        if(NewDoubleArrayList(pEnv, buffer, size, &local) != 0)
+        {
+            delete data;
+            continue;
+        }
+        jobject list = pEnv->NewGlobalRef(local);
+        DeleteRefs(pEnv, local);
+
+        Bench("collection", "NewDoubleArrayList", size, bytes, 1L << 40, [=](long n) {
+            for(long i = 0; i < n; i++)
+            {
+                jobject l = NULL;
+                if(NewDoubleArrayList(pEnv, buffer, size, &l) != 0)
+                    return false;
+                DeleteRefs(pEnv, l);
+            }
+            return true;
+        });
+
+        Bench("collection", "CollectionToDoubleArray", size, bytes, 1L << 40, [=](long n) {
+            int count = 0;
+            for(long i = 0; i < n; i++)
+                if(CollectionToDoubleArray(pEnv, list, buffer, size, &count) != 0 || count != size)
+                    return false;
+            return true;
+        });
+
+        pEnv->DeleteGlobalRef(list);
+        delete data;
+    }
+}
+
+static void BenchMatrices(JNIEnv* pEnv)
+{
+    int shapes[][2] = { { 1000, 10 }, { 1000, 1000 }, { 100, 100000 } };
+    int threads[] = { 1, 4 };
+    int count = g_options.quick ? 2 : 3;
+
+    for(int s = 0; s < count; s++)
+    {
+        int rows = shapes[s][0], cols = shapes[s][1];
+        double bytes = (double)rows * cols * sizeof(jdouble);
+
+        vector<jdouble>* data = new vector<jdouble>((size_t)rows * cols, 1.5);
+        vector<void*>* pointers = new vector<void*>(rows);
+        vector<int>* lengths = new vector<int>(rows, cols);
+        for(int r = 0; r < rows; r++)
+            (*pointers)[r] = &(*data)[(size_t)r * cols];
+        void** pRows = &(*pointers)[0];
+        const int* pLengths = &(*lengths)[0];
+
+        jobjectArray local = NULL;
+        if(NewMatrix(pEnv, "D", rows, pRows, pLengths, 1, &local) != 0)
+        {
+            delete data; delete pointers; delete lengths;
+            continue;
+        }
+        jobjectArray matrix = (jobjectArray)pEnv->NewGlobalRef(local);
+        DeleteRefs(pEnv, local);
+
+        for(int t = 0; t < 2; t++)
+        {
+            int nThreads = threads[t];
+            string shape = to_string(rows) + "x" + to_string(cols) + ".threads" + to_string(nThreads);
+
+            Bench("matrix", "NewMatrix." + shape, (long)rows * cols, bytes, 1L << 40, [=](long n) {
+                for(long i = 0; i < n; i++)
+                {
+                    jobjectArray m = NULL;
+                    if(NewMatrix(pEnv, "D", rows, pRows, pLengths, nThreads, &m) != 0)
+                        return false;
+                    DeleteRefs(pEnv, m);
+                }
+                return true;
+            });
+
+            Bench("matrix", "GetMatrixRows." + shape, (long)rows * cols, bytes, 1L << 40, [=](long n) {
+                for(long i = 0; i < n; i++)
+                    if(GetMatrixRows(pEnv, matrix, "D", rows, pRows, pLengths, nThreads) != 0)
+                        return false;
+                return true;
+            });
+        }
+
+        pEnv->DeleteGlobalRef(matrix);
+        delete data; delete pointers; delete lengths;
+    }
+}
+
+//exceptions
+
+static void BenchExceptions(JNIEnv* pEnv, jclass cls)
+{
+    jmethodID fail = StaticMethod(pEnv, cls, "fail", "(I)I");
+    jmethodID failNested = StaticMethod(pEnv, cls, "failNested", "(I)I");
+    if(fail == NULL || failNested == NULL)
+        return;
+
+    //The call is expected to fail, anything else is an error of the case.
+    auto Throw = [=](jmethodID mid) {
+        jvalue arg;
+        arg.i = 1;
+        int res = 0;
+        return CallStaticIntMethod(pEnv, cls, mid, 1, (void**)&arg, &res) != 0 && pEnv->ExceptionCheck() == JNI_TRUE;
+    };
+
+    Bench("exception", "TakeException.clear", 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            jobject throwable; jstring name, message;
+            if(!Throw(fail) || TakeException(pEnv, 0, &throwable, &name, &message) != 0)
+                return false;
+        }
+        return true;
+    });
+
+    Bench("exception", "TakeException.detail", 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            jobject throwable; jstring name, message;
+            if(!Throw(fail) || TakeException(pEnv, 1, &throwable, &name, &message) != 0)
+                return false;
+            DeleteRefs(pEnv, name, message);
+            ReleaseException(pEnv, throwable);
+        }
+        return true;
+    });
+
+    Bench("exception", "TakeException.trace", 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            jobject throwable; jstring name, message, trace;
+            if(!Throw(fail) || TakeException(pEnv, 1, &throwable, &name, &message) != 0)
+                return false;
+            if(DescribeException(pEnv, throwable, &trace) != 0)
+                return false;
+            DeleteRefs(pEnv, name, message, trace);
+            ReleaseException(pEnv, throwable);
+        }
+        return true;
+    });
+
+    Bench("exception", "TakeException.cause", 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            jobject throwable, cause; jstring name, message, causeName, causeMessage;
+            if(!Throw(failNested) || TakeException(pEnv, 1, &throwable, &name, &message) != 0)
+                return false;
+            if(GetExceptionCause(pEnv, throwable, &cause, &causeName, &causeMessage) != 0)
+                return false;
+            DeleteRefs(pEnv, name, message);
+            DeleteRefs(pEnv, causeName, causeMessage);
+            ReleaseException(pEnv, cause);
+            ReleaseException(pEnv, throwable);
+        }
+        return true;
+    });
+
+    Bench("exception", "GetException", 0, [=](long n) {
+        for(long i = 0; i < n; i++)
+        {
+            if(!Throw(fail))
+                return false;
+            const char* szError = GetException(pEnv);
+            if(szError == NULL || szError[0] == 0)
+                return false;
+        }
+        return true;
+    });
+}
+
+//callbacks
+/*
+The loops live in JNIWrapperBenchTarget so the natives are entered from Java, the way CLRObject and the CLRFunction
+proxies enter them. One wrapper call starts a loop of n entries, its own cost is spread over the batch.
+*/
+
+static void BenchCallbackLoop(JNIEnv* pEnv, jclass cls, const string& group, const string& name, long param, const char* szMethod, const char* szSignature, const vector<jvalue>& prefix)
+{
+    jmethodID mid = StaticMethod(pEnv, cls, szMethod, szSignature);
+    if(mid == NULL)
+        return;
+
+    char kind = szSignature[strlen(szSignature) - 1];
+    Bench(group, name, param, [=](long n) {
+        vector<jvalue> args(1 + prefix.size());
+        args[0].i = (jint)n;
+        for(size_t i = 0; i < prefix.size(); i++)
+            args[1 + i] = prefix[i];
+
+        switch(kind)
+        {
+            case 'I': g_sink = g_sink + pEnv->CallStaticIntMethodA(cls, mid, &args[0]); break;
+            case 'J': g_sink = g_sink + pEnv->CallStaticLongMethodA(cls, mid, &args[0]); break;
+            default: g_sink = g_sink + pEnv->CallStaticDoubleMethodA(cls, mid, &args[0]); break;
+        }
+        return pEnv->ExceptionCheck() != JNI_TRUE;
+    });
+}
+
+static jobject NewArgs(JNIEnv* pEnv, jclass cls, const char* szFactory, int len)
+{
+    jmethodID mid = StaticMethod(pEnv, cls, szFactory, "(I)[Ljava/lang/Object;");
+    if(mid == NULL)
+        return NULL;
+
+    jobject local = pEnv->CallStaticObjectMethod(cls, mid, (jint)len);
+    if(local == NULL)
+        return NULL;
+    jobject global = pEnv->NewGlobalRef(local);
+    pEnv->DeleteLocalRef(local);
+    return global;
+}
+
+static void BenchCallbacks(JNIEnv* pEnv, jclass cls)
+{
+    vector<jobject> globals;
+    int arities[] = { 0, 1, 4, 15 };
+    for(int a = 0; a < 4; a++)
+    {
+        vector<jvalue> args(1);
+        args[0].l = NewArgs(pEnv, cls, "boxedArgs", arities[a]);
+        globals.push_back(args[0].l);
+
+        BenchCallbackLoop(pEnv, cls, "callback", "nativeInvoke", arities[a], "invoke", "(I[Ljava/lang/Object;)I", args);
+        BenchCallbackLoop(pEnv, cls, "callback", "nativeInvokeFunc", arities[a], "invokeFunc", "(I[Ljava/lang/Object;)I", args);
+    }
+
+    vector<jvalue> strings(1), one(1);
+    strings[0].l = NewArgs(pEnv, cls, "stringArgs", 4);
+    one[0].l = NewArgs(pEnv, cls, "boxedArgs", 1);
+    globals.push_back(strings[0].l);
+    globals.push_back(one[0].l);
+
+    vector<jvalue> none;
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeInvoke.strings", 4, "invoke", "(I[Ljava/lang/Object;)I", strings);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeGetProperty", 0, "getProperty", "(I)I", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeSetProperty", 1, "setProperty", "(I[Ljava/lang/Object;)I", one);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCreateInstance", 1, "createInstance", "(I[Ljava/lang/Object;)I", one);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeRegisterFunc", 0, "registerFunc", "(I)I", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeRemoveObject", 0, "removeObject", "(I)I", none);
+
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeBindMethod", 0, "bindMethod", "(I)I", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCallV", 0, "callV", "(I)I", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCallDV", 1, "callDV", "(I)I", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCallDDV", 2, "callDDV", "(I)I", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCallDD", 1, "callDD", "(I)D", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCallDDD", 2, "callDDD", "(I)D", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCallJJ", 1, "callJJ", "(I)J", none);
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCallII", 1, "callII", "(I)I", none);
+
+    int lengths[] = { 16, 1024 };
+    for(int l = 0; l < 2; l++)
+    {
+        vector<jvalue> array(1);
+        jdoubleArray local = pEnv->NewDoubleArray(lengths[l]);
+        array[0].l = pEnv->NewGlobalRef(local);
+        pEnv->DeleteLocalRef(local);
+        globals.push_back(array[0].l);
+        BenchCallbackLoop(pEnv, cls, "callback", "nativeCallArrDD", lengths[l], "callArrDD", "(I[D)D", array);
+    }
+
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCreateID+nativeReleaseID", 0, "createReleaseID", "(I)I", none);
+    vector<jvalue> batch(1);
+    batch[0].i = 256;
+    BenchCallbackLoop(pEnv, cls, "callback", "nativeCreateID+nativeReleaseObjects", 256, "releaseObjects", "(II)I", batch);
+
+    for(size_t i = 0; i < globals.size(); i++)
+        if(globals[i] != NULL)
+            pEnv->DeleteGlobalRef(globals[i]);
+}
+
+//parallel
+/*
+Java threads calling the same .NET function at once, the IntStream.parallel().map(clrFunc) pattern. The stubs share
+nothing, so anything that keeps ns per call from falling with the thread count is contention in the bridge.
+*/
+
+static void BenchParallel(JNIEnv* pEnv, jclass cls)
+{
+    vector<int> threads;
+    int cpus = (int)std::thread::hardware_concurrency();
+    for(int t = 1; t < cpus; t *= 2)
+        threads.push_back(t);
+    threads.push_back(cpus < 1 ? 1 : cpus);
+
+    jobject args = NewArgs(pEnv, cls, "boxedArgs", 1);
+    for(size_t t = 0; t < threads.size(); t++)
+    {
+        vector<jvalue> pool(1), poolArgs(2);
+        pool[0].i = threads[t];
+        poolArgs[0].i = threads[t];
+        poolArgs[1].l = args;
+
+        BenchCallbackLoop(pEnv, cls, "parallel", "nativeCallII", threads[t], "parallelCallII", "(II)I", pool);
+        BenchCallbackLoop(pEnv, cls, "parallel", "nativeInvokeFunc", threads[t], "parallelInvokeFunc", "(II[Ljava/lang/Object;)I", poolArgs);
+        BenchCallbackLoop(pEnv, cls, "parallel", "CLRObject.InvokeArr", threads[t], "parallelInvoke", "(II[Ljava/lang/Object;)I", poolArgs);
+    }
+
+    if(args != NULL)
+        pEnv->DeleteGlobalRef(args);
+}
+
+/*
+.NET threads calling into the JVM at once: Call<Type>Method and CallBatch from 1 to all cores of native threads, each
+attached once through EnterThread like a ThreadPool thread. The n calls of a batch are split across the threads, so
+ns per call should fall as the threads go up; where it does not, the bridge or the JVM serializes the callers.
+*/
+
+typedef std::function<bool(JNIEnv* pEnv, long n)> ThreadBody;
+
+class ThreadGang
+{
+public:
+    ThreadGang(JavaVM* pVM, int count) : m_count(count), m_body(NULL), m_n(0), m_generation(0), m_pending(0), m_ok(true), m_stop(false)
+    {
+        for(int i = 0; i < count; i++)
+            m_threads.push_back(std::thread(&ThreadGang::Worker, this, pVM, i));
+    }
+
+    ~ThreadGang()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for(size_t i = 0; i < m_threads.size(); i++)
+            m_threads[i].join();
+    }
+
+    //Runs body on every thread with its share of n and waits for all of them.
+    bool Run(const ThreadBody& body, long n)
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_body = &body;
+        m_n = n;
+        m_ok = true;
+        m_pending = m_count;
+        m_generation++;
+        m_start.notify_all();
+        m_done.wait(lock, [this] { return m_pending == 0; });
+        return m_ok;
+    }
+
+private:
+    void Worker(JavaVM* pVM, int index)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "CLR Bench %d", index);
+        JNIEnv* pEnv = (JNIEnv*)EnterThread(pVM, name);
+
+        long seen = 0;
+        while(true)
+        {
+            const ThreadBody* body;
+            long n;
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_start.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if(m_stop)
+                    break;
+                seen = m_generation;
+                body = m_body;
+                n = m_n / m_count + (index < m_n % m_count ? 1 : 0);
+            }
+
+            bool ok = pEnv != NULL && (n == 0 || (*body)(pEnv, n));
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_ok = m_ok && ok;
+                if(--m_pending == 0)
+                    m_done.notify_one();
+            }
+        }
+
+        if(pEnv != NULL)
+            LeaveThread(pVM);
+    }
+
+    int m_count;
+    const ThreadBody* m_body;
+    long m_n;
+    long m_generation;
+    int m_pending;
+    bool m_ok;
+    bool m_stop;
+    std::mutex m_lock;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    vector<std::thread> m_threads;
+};
+
+static void BenchGang(ThreadGang* pGang, const string& name, long param, const ThreadBody& body)
+{
+    Bench("threads", name, param, [=](long n) {
+        return pGang->Run(body, n);
+    });
+}
+
+static void BenchThreads(JavaVM* pVM, JNIEnv* pEnv, jclass cls, jobject target)
+{
+    jmethodID staticI = StaticMethod(pEnv, cls, "staticI", "(I)I");
+    jmethodID staticD = StaticMethod(pEnv, cls, "staticD", "(I)D");
+    jmethodID staticL = StaticMethod(pEnv, cls, "staticL", "(I)Ljava/lang/Object;");
+    jmethodID instanceI = InstanceMethod(pEnv, target, "instanceI", "(I)I");
+    if(staticI == NULL || staticD == NULL || staticL == NULL || instanceI == NULL)
+        return;
+
+    if(!Selected("threads", "CallStaticIntMethod") && !Selected("threads", "CallStaticDoubleMethod") &&
+        !Selected("threads", "CallStaticObjectMethod") && !Selected("threads", "CallIntMethod") && !Selected("threads", "CallBatch"))
+        return;
+
+    vector<int> threads;
+    int cpus = (int)std::thread::hardware_concurrency();
+    for(int t = 1; t < cpus; t *= 2)
+        threads.push_back(t);
+    threads.push_back(cpus < 1 ? 1 : cpus);
+
+    for(size_t t = 0; t < threads.size(); t++)
+    {
+        ThreadGang gang(pVM, threads[t]);
+
+        BenchGang(&gang, "CallStaticIntMethod", threads[t], [=](JNIEnv* pThreadEnv, long n) {
+            jvalue arg;
+            arg.i = 7;
+            for(long i = 0; i < n; i++)
+                if(!CallKind(pThreadEnv, 'I', cls, NULL, staticI, 1, &arg))
+                    return false;
+            return true;
+        });
+        BenchGang(&gang, "CallStaticDoubleMethod", threads[t], [=](JNIEnv* pThreadEnv, long n) {
+            jvalue arg;
+            arg.i = 7;
+            for(long i = 0; i < n; i++)
+                if(!CallKind(pThreadEnv, 'D', cls, NULL, staticD, 1, &arg))
+                    return false;
+            return true;
+        });
+        BenchGang(&gang, "CallStaticObjectMethod", threads[t], [=](JNIEnv* pThreadEnv, long n) {
+            jvalue arg;
+            arg.i = 7;
+            for(long i = 0; i < n; i++)
+                if(!CallKind(pThreadEnv, 'L', cls, NULL, staticL, 1, &arg))
+                    return false;
+            return true;
+        });
+        BenchGang(&gang, "CallIntMethod", threads[t], [=](JNIEnv* pThreadEnv, long n) {
+            jvalue arg;
+            arg.i = 7;
+            for(long i = 0; i < n; i++)
+                if(!CallKind(pThreadEnv, 'I', cls, target, instanceI, 1, &arg))
+                    return false;
+            return true;
+        });
+
+        //32 static int calls per CallBatch, per call
+        BenchGang(&gang, "CallBatch", threads[t], [=](JNIEnv* pThreadEnv, long n) {
+            const int size = 32;
+            BatchCall calls[size];
+            jvalue args[size];
+            BatchResult results[size];
+            for(int i = 0; i < size; i++)
+            {
+                BatchCall call = { cls, staticI, NULL, NULL, 'I', 1, i, 1 };
+                calls[i] = call;
+                args[i].i = i;
+            }
+
+            for(long done = 0; done < n; done += size)
+                if(CallBatch(pThreadEnv, calls, size, args, results, 1) != 0)
+                    return false;
+            return true;
+        });
+    }
+}
+
+/*
+Thread scopes, entered the way Runtime.cs AttacheThread does: GetThreadEnv first, EnterThread when it returns NULL.
+Each batch opens an outer scope, makes n nested calls that each enter and leave a scope of their own and then checks
+that a local created in the outer scope is still alive, so the case fails if a nested LeaveThread pops the frame.
+*/
+
+static void BenchScopes(JavaVM* pVM)
+{
+    Bench("scope", "nestedAttach", 0, [=](long n) {
+        JNIEnv* pEnv = (JNIEnv*)EnterThread(pVM, NULL);
+        jobject outer = NULL;
+        if(pEnv == NULL || NewIntegerObject(pEnv, 42, &outer) != 0)
+        {
+            LeaveThread(pVM);
+            return false;
+        }
+
+        bool alive = true;
+        for(long i = 0; alive && i < n; i++)
+        {
+            JNIEnv* pInner = (JNIEnv*)GetThreadEnv();
+            if(pInner == NULL)
+                pInner = (JNIEnv*)EnterThread(pVM, NULL);
+            if(pInner == NULL)
+                break;
+
+            jobject inner = NULL;
+            alive = NewIntegerObject(pInner, (int)i, &inner) == 0;
+            pInner->DeleteLocalRef(inner);
+            LeaveThread(pVM);
+        }
+
+        TaggedValue value;
+        alive = alive && pEnv->GetObjectRefType(outer) == JNILocalRefType && UnboxObject(pEnv, outer, &value) == 0 && value.value.i == 42;
+        LeaveThread(pVM);
+        return alive;
+    });
+}
+
+/*
+Start up with and without class data sharing. Each op starts this harness again with --startup-child, which creates
+the JVM, resolves CLRRuntime and exits, so ns per op is the time to a usable JVM plus process start and exit.
+The children only get the jars of --classpath because the JVM refuses archives over non-empty directories.
+xshareOff runs without sharing, xshareAuto with the JDK's own archive and, with --cds-archive, appCds with an archive
+of the bridge classes built the way JVMLaunchOptions does in Auto mode: one run records the loaded class list, then
+java -Xshare:dump turns the list into the archive.
+*/
+
+static string Quote(const string& value)
+{
+    string quoted = "'";
+    for(size_t i = 0; i < value.size(); i++)
+        quoted += value[i] == '\'' ? string("'\\''") : string(1, value[i]);
+    return quoted + "'";
+}
+
+static string JarClasspath()
+{
+    string jars;
+    size_t start = 0;
+    while(start <= g_options.classpath.size())
+    {
+        size_t end = g_options.classpath.find(':', start);
+        if(end == string::npos)
+            end = g_options.classpath.size();
+
+        string entry = g_options.classpath.substr(start, end - start);
+        struct stat info;
+        if(!entry.empty() && stat(entry.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+            jars += (jars.empty() ? "" : ":") + entry;
+        start = end + 1;
+    }
+    return jars;
+}
+
+static string StartupCommand(const vector<string>& options)
+{
+    string command = Quote(g_options.self) + " --startup-child --classpath " + Quote(JarClasspath()) + " --libpath " + Quote(g_options.libpath);
+    for(size_t i = 0; i < g_options.jvmOptions.size(); i++)
+        command += " " + Quote(g_options.jvmOptions[i]);
+    for(size_t i = 0; i < options.size(); i++)
+        command += " " + Quote(options[i]);
+    return command + " > /dev/null 2>&1";
+}
+
+static bool DumpArchive(const string& archive)
+{
+    string classList = archive + ".classlist";
+    vector<string> record;
+    record.push_back("-Xshare:off");
+    record.push_back("-XX:DumpLoadedClassList=" + classList);
+    if(system(StartupCommand(record).c_str()) != 0)
+        return false;
+
+    const char* szHome = getenv("JAVA_HOME");
+    string java = szHome == NULL ? "java" : string(szHome) + "/bin/java";
+    string command = Quote(java) + " -Xshare:dump -XX:SharedClassListFile=" + Quote(classList) +
+        " -XX:SharedArchiveFile=" + Quote(archive) + " -cp " + Quote(JarClasspath()) + " > /dev/null 2>&1";
+    return system(command.c_str()) == 0;
+}
+
+static void BenchStartupCase(const string& name, const vector<string>& options)
+{
+    string command = StartupCommand(options);
+    Bench("startup", name, 0, 0, 1, [=](long n) {
+        for(long i = 0; i < n; i++)
+            if(system(command.c_str()) != 0)
+                return false;
+        return true;
+    });
+}
+
+static void BenchStartup()
+{
+    BenchStartupCase("xshareOff", vector<string>(1, "-Xshare:off"));
+    BenchStartupCase("xshareAuto", vector<string>(1, "-Xshare:auto"));
+
+    if(g_options.cdsArchive.empty() || !Selected("startup", "appCds"))
+        return;
+
+    struct stat info;
+    if(stat(g_options.cdsArchive.c_str(), &info) != 0 && !DumpArchive(g_options.cdsArchive))
+        fprintf(stderr, "startup: could not dump %s\n", g_options.cdsArchive.c_str());
+
+    vector<string> options;
+    options.push_back("-XX:SharedArchiveFile=" + g_options.cdsArchive);
+    options.push_back("-Xshare:on");
+    BenchStartupCase("appCds", options);
+}
+
+//output
+
+static string JsonString(const string& value)
+{
+    string res = "\"";
+    for(size_t i = 0; i < value.size(); i++)
+    {
+        char c = value[i];
+        switch(c)
+        {
+            case '"': res += "\\\""; break;
+            case '\\': res += "\\\\"; break;
+            case '\n': res += "\\n"; break;
+            case '\r': res += "\\r"; break;
+            case '\t': res += "\\t"; break;
+            default:
+                if((unsigned char)c < 0x20)
+                {
+                    char escape[8];
+                    snprintf(escape, sizeof(escape), "\\u%04x", c);
+                    res += escape;
+                }
+                else
+                    res += c;
+        }
+    }
+    return res + "\"";
+}
+
+static string JavaProperty(JNIEnv* pEnv, const char* szName)
+{
+    jclass cls = pEnv->FindClass("java/lang/System");
+    jmethodID mid = cls == NULL ? NULL : pEnv->GetStaticMethodID(cls, "getProperty", "(Ljava/lang/String;)Ljava/lang/String;");
+    if(mid == NULL)
+    {
+        pEnv->ExceptionClear();
+        return "";
+    }
+
+    jstring name = pEnv->NewStringUTF(szName);
+    jstring value = (jstring)pEnv->CallStaticObjectMethod(cls, mid, name);
+    string res;
+    if(value != NULL)
+    {
+        const char* chars = pEnv->GetStringUTFChars(value, NULL);
+        res = chars;
+        pEnv->ReleaseStringUTFChars(value, chars);
+        pEnv->DeleteLocalRef(value);
+    }
+    pEnv->DeleteLocalRef(name);
+    pEnv->DeleteLocalRef(cls);
+    return res;
+}
+
+static int WriteResults(JNIEnv* pEnv, const string& path)
+{
+    FILE* file = path.empty() || path == "-" ? stdout : fopen(path.c_str(), "w");
+    if(file == NULL)
+    {
+        fprintf(stderr, "%s could not be opened\n", path.c_str());
+        return -1;
+    }
+
+    char timestamp[32];
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(file, "{\n  \"format\": 1,\n");
+    fprintf(file, "  \"timestamp\": %s,\n", JsonString(timestamp).c_str());
+    fprintf(file, "  \"java_version\": %s,\n", JsonString(JavaProperty(pEnv, "java.version")).c_str());
+    fprintf(file, "  \"java_vm\": %s,\n", JsonString(JavaProperty(pEnv, "java.vm.name")).c_str());
+    fprintf(file, "  \"cpus\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(file, "  \"metrics\": %s,\n", MetricsEnabled() ? "true" : "false");
+    fprintf(file, "  \"reps\": %d,\n  \"warmup\": %d,\n  \"batch_ms\": %g,\n", g_options.reps, g_options.warmup, g_options.batchMs);
+    fprintf(file, "  \"results\": [");
+
+    for(size_t r = 0; r < g_results.size(); r++)
+    {
+        const BenchResult& result = g_results[r];
+        fprintf(file, "%s\n    { \"group\": %s, \"name\": %s, \"param\": %ld, \"ops\": %ld",
+            r == 0 ? "" : ",", JsonString(result.group).c_str(), JsonString(result.name).c_str(), result.param, result.ops);
+
+        if(!result.error.empty())
+        {
+            fprintf(file, ", \"error\": %s }", JsonString(result.error).c_str());
+            continue;
+        }
+
+        vector<double> sorted(result.samples);
+        std::sort(sorted.begin(), sorted.end());
+        double mean = 0, variance = 0;
+        for(size_t i = 0; i < sorted.size(); i++)
+            mean += sorted[i];
+        mean /= sorted.size();
+        for(size_t i = 0; i < sorted.size(); i++)
+            variance += (sorted[i] - mean) * (sorted[i] - mean);
+        double median = sorted[sorted.size() / 2];
+
+        fprintf(file, ", \"ns_min\": %.3f, \"ns_median\": %.3f, \"ns_mean\": %.3f, \"ns_max\": %.3f, \"ns_stddev\": %.3f",
+            sorted.front(), median, mean, sorted.back(), sqrt(variance / sorted.size()));
+        if(result.bytesPerOp > 0)
+            fprintf(file, ", \"bytes_per_op\": %.0f, \"mb_per_s\": %.1f", result.bytesPerOp, result.bytesPerOp / median * 1e9 / (1 << 20));
+        fprintf(file, " }");
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+    if(file != stdout)
+        fclose(file);
+    return 0;
+}
+
+//main
+
+static void Usage()
+{
+    fprintf(stderr,
+        "JNIWrapperBench [options] [-Xjvm-option ...]\n"
+        "  --classpath <cp>    class path, default app.quant.clr.jar:scala-library.jar:.\n"
+        "  --libpath <dir>     directory holding libJNIWrapper, default .\n"
+        "  --out <file>        JSON results, default stdout\n"
+        "  --filter <text>     only run cases whose group/name contains text\n"
+        "  --reps <n>          measured batches per case, default 7\n"
+        "  --warmup <n>        dropped batches per case, default 3\n"
+        "  --batch-ms <ms>     target duration of a batch, default 20\n"
+        "  --quick             smaller sizes and shorter batches\n"
+        "  --no-metrics        turn off the wrapper's call metrics\n"
+        "  --cds-archive <file> AppCDS archive for the startup group, dumped first when missing\n"
+        "Any argument starting with -X or -D is passed to the JVM.\n");
+}
+
+static bool ParseOptions(int argc, char** argv)
+{
+    g_options.classpath = "app.quant.clr.jar:scala-library.jar:.";
+    g_options.libpath = ".";
+    g_options.reps = 7;
+    g_options.warmup = 3;
+    g_options.batchMs = 20;
+    g_options.quick = false;
+    g_options.metrics = true;
+    g_options.startupChild = false;
+    g_options.self = argv[0];
+
+    for(int i = 1; i < argc; i++)
+    {
+        string arg(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if(arg == "--classpath" && hasValue) g_options.classpath = argv[++i];
+        else if(arg == "--libpath" && hasValue) g_options.libpath = argv[++i];
+        else if(arg == "--out" && hasValue) g_options.out = argv[++i];
+        else if(arg == "--filter" && hasValue) g_options.filter = argv[++i];
+        else if(arg == "--reps" && hasValue) g_options.reps = std::max(1, atoi(argv[++i]));
+        else if(arg == "--warmup" && hasValue) g_options.warmup = std::max(0, atoi(argv[++i]));
+        else if(arg == "--batch-ms" && hasValue) g_options.batchMs = atof(argv[++i]);
+        else if(arg == "--quick") g_options.quick = true;
+        else if(arg == "--no-metrics") g_options.metrics = false;
+        else if(arg == "--cds-archive" && hasValue) g_options.cdsArchive = argv[++i];
+        else if(arg == "--startup-child") g_options.startupChild = true;
+        else if(arg.compare(0, 2, "-X") == 0 || arg.compare(0, 2, "-D") == 0) g_options.jvmOptions.push_back(arg);
+        else
+        {
+            Usage();
+            return false;
+        }
+    }
+
+    if(g_options.quick)
+    {
+        g_options.reps = std::min(g_options.reps, 3);
+        g_options.warmup = std::min(g_options.warmup, 1);
+        g_options.batchMs = std::min(g_options.batchMs, 5.0);
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if(!ParseOptions(argc, argv))
+        return 2;
+
+    InstallStubCallbacks();
+
+    vector<char*> extra;
+    for(size_t i = 0; i < g_options.jvmOptions.size(); i++)
+        extra.push_back((char*)g_options.jvmOptions[i].c_str());
+
+    void* pArgs = NULL;
+    if(MakeJavaVMInitArgsEx((char*)g_options.classpath.c_str(), (char*)g_options.libpath.c_str(), (int)extra.size(), extra.empty() ? NULL : &extra[0], &pArgs) != 0)
+        return 1;
+
+    JavaVM* pVM = NULL;
+    JNIEnv* pEnv = NULL;
+    int res = JNI_CreateJavaVM(&pVM, (void**)&pEnv, pArgs);
+    FreeJavaVMInitArgs(pArgs);
+    if(res != 0)
+    {
+        fprintf(stderr, "JNI_CreateJavaVM failed: %d\n", res);
+        return 1;
+    }
+    g_env = pEnv;
+
+    if(InitJNICache(pEnv) != 0)
+    {
+        fprintf(stderr, "app/quant/clr/CLRRuntime not found in %s\n", g_options.classpath.c_str());
+        return 1;
+    }
+    if(g_options.startupChild)
+        return DestroyJavaVM(pVM) != 0 ? 1 : 0;
+    SetMetricsEnabled(g_options.metrics ? 1 : 0);
+
+    jclass cls = NULL;
+    jobject target = NULL;
+    if(FindClass(pEnv, "JNIWrapperBenchTarget", &cls) != 0 || NewObject(pEnv, "JNIWrapperBenchTarget", "()V", 0, NULL, &target) != 0)
+    {
+        fprintf(stderr, "JNIWrapperBenchTarget not found in %s\n", g_options.classpath.c_str());
+        return 1;
+    }
+    cls = (jclass)pEnv->NewGlobalRef(cls);
+    target = pEnv->NewGlobalRef(target);
+
+    BenchBoxing(pEnv);
+    BenchCalls(pEnv, cls, target);
+    BenchFields(pEnv, cls, target);
+    BenchStrings(pEnv);
+    BenchAllArrays(pEnv);
+    BenchCollections(pEnv);
+    BenchMatrices(pEnv);
+    BenchExceptions(pEnv, cls);
+    BenchCallbacks(pEnv, cls);
+    BenchParallel(pEnv, cls);
+    BenchThreads(pVM, pEnv, cls, target);
+    BenchScopes(pVM);
+    BenchStartup();
+
+    int failed = 0;
+    for(size_t i = 0; i < g_results.size(); i++)
+        if(!g_results[i].error.empty())
+            failed++;
+
+    res = WriteResults(pEnv, g_options.out);
+
+    pEnv->DeleteGlobalRef(target);
+    pEnv->DeleteGlobalRef(cls);
+    DestroyJavaVM(pVM);
+
+    return res != 0 || failed != 0 ? 1 : 0;
+}
@@ -0,0 +1,325 @@
+/*
+ * The MIT License (MIT)
+ * Copyright (c) Arturo Rodriguez All rights reserved.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+import app.quant.clr.CLRObject;
+import app.quant.clr.CLRRuntime;
+
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ForkJoinPool;
+import java.util.stream.IntStream;
+
+/*
+Java side of JNIWrapperBench.
+Static and instance targets for every Call<Type>Method and field wrapper, methods of 0 to 15 arguments for the
+arity sweeps, throwers for the exception paths and loops over the CLRRuntime natives, so the Java to .NET
+callbacks are timed from Java where they are normally entered.
+*/
+public class JNIWrapperBenchTarget
+{
+    public static int staticInt;
+    public static double staticDouble;
+    public static Object staticObject;
+
+    public int instanceInt;
+    public double instanceDouble;
+    public Object instanceObject;
+
+    private static final String text = "bench";
+    private static volatile double sink;
+
+    public JNIWrapperBenchTarget()
+    {
+    }
+
+    //return types, static
+    public static void staticV(int a) { }
+    public static boolean staticZ(int a) { return a != 0; }
+    public static byte staticB(int a) { return (byte)a; }
+    public static char staticC(int a) { return (char)a; }
+    public static short staticS(int a) { return (short)a; }
+    public static int staticI(int a) { return a; }
+    public static long staticJ(int a) { return a; }
+    public static float staticF(int a) { return a; }
+    public static double staticD(int a) { return a; }
+    public static Object staticL(int a) { return text; }
+
+    //return types, instance
+    public void instanceV(int a) { }
+    public boolean instanceZ(int a) { return a != 0; }
+    public byte instanceB(int a) { return (byte)a; }
+    public char instanceC(int a) { return (char)a; }
+    public short instanceS(int a) { return (short)a; }
+    public int instanceI(int a) { return a; }
+    public long instanceJ(int a) { return a; }
+    public float instanceF(int a) { return a; }
+    public double instanceD(int a) { return a; }
+    public Object instanceL(int a) { return text; }
+
+    //arity, int
+    public static int sumI0() { return 0; }
+    public static int sumI1(int a0) { return a0; }
+    public static int sumI2(int a0, int a1) { return a0 + a1; }
+    public static int sumI3(int a0, int a1, int a2) { return a0 + a1 + a2; }
+    public static int sumI4(int a0, int a1, int a2, int a3) { return a0 + a1 + a2 + a3; }
+    public static int sumI5(int a0, int a1, int a2, int a3, int a4) { return a0 + a1 + a2 + a3 + a4; }
+    public static int sumI6(int a0, int a1, int a2, int a3, int a4, int a5) { return a0 + a1 + a2 + a3 + a4 + a5; }
+    public static int sumI7(int a0, int a1, int a2, int a3, int a4, int a5, int a6) { return a0 + a1 + a2 + a3 + a4 + a5 + a6; }
+    public static int sumI8(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7; }
+    public static int sumI9(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8; }
+    public static int sumI10(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9; }
+    public static int sumI11(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10; }
+    public static int sumI12(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11; }
+    public static int sumI13(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11, int a12) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12; }
+    public static int sumI14(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11, int a12, int a13) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12 + a13; }
+    public static int sumI15(int a0, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8, int a9, int a10, int a11, int a12, int a13, int a14) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12 + a13 + a14; }
+
+    //arity, double
+    public static double sumD0() { return 0; }
+    public static double sumD1(double a0) { return a0; }
+    public static double sumD2(double a0, double a1) { return a0 + a1; }
+    public static double sumD3(double a0, double a1, double a2) { return a0 + a1 + a2; }
+    public static double sumD4(double a0, double a1, double a2, double a3) { return a0 + a1 + a2 + a3; }
+    public static double sumD5(double a0, double a1, double a2, double a3, double a4) { return a0 + a1 + a2 + a3 + a4; }
+    public static double sumD6(double a0, double a1, double a2, double a3, double a4, double a5) { return a0 + a1 + a2 + a3 + a4 + a5; }
+    public static double sumD7(double a0, double a1, double a2, double a3, double a4, double a5, double a6) { return a0 + a1 + a2 + a3 + a4 + a5 + a6; }
+    public static double sumD8(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7; }
+    public static double sumD9(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7, double a8) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8; }
+    public static double sumD10(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7, double a8, double a9) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9; }
+    public static double sumD11(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7, double a8, double a9, double a10) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10; }
+    public static double sumD12(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7, double a8, double a9, double a10, double a11) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11; }
+    public static double sumD13(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7, double a8, double a9, double a10, double a11, double a12) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12; }
+    public static double sumD14(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7, double a8, double a9, double a10, double a11, double a12, double a13) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12 + a13; }
+    public static double sumD15(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7, double a8, double a9, double a10, double a11, double a12, double a13, double a14) { return a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 + a8 + a9 + a10 + a11 + a12 + a13 + a14; }
+
+    //arity, object
+    public static Object firstL0() { return null; }
+    public static Object firstL1(Object a0) { return a0; }
+    public static Object firstL2(Object a0, Object a1) { return a0; }
+    public static Object firstL3(Object a0, Object a1, Object a2) { return a0; }
+    public static Object firstL4(Object a0, Object a1, Object a2, Object a3) { return a0; }
+    public static Object firstL5(Object a0, Object a1, Object a2, Object a3, Object a4) { return a0; }
+    public static Object firstL6(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5) { return a0; }
+    public static Object firstL7(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6) { return a0; }
+    public static Object firstL8(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7) { return a0; }
+    public static Object firstL9(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7, Object a8) { return a0; }
+    public static Object firstL10(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7, Object a8, Object a9) { return a0; }
+    public static Object firstL11(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7, Object a8, Object a9, Object a10) { return a0; }
+    public static Object firstL12(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7, Object a8, Object a9, Object a10, Object a11) { return a0; }
+    public static Object firstL13(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7, Object a8, Object a9, Object a10, Object a11, Object a12) { return a0; }
+    public static Object firstL14(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7, Object a8, Object a9, Object a10, Object a11, Object a12, Object a13) { return a0; }
+    public static Object firstL15(Object a0, Object a1, Object a2, Object a3, Object a4, Object a5, Object a6, Object a7, Object a8, Object a9, Object a10, Object a11, Object a12, Object a13, Object a14) { return a0; }
+
+    //exceptions
+    public static int fail(int a)
+    {
+        throw new IllegalStateException("bench " + a);
+    }
+
+    public static int failNested(int a)
+    {
+        try
+        {
+            return fail(a);
+        }
+        catch(IllegalStateException e)
+        {
+            throw new RuntimeException("wrapped", e);
+        }
+    }
+
+    //callbacks, each loop enters the native n times and returns the accumulated results so nothing is elided
+    public static Object[] boxedArgs(int len)
+    {
+        Object[] args = new Object[len];
+        for(int i = 0; i < len; i++)
+            args[i] = Double.valueOf(i);
+        return args;
+    }
+
+    public static Object[] stringArgs(int len)
+    {
+        Object[] args = new Object[len];
+        for(int i = 0; i < len; i++)
+            args[i] = text + i;
+        return args;
+    }
+
+    public static int invoke(int n, Object[] args)
+    {
+        int hits = 0;
+        for(int i = 0; i < n; i++)
+            if(CLRRuntime.nativeInvoke(1, "Run", args.length, args) == null)
+                hits++;
+        return hits;
+    }
+
+    public static int invokeFunc(int n, Object[] args)
+    {
+        int hits = 0;
+        for(int i = 0; i < n; i++)
+            if(CLRRuntime.nativeInvokeFunc(1, args.length, args) == null)
+                hits++;
+        return hits;
+    }
+
+    public static int getProperty(int n)
+    {
+        int hits = 0;
+        for(int i = 0; i < n; i++)
+            if(CLRRuntime.nativeGetProperty(1, "Value") == null)
+                hits++;
+        return hits;
+    }
+
+    public static int setProperty(int n, Object[] value)
+    {
+        for(int i = 0; i < n; i++)
+            CLRRuntime.nativeSetProperty(1, "Value", value);
+        return n;
+    }
+
+    public static int createInstance(int n, Object[] args)
+    {
+        int sum = 0;
+        for(int i = 0; i < n; i++)
+            sum += CLRRuntime.nativeCreateInstance("Bench", args.length, args);
+        return sum;
+    }
+
+    public static int registerFunc(int n)
+    {
+        int hits = 0;
+        for(int i = 0; i < n; i++)
+            if(CLRRuntime.nativeRegisterFunc("Bench", 1) == null)
+                hits++;
+        return hits;
+    }
+
+    public static int removeObject(int n)
+    {
+        for(int i = 0; i < n; i++)
+            CLRRuntime.nativeRemoveObject(1);
+        return n;
+    }
+
+    public static int bindMethod(int n)
+    {
+        int sum = 0;
+        for(int i = 0; i < n; i++)
+            sum += CLRRuntime.nativeBindMethod(1, "Run", "(D)D");
+        return sum;
+    }
+
+    public static int callV(int n)
+    {
+        for(int i = 0; i < n; i++)
+            CLRRuntime.nativeCallV(1);
+        return n;
+    }
+
+    public static int callDV(int n)
+    {
+        for(int i = 0; i < n; i++)
+            CLRRuntime.nativeCallDV(1, i);
+        return n;
+    }
+
+    public static int callDDV(int n)
+    {
+        for(int i = 0; i < n; i++)
+            CLRRuntime.nativeCallDDV(1, i, i);
+        return n;
+    }
+
+    public static double callDD(int n)
+    {
+        double sum = 0;
+        for(int i = 0; i < n; i++)
+            sum += CLRRuntime.nativeCallDD(1, i);
+        sink = sum;
+        return sum;
+    }
+
+    public static double callDDD(int n)
+    {
+        double sum = 0;
+        for(int i = 0; i < n; i++)
+            sum += CLRRuntime.nativeCallDDD(1, i, i);
+        sink = sum;
+        return sum;
+    }
+
+    public static long callJJ(int n)
+    {
+        long sum = 0;
+        for(int i = 0; i < n; i++)
+            sum += CLRRuntime.nativeCallJJ(1, i);
+        return sum;
+    }
+
+    public static int callII(int n)
+    {
+        int sum = 0;
+        for(int i = 0; i < n; i++)
+            sum += CLRRuntime.nativeCallII(1, i);
+        return sum;
+    }
+
+    public static double callArrDD(int n, double[] a)
+    {
+        double sum = 0;
+        for(int i = 0; i < n; i++)
+            sum += CLRRuntime.nativeCallArrDD(1, a);
+        sink = sum;
+        return sum;
+    }
+
+    public static int createReleaseID(int n)
+    {
+        int released = 0;
+        for(int i = 0; i < n; i++)
+            if(CLRRuntime.nativeReleaseID(CLRRuntime.nativeCreateID()))
+                released++;
+        return released;
+    }
+
+    public static int releaseObjects(int n, int batch)
+    {
+        int[] ids = new int[batch];
+        for(int done = 0; done < n; done += batch)
+        {
+            for(int i = 0; i < batch; i++)
+                ids[i] = CLRRuntime.nativeCreateID();
+            CLRRuntime.nativeReleaseObjects(ids);
+        }
+        return n;
+    }
+
+    //parallel callbacks, the n calls of a loop are spread over a pool of the given size by a parallel stream
+    private static final ConcurrentHashMap<Integer, ForkJoinPool> pools = new ConcurrentHashMap<Integer, ForkJoinPool>();
+    private static final CLRObject clrObject = new CLRObject("Bench", 1, false);
+
+    private static ForkJoinPool pool(int threads)
+    {
+        return pools.computeIfAbsent(threads, ForkJoinPool::new);
+    }
+
+    public static int parallelCallII(int n, int threads)
+    {
+        return pool(threads).submit(() -> IntStream.range(0, n).parallel().map(i -> CLRRuntime.nativeCallII(1, i)).sum()).join();
+    }
+
+    public static int parallelInvokeFunc(int n, int threads, Object[] args)
+    {
+        return pool(threads).submit(() -> IntStream.range(0, n).parallel().map(i -> CLRRuntime.nativeInvokeFunc(1, args.length, args) == null ? 1 : 0).sum()).join();
+    }
+
+    public static int parallelInvoke(int n, int threads, Object[] args)
+    {
+        return pool(threads).submit(() -> IntStream.range(0, n).parallel().map(i -> clrObject.InvokeArr("Run", args) == null ? 1 : 0).sum()).join();
+    }
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+# Builds the JNIWrapper microbenchmarks into CoFlows.Server/obj/lnx/bench, outside this folder so the build root
+# never packs them into app.quant.clr.jar: libJNIWrapper.so from the current JNIWrapper.cpp, the Java
+# targets and the JNIWrapperBench harness linked against both the library and libjvm.
+# Needs a JDK in JAVA_HOME and app.quant.clr.jar as built by build.lnx.sh at the repository root.
+#
+#   JAVA_HOME=/usr/java/openjdk-11 ./build.lnx.sh
+#   cd ../../../CoFlows.Server/obj/lnx/bench && ./JNIWrapperBench --out results.json
+#
+# The library is compiled with the flags of CoFlows.Server/Dockerfile so the numbers are those of what ships,
+# set CXXFLAGS to try others.
+
+set -e
+cd "$(dirname "$0")"
+
+JAVA_HOME=${JAVA_HOME:-/usr/java/openjdk-11}
+JAR=${JAR:-../../../CoFlows.Server/obj/lnx/publish/app.quant.clr.jar}
+SCALA_LIB=${SCALA_LIB:-/usr/share/scala/lib/scala-library.jar}
+CXXFLAGS=${CXXFLAGS:-}
+OUT=${OUT:-../../../CoFlows.Server/obj/lnx/bench}
+JVM_LIB=$(dirname "$(find -L "$JAVA_HOME" -name libjvm.so | head -n 1)")
+INCLUDES="-I$JAVA_HOME/include -I$JAVA_HOME/include/linux"
+
+mkdir -p "$OUT"
+cp "$JAR" "$OUT"/app.quant.clr.jar
+if [ -f "$SCALA_LIB" ]; then cp "$SCALA_LIB" "$OUT"/; fi
+
+javac -cp "$OUT"/app.quant.clr.jar -d "$OUT" JNIWrapperBenchTarget.java
+g++ $CXXFLAGS -shared -fPIC -o "$OUT"/libJNIWrapper.so $INCLUDES ../JNIWrapper.cpp -lpthread
+g++ -O2 -o "$OUT"/JNIWrapperBench $INCLUDES JNIWrapperBench.cpp -L"$OUT" -lJNIWrapper -L"$JVM_LIB" -ljvm -lpthread \
+    -Wl,-rpath,'$ORIGIN' -Wl,-rpath,"$JVM_LIB"
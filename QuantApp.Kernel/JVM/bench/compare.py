@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+# Compares two JNIWrapperBench result files case by case on the median ns per operation.
+#
+#   python3 compare.py before.json after.json [--threshold 5] [--filter array/]
+
+import argparse
+import json
+
+
+def load(path):
+    with open(path) as f:
+        results = json.load(f)["results"]
+    return {(r["group"], r["name"], r["param"]): r for r in results}
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("before")
+    parser.add_argument("after")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent change to flag, default 5")
+    parser.add_argument("--filter", default="", help="only cases whose group/name contains this text")
+    args = parser.parse_args()
+
+    before = load(args.before)
+    after = load(args.after)
+
+    print("%-10s %-44s %10s %12s %12s %8s" % ("group", "name", "param", "before ns", "after ns", "change"))
+    for key in sorted(set(before) | set(after)):
+        group, name, param = key
+        if args.filter not in group + "/" + name:
+            continue
+
+        old, new = before.get(key), after.get(key)
+        if old is None or new is None or "error" in old or "error" in new:
+            state = "missing" if old is None or new is None else "error"
+            print("%-10s %-44s %10d %12s %12s %8s" % (group, name, param, "", "", state))
+            continue
+
+        change = (new["ns_median"] - old["ns_median"]) / old["ns_median"] * 100 if old["ns_median"] > 0 else 0.0
+        flag = " <" if change <= -args.threshold else " >" if change >= args.threshold else ""
+        print("%-10s %-44s %10d %12.1f %12.1f %+7.1f%%%s" % (group, name, param, old["ns_median"], new["ns_median"], change, flag))
+
+
+if __name__ == "__main__":
+    main()